@@ -18,6 +18,8 @@
 #include <capability/tts_interface.hh>
 #include <clientkit/nugu_client.hh>
 
+#include "win32_getopt.hh"
+
 #define DEFAULT_MODEL_PATH NUGU_ASSET_PATH "/model"
 
 using namespace NuguClientKit;
@@ -33,6 +35,7 @@ static int test_network_timeout = 60;
 static std::string test_name;
 static GMainLoop* loop;
 static FILE* fp_out;
+static FILE* fp_summary;
 static guint timer_src;
 static guint network_timer_src;
 
@@ -125,6 +128,30 @@ static void test_finished(void)
     test_start();
 }
 
+static void export_latency(void)
+{
+    /* CSV header, NOLINTNEXTLINE(cert-err33-c) */
+    fprintf(fp_summary, "From,To,Count,Min,P50,P90,P99,Max\n");
+
+    for (int type = 0; type < NUGU_PROF_TYPE_MAX; type++) {
+        struct nugu_prof_latency latency;
+
+        if (nugu_prof_get_latency((enum nugu_prof_type)type, &latency) < 0 || latency.count == 0)
+            continue;
+
+        nugu_info("%s ~ %s: count %u, p50 %d, p90 %d, p99 %d, max %d (msec)",
+            nugu_prof_get_type_name(latency.from), nugu_prof_get_type_name(latency.to),
+            latency.count, (int)(latency.p50 / 1000), (int)(latency.p90 / 1000),
+            (int)(latency.p99 / 1000), (int)(latency.max / 1000));
+
+        /* CSV data, NOLINTNEXTLINE(cert-err33-c) */
+        fprintf(fp_summary, "%s,%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+            nugu_prof_get_type_name(latency.from), nugu_prof_get_type_name(latency.to),
+            latency.count, latency.min / 1000.0, latency.p50 / 1000.0,
+            latency.p90 / 1000.0, latency.p99 / 1000.0, latency.max / 1000.0);
+    }
+}
+
 static void usage(const char* cmd)
 {
     printf("Profiling measurement tool using pre-recorded voice files.\n\n");
@@ -136,6 +163,7 @@ static void usage(const char* cmd)
     printf(" -d delay\t\tDelay between each test iteration. (seconds, default = %d)\n", test_delay);
     printf(" -t timeout\t\tTimeout for each tests. (seconds, default = %d)\n", test_timeout);
     printf(" -c name\t\tName for testcase. (default = input-file)\n");
+    printf(" -s <summary-file>\tFile to save the latency percentiles of the session (CSV format)\n");
     printf("\nPlease set the token using the NUGU_TOKEN environment variable.\n");
 }
 
@@ -264,65 +292,17 @@ public:
     }
 };
 
-#ifdef _WIN32
-static char *optarg;
-static int optind = 1, opterr = 1, optopt;
-
-static char *next = NULL;
-
-static int getopt(int argc, char * const argv[], const char *optstring) {
-    if (optind == 0) {
-        optind = 1;
-        next = NULL;
-    }
-    if (next == NULL || *next == '\0') {
-        if (optind == argc || argv[optind][0] != '-' || argv[optind][1] == '\0') {
-            return -1;
-        }
-        if (strcmp(argv[optind], "--") == 0) {
-            optind++;
-            return -1;
-        }
-        next = argv[optind] + 1;
-        optind++;
-    }
-
-    optopt = *next++;
-    const char *opt = strchr(optstring, optopt);
-    if (opt == NULL || optopt == ':') {
-        if (opterr) {
-            fprintf(stderr, "Unknown option -%c\n", optopt);
-        }
-        return '?';
-    }
-    if (opt[1] == ':') {
-        if (*next != '\0') {
-            optarg = next;
-            next = NULL;
-        } else if (optind < argc) {
-            optarg = argv[optind];
-            optind++;
-        } else {
-            if (opterr) {
-                fprintf(stderr, "Option -%c requires an argument\n", optopt);
-            }
-            return '?';
-        }
-    }
-    return optopt;
-}
-#endif
-
 int main(int argc, char* argv[])
 {
     std::shared_ptr<NuguClient> nugu_client;
     int c;
     std::string input_file;
     std::string output_file;
+    std::string summary_file;
     std::string model_path = DEFAULT_MODEL_PATH;
     const char* env_token;
 
-    while ((c = getopt(argc, argv, "i:o:n:m:d:t:c:")) != -1) {
+    while ((c = getopt(argc, argv, "i:o:n:m:d:t:c:s:")) != -1) {
         switch (c) {
         case 'i':
             input_file = optarg;
@@ -345,6 +325,9 @@ int main(int argc, char* argv[])
         case 'c':
             test_name = optarg;
             break;
+        case 's':
+            summary_file = optarg;
+            break;
         default:
             usage(argv[0]);
             return -1;
@@ -386,6 +369,14 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    if (summary_file.size() > 0) {
+        fp_summary = fopen(summary_file.c_str(), "w");
+        if (!fp_summary) {
+            printf("Fail to open summary file '%s'\n", summary_file.c_str());
+            return -1;
+        }
+    }
+
     /* CSV header, NOLINTNEXTLINE(cert-err33-c) */
     fprintf(fp_out, "Testcase,Num,timestamp,%s,%s,%s,%s,%s,Dialog_Request_ID\n",
         nugu_prof_get_type_name(NUGU_PROF_TYPE_ASR_END_POINT_DETECTED),
@@ -465,5 +456,12 @@ int main(int argc, char* argv[])
             printf("fclose() failed\n");
     }
 
+    if (fp_summary) {
+        export_latency();
+
+        if (fclose(fp_summary))
+            printf("fclose() failed\n");
+    }
+
     return 0;
 }
@@ -0,0 +1,354 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#define NUGU_LOG_MODULE NUGU_LOG_MODULE_APPLICATION
+#include <base/nugu_log.h>
+
+#include <base/nugu_plugin.h>
+#include <base/nugu_prof.h>
+#include <capability/asr_interface.hh>
+#include <capability/audio_player_interface.hh>
+#include <capability/capability_factory.hh>
+#include <capability/system_interface.hh>
+#include <capability/text_interface.hh>
+#include <capability/tts_interface.hh>
+#include <clientkit/nugu_client.hh>
+
+#include "win32_getopt.hh"
+
+using namespace NuguClientKit;
+using namespace NuguCapability;
+
+/* audio drivers needed to start listening and speaking */
+#define LISTENING_DRIVERS (NUGU_PLUGIN_PROVIDES_RECORDER | NUGU_PLUGIN_PROVIDES_PCM)
+
+struct StartupPhase {
+    const char* name;
+    enum nugu_prof_type from; /* NUGU_PROF_TYPE_MAX is no profiling range */
+    enum nugu_prof_type to;
+    bool with_drivers; /* add the driver acquisition after the initialize() */
+    long threshold; /* usec, -1 is no threshold */
+    std::vector<long> samples; /* usec */
+};
+
+static std::vector<StartupPhase> phases = {
+    { "network", NUGU_PROF_TYPE_SDK_CREATED, NUGU_PROF_TYPE_SDK_NETWORK_INIT_DONE, false, -1, {} },
+    { "plugin", NUGU_PROF_TYPE_SDK_PLUGIN_INIT_START, NUGU_PROF_TYPE_SDK_PLUGIN_INIT_DONE, false, -1, {} },
+    { "capability", NUGU_PROF_TYPE_SDK_PLUGIN_INIT_DONE, NUGU_PROF_TYPE_SDK_CAPABILITY_INIT_DONE, false, -1, {} },
+    { "model", NUGU_PROF_TYPE_SDK_MODEL_LOAD_START, NUGU_PROF_TYPE_SDK_MODEL_LOAD_DONE, false, -1, {} },
+    { "driver", NUGU_PROF_TYPE_MAX, NUGU_PROF_TYPE_MAX, true, -1, {} },
+    { "total", NUGU_PROF_TYPE_SDK_CREATED, NUGU_PROF_TYPE_SDK_INIT_DONE, true, -1, {} },
+};
+
+static int test_iteration_max = 5;
+static FILE* fp_out;
+
+static void usage(const char* cmd)
+{
+    printf("Startup time benchmark from the NuguClient creation to ready to listen.\n\n");
+    printf("Usage: %s [OPTIONS]\n", cmd);
+    printf(" -n count\t\tNumber of test iterations. (default = %d)\n", test_iteration_max);
+    printf(" -p plugin_path\t\tLoad the plugins from the directory. (default = built-in plugins only)\n");
+    printf(" -w net,search\t\tSet the wakeup model files to measure the model loading by the kwd engine\n");
+    printf(" -l phase=msec\t\tFail if the median of the phase exceeds the threshold.\n");
+    printf(" -o <output-file>\tFile to save the duration of each iteration (CSV format)\n");
+    printf("\nPhases: network, plugin, capability, model, driver, total\n");
+    printf(" driver: initialization of the lazy recorder and pcm plugins\n");
+    printf(" total: NuguClient creation to the drivers ready to listen\n");
+}
+
+static StartupPhase* find_phase(const std::string& name)
+{
+    for (auto& phase : phases) {
+        if (name == phase.name)
+            return &phase;
+    }
+
+    return nullptr;
+}
+
+static bool set_threshold(const char* arg)
+{
+    const char* pos = strchr(arg, '=');
+    StartupPhase* phase;
+
+    if (!pos)
+        return false;
+
+    phase = find_phase(std::string(arg, pos - arg));
+    if (!phase)
+        return false;
+
+    phase->threshold = (long)(std::strtod(pos + 1, nullptr) * 1000);
+
+    return true;
+}
+
+static long get_duration(enum nugu_prof_type from, enum nugu_prof_type to)
+{
+    struct nugu_prof_data* data_from = nugu_prof_get_last_data(from);
+    struct nugu_prof_data* data_to = nugu_prof_get_last_data(to);
+    long duration = -1;
+
+    /* timestamp is cleared to 0 at the NuguClient creation */
+    if (data_from && data_to && data_from->timestamp && data_to->timestamp)
+        duration = (long)(data_to->timestamp - data_from->timestamp);
+
+    free(data_from);
+    free(data_to);
+
+    return duration;
+}
+
+static long get_phase_duration(const StartupPhase& phase, long drivers)
+{
+    long duration = 0;
+
+    if (phase.from != NUGU_PROF_TYPE_MAX) {
+        duration = get_duration(phase.from, phase.to);
+        if (duration < 0)
+            return -1;
+    }
+
+    if (phase.with_drivers)
+        duration += drivers;
+
+    return duration;
+}
+
+static bool run_startup(int num, const std::string& plugin_path, const WakeupModelFile& model_file)
+{
+    auto nugu_client = std::make_shared<NuguClient>();
+
+    auto system_handler = std::shared_ptr<ISystemHandler>(
+        CapabilityFactory::makeCapability<SystemAgent, ISystemHandler>());
+    auto audio_player_handler = std::shared_ptr<IAudioPlayerHandler>(
+        CapabilityFactory::makeCapability<AudioPlayerAgent, IAudioPlayerHandler>());
+    auto text_handler = std::shared_ptr<ITextHandler>(
+        CapabilityFactory::makeCapability<TextAgent, ITextHandler>());
+    auto tts_handler = std::shared_ptr<ITTSHandler>(
+        CapabilityFactory::makeCapability<TTSAgent, ITTSHandler>());
+    auto asr_handler = std::shared_ptr<IASRHandler>(
+        CapabilityFactory::makeCapability<ASRAgent, IASRHandler>());
+
+    auto builder = nugu_client->getCapabilityBuilder()
+                       ->add(system_handler.get())
+                       ->add(audio_player_handler.get())
+                       ->add(text_handler.get())
+                       ->add(tts_handler.get())
+                       ->add(asr_handler.get());
+
+    if (!model_file.net.empty())
+        builder->setWakeupModel(model_file);
+
+    builder->construct();
+
+    if (!nugu_client->loadPlugins(plugin_path) || !nugu_client->initialize()) {
+        printf("SDK Initialization failed.\n");
+        return false;
+    }
+
+    /* the lazy plugins are initialized by the first recorder and pcm */
+    gint64 begin = g_get_monotonic_time();
+    nugu_plugin_require(LISTENING_DRIVERS);
+    long drivers = (long)(g_get_monotonic_time() - begin);
+
+    if (fp_out) {
+        /* NOLINTNEXTLINE(cert-err33-c) */
+        fprintf(fp_out, "%d", num);
+    }
+
+    for (auto& phase : phases) {
+        long duration = get_phase_duration(phase, drivers);
+
+        if (duration >= 0)
+            phase.samples.push_back(duration);
+
+        if (fp_out) {
+            /* CSV data, NOLINTNEXTLINE(cert-err33-c) */
+            fprintf(fp_out, ",%.3f", duration / 1000.0);
+        }
+    }
+
+    if (fp_out) {
+        /* NOLINTNEXTLINE(cert-err33-c) */
+        fprintf(fp_out, "\n");
+    }
+
+    nugu_client->deInitialize();
+    nugu_client->unloadPlugins();
+
+    return true;
+}
+
+static long get_median(std::vector<long> samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2];
+}
+
+static int report(void)
+{
+    StartupPhase* total_phase = find_phase("total");
+    long total = total_phase->samples.empty() ? 0 : get_median(total_phase->samples);
+    int failed = 0;
+
+    printf("\n%-12s %10s %10s %10s %7s %10s\n", "Phase", "Min", "P50", "Max", "Share", "Threshold");
+
+    for (auto& phase : phases) {
+        long median;
+
+        if (phase.samples.empty()) {
+            printf("%-12s %10s %10s %10s %7s\n", phase.name, "-", "-", "-", "-");
+            continue;
+        }
+
+        median = get_median(phase.samples);
+
+        printf("%-12s %10.3f %10.3f %10.3f %6.1f%%", phase.name,
+            *std::min_element(phase.samples.begin(), phase.samples.end()) / 1000.0,
+            median / 1000.0,
+            *std::max_element(phase.samples.begin(), phase.samples.end()) / 1000.0,
+            total > 0 ? median * 100.0 / total : 0.0);
+
+        if (phase.threshold < 0) {
+            printf(" %10s\n", "-");
+            continue;
+        }
+
+        printf(" %10.3f %s\n", phase.threshold / 1000.0, median > phase.threshold ? "FAIL" : "OK");
+
+        if (median > phase.threshold)
+            failed++;
+    }
+
+    printf("\n(msec, %d iterations)\n", test_iteration_max);
+
+    if (failed) {
+        printf("%d phase(s) exceeded the threshold\n", failed);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int c;
+    int ret;
+    std::string plugin_path;
+    std::string output_file;
+    WakeupModelFile model_file;
+    gchar* empty_dir = NULL;
+    const char* pos;
+
+    while ((c = getopt(argc, argv, "n:p:w:l:o:")) != -1) {
+        switch (c) {
+        case 'n':
+            test_iteration_max = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'p':
+            plugin_path = optarg;
+            break;
+        case 'w':
+            pos = strchr(optarg, ',');
+            if (!pos) {
+                usage(argv[0]);
+                return -1;
+            }
+            model_file.net = std::string(optarg, pos - optarg);
+            model_file.search = pos + 1;
+            break;
+        case 'l':
+            if (!set_threshold(optarg)) {
+                printf("Invalid threshold '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'o':
+            output_file = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (test_iteration_max <= 0) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    /* Load only the built-in plugins(e.g. dummy, filedump) by default */
+    if (plugin_path.size() == 0) {
+        empty_dir = g_dir_make_tmp("nugu_startup_XXXXXX", NULL);
+        if (!empty_dir) {
+            printf("Fail to create the temporary directory\n");
+            return -1;
+        }
+
+        plugin_path = empty_dir;
+
+#ifdef _WIN32
+        if (!getenv("NUGU_DEFAULT_PCM_DRIVER"))
+            _putenv_s("NUGU_DEFAULT_PCM_DRIVER", "filedump");
+#else
+        setenv("NUGU_DEFAULT_PCM_DRIVER", "filedump", 0);
+#endif
+    }
+
+    if (output_file.size() > 0) {
+        fp_out = fopen(output_file.c_str(), "w");
+        if (!fp_out) {
+            printf("Fail to open output file '%s'\n", output_file.c_str());
+            return -1;
+        }
+
+        /* CSV header, NOLINTNEXTLINE(cert-err33-c) */
+        fprintf(fp_out, "Num");
+        for (auto& phase : phases) {
+            /* NOLINTNEXTLINE(cert-err33-c) */
+            fprintf(fp_out, ",%s", phase.name);
+        }
+        /* NOLINTNEXTLINE(cert-err33-c) */
+        fprintf(fp_out, "\n");
+    }
+
+    nugu_log_set_prefix_fields(NUGU_LOG_PREFIX_TIMESTAMP);
+    nugu_log_set_modules(NUGU_LOG_MODULE_APPLICATION);
+
+    ret = 0;
+    for (int i = 1; i <= test_iteration_max; i++) {
+        nugu_info("Start %d/%d", i, test_iteration_max);
+
+        if (!run_startup(i, plugin_path, model_file)) {
+            ret = -1;
+            break;
+        }
+    }
+
+    if (ret == 0)
+        ret = report();
+
+    if (fp_out) {
+        if (fclose(fp_out))
+            printf("fclose() failed\n");
+    }
+
+    if (empty_dir) {
+        g_rmdir(empty_dir);
+        g_free(empty_dir);
+    }
+
+    return ret;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_PROFILING_WIN32_GETOPT_H__
+#define __NUGU_PROFILING_WIN32_GETOPT_H__
+
+/* minimal getopt() for the platform without unistd.h */
+#ifdef _WIN32
+#include <cstdio>
+#include <cstring>
+
+static char *optarg;
+static int optind = 1, opterr = 1, optopt;
+
+static char *next = NULL;
+
+static int getopt(int argc, char * const argv[], const char *optstring) {
+    if (optind == 0) {
+        optind = 1;
+        next = NULL;
+    }
+    if (next == NULL || *next == '\0') {
+        if (optind == argc || argv[optind][0] != '-' || argv[optind][1] == '\0') {
+            return -1;
+        }
+        if (strcmp(argv[optind], "--") == 0) {
+            optind++;
+            return -1;
+        }
+        next = argv[optind] + 1;
+        optind++;
+    }
+
+    optopt = *next++;
+    const char *opt = strchr(optstring, optopt);
+    if (opt == NULL || optopt == ':') {
+        if (opterr) {
+            fprintf(stderr, "Unknown option -%c\n", optopt);
+        }
+        return '?';
+    }
+    if (opt[1] == ':') {
+        if (*next != '\0') {
+            optarg = next;
+            next = NULL;
+        } else if (optind < argc) {
+            optarg = argv[optind];
+            optind++;
+        } else {
+            if (opterr) {
+                fprintf(stderr, "Option -%c requires an argument\n", optopt);
+            }
+            return '?';
+        }
+    }
+    return optopt;
+}
+#endif
+
+#endif /* __NUGU_PROFILING_WIN32_GETOPT_H__ */
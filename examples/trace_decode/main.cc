@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <iostream>
+
+#include <base/nugu_log.h>
+#include <base/nugu_trace.h>
+
+static void usage(const char* name)
+{
+    std::cout << "Usage: " << name << " <trace-file> [output-file]" << std::endl
+              << std::endl
+              << "Decode the binary trace file (NUGU_TRACE_PATH) into the readable log." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    FILE* out = stdout;
+    int count;
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    nugu_log_set_system(NUGU_LOG_SYSTEM_STDERR);
+
+    if (argc > 2) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            std::cout << "can't open the output file: " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+
+    count = nugu_trace_decode(argv[1], out);
+
+    if (out != stdout)
+        fclose(out);
+
+    if (count < 0)
+        return 1;
+
+    std::cerr << count << " messages decoded" << std::endl;
+
+    return 0;
+}
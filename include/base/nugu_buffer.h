@@ -19,6 +19,7 @@
 
 #include <stddef.h>
 #include <nugu.h>
+#include <base/nugu_memory.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -71,6 +72,17 @@ NUGU_API NuguBuffer *nugu_buffer_new(size_t default_size);
  */
 NUGU_API void *nugu_buffer_free(NuguBuffer *buf, int is_data_free);
 
+/**
+ * @brief Set the memory accounting tag of the buffer
+ *
+ * The buffer is accounted to the NUGU_MEMORY_TAG_BUFFER by default.
+ * @param[in] buf buffer object
+ * @param[in] tag accounting tag
+ * @see nugu_memory_get_stat()
+ */
+NUGU_API void nugu_buffer_set_memory_tag(NuguBuffer *buf,
+					 enum nugu_memory_tag tag);
+
 /**
  * @brief Append the data to buffer object
  * @param[in] buf buffer object
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_CACHE_H__
+#define __NUGU_CACHE_H__
+
+#include <stddef.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_cache.h
+ * @defgroup NuguCache File cache
+ * @ingroup SDKBase
+ * @brief LRU file cache with memory-mapped entries
+ *
+ * Each entry is stored as a file in the cache directory. The file name is
+ * the hash of the key, so any string (e.g. the text of the TTS) can be
+ * used as the key.
+ *
+ * The total size of the entries is bounded. When a new entry exceeds the
+ * bound, the least recently used entries are removed. The access time is
+ * kept as the modification time of the file, so the order is preserved
+ * after restarting.
+ *
+ * The entry data is memory-mapped when looking up.
+ *
+ * The functions are not thread safe.
+ *
+ * @{
+ */
+
+/**
+ * @brief Cache object
+ */
+typedef struct _nugu_cache NuguCache;
+
+/**
+ * @brief Cache entry object
+ */
+typedef struct _nugu_cache_entry NuguCacheEntry;
+
+/**
+ * @brief Cache writer object
+ */
+typedef struct _nugu_cache_writer NuguCacheWriter;
+
+/**
+ * @brief Statistics of the cache
+ * @see nugu_cache_get_stats()
+ */
+struct nugu_cache_stats {
+	unsigned int hits; /**< number of lookup hits */
+	unsigned int misses; /**< number of lookup misses */
+	size_t hit_bytes; /**< total size of the hit entries */
+	size_t size; /**< total size of the entries */
+	unsigned int entries; /**< number of entries */
+};
+
+/**
+ * @brief Create new cache object
+ *
+ * The directory is created if it does not exist, and the existing entries
+ * are loaded.
+ * @param[in] path cache directory
+ * @param[in] max_size maximum total size of the entries
+ * @return cache object
+ */
+NUGU_API NuguCache *nugu_cache_new(const char *path, size_t max_size);
+
+/**
+ * @brief Destroy the cache object. The entry files are kept.
+ * @param[in] cache cache object
+ */
+NUGU_API void nugu_cache_free(NuguCache *cache);
+
+/**
+ * @brief Find the entry and map the data
+ * @param[in] cache cache object
+ * @param[in] key key of the entry
+ * @return cache entry object. NULL if not found.
+ * @see nugu_cache_entry_free()
+ */
+NUGU_API NuguCacheEntry *nugu_cache_lookup(NuguCache *cache, const char *key);
+
+/**
+ * @brief Get the data of the entry
+ * @param[in] entry cache entry object
+ * @param[out] size size of the data
+ * @return data which is valid until the entry is freed
+ */
+NUGU_API const void *nugu_cache_entry_peek_data(NuguCacheEntry *entry,
+						size_t *size);
+
+/**
+ * @brief Unmap the data and destroy the entry object
+ * @param[in] entry cache entry object
+ */
+NUGU_API void nugu_cache_entry_free(NuguCacheEntry *entry);
+
+/**
+ * @brief Create new writer to add an entry
+ *
+ * The data is written to a temporary file and added to the cache by
+ * nugu_cache_writer_commit().
+ * @param[in] cache cache object
+ * @param[in] key key of the entry
+ * @return cache writer object
+ */
+NUGU_API NuguCacheWriter *nugu_cache_writer_new(NuguCache *cache,
+						const char *key);
+
+/**
+ * @brief Append the data to the entry
+ * @param[in] writer cache writer object
+ * @param[in] data data
+ * @param[in] size size of data
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure (e.g. the entry exceeds the maximum size)
+ */
+NUGU_API int nugu_cache_writer_append(NuguCacheWriter *writer,
+				      const void *data, size_t size);
+
+/**
+ * @brief Add the entry to the cache and destroy the writer object
+ *
+ * The existing entry with the same key is replaced, and the least recently
+ * used entries are removed to keep the maximum size.
+ * @param[in] writer cache writer object
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ */
+NUGU_API int nugu_cache_writer_commit(NuguCacheWriter *writer);
+
+/**
+ * @brief Discard the written data and destroy the writer object
+ * @param[in] writer cache writer object
+ */
+NUGU_API void nugu_cache_writer_abort(NuguCacheWriter *writer);
+
+/**
+ * @brief Get the statistics of the cache
+ * @param[in] cache cache object
+ * @param[out] stats statistics
+ */
+NUGU_API void nugu_cache_get_stats(NuguCache *cache,
+				   struct nugu_cache_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
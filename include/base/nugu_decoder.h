@@ -17,6 +17,8 @@
 #ifndef __NUGU_DECODER_H__
 #define __NUGU_DECODER_H__
 
+#include <stddef.h>
+
 #include <nugu.h>
 #include <base/nugu_pcm.h>
 #include <base/nugu_buffer.h>
@@ -54,6 +56,8 @@ typedef struct _nugu_decoder_driver NuguDecoderDriver;
 
 /**
  * @brief Create new decoder object
+ *
+ * An idle decoder in the pool of the driver is reused if available.
  * @param[in] driver decoder driver
  * @param[in] sink pcm object
  * @return decoder object
@@ -66,6 +70,9 @@ NUGU_API NuguDecoder *nugu_decoder_new(NuguDecoderDriver *driver,
 
 /**
  * @brief Destroy the decoder object
+ *
+ * If the driver supports the reset operation and the pool is not full,
+ * the decoder is reset and kept in the pool instead of being destroyed.
  * @param[in] dec decoder object
  * @return result
  * @retval 0 success
@@ -76,6 +83,9 @@ NUGU_API int nugu_decoder_free(NuguDecoder *dec);
 
 /**
  * @brief Decode the encoded data and pass the result to sink
+ *
+ * If the driver supports decode_to_sink, the data is decoded directly into
+ * the buffer of the sink pcm without intermediate copies.
  * @param[in] dec decoder object
  * @param[in] data encoded data
  * @param[in] data_len encoded data length
@@ -83,6 +93,7 @@ NUGU_API int nugu_decoder_free(NuguDecoder *dec);
  * @retval 0 success
  * @retval -1 failure
  * @see nugu_decoder_decode()
+ * @see nugu_decoder_set_skip_size()
  */
 NUGU_API int nugu_decoder_play(NuguDecoder *dec, const void *data,
 			       size_t data_len);
@@ -125,6 +136,21 @@ NUGU_API void *nugu_decoder_decode(NuguDecoder *dec, const void *data,
  */
 NUGU_API NuguPcm *nugu_decoder_get_pcm(NuguDecoder *dec);
 
+/**
+ * @brief Set the size of decoded data to drop before passing to sink
+ *
+ * The decoded data is dropped by nugu_decoder_play() and
+ * nugu_decoder_decode() until the given size is reached. It is used to
+ * start the playback from the seek position.
+ * @param[in] dec decoder object
+ * @param[in] size size of decoded data to drop (0 to cancel)
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_decoder_play()
+ */
+NUGU_API int nugu_decoder_set_skip_size(NuguDecoder *dec, size_t size);
+
 /**
  * @}
  */
@@ -170,10 +196,75 @@ struct nugu_decoder_driver_ops {
 	 * @see nugu_decoder_free()
 	 */
 	int (*destroy)(NuguDecoderDriver *driver, NuguDecoder *dec);
+
+	/**
+	 * @brief Called when a playback request is received from the decoder.
+	 *
+	 * Optional. The driver decodes the data into the space reserved by
+	 * nugu_decoder_reserve_output() and passes it to the sink with
+	 * nugu_decoder_commit_output().
+	 * @see nugu_decoder_play()
+	 */
+	int (*decode_to_sink)(NuguDecoderDriver *driver, NuguDecoder *dec,
+			      const void *data, size_t data_len);
+
+	/**
+	 * @brief Called when the decoder is returned to the pool.
+	 *
+	 * Optional. The driver clears the decoding state of the instance
+	 * so that it can be reused by nugu_decoder_new(). If it is not
+	 * supported, the decoder is always destroyed.
+	 * @see nugu_decoder_free()
+	 * @see nugu_decoder_driver_set_pool_size()
+	 */
+	int (*reset)(NuguDecoderDriver *driver, NuguDecoder *dec);
+};
+
+/**
+ * @brief Statistics of the decoder pool
+ * @see nugu_decoder_driver_get_pool_stats()
+ */
+struct nugu_decoder_pool_stats {
+	unsigned int created; /**< number of created instances */
+	unsigned int reused; /**< number of instances reused from the pool */
+	unsigned int destroyed; /**< number of destroyed instances */
+	unsigned int pooled; /**< number of idle instances in the pool */
 };
 
+/**
+ * @brief Size of the decoder driver operations without the optional ones
+ *
+ * The optional operations (decode_to_sink and reset) are appended to the
+ * struct nugu_decoder_driver_ops, so the size of the operation table is
+ * the version of the driver ABI.
+ * @see nugu_decoder_driver_new_with_size()
+ */
+#define NUGU_DECODER_DRIVER_OPS_BASE_SIZE \
+	(offsetof(struct nugu_decoder_driver_ops, decode_to_sink))
+
+/**
+ * @brief Create new decoder driver with the size of the operation table
+ *
+ * The operations beyond the ops_size are regarded as not supported, so
+ * the drivers built against the older header keep working.
+ * @param[in] name driver name
+ * @param[in] type decoder type
+ * @param[in] ops operation table
+ * @param[in] ops_size size of the operation table of the driver
+ * @return decoder driver object
+ * @see nugu_decoder_driver_free()
+ */
+NUGU_API NuguDecoderDriver *nugu_decoder_driver_new_with_size(
+	const char *name, enum nugu_decoder_type type,
+	struct nugu_decoder_driver_ops *ops, size_t ops_size);
+
 /**
  * @brief Create new decoder driver
+ *
+ * The binaries built against the older header call this function, so
+ * only the base operations (NUGU_DECODER_DRIVER_OPS_BASE_SIZE) are used. The
+ * source code calls nugu_decoder_driver_new_with_size() with the size of
+ * the current operation table through the macro of the same name.
  * @param[in] name driver name
  * @param[in] type decoder type
  * @param[in] ops operation table
@@ -184,6 +275,10 @@ NUGU_API NuguDecoderDriver *
 nugu_decoder_driver_new(const char *name, enum nugu_decoder_type type,
 			struct nugu_decoder_driver_ops *ops);
 
+#define nugu_decoder_driver_new(name, type, ops)                            \
+	nugu_decoder_driver_new_with_size(name, type, ops,                   \
+					   sizeof(struct nugu_decoder_driver_ops))
+
 /**
  * @brief Destroy the decoder driver
  * @param[in] driver decoder driver object
@@ -228,6 +323,50 @@ NUGU_API NuguDecoderDriver *nugu_decoder_driver_find(const char *name);
 NUGU_API NuguDecoderDriver *
 nugu_decoder_driver_find_bytype(enum nugu_decoder_type type);
 
+/**
+ * @brief Set the maximum number of idle decoders kept in the pool
+ *
+ * The pool is used only if the driver supports the reset operation.
+ * The exceeding idle decoders are destroyed. Set 0 to disable the pool.
+ * @param[in] driver decoder driver object
+ * @param[in] size maximum number of idle decoders
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ */
+NUGU_API int nugu_decoder_driver_set_pool_size(NuguDecoderDriver *driver,
+					       int size);
+
+/**
+ * @brief Get the statistics of the decoder pool
+ * @param[in] driver decoder driver object
+ * @param[out] stats statistics
+ */
+NUGU_API void
+nugu_decoder_driver_get_pool_stats(NuguDecoderDriver *driver,
+				   struct nugu_decoder_pool_stats *stats);
+
+/**
+ * @brief Reserve space for decoded data in the sink pcm buffer
+ * @param[in] dec decoder object
+ * @param[in] size maximum size of decoded data
+ * @return reserved space. NULL on failure.
+ * @see nugu_decoder_commit_output()
+ * @see nugu_pcm_reserve_data()
+ */
+NUGU_API void *nugu_decoder_reserve_output(NuguDecoder *dec, size_t size);
+
+/**
+ * @brief Pass the decoded data in the reserved space to the sink pcm
+ * @param[in] dec decoder object
+ * @param[in] size size of decoded data
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_decoder_reserve_output()
+ */
+NUGU_API int nugu_decoder_commit_output(NuguDecoder *dec, size_t size);
+
 /**
  * @}
  */
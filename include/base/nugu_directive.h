@@ -18,6 +18,7 @@
 #define __NUGU_DIRECTIVE_H__
 
 #include <stddef.h>
+#include <stdint.h>
 #include <nugu.h>
 
 #ifdef __cplusplus
@@ -252,6 +253,14 @@ NUGU_API unsigned char *nugu_directive_get_data(NuguDirective *ndir,
  */
 NUGU_API size_t nugu_directive_get_data_size(const NuguDirective *ndir);
 
+/**
+ * @brief Get the time when the latest attachment data is received.
+ * @param[in] ndir directive object
+ * @return receive time from the monotonic clock (msec), 0 if no data
+ * @see nugu_directive_add_data()
+ */
+NUGU_API int64_t nugu_directive_get_data_time(const NuguDirective *ndir);
+
 /**
  * @brief Set the medium of BlockingPolicy for the directive
  * @param[in] ndir directive object
@@ -17,6 +17,8 @@
 #ifndef __NUGU_ENCODER_H__
 #define __NUGU_ENCODER_H__
 
+#include <stddef.h>
+
 #include <nugu.h>
 #include <base/nugu_pcm.h>
 #include <base/nugu_buffer.h>
@@ -53,6 +55,8 @@ typedef struct _nugu_encoder_driver NuguEncoderDriver;
 
 /**
  * @brief Create new encoder object
+ *
+ * An idle encoder in the pool of the driver is reused if available.
  * @param[in] driver encoder driver
  * @param[in] property audio property(channel,type,sample-rate)
  * @return encoder object
@@ -63,6 +67,9 @@ NUGU_API NuguEncoder *nugu_encoder_new(NuguEncoderDriver *driver,
 
 /**
  * @brief Destroy the encoder object
+ *
+ * If the driver supports the reset operation and the pool is not full,
+ * the encoder is reset and kept in the pool instead of being destroyed.
  * @param[in] enc encoder object
  * @return result
  * @retval 0 success
@@ -164,10 +171,64 @@ struct nugu_encoder_driver_ops {
 	 * @see nugu_encoder_free()
 	 */
 	int (*destroy)(NuguEncoderDriver *driver, NuguEncoder *enc);
+
+	/**
+	 * @brief Called when the encoder is returned to the pool.
+	 *
+	 * Optional. The driver clears the encoding state of the instance
+	 * so that it can be reused by nugu_encoder_new() with the same
+	 * property. If it is not supported, the encoder is always destroyed.
+	 * @see nugu_encoder_free()
+	 * @see nugu_encoder_driver_set_pool_size()
+	 */
+	int (*reset)(NuguEncoderDriver *driver, NuguEncoder *enc);
 };
 
+/**
+ * @brief Statistics of the encoder pool
+ * @see nugu_encoder_driver_get_pool_stats()
+ */
+struct nugu_encoder_pool_stats {
+	unsigned int created; /**< number of created instances */
+	unsigned int reused; /**< number of instances reused from the pool */
+	unsigned int destroyed; /**< number of destroyed instances */
+	unsigned int pooled; /**< number of idle instances in the pool */
+};
+
+/**
+ * @brief Size of the encoder driver operations without the optional ones
+ *
+ * The optional operations (reset) are appended to the
+ * struct nugu_encoder_driver_ops, so the size of the operation table is
+ * the version of the driver ABI.
+ * @see nugu_encoder_driver_new_with_size()
+ */
+#define NUGU_ENCODER_DRIVER_OPS_BASE_SIZE \
+	(offsetof(struct nugu_encoder_driver_ops, reset))
+
+/**
+ * @brief Create new encoder driver with the size of the operation table
+ *
+ * The operations beyond the ops_size are regarded as not supported, so
+ * the drivers built against the older header keep working.
+ * @param[in] name driver name
+ * @param[in] type encoder type
+ * @param[in] ops operation table
+ * @param[in] ops_size size of the operation table of the driver
+ * @return encoder driver object
+ * @see nugu_encoder_driver_free()
+ */
+NUGU_API NuguEncoderDriver *nugu_encoder_driver_new_with_size(
+	const char *name, enum nugu_encoder_type type,
+	struct nugu_encoder_driver_ops *ops, size_t ops_size);
+
 /**
  * @brief Create new encoder driver
+ *
+ * The binaries built against the older header call this function, so
+ * only the base operations (NUGU_ENCODER_DRIVER_OPS_BASE_SIZE) are used. The
+ * source code calls nugu_encoder_driver_new_with_size() with the size of
+ * the current operation table through the macro of the same name.
  * @param[in] name driver name
  * @param[in] type encoder type
  * @param[in] ops operation table
@@ -178,6 +239,10 @@ NUGU_API NuguEncoderDriver *
 nugu_encoder_driver_new(const char *name, enum nugu_encoder_type type,
 			struct nugu_encoder_driver_ops *ops);
 
+#define nugu_encoder_driver_new(name, type, ops)                            \
+	nugu_encoder_driver_new_with_size(name, type, ops,                   \
+					   sizeof(struct nugu_encoder_driver_ops))
+
 /**
  * @brief Destroy the encoder driver
  * @param[in] driver encoder driver object
@@ -222,6 +287,29 @@ NUGU_API NuguEncoderDriver *nugu_encoder_driver_find(const char *name);
 NUGU_API NuguEncoderDriver *
 nugu_encoder_driver_find_bytype(enum nugu_encoder_type type);
 
+/**
+ * @brief Set the maximum number of idle encoders kept in the pool
+ *
+ * The pool is used only if the driver supports the reset operation.
+ * The exceeding idle encoders are destroyed. Set 0 to disable the pool.
+ * @param[in] driver encoder driver object
+ * @param[in] size maximum number of idle encoders
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ */
+NUGU_API int nugu_encoder_driver_set_pool_size(NuguEncoderDriver *driver,
+					       int size);
+
+/**
+ * @brief Get the statistics of the encoder pool
+ * @param[in] driver encoder driver object
+ * @param[out] stats statistics
+ */
+NUGU_API void
+nugu_encoder_driver_get_pool_stats(NuguEncoderDriver *driver,
+				   struct nugu_encoder_pool_stats *stats);
+
 /**
  * @}
  */
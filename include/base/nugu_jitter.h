@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_JITTER_H__
+#define __NUGU_JITTER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_jitter.h
+ * @defgroup NuguJitter Jitter estimator
+ * @ingroup SDKBase
+ * @brief Start threshold estimator for the streamed audio
+ *
+ * The estimator records the arrival time and size of each attachment of a
+ * stream. When the stream is finished, it calculates the minimum amount of
+ * buffered audio that the playback should wait for to play the stream
+ * without underrun.
+ *
+ * The start threshold for the next stream is selected from the recent
+ * streams so that the ratio of the streams with underrun does not exceed
+ * the target rate. It is used with nugu_pcm_set_start_threshold().
+ *
+ * The functions are not thread safe.
+ *
+ * @{
+ */
+
+/**
+ * @brief Jitter estimator object
+ */
+typedef struct _nugu_jitter NuguJitter;
+
+/**
+ * @brief Statistics of the jitter estimator
+ * @see nugu_jitter_get_stats()
+ */
+struct nugu_jitter_stats {
+	unsigned int streams; /**< number of finished streams */
+	unsigned int underrun_streams; /**< number of streams with underrun */
+	unsigned int underruns; /**< total number of underruns */
+	unsigned long added_latency; /**< total added latency (msec) */
+	int threshold; /**< current start threshold (msec) */
+};
+
+/**
+ * @brief Create new jitter estimator object
+ * @param[in] target_underrun_rate target ratio of the streams with underrun
+ * (0.0 ~ 1.0)
+ * @param[in] max_threshold maximum start threshold (msec)
+ * @return jitter estimator object
+ */
+NUGU_API NuguJitter *nugu_jitter_new(double target_underrun_rate,
+				     int max_threshold);
+
+/**
+ * @brief Destroy the jitter estimator object
+ * @param[in] jitter jitter estimator object
+ */
+NUGU_API void nugu_jitter_free(NuguJitter *jitter);
+
+/**
+ * @brief Start a new stream
+ *
+ * The arrivals of the previous unfinished stream are discarded.
+ * @param[in] jitter jitter estimator object
+ */
+NUGU_API void nugu_jitter_begin(NuguJitter *jitter);
+
+/**
+ * @brief Add an arrival of the stream data
+ * @param[in] jitter jitter estimator object
+ * @param[in] msec arrival time from any monotonic clock (msec)
+ * @param[in] size size of the arrived data (e.g. encoded size)
+ */
+NUGU_API void nugu_jitter_add_arrival(NuguJitter *jitter, int64_t msec,
+				      size_t size);
+
+/**
+ * @brief Finish the stream and update the start threshold
+ *
+ * The arrived sizes are converted to the audio duration in proportion to
+ * the duration of the whole stream.
+ * @param[in] jitter jitter estimator object
+ * @param[in] duration audio duration of the stream (msec)
+ * @param[in] underruns number of underruns of the stream
+ * @param[in] added_latency latency added by the start threshold (msec)
+ * @return required start threshold of the stream (msec), -1 on failure
+ */
+NUGU_API int nugu_jitter_end(NuguJitter *jitter, int duration,
+			     unsigned int underruns, int added_latency);
+
+/**
+ * @brief Get the start threshold for the next stream
+ * @param[in] jitter jitter estimator object
+ * @return start threshold (msec)
+ */
+NUGU_API int nugu_jitter_get_threshold(NuguJitter *jitter);
+
+/**
+ * @brief Get the statistics of the jitter estimator
+ * @param[in] jitter jitter estimator object
+ * @param[out] stats statistics
+ */
+NUGU_API void nugu_jitter_get_stats(NuguJitter *jitter,
+				    struct nugu_jitter_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
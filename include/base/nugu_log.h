@@ -41,6 +41,14 @@ extern "C" {
  * The log function also supports setting logs at runtime using the
  * environment variables below.
  *  - NUGU_LOG: "stderr", "syslog" or "none"
+ *  - NUGU_LOG_ASYNC: "1" to use the asynchronous logging
+ *
+ * In the asynchronous logging, each thread only formats the message into
+ * its own lock-free ring buffer, and a background writer thread makes the
+ * prefix and writes the messages of all threads in a batch. The messages
+ * are dropped when the ring buffer of the thread is full. Only the stderr
+ * and stdout systems are supported, and the other systems are processed
+ * synchronously.
  *
  * @{
  */
@@ -313,6 +321,35 @@ NUGU_API void nugu_log_set_protocol_line_limit(int length);
  */
 NUGU_API int nugu_log_get_protocol_line_limit(void);
 
+/**
+ * @brief Enable or disable the asynchronous logging
+ *
+ * When disabled, the queued messages are written before the return.
+ * @param[in] enable 1 to enable, 0 to disable
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_log_flush()
+ */
+NUGU_API int nugu_log_set_async(int enable);
+
+/**
+ * @brief Get the asynchronous logging status
+ * @return 1 if the asynchronous logging is enabled, otherwise 0
+ */
+NUGU_API int nugu_log_is_async(void);
+
+/**
+ * @brief Wait until the queued messages are written by the writer thread
+ */
+NUGU_API void nugu_log_flush(void);
+
+/**
+ * @brief Get the number of messages dropped by the full ring buffer
+ * @return number of dropped messages
+ */
+NUGU_API unsigned int nugu_log_get_dropped_count(void);
+
 /**
  * @brief Hexdump the specific data to stderr
  * @param[in] module log module
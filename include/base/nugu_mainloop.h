@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_MAINLOOP_H__
+#define __NUGU_MAINLOOP_H__
+
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_mainloop.h
+ * @defgroup NuguMainloop Mainloop
+ * @ingroup SDKBase
+ * @brief SDK main context management
+ *
+ * All SDK sources (event queue, idle handlers, timers and NuguRunner) are
+ * attached to the SDK main context. By default, the SDK main context is the
+ * default GMainContext, so the SDK is dispatched by the application's main
+ * loop.
+ *
+ * nugu_mainloop_start() creates a dedicated GMainContext and runs it on
+ * the SDK thread, so the voice pipeline is not delayed by the application
+ * load. In this case, the listeners of the SDK are invoked on the SDK
+ * thread and the application should call the SDK functions on the SDK
+ * thread using nugu_mainloop_invoke() or NuguRunner.
+ *
+ * @{
+ */
+
+/**
+ * @brief Callback prototype for the source
+ * @param[in] userdata data passed to the source
+ * @return result
+ * @retval 1 keep the source
+ * @retval 0 remove the source
+ */
+typedef int (*NuguMainloopSourceFunc)(void *userdata);
+
+/**
+ * @brief Callback prototype for the nugu_mainloop_invoke()
+ * @param[in] userdata data passed to the nugu_mainloop_invoke()
+ */
+typedef void (*NuguMainloopInvokeFunc)(void *userdata);
+
+/**
+ * @brief Create the dedicated main context and start the SDK thread
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_mainloop_stop()
+ */
+NUGU_API int nugu_mainloop_start(void);
+
+/**
+ * @brief Stop the SDK thread and destroy the dedicated main context
+ *
+ * After stop, the default GMainContext is used again.
+ * @see nugu_mainloop_start()
+ */
+NUGU_API void nugu_mainloop_stop(void);
+
+/**
+ * @brief Check whether the dedicated main context is running
+ * @return result
+ * @retval 1 dedicated main context
+ * @retval 0 default main context
+ */
+NUGU_API int nugu_mainloop_is_dedicated(void);
+
+/**
+ * @brief Check whether the current thread owns the SDK main context
+ * @return result
+ * @retval 1 current thread is the SDK thread
+ * @retval 0 other thread
+ */
+NUGU_API int nugu_mainloop_is_owner(void);
+
+/**
+ * @brief Get the SDK main context
+ * @return GMainContext of the SDK
+ */
+NUGU_API void *nugu_mainloop_get_context(void);
+
+/**
+ * @brief Add an idle source to the SDK main context
+ * @param[in] func callback function
+ * @param[in] userdata data to pass to the callback
+ * @return source id (greater than 0)
+ * @see nugu_mainloop_source_remove()
+ */
+NUGU_API unsigned int nugu_mainloop_idle_add(NuguMainloopSourceFunc func,
+					     void *userdata);
+
+/**
+ * @brief Add a timeout source to the SDK main context
+ * @param[in] interval_msec interval in milliseconds
+ * @param[in] func callback function
+ * @param[in] userdata data to pass to the callback
+ * @return source id (greater than 0)
+ * @see nugu_mainloop_source_remove()
+ */
+NUGU_API unsigned int nugu_mainloop_timeout_add(unsigned int interval_msec,
+						NuguMainloopSourceFunc func,
+						void *userdata);
+
+/**
+ * @brief Add a timeout source(seconds granularity) to the SDK main context
+ * @param[in] interval_sec interval in seconds
+ * @param[in] func callback function
+ * @param[in] userdata data to pass to the callback
+ * @return source id (greater than 0)
+ * @see nugu_mainloop_source_remove()
+ */
+NUGU_API unsigned int
+nugu_mainloop_timeout_add_seconds(unsigned int interval_sec,
+				  NuguMainloopSourceFunc func, void *userdata);
+
+/**
+ * @brief Remove the source
+ *
+ * The source is removed from the main context which it was attached to,
+ * even if the SDK main context is changed after that.
+ * @param[in] id source id
+ */
+NUGU_API void nugu_mainloop_source_remove(unsigned int id);
+
+/**
+ * @brief Invoke the function on the SDK thread and wait for the completion
+ *
+ * If the current thread owns the SDK main context, the function is called
+ * immediately.
+ * @param[in] func callback function
+ * @param[in] userdata data to pass to the callback
+ */
+NUGU_API void nugu_mainloop_invoke(NuguMainloopInvokeFunc func,
+				   void *userdata);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_MEMORY_H__
+#define __NUGU_MEMORY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_memory.h
+ * @defgroup NuguMemory Memory accounting
+ * @ingroup SDKBase
+ * @brief Heap usage of the SDK per subsystem
+ *
+ * The allocations of the SDK are accounted by the tag of the subsystem
+ * (e.g. network buffers, directive payloads) to find out which subsystem
+ * uses the heap on the device which has small memory.
+ *
+ * The allocation functions are thin wrappers of the calloc/realloc/free,
+ * so the memory can be freed by free() after the ownership is moved out
+ * with nugu_memory_sub(). The accounting is enabled by the
+ * ENABLE_MEMORY_ACCOUNTING build option, otherwise only the allocation is
+ * done.
+ *
+ * The functions are thread safe.
+ *
+ * @{
+ */
+
+/**
+ * @brief Accounting tags
+ */
+enum nugu_memory_tag {
+	NUGU_MEMORY_TAG_BUFFER, /**< Buffers which are not tagged */
+	NUGU_MEMORY_TAG_NETWORK, /**< Network request/response buffers */
+	NUGU_MEMORY_TAG_DIRECTIVE, /**< Directive headers and payloads */
+	NUGU_MEMORY_TAG_ATTACHMENT, /**< Directive attachment buffers */
+	NUGU_MEMORY_TAG_PCM, /**< PCM playback buffers */
+	NUGU_MEMORY_TAG_RECORDER, /**< Recorder ring buffers */
+	NUGU_MEMORY_TAG_JSON, /**< JSON text collected by the parsers */
+	NUGU_MEMORY_TAG_MAX
+};
+
+/**
+ * @brief Memory usage of the tag
+ * @see nugu_memory_get_stat()
+ */
+struct nugu_memory_stat {
+	uint64_t current; /**< bytes in use */
+	uint64_t peak; /**< maximum bytes in use */
+};
+
+/**
+ * @brief Allocate the zero-filled memory and account it
+ * @param[in] tag accounting tag
+ * @param[in] size size of the memory
+ * @return allocated memory. NULL on failure.
+ * @see nugu_memory_free()
+ */
+NUGU_API void *nugu_memory_alloc(enum nugu_memory_tag tag, size_t size);
+
+/**
+ * @brief Resize the memory and account the difference
+ * @param[in] tag accounting tag
+ * @param[in] ptr memory allocated by nugu_memory_alloc()
+ * @param[in] old_size current size of the memory
+ * @param[in] new_size new size of the memory
+ * @return resized memory. NULL on failure and the ptr is not changed.
+ */
+NUGU_API void *nugu_memory_realloc(enum nugu_memory_tag tag, void *ptr,
+				   size_t old_size, size_t new_size);
+
+/**
+ * @brief Free the memory and account it
+ * @param[in] tag accounting tag
+ * @param[in] ptr memory allocated by nugu_memory_alloc()
+ * @param[in] size size of the memory
+ */
+NUGU_API void nugu_memory_free(enum nugu_memory_tag tag, void *ptr,
+			       size_t size);
+
+/**
+ * @brief Account the memory which is allocated by the other allocator
+ * @param[in] tag accounting tag
+ * @param[in] size size of the memory
+ */
+NUGU_API void nugu_memory_add(enum nugu_memory_tag tag, size_t size);
+
+/**
+ * @brief Stop accounting the memory (e.g. freed, ownership moved out)
+ * @param[in] tag accounting tag
+ * @param[in] size size of the memory
+ */
+NUGU_API void nugu_memory_sub(enum nugu_memory_tag tag, size_t size);
+
+/**
+ * @brief Get the memory usage of the tag
+ * @param[in] tag accounting tag
+ * @param[out] stat memory usage
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure (e.g. accounting is disabled)
+ */
+NUGU_API int nugu_memory_get_stat(enum nugu_memory_tag tag,
+				  struct nugu_memory_stat *stat);
+
+/**
+ * @brief Get the name of the tag
+ * @param[in] tag accounting tag
+ * @return name of the tag (e.g. "network")
+ */
+NUGU_API const char *nugu_memory_get_tag_name(enum nugu_memory_tag tag);
+
+/**
+ * @brief Reset the peak of all tags to the current usage
+ */
+NUGU_API void nugu_memory_reset_peak(void);
+
+/**
+ * @brief Print the memory usage of all tags to the log
+ */
+NUGU_API void nugu_memory_dump(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
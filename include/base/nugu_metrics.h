@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_METRICS_H__
+#define __NUGU_METRICS_H__
+
+#include <stdint.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_metrics.h
+ * @defgroup NuguMetrics Metrics
+ * @ingroup SDKBase
+ * @brief Registry of the counters, gauges and histograms of the SDK
+ *
+ * The metric is registered once by the name and never freed, so the
+ * module keeps the returned object and updates it with the atomic
+ * operations without any lock. The registry can be read by the snapshot
+ * or the text exposition format (e.g. Prometheus).
+ *
+ * The value is always 64 bits. It is updated with the atomic operations on
+ * the 64 bits platform, and with a lock on the 32 bits platform.
+ *
+ * @{
+ */
+
+/**
+ * @brief Maximum number of the metrics
+ */
+#define NUGU_METRICS_MAX 64
+
+/**
+ * @brief Maximum length of the metric name
+ */
+#define NUGU_METRICS_MAX_NAME_LEN 63
+
+/**
+ * @brief Number of the histogram buckets
+ *
+ * The bucket i (i < last) counts the value less than or equal to 2^i,
+ * and the last bucket counts the rest.
+ */
+#define NUGU_METRICS_BUCKETS 24
+
+/**
+ * @brief Metric types
+ */
+enum nugu_metric_type {
+	NUGU_METRIC_TYPE_COUNTER, /**< Monotonically increasing value */
+	NUGU_METRIC_TYPE_GAUGE, /**< Value which can go up and down */
+	NUGU_METRIC_TYPE_HISTOGRAM /**< Distribution of the observed values */
+};
+
+/**
+ * @brief Metric object
+ */
+typedef struct _nugu_metric NuguMetric;
+
+/**
+ * @brief Snapshot of the metric
+ * @see nugu_metrics_get_snapshot()
+ */
+struct nugu_metric_snapshot {
+	char name[NUGU_METRICS_MAX_NAME_LEN + 1]; /**< metric name */
+	enum nugu_metric_type type; /**< metric type */
+	int64_t value; /**< value, or sum of the observed values */
+	int64_t count; /**< number of the observed values (histogram) */
+	uint32_t buckets[NUGU_METRICS_BUCKETS]; /**< histogram buckets */
+};
+
+/**
+ * @brief Register the metric
+ *
+ * The metric which is already registered with the same name is returned.
+ * @param[in] name metric name (e.g. nugu_http2_sent_bytes)
+ * @param[in] type metric type
+ * @param[in] help description of the metric
+ * @return metric object. NULL on failure (e.g. type mismatch, full).
+ */
+NUGU_API NuguMetric *nugu_metrics_register(const char *name,
+					   enum nugu_metric_type type,
+					   const char *help);
+
+/**
+ * @brief Register the metric once and keep it in the handle
+ *
+ * The metric in the handle is returned without the lookup, so this is
+ * suitable for the frequently called constructors.
+ * @param[in,out] handle static storage of the metric. NULL at first.
+ * @param[in] name metric name
+ * @param[in] type metric type
+ * @param[in] help description of the metric
+ * @return metric object. NULL on failure.
+ * @see nugu_metrics_register()
+ */
+NUGU_API NuguMetric *nugu_metrics_register_once(NuguMetric **handle,
+						const char *name,
+						enum nugu_metric_type type,
+						const char *help);
+
+/**
+ * @brief Find the metric by the name
+ * @param[in] name metric name
+ * @return metric object. NULL if not registered.
+ */
+NUGU_API NuguMetric *nugu_metrics_find(const char *name);
+
+/**
+ * @brief Add the value to the counter or the gauge
+ * @param[in] metric metric object. NULL is ignored.
+ * @param[in] value value to add. The counter ignores the negative value.
+ */
+NUGU_API void nugu_metric_add(NuguMetric *metric, int64_t value);
+
+/**
+ * @brief Set the value of the gauge
+ * @param[in] metric metric object. NULL is ignored.
+ * @param[in] value value
+ */
+NUGU_API void nugu_metric_set(NuguMetric *metric, int64_t value);
+
+/**
+ * @brief Observe the value to the histogram
+ * @param[in] metric metric object. NULL is ignored.
+ * @param[in] value observed value
+ */
+NUGU_API void nugu_metric_observe(NuguMetric *metric, int64_t value);
+
+/**
+ * @brief Get the value of the metric
+ * @param[in] metric metric object
+ * @return value of the counter or the gauge, or sum of the histogram
+ */
+NUGU_API int64_t nugu_metric_get(NuguMetric *metric);
+
+/**
+ * @brief Get the snapshot of all metrics
+ * @param[out] snapshots array to store the snapshots
+ * @param[in] max maximum number of the snapshots
+ * @return number of the snapshots
+ */
+NUGU_API int nugu_metrics_get_snapshot(struct nugu_metric_snapshot *snapshots,
+				       int max);
+
+/**
+ * @brief Get all metrics in the text exposition format
+ * @return memory allocated text. Developer must free the data manually.
+ */
+NUGU_API char *nugu_metrics_format(void);
+
+/**
+ * @brief Reset the counters and the histograms
+ *
+ * The gauges are kept since they represent the current state (e.g. queue
+ * depth), and the metrics are not unregistered.
+ */
+NUGU_API void nugu_metrics_reset(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
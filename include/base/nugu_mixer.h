@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_MIXER_H__
+#define __NUGU_MIXER_H__
+
+#include <nugu.h>
+#include <base/nugu_audio.h>
+#include <base/nugu_pcm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_mixer.h
+ * @defgroup NuguMixer Playback mixer
+ * @ingroup SDKBase
+ * @brief PCM driver which mixes the pcm streams into one output stream
+ *
+ * The mixer registers the "mixer" PCM driver. Each NuguPcm object created
+ * with the mixer driver is a source of the mixer, and the playing sources
+ * are summed into a single output NuguPcm object which is created with the
+ * output driver (e.g. portaudio). So the device stream is opened only once
+ * for all the sources.
+ *
+ * The source which has a different audio property from the output is
+ * converted by NuguResampler.
+ *
+ * The gain of each source is the volume of the pcm (nugu_pcm_set_volume())
+ * multiplied by the ducking gain of its audio attribute. The gain change is
+ * ramped to avoid the click noise.
+ *
+ * The mixing thread keeps a few periods of the mixed audio in the output
+ * stream, so the latency of a new source is bounded by the periods.
+ *
+ * @{
+ */
+
+/**
+ * @brief Name of the mixer PCM driver
+ */
+#define NUGU_MIXER_DRIVER_NAME "mixer"
+
+/**
+ * @brief Initialize the mixer and register the mixer PCM driver
+ * @param[in] output driver of the output stream
+ * @param[in] property audio property of the output stream.
+ *                     NUGU_AUDIO_FORMAT_S16_LE is only supported.
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_mixer_deinitialize()
+ */
+NUGU_API int nugu_mixer_initialize(NuguPcmDriver *output,
+				   NuguAudioProperty property);
+
+/**
+ * @brief Stop the mixer and unregister the mixer PCM driver
+ *
+ * All the pcm objects of the mixer driver must be freed before.
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure (e.g. the pcm objects still use the driver)
+ */
+NUGU_API int nugu_mixer_deinitialize(void);
+
+/**
+ * @brief Get the mixer PCM driver
+ * @return mixer PCM driver. NULL if the mixer is not initialized.
+ */
+NUGU_API NuguPcmDriver *nugu_mixer_get_driver(void);
+
+/**
+ * @brief Get the output pcm object
+ * @return output pcm object. NULL if the mixer is not initialized.
+ */
+NUGU_API NuguPcm *nugu_mixer_get_output(void);
+
+/**
+ * @brief Set the ducking gain of the sources which have the attribute
+ * @param[in] attr audio attribute
+ * @param[in] gain gain in [0.0, 1.0]. 1.0 restores the sources.
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ */
+NUGU_API int nugu_mixer_set_ducking(NuguAudioAttribute attr, float gain);
+
+/**
+ * @brief Get the ducking gain of the attribute
+ * @param[in] attr audio attribute
+ * @return ducking gain
+ */
+NUGU_API float nugu_mixer_get_ducking(NuguAudioAttribute attr);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
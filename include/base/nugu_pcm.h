@@ -288,6 +288,36 @@ NUGU_API void nugu_pcm_clear_buffer(NuguPcm *pcm);
 NUGU_API int nugu_pcm_push_data(NuguPcm *pcm, const char *data, size_t size,
 				int is_last);
 
+/**
+ * @brief Reserve space for playback pcm data
+ *
+ * Reserve a contiguous space at the end of the pcm buffer, so that the
+ * producer (e.g. decoder) can write the data directly without the copy of
+ * nugu_pcm_push_data(). The data is not visible to the consumer until
+ * nugu_pcm_commit_data() is called. Only one reservation can be pending
+ * and nugu_pcm_push_data() must not be called until it is committed.
+ *
+ * The reserved space follows the previous data, so it is aligned to the
+ * sample size as long as all the pushed sizes are multiples of it.
+ * @param[in] pcm pcm object
+ * @param[in] size size to reserve (up to 16KB)
+ * @return reserved space. NULL on failure.
+ * @see nugu_pcm_commit_data()
+ */
+NUGU_API char *nugu_pcm_reserve_data(NuguPcm *pcm, size_t size);
+
+/**
+ * @brief Commit the data written to the reserved space
+ * @param[in] pcm pcm object
+ * @param[in] size size of written data (0 ~ reserved size)
+ * @param[in] is_last last data(is_last=1) or not(is_last=0)
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_pcm_reserve_data()
+ */
+NUGU_API int nugu_pcm_commit_data(NuguPcm *pcm, size_t size, int is_last);
+
 /**
  * @brief Set flag that push for all data is complete.
  * @param[in] pcm pcm object
@@ -300,6 +330,10 @@ NUGU_API int nugu_pcm_push_data_done(NuguPcm *pcm);
 
 /**
  * @brief Get all data
+ *
+ * The pcm buffer is a lock-free single producer(nugu_pcm_push_data) and
+ * single consumer(nugu_pcm_get_data) queue, so it is safe to call this
+ * function in the audio callback.
  * @param[in] pcm pcm object
  * @param[out] data buffer to get pcm data
  * @param[in] size size of buffer
@@ -326,6 +360,57 @@ NUGU_API size_t nugu_pcm_get_data_size(NuguPcm *pcm);
  */
 NUGU_API int nugu_pcm_receive_is_last_data(NuguPcm *pcm);
 
+/**
+ * @brief Get the number of buffer underruns
+ *
+ * The underrun is counted when nugu_pcm_get_data() can't fill the requested
+ * size before the last data is pushed. The counter is reset by
+ * nugu_pcm_clear_buffer().
+ * @param[in] pcm pcm object
+ * @return number of underruns
+ */
+NUGU_API unsigned int nugu_pcm_get_underrun_count(NuguPcm *pcm);
+
+/**
+ * @brief Set the start threshold of the playback (jitter buffer)
+ *
+ * nugu_pcm_get_data() returns no data until the buffered size reaches the
+ * threshold or the last data is pushed, so the playback starts with enough
+ * data to absorb the network jitter. The threshold is applied again after
+ * nugu_pcm_clear_buffer().
+ * @param[in] pcm pcm object
+ * @param[in] size threshold in bytes (0: start immediately)
+ * @see nugu_pcm_get_start_latency()
+ */
+NUGU_API void nugu_pcm_set_start_threshold(NuguPcm *pcm, size_t size);
+
+/**
+ * @brief Get the start threshold of the playback
+ * @param[in] pcm pcm object
+ * @return threshold in bytes
+ * @see nugu_pcm_set_start_threshold()
+ */
+NUGU_API size_t nugu_pcm_get_start_threshold(NuguPcm *pcm);
+
+/**
+ * @brief Get the latency added by the start threshold
+ *
+ * The latency is the time from the first data push to the first data
+ * returned by nugu_pcm_get_data(). The value is reset by
+ * nugu_pcm_clear_buffer().
+ * @param[in] pcm pcm object
+ * @return latency in milliseconds, -1 if the playback is not started
+ * @see nugu_pcm_set_start_threshold()
+ */
+NUGU_API int nugu_pcm_get_start_latency(NuguPcm *pcm);
+
+/**
+ * @brief Get the size of all data pushed after nugu_pcm_clear_buffer()
+ * @param[in] pcm pcm object
+ * @return size of pushed data
+ */
+NUGU_API size_t nugu_pcm_get_total_size(NuguPcm *pcm);
+
 /**
  * @}
  */
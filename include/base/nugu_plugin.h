@@ -34,6 +34,23 @@ extern "C" {
  * 'nugu_plugin_define_desc' symbol.
  * And there should be no 'lib' prefix in file name.
  *
+ * The plugin can declare the types of drivers it provides in the optional
+ * 'nugu_plugin_define_desc_ext' symbol (NUGU_PLUGIN_DEFINE_FULL), so the
+ * plugins built with the previous description are still loaded. The
+ * declared plugins with the same priority are initialized in parallel on
+ * the worker threads since they do not share the driver list. And the
+ * plugin with the NUGU_PLUGIN_FLAG_LAZY flag is not initialized until the
+ * driver of the declared type is first requested
+ * (e.g. nugu_pcm_driver_get_default()). The plugin without the declaration
+ * is initialized on the caller thread as before. Since the first registered
+ * driver becomes the default driver, the plugin which provides the same
+ * driver type with the lazy plugins should be also lazy.
+ *
+ * The lazy and parallel initialization can be disabled with the
+ * environment variable.
+ *  - NUGU_PLUGIN_INIT: "serial" to initialize all plugins on the caller
+ *    thread in priority order
+ *
  * @{
  */
 
@@ -58,10 +75,29 @@ extern "C" {
 #define NUGU_PLUGIN_SYMBOL "nugu_plugin_define_desc"
 
 /**
- * @brief Macros to easily define plugins
+ * @brief Optional symbol name of the extended description for dlsym()
+ */
+#define NUGU_PLUGIN_EXT_SYMBOL "nugu_plugin_define_desc_ext"
+
+/**
+ * @brief Flag to defer the init until the provided driver is requested.
+ * @see nugu_plugin_require()
+ */
+#define NUGU_PLUGIN_FLAG_LAZY (1 << 0)
+
+/**
+ * @brief Macros to easily define plugins with the provided driver types
+ * @see enum nugu_plugin_provides
  */
 #ifdef NUGU_PLUGIN_BUILTIN
-#define NUGU_PLUGIN_DEFINE(p_name, p_prio, p_ver, p_load, p_unload, p_init)    \
+#define NUGU_PLUGIN_DEFINE_FULL(p_name, p_prio, p_ver, p_load, p_unload,       \
+				p_init, p_provides, p_flags)                   \
+	NUGU_API_EXPORT struct nugu_plugin_desc_ext                            \
+		_builtin_plugin_ext_##p_name = {                               \
+			.size = sizeof(struct nugu_plugin_desc_ext),           \
+			.provides = p_provides,                                \
+			.flags = p_flags                                       \
+		};                                                             \
 	NUGU_API_EXPORT struct nugu_plugin_desc _builtin_plugin_##p_name = {   \
 		.name = #p_name,                                               \
 		.priority = p_prio,                                            \
@@ -71,7 +107,14 @@ extern "C" {
 		.init = p_init                                                 \
 	}
 #else
-#define NUGU_PLUGIN_DEFINE(p_name, p_prio, p_ver, p_load, p_unload, p_init)    \
+#define NUGU_PLUGIN_DEFINE_FULL(p_name, p_prio, p_ver, p_load, p_unload,       \
+				p_init, p_provides, p_flags)                   \
+	NUGU_API_EXPORT struct nugu_plugin_desc_ext                            \
+		nugu_plugin_define_desc_ext = {                                \
+			.size = sizeof(struct nugu_plugin_desc_ext),           \
+			.provides = p_provides,                                \
+			.flags = p_flags                                       \
+		};                                                             \
 	NUGU_API_EXPORT struct nugu_plugin_desc nugu_plugin_define_desc = {    \
 		.name = #p_name,                                               \
 		.priority = p_prio,                                            \
@@ -82,6 +125,24 @@ extern "C" {
 	}
 #endif
 
+/**
+ * @brief Macros to easily define plugins
+ */
+#define NUGU_PLUGIN_DEFINE(p_name, p_prio, p_ver, p_load, p_unload, p_init)    \
+	NUGU_PLUGIN_DEFINE_FULL(p_name, p_prio, p_ver, p_load, p_unload,       \
+				p_init, 0, 0)
+
+/**
+ * @brief Driver types provided by the plugin (bitmask)
+ */
+enum nugu_plugin_provides {
+	NUGU_PLUGIN_PROVIDES_PCM = (1 << 0), /**< nugu_pcm_driver */
+	NUGU_PLUGIN_PROVIDES_PLAYER = (1 << 1), /**< nugu_player_driver */
+	NUGU_PLUGIN_PROVIDES_RECORDER = (1 << 2), /**< nugu_recorder_driver */
+	NUGU_PLUGIN_PROVIDES_DECODER = (1 << 3), /**< nugu_decoder_driver */
+	NUGU_PLUGIN_PROVIDES_ENCODER = (1 << 4) /**< nugu_encoder_driver */
+};
+
 /**
  * @brief Plugin object
  */
@@ -123,15 +184,52 @@ struct nugu_plugin_desc {
 	int (*init)(NuguPlugin *p);
 };
 
+/**
+ * @brief Extended plugin description
+ *
+ * The extension is separated from the nugu_plugin_desc to keep the layout
+ * of the description for the plugins built with the previous version.
+ * The fields beyond the size are regarded as 0.
+ */
+struct nugu_plugin_desc_ext {
+	/**
+	 * @brief Size of the structure (sizeof(struct nugu_plugin_desc_ext))
+	 */
+	unsigned int size;
+
+	/**
+	 * @brief Driver types provided by the plugin.
+	 * (bitmask of enum nugu_plugin_provides, 0 if not declared)
+	 */
+	unsigned int provides;
+
+	/**
+	 * @brief Plugin flags (e.g. NUGU_PLUGIN_FLAG_LAZY)
+	 */
+	unsigned int flags;
+};
+
 /**
  * @brief Create new plugin object
  * @param[in] desc plugin description
  * @return plugin object
+ * @see nugu_plugin_new_full()
  * @see nugu_plugin_new_from_file()
  * @see nugu_plugin_free()
  */
 NUGU_API NuguPlugin *nugu_plugin_new(struct nugu_plugin_desc *desc);
 
+/**
+ * @brief Create new plugin object with the extended description
+ * @param[in] desc plugin description
+ * @param[in] ext extended description. NULL if not declared.
+ * @return plugin object
+ * @see nugu_plugin_new()
+ */
+NUGU_API NuguPlugin *
+nugu_plugin_new_full(struct nugu_plugin_desc *desc,
+		     const struct nugu_plugin_desc_ext *ext);
+
 /**
  * @brief Create new plugin object from file
  * @param[in] filepath plugin file path
@@ -172,6 +270,9 @@ NUGU_API int nugu_plugin_remove(NuguPlugin *p);
 
 /**
  * @brief Find a plugin by name in the managed list
+ *
+ * The plugin whose init() is failed and the lazy plugin which is not
+ * initialized yet are not found.
  * @param[in] name name of plugin
  * @return plugin object
  * @see nugu_plugin_add()
@@ -231,10 +332,28 @@ NUGU_API int nugu_plugin_load_builtin(void);
 
 /**
  * @brief Initialize plugin
+ *
+ * The lazy plugins are not initialized and not counted.
  * @return Number of plugins initialized
+ * @see nugu_plugin_require()
  */
 NUGU_API int nugu_plugin_initialize(void);
 
+/**
+ * @brief Initialize the lazy plugins which provide the driver type
+ *
+ * The plugins are initialized in priority order on the caller thread.
+ * The other lazy plugins which share a driver type with them are also
+ * initialized, so the default driver of each type is not changed by the
+ * order of the requests.
+ * The driver modules call this function when the driver is requested, so
+ * the call inside the plugin init() is ignored.
+ * @param[in] provides driver types (bitmask of enum nugu_plugin_provides)
+ * @return Number of plugins initialized
+ * @see nugu_plugin_initialize()
+ */
+NUGU_API int nugu_plugin_require(unsigned int provides);
+
 /**
  * @brief De-initialize plugin
  */
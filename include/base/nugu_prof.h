@@ -34,9 +34,28 @@ extern "C" {
  * The profiling module provides notification and performance measurement
  * for each condition.
  *
+ * Each mark is also recorded to a preallocated ring with the dialog request
+ * id and the monotonic timestamp, so the latency of each turn can be
+ * measured even if the dialogs are overlapped (e.g. barge-in). The marks
+ * without the dialog request id are attributed to the dialog as follows.
+ *  - ASR marks: the dialog of the last NUGU_PROF_TYPE_ASR_RECOGNIZE
+ *  - TTS marks: the dialog of the last NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE
+ *    or NUGU_PROF_TYPE_TTS_STARTED
+ *  - Wakeup and listening marks: the next NUGU_PROF_TYPE_ASR_RECOGNIZE
+ *
+ * The latency from the relative type (e.g. wakeup detected to listening
+ * started) is accumulated to a fixed size histogram of each type, so the
+ * percentiles over the session can be exported by nugu_prof_get_latency().
+ *
  * @{
  */
 
+/**
+ * @brief Number of the records in the timeline ring
+ * @see nugu_prof_get_timeline()
+ */
+#define NUGU_PROF_RING_SIZE 1024
+
 /**
  * @brief Profiling type list
  * @see nugu_prof_mark()
@@ -191,6 +210,30 @@ enum nugu_prof_type {
 	NUGU_PROF_TYPE_AUDIO_FINISHED,
 	/**< AudioPlayer finished */
 
+	NUGU_PROF_TYPE_TTS_DECODE_QUEUE,
+	/**< TTS decode queue reached the new maximum depth */
+
+	NUGU_PROF_TYPE_TTS_LAST_DECODING,
+	/**< TTS decoding for last attachment */
+
+	NUGU_PROF_TYPE_TTS_CACHE_HIT,
+	/**< TTS audio is played from the cache (contents: cache statistics) */
+
+	NUGU_PROF_TYPE_TTS_CACHE_MISS,
+	/**< TTS audio is not found in the cache (contents: cache statistics) */
+
+	NUGU_PROF_TYPE_SDK_NETWORK_INIT_DONE,
+	/**< Network manager created */
+
+	NUGU_PROF_TYPE_SDK_CAPABILITY_INIT_DONE,
+	/**< All capabilities initialized */
+
+	NUGU_PROF_TYPE_SDK_MODEL_LOAD_START,
+	/**< Wakeup model loading start */
+
+	NUGU_PROF_TYPE_SDK_MODEL_LOAD_DONE,
+	/**< Wakeup model loaded */
+
 	NUGU_PROF_TYPE_MAX
 	/**< Just last value */
 };
@@ -207,6 +250,31 @@ struct nugu_prof_data {
 	char *contents; /* additional contents */
 };
 
+/**
+ * @brief Timeline record of the profiling mark
+ * @see nugu_prof_get_timeline()
+ */
+struct nugu_prof_record {
+	enum nugu_prof_type type; /**< profiling type */
+	char dialog_id[NUGU_MAX_UUID_STRING_SIZE + 1]; /**< dialog request id */
+	gint64 timestamp_ns; /**< monotonic timestamp(nanoseconds) */
+};
+
+/**
+ * @brief Latency statistics from the relative type
+ * @see nugu_prof_get_latency()
+ */
+struct nugu_prof_latency {
+	enum nugu_prof_type from; /**< relative profiling type */
+	enum nugu_prof_type to; /**< profiling type */
+	unsigned int count; /**< number of the samples */
+	gint64 min; /**< minimum latency(microseconds) */
+	gint64 max; /**< maximum latency(microseconds) */
+	gint64 p50; /**< 50th percentile latency(microseconds) */
+	gint64 p90; /**< 90th percentile latency(microseconds) */
+	gint64 p99; /**< 99th percentile latency(microseconds) */
+};
+
 /**
  * @brief Callback prototype for receiving an attachment
  * @see nugu_prof_set_callback()
@@ -234,6 +302,9 @@ NUGU_API void nugu_prof_disable_tracelog(void);
  * @brief Set profiling callback
  * @param[in] callback callback function
  * @param[in] userdata data to pass to the user callback
+ * @remarks The callback is called in the mainloop once for each mark, in
+ * the order of the marking. If the mainloop is blocked and too many marks
+ * are waiting, the new marks are not delivered to the callback.
  */
 NUGU_API void nugu_prof_set_callback(NuguProfCallback callback, void *userdata);
 
@@ -309,6 +380,44 @@ NUGU_API const char *nugu_prof_get_type_name(enum nugu_prof_type type);
  */
 NUGU_API void nugu_prof_dump(enum nugu_prof_type from, enum nugu_prof_type to);
 
+/**
+ * @brief Get the timeline of the dialog
+ *
+ * The records are sorted by the timestamp. The records overwritten in the
+ * ring are not included.
+ * @param[in] dialog_id dialog request id
+ * @param[out] records array to store the records
+ * @param[in] max maximum number of the records
+ * @return number of the records. -1 on failure.
+ */
+NUGU_API int nugu_prof_get_timeline(const char *dialog_id,
+				    struct nugu_prof_record *records, int max);
+
+/**
+ * @brief Dump the timeline of the dialog
+ * @param[in] dialog_id dialog request id
+ */
+NUGU_API void nugu_prof_dump_timeline(const char *dialog_id);
+
+/**
+ * @brief Get the latency statistics from the relative type
+ *
+ * The statistics are accumulated until nugu_prof_clear(). The percentiles
+ * are the highest value of the histogram bucket (relative error < 6.25%).
+ * @param[in] type profiling type
+ * @param[out] latency latency statistics
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure (e.g. the type has no relative type)
+ */
+NUGU_API int nugu_prof_get_latency(enum nugu_prof_type type,
+				   struct nugu_prof_latency *latency);
+
+/**
+ * @brief Dump the latency statistics of all types
+ */
+NUGU_API void nugu_prof_dump_latency(void);
+
 /**
  * @}
  */
@@ -251,6 +251,32 @@ NUGU_API int nugu_recorder_get_frame_timeout(NuguRecorder *rec, char *data,
  */
 NUGU_API int nugu_recorder_get_frame_count(NuguRecorder *rec);
 
+/**
+ * @brief Set the source recorder
+ *
+ * The recorder receives the frames pushed to the source recorder instead
+ * of using its own driver. The frames are converted to the property of the
+ * recorder by NuguResampler, so a single capture stream can feed the
+ * recorders with different properties.
+ *
+ * Starting the recorder starts the source recorder if it is not recording,
+ * and the source recorder is stopped when all the recorders linked to it
+ * are stopped.
+ * @param[in] rec recorder object
+ * @param[in] source source recorder object. NULL to unlink.
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure (e.g. the recorder is recording)
+ */
+NUGU_API int nugu_recorder_set_source(NuguRecorder *rec, NuguRecorder *source);
+
+/**
+ * @brief Get the source recorder
+ * @param[in] rec recorder object
+ * @return source recorder object. NULL if not linked.
+ */
+NUGU_API NuguRecorder *nugu_recorder_get_source(NuguRecorder *rec);
+
 /**
  * @}
  */
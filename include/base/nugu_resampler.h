@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_RESAMPLER_H__
+#define __NUGU_RESAMPLER_H__
+
+#include <stddef.h>
+#include <nugu.h>
+#include <base/nugu_audio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_resampler.h
+ * @defgroup NuguResampler Resampler
+ * @ingroup SDKBase
+ * @brief Streaming sample rate, channel and format converter
+ *
+ * The resampler converts the 16-bit PCM stream of an audio property to
+ * another one. It is used to feed the recorders which have different
+ * properties from a single capture stream.
+ *
+ * The sample rate is converted by a polyphase windowed-sinc filter. The
+ * filter state is kept between the calls, so the stream can be passed in
+ * chunks of any size. The filter is calculated by the nugu_sample_float_dot()
+ * kernel, which uses the SIMD instructions.
+ *
+ * The channels are down-mixed to mono or the mono channel is duplicated.
+ *
+ * Supported formats are NUGU_AUDIO_FORMAT_S16_LE and NUGU_AUDIO_FORMAT_S16_BE.
+ *
+ * The functions are not thread safe.
+ *
+ * @{
+ */
+
+/**
+ * @brief Resampler object
+ */
+typedef struct _nugu_resampler NuguResampler;
+
+/**
+ * @brief Create new resampler object
+ * @param[in] in audio property of the input
+ * @param[in] out audio property of the output
+ * @return resampler object. NULL if the conversion is not supported.
+ */
+NUGU_API NuguResampler *nugu_resampler_new(NuguAudioProperty in,
+					   NuguAudioProperty out);
+
+/**
+ * @brief Destroy the resampler object
+ * @param[in] rs resampler object
+ */
+NUGU_API void nugu_resampler_free(NuguResampler *rs);
+
+/**
+ * @brief Check whether the resampler only copies the data
+ * @param[in] rs resampler object
+ * @return 1 if the input and output properties are same, otherwise 0
+ */
+NUGU_API int nugu_resampler_is_passthrough(NuguResampler *rs);
+
+/**
+ * @brief Get the maximum output size for the input size
+ * @param[in] rs resampler object
+ * @param[in] size input size
+ * @return maximum output size of nugu_resampler_process()
+ */
+NUGU_API size_t nugu_resampler_get_output_size(NuguResampler *rs,
+					       size_t size);
+
+/**
+ * @brief Get the output size which has the same duration as the input size
+ *
+ * It can be used to decide the frame size of the output stream.
+ * @param[in] rs resampler object
+ * @param[in] size input size
+ * @return output size
+ */
+NUGU_API size_t nugu_resampler_convert_size(NuguResampler *rs, size_t size);
+
+/**
+ * @brief Convert the input data
+ *
+ * The output is delayed by the half length of the filter when the sample
+ * rate is converted. The incomplete frame of the input is kept for the
+ * next call.
+ * @param[in] rs resampler object
+ * @param[in] data input data
+ * @param[in] size size of input data
+ * @param[out] out output buffer
+ * @param[in] out_size size of output buffer
+ * @return size of the output data, -1 on failure
+ * @see nugu_resampler_get_output_size()
+ */
+NUGU_API int nugu_resampler_process(NuguResampler *rs, const void *data,
+				    size_t size, void *out, size_t out_size);
+
+/**
+ * @brief Clear the filter state to start a new stream
+ * @param[in] rs resampler object
+ */
+NUGU_API void nugu_resampler_reset(NuguResampler *rs);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -18,6 +18,7 @@
 #define __NUGU_RING_BUFFER_H__
 
 #include <nugu.h>
+#include <base/nugu_memory.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +55,17 @@ NUGU_API NuguRingBuffer *nugu_ring_buffer_new(int item_size, int max_items);
  */
 NUGU_API void nugu_ring_buffer_free(NuguRingBuffer *buf);
 
+/**
+ * @brief Set the memory accounting tag of the ringbuffer
+ *
+ * The ringbuffer is accounted to the NUGU_MEMORY_TAG_BUFFER by default.
+ * @param[in] buf ringbuffer object
+ * @param[in] tag accounting tag
+ * @see nugu_memory_get_stat()
+ */
+NUGU_API void nugu_ring_buffer_set_memory_tag(NuguRingBuffer *buf,
+					      enum nugu_memory_tag tag);
+
 /**
  * @brief Resize the ringbuffer
  * @param[in] buf ringbuffer object
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_SAMPLE_H__
+#define __NUGU_SAMPLE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_sample.h
+ * @defgroup NuguSample PCM sample conversion
+ * @ingroup SDKBase
+ * @brief PCM sample conversion kernels
+ *
+ * Conversion functions for the 16-bit PCM samples which are used by the
+ * codec and audio plugins (byte order, int16/float, stereo down-mix,
+ * gain and dot product).
+ *
+ * Each function has a scalar implementation and SIMD implementations
+ * (SSE2, AVX2 on x86 and NEON on ARM). The best implementation supported
+ * by the running CPU is selected at the first call. The selection can be
+ * overridden with nugu_sample_set_isa() for testing.
+ *
+ * All functions are thread safe and the source and destination buffers
+ * must not overlap unless otherwise noted.
+ *
+ * @{
+ */
+
+/**
+ * @brief Instruction set used by the conversion kernels
+ * @see nugu_sample_set_isa()
+ * @see nugu_sample_get_isa()
+ */
+enum nugu_sample_isa {
+	NUGU_SAMPLE_ISA_AUTO, /**< Best instruction set of the running CPU */
+	NUGU_SAMPLE_ISA_SCALAR, /**< Plain C implementation */
+	NUGU_SAMPLE_ISA_SSE2, /**< x86 SSE2 */
+	NUGU_SAMPLE_ISA_AVX2, /**< x86 AVX2 */
+	NUGU_SAMPLE_ISA_NEON /**< ARM NEON */
+};
+
+/**
+ * @brief Select the instruction set of the conversion kernels
+ * @param[in] isa instruction set
+ * @return result
+ * @retval 0 success
+ * @retval -1 the instruction set is not supported by the build or the CPU
+ */
+NUGU_API int nugu_sample_set_isa(enum nugu_sample_isa isa);
+
+/**
+ * @brief Get the instruction set of the conversion kernels
+ * @return instruction set (never NUGU_SAMPLE_ISA_AUTO)
+ */
+NUGU_API enum nugu_sample_isa nugu_sample_get_isa(void);
+
+/**
+ * @brief Get the name of the instruction set
+ * @param[in] isa instruction set
+ * @return name of the instruction set. e.g. "sse2"
+ */
+NUGU_API const char *nugu_sample_isa_name(enum nugu_sample_isa isa);
+
+/**
+ * @brief Convert native samples to the little-endian byte stream
+ * @param[in] src native 16-bit samples
+ * @param[out] dest byte buffer (count * 2 bytes)
+ * @param[in] count number of samples
+ */
+NUGU_API void nugu_sample_s16_to_le(const int16_t *src, void *dest,
+				    size_t count);
+
+/**
+ * @brief Convert the little-endian byte stream to native samples
+ * @param[in] src byte buffer (count * 2 bytes)
+ * @param[out] dest native 16-bit samples
+ * @param[in] count number of samples
+ */
+NUGU_API void nugu_sample_s16_from_le(const void *src, int16_t *dest,
+				      size_t count);
+
+/**
+ * @brief Swap the byte order of the 16-bit samples
+ * @param[in] src source samples
+ * @param[out] dest destination samples (can be same with the src)
+ * @param[in] count number of samples
+ */
+NUGU_API void nugu_sample_s16_swap(const int16_t *src, int16_t *dest,
+				   size_t count);
+
+/**
+ * @brief Convert 16-bit samples to float samples in [-1.0, 1.0)
+ * @param[in] src 16-bit samples
+ * @param[out] dest float samples
+ * @param[in] count number of samples
+ */
+NUGU_API void nugu_sample_s16_to_float(const int16_t *src, float *dest,
+				       size_t count);
+
+/**
+ * @brief Convert float samples to 16-bit samples
+ *
+ * The samples are scaled by 32768, rounded to the nearest (ties to even)
+ * and saturated to the 16-bit range.
+ *
+ * @param[in] src float samples
+ * @param[out] dest 16-bit samples
+ * @param[in] count number of samples
+ */
+NUGU_API void nugu_sample_float_to_s16(const float *src, int16_t *dest,
+				       size_t count);
+
+/**
+ * @brief Down-mix interleaved stereo samples to mono
+ *
+ * Each output sample is (left + right) >> 1.
+ *
+ * @param[in] src interleaved stereo samples (frames * 2 samples)
+ * @param[out] dest mono samples (frames samples, can be same with the src)
+ * @param[in] frames number of stereo frames
+ */
+NUGU_API void nugu_sample_s16_downmix_stereo(const int16_t *src,
+					     int16_t *dest, size_t frames);
+
+/**
+ * @brief Apply the gain to 16-bit samples
+ *
+ * The result is rounded to the nearest and saturated to the 16-bit range.
+ *
+ * @param[in] src source samples
+ * @param[out] dest destination samples (can be same with the src)
+ * @param[in] count number of samples
+ * @param[in] gain linear gain (1.0 is unity)
+ */
+NUGU_API void nugu_sample_s16_gain(const int16_t *src, int16_t *dest,
+				   size_t count, float gain);
+
+/**
+ * @brief Calculate the dot product of two float vectors
+ *
+ * It is the inner loop of the FIR filters (e.g. NuguResampler). The
+ * SIMD implementations sum the products in a different order, so the
+ * result can differ from the scalar one in the last bits.
+ *
+ * @param[in] a float samples
+ * @param[in] b float samples
+ * @param[in] count number of samples
+ * @return sum of a[i] * b[i]
+ */
+NUGU_API float nugu_sample_float_dot(const float *a, const float *b,
+				     size_t count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_SPAN_H__
+#define __NUGU_SPAN_H__
+
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_span.h
+ * @defgroup NuguSpan Span trace
+ * @ingroup SDKBase
+ * @brief Begin/end spans of the SDK internals in Chrome trace format
+ *
+ * Each thread records the spans into its own preallocated buffer without
+ * any lock, and the oldest spans are overwritten when the buffer is full.
+ * The buffers are dumped to the Chrome trace-event JSON file, which can be
+ * loaded by the trace viewer (e.g. https://ui.perfetto.dev or
+ * chrome://tracing) to see the interactions between the threads.
+ *
+ * The span is enabled at the first use with the environment variable, and
+ * the file is dumped when the process exits.
+ *  - NUGU_SPAN_PATH: path of the trace-event JSON file
+ *
+ * @{
+ */
+
+/**
+ * @brief Enable the span recording
+ */
+NUGU_API void nugu_span_enable(void);
+
+/**
+ * @brief Disable the span recording. The recorded spans are kept.
+ */
+NUGU_API void nugu_span_disable(void);
+
+/**
+ * @brief Check the span recording is enabled
+ * @return 1 if enabled, otherwise 0
+ */
+NUGU_API int nugu_span_is_enabled(void);
+
+/**
+ * @brief Begin a span in the current thread
+ * @param[in] name span name. The string must be valid until the dump
+ *                 (e.g. string literal).
+ * @see nugu_span_end()
+ */
+NUGU_API void nugu_span_begin(const char *name);
+
+/**
+ * @brief End the last span of the current thread
+ * @param[in] name span name
+ * @see nugu_span_begin()
+ */
+NUGU_API void nugu_span_end(const char *name);
+
+/**
+ * @brief Discard the recorded spans
+ */
+NUGU_API void nugu_span_clear(void);
+
+/**
+ * @brief Dump the recorded spans to the trace-event JSON file
+ * @param[in] path path of the file. Existing file is overwritten.
+ * @return number of the dumped events. -1 on failure.
+ */
+NUGU_API int nugu_span_dump(const char *path);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief Span of the enclosing scope
+ * @ingroup NuguSpan
+ */
+class NuguSpanScope {
+public:
+	explicit NuguSpanScope(const char *name)
+		: name(name)
+	{
+		nugu_span_begin(name);
+	}
+
+	~NuguSpanScope()
+	{
+		nugu_span_end(name);
+	}
+
+	NuguSpanScope(const NuguSpanScope &) = delete;
+	NuguSpanScope &operator=(const NuguSpanScope &) = delete;
+
+private:
+	const char *name;
+};
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_TRACE_H__
+#define __NUGU_TRACE_H__
+
+#include <stdio.h>
+#include <stddef.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_trace.h
+ * @defgroup NuguTrace Binary trace
+ * @ingroup SDKBase
+ * @brief Compact binary trace of the protocol messages
+ *
+ * The trace stores only the format id and the raw arguments of each
+ * message into a memory-mapped circular file, so the tracing can be kept
+ * enabled on the device without the cost of the text formatting. The
+ * readable log is reconstructed from the file by nugu_trace_decode() on
+ * the host (e.g. nugu_trace_decode tool).
+ *
+ * The file consists of the fixed size blocks. A message never crosses the
+ * block boundary and the oldest block is overwritten when the file is
+ * full, so the file can be decoded even after the crash of the process.
+ *
+ * The trace is opened at the first use with the environment variables.
+ *  - NUGU_TRACE_PATH: path of the trace file
+ *  - NUGU_TRACE_SIZE: size of the trace file in KB (default: 1024)
+ *
+ * @{
+ */
+
+/**
+ * @brief Format ids of the trace messages
+ * @see nugu_trace_get_format()
+ */
+enum nugu_trace_id {
+	NUGU_TRACE_ID_EVENT = 1, /**< Event request body (text part only) */
+	NUGU_TRACE_ID_EVENT_ATTACHMENT, /**< Event attachment request */
+	NUGU_TRACE_ID_DIRECTIVES, /**< Directives response body */
+	NUGU_TRACE_ID_POLICY, /**< Policy response body */
+	NUGU_TRACE_ID_MAX
+};
+
+/**
+ * @brief Open the trace file and enable the trace
+ * @param[in] path path of the trace file. Existing file is overwritten.
+ * @param[in] size size of the trace file in bytes
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ */
+NUGU_API int nugu_trace_open(const char *path, size_t size);
+
+/**
+ * @brief Close the trace file and disable the trace
+ */
+NUGU_API void nugu_trace_close(void);
+
+/**
+ * @brief Check the trace is enabled
+ * @return 1 if enabled, otherwise 0
+ */
+NUGU_API int nugu_trace_is_enabled(void);
+
+/**
+ * @brief Write a trace message
+ *
+ * The arguments must match the format of the id. The string argument
+ * of "%.*s" conversion doesn't need the null terminator.
+ * @param[in] id format id
+ * @return result
+ * @retval 0 success
+ * @retval -1 failure
+ * @see nugu_trace_get_format()
+ */
+NUGU_API int nugu_trace_write(enum nugu_trace_id id, ...);
+
+/**
+ * @brief Get the printf format string of the id
+ * @param[in] id format id
+ * @return format string. NULL if the id is invalid.
+ */
+NUGU_API const char *nugu_trace_get_format(enum nugu_trace_id id);
+
+/**
+ * @brief Decode the trace file into the readable log
+ * @param[in] path path of the trace file
+ * @param[in] out output stream
+ * @return number of decoded messages. -1 on failure.
+ */
+NUGU_API int nugu_trace_decode(const char *path, FILE *out);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_WATCHDOG_H__
+#define __NUGU_WATCHDOG_H__
+
+#include <stdint.h>
+#include <nugu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file nugu_watchdog.h
+ * @defgroup NuguWatchdog Watchdog
+ * @ingroup SDKBase
+ * @brief Main loop latency watchdog
+ *
+ * The watchdog measures the running time of the callbacks which are
+ * dispatched by the SDK on the main loop (equeue, idle handlers, timers
+ * and NuguRunner) and the lag of the main loop itself. A callback that
+ * runs longer than the threshold is reported with its tag.
+ *
+ * The watchdog is disabled by default. It can be enabled with
+ * nugu_watchdog_enable() or the NUGU_WATCHDOG environment variable
+ * (threshold in milliseconds).
+ *
+ * @{
+ */
+
+/**
+ * @brief Default threshold(milliseconds) for the stall report
+ */
+#define NUGU_WATCHDOG_DEFAULT_THRESHOLD 50
+
+/**
+ * @brief Maximum length of the callback tag
+ */
+#define NUGU_WATCHDOG_MAX_TAG_LEN 47
+
+/**
+ * @brief Number of buckets in the loop lag histogram
+ *
+ * The bucket i (0 < i < last) counts the lag less than 2^i milliseconds,
+ * the first bucket counts the lag less than 1 millisecond and the last
+ * bucket counts the rest.
+ */
+#define NUGU_WATCHDOG_LAG_BUCKETS 12
+
+/**
+ * @brief Statistics of the callbacks which have same tag
+ * @see nugu_watchdog_get_stats()
+ */
+struct nugu_watchdog_stat {
+	char tag[NUGU_WATCHDOG_MAX_TAG_LEN + 1]; /**< callback tag */
+	unsigned int count; /**< number of dispatches */
+	unsigned int stalls; /**< number of dispatches over the threshold */
+	int64_t total; /**< total running time(microseconds) */
+	int64_t max; /**< maximum running time(microseconds) */
+};
+
+/**
+ * @brief Enable the watchdog
+ * @param[in] threshold_msec threshold for the stall report (milliseconds)
+ * @see nugu_watchdog_disable()
+ */
+NUGU_API void nugu_watchdog_enable(int threshold_msec);
+
+/**
+ * @brief Disable the watchdog
+ * @see nugu_watchdog_enable()
+ */
+NUGU_API void nugu_watchdog_disable(void);
+
+/**
+ * @brief Check whether the watchdog is enabled
+ * @return result
+ * @retval 1 enabled
+ * @retval 0 disabled
+ */
+NUGU_API int nugu_watchdog_is_enabled(void);
+
+/**
+ * @brief Check the environment variable and enable the watchdog if it is set.
+ */
+NUGU_API void nugu_watchdog_check_env(void);
+
+/**
+ * @brief Get the start time of the callback
+ * @return monotonic time(microseconds), 0 if the watchdog is disabled
+ * @see nugu_watchdog_end()
+ */
+NUGU_API int64_t nugu_watchdog_begin(void);
+
+/**
+ * @brief Record the running time of the callback
+ * @param[in] tag callback tag
+ * @param[in] begin start time returned by nugu_watchdog_begin()
+ * @param[in] func address of the callback function for the stall report
+ * @param[in] userdata user data of the callback for the stall report
+ * @see nugu_watchdog_begin()
+ */
+NUGU_API void nugu_watchdog_end(const char *tag, int64_t begin,
+				const void *func, const void *userdata);
+
+/**
+ * @brief Get the callback statistics sorted by the maximum running time
+ * @param[out] stats array to store the statistics
+ * @param[in] max_count size of the array
+ * @return number of stored statistics
+ */
+NUGU_API int nugu_watchdog_get_stats(struct nugu_watchdog_stat *stats,
+				     int max_count);
+
+/**
+ * @brief Get the loop lag histogram
+ * @param[out] buckets array with NUGU_WATCHDOG_LAG_BUCKETS items
+ */
+NUGU_API void nugu_watchdog_get_lag_histogram(unsigned int *buckets);
+
+/**
+ * @brief Clear all statistics
+ */
+NUGU_API void nugu_watchdog_reset(void);
+
+/**
+ * @brief Dump the slowest callbacks and the loop lag histogram
+ * @param[in] max_count maximum number of callbacks to dump
+ */
+NUGU_API void nugu_watchdog_dump(int max_count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
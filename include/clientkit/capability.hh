@@ -18,6 +18,7 @@
 #define __NUGU_CAPABILITY_H__
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -369,6 +370,34 @@ public:
      */
     virtual void parsingDirective(const char* dname, const char* message);
 
+    /**
+     * @brief Directive handler which is called with the directive data.
+     */
+    using DirectiveHandler = std::function<void(const char* message)>;
+
+    /**
+     * @brief Add directive handler to the directive dispatch table.
+     * @param[in] dname directive name
+     * @param[in] handler directive handler
+     */
+    void addDirectiveHandler(const std::string& dname, DirectiveHandler handler);
+
+    /**
+     * @brief Call the directive handler which is added for directive name.
+     * @param[in] dname directive name
+     * @param[in] message directive data
+     * @return dispatch result
+     * @retval true The directive handler is called
+     * @retval false There is no directive handler for directive name
+     */
+    bool dispatchDirective(const char* dname, const char* message);
+
+    /**
+     * @brief Get directive names which are added to the directive dispatch table.
+     * @return directive names
+     */
+    std::vector<std::string> getDirectiveNames();
+
     /**
      * @brief Get current context info.
      * @return context info
@@ -17,6 +17,8 @@
 #ifndef __NUGU_MEDIA_PLAYER_INTERFACE_H__
 #define __NUGU_MEDIA_PLAYER_INTERFACE_H__
 
+#include <cstdint>
+#include <functional>
 #include <string>
 
 #include <base/nugu_audio.h>
@@ -275,10 +277,69 @@ public:
      */
     virtual bool writeAudio(const char* data, int size) = 0;
 
+    /**
+     * @brief Write audio samples with the time when they are received.
+     *
+     * The receive time is used to estimate the network jitter of the stream
+     * when the samples are kept by the writer before they are written. The
+     * default implementation ignores the time.
+     * @param[in] data raw audio data
+     * @param[in] size data size
+     * @param[in] received_msec receive time from the monotonic clock (msec)
+     * @return success or not
+     * @see writeAudio()
+     */
+    virtual bool writeReceivedAudio(const char* data, int size, int64_t received_msec)
+    {
+        return writeAudio(data, size);
+    }
+
     /**
      * @brief Notify to write done to the tts player.
      */
     virtual void writeDone() = 0;
+
+    /**
+     * @brief Check whether the tts player can accept more audio samples.
+     *
+     * The tts player decodes the audio samples on a worker thread. When the
+     * decoding queue is full, the writer should keep the remaining data and
+     * wait for the writable callback. The default implementation is always
+     * writable.
+     * @return writable or not
+     * @see setWritableCallback()
+     */
+    virtual bool isWritable()
+    {
+        return true;
+    }
+
+    /**
+     * @brief Set the callback which is called on the main loop when the tts
+     * player becomes writable after isWritable() returned false. The default
+     * implementation ignores the callback.
+     * @param[in] callback writable callback
+     * @see isWritable()
+     */
+    virtual void setWritableCallback(std::function<void()> callback)
+    {
+    }
+
+    /**
+     * @brief Set the cache key of the audio samples to be written.
+     *
+     * If the decoded audio of the key is cached, it is written to the tts
+     * player immediately and the following writeAudio() and writeDone() are
+     * ignored. Otherwise the decoded audio is cached when writeDone() is
+     * called. The cache is enabled by NUGU_TTS_CACHE_PATH. The default
+     * implementation doesn't support the cache.
+     * @param[in] key cache key (e.g. text of the TTS)
+     * @return the cached audio is written or not
+     */
+    virtual bool setCacheKey(const std::string& key)
+    {
+        return false;
+    }
 };
 
 /**
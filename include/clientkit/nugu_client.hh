@@ -17,6 +17,8 @@
 #ifndef __NUGU_CLIENT_H__
 #define __NUGU_CLIENT_H__
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -82,7 +84,28 @@ public:
         NuguClientImpl* client_impl = nullptr;
     };
 
+    /**
+     * @brief Main context where the SDK core is dispatched
+     */
+    enum class MainContext {
+        Default, /**< Application's default GMainContext */
+        Dedicated /**< Dedicated GMainContext on the SDK thread */
+    };
+
     NuguClient();
+
+    /**
+     * @brief Create NuguClient with the main context option.
+     *
+     * With MainContext::Dedicated, the SDK core runs on its own thread so the
+     * voice pipeline is not delayed by the application main loop.
+     * The lifecycle functions of NuguClient (loadPlugins, initialize, ...) are
+     * marshalled to the SDK thread, but all listeners are invoked on the SDK
+     * thread, and the other SDK functions should be called on the SDK thread
+     * using NuguRunner.
+     * @param[in] main_context main context option
+     */
+    explicit NuguClient(MainContext main_context);
     ~NuguClient();
 
     /**
@@ -159,6 +182,21 @@ public:
      */
     void removeDialogUXStateListener(IDialogUXStateAggregatorListener* listener);
 
+    /**
+     * @brief Get the snapshot of the SDK metrics
+     *
+     * The histogram is returned as the sum and the count with the '_sum'
+     * and '_count' suffixes.
+     * @return map of the metric name and the value
+     */
+    std::map<std::string, int64_t> getMetrics();
+
+    /**
+     * @brief Get the SDK metrics in the text exposition format
+     * @return metrics text (e.g. Prometheus)
+     */
+    std::string getMetricsText();
+
 private:
     std::unique_ptr<NuguClientImpl> impl;
     CapabilityBuilder* cap_builder;
@@ -310,9 +310,11 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(filedump,
+NUGU_PLUGIN_DEFINE_FULL(filedump,
 	NUGU_PLUGIN_PRIORITY_LOW,
 	"0.0.1",
 	load,
 	unload,
-	init);
+	init,
+	NUGU_PLUGIN_PROVIDES_PCM | NUGU_PLUGIN_PROVIDES_DECODER,
+	NUGU_PLUGIN_FLAG_LAZY);
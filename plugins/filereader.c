@@ -42,6 +42,7 @@ typedef SSIZE_T ssize_t;
 #endif
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_plugin.h"
 #include "base/nugu_recorder.h"
 
@@ -313,7 +314,8 @@ static int _rec_start(NuguRecorderDriver *driver, NuguRecorder *rec,
 
 	nugu_recorder_set_driver_data(rec, rec_param);
 
-	rec_param->idle_id = g_idle_add(_record_callback, (gpointer)rec);
+	rec_param->idle_id =
+		nugu_mainloop_idle_add(_record_callback, (gpointer)rec);
 
 	nugu_dbg("start done");
 	return 0;
@@ -342,7 +344,7 @@ static int _rec_stop(NuguRecorderDriver *driver, NuguRecorder *rec)
 	}
 
 	if (rec_param->idle_id) {
-		g_source_remove(rec_param->idle_id);
+		nugu_mainloop_source_remove(rec_param->idle_id);
 		rec_param->idle_id = 0;
 	}
 
@@ -413,11 +415,13 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(
+NUGU_PLUGIN_DEFINE_FULL(
 	filereader,
 	NUGU_PLUGIN_PRIORITY_LOW,
 	"0.0.1",
 	load,
 	unload,
-	init
+	init,
+	NUGU_PLUGIN_PROVIDES_RECORDER,
+	NUGU_PLUGIN_FLAG_LAZY
 );
@@ -913,9 +913,11 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(gstreamer,
+NUGU_PLUGIN_DEFINE_FULL(gstreamer,
 	NUGU_PLUGIN_PRIORITY_DEFAULT,
 	"0.0.1",
 	load,
 	unload,
-	init);
+	init,
+	NUGU_PLUGIN_PROVIDES_PLAYER,
+	NUGU_PLUGIN_FLAG_LAZY);
@@ -644,12 +644,14 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(
+NUGU_PLUGIN_DEFINE_FULL(
 	/* NUGU SDK Plug-in description */
 	gstreamer_recorder, /* Plugin name */
 	NUGU_PLUGIN_PRIORITY_DEFAULT, /* Plugin priority */
 	"0.0.1", /* Plugin version */
 	load, /* dlopen */
 	unload, /* dlclose */
-	init /* initialize */
+	init, /* initialize */
+	NUGU_PLUGIN_PROVIDES_RECORDER, /* Provided drivers */
+	NUGU_PLUGIN_FLAG_LAZY /* Flags */
 );
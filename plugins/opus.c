@@ -42,6 +42,7 @@
 #include "base/nugu_plugin.h"
 #include "base/nugu_decoder.h"
 #include "base/nugu_pcm.h"
+#include "base/nugu_sample.h"
 
 #define SAMPLING_RATES 24000
 #define CHANNELS 1
@@ -171,6 +172,63 @@ static int _decoder_create(NuguDecoderDriver *driver, NuguDecoder *dec)
 	return 0;
 }
 
+static void _dump_input(struct opus_data *od, const void *data,
+			size_t data_len)
+{
+	if (od->dump_fd == -1)
+		return;
+
+	if (write(od->dump_fd, data, data_len) < 0)
+		nugu_error("write to fd-%d failed", od->dump_fd);
+}
+
+/**
+ * opus 1 frame
+ *   := 168 bytes (4 bytes[len] + 4 bytes[range] + 160 bytes[payload])
+ * decoding result
+ *   := 480 samples (16bit) == 960 bytes
+ *
+ * Decode a frame and move the packet to the next frame.
+ * Return the number of samples, 0 to skip the frame or -1 on error.
+ */
+static int _decode_frame(struct opus_data *od, const unsigned char **packet,
+			 opus_int16 *sample)
+{
+	const unsigned char *p = *packet;
+	int len = READINT(p);
+	int nsamples;
+	uint32_t enc_final_range;
+	uint32_t dec_final_range;
+
+	p += 4;
+	*packet = p;
+
+	if (len > 160 || len == 0) {
+		nugu_error("invalid payload length(%d)", len);
+		return 0;
+	}
+
+	enc_final_range = READINT(p);
+	p += 4;
+
+	nsamples = opus_decode(od->handle, p, len, sample, PCM_SAMPLES, 0);
+	if (nsamples <= 0) {
+		dump_opus_error(nsamples);
+		return -1;
+	}
+
+	*packet = p + len;
+
+	opus_decoder_ctl(od->handle, OPUS_GET_FINAL_RANGE(&dec_final_range));
+	if (enc_final_range != dec_final_range) {
+		nugu_error("range coder status mismatch (0x%x != 0x%X)",
+			   enc_final_range, dec_final_range);
+		return 0;
+	}
+
+	return nsamples;
+}
+
 static int _decoder_decode(NuguDecoderDriver *driver, NuguDecoder *dec,
 			   const void *data, size_t data_len,
 			   NuguBuffer *out_buf)
@@ -178,61 +236,63 @@ static int _decoder_decode(NuguDecoderDriver *driver, NuguDecoder *dec,
 	struct opus_data *od;
 	const unsigned char *packet = data;
 	int nsamples;
-	uint32_t enc_final_range;
-	uint32_t dec_final_range;
 	opus_int16 sample[PCM_SAMPLES * CHANNELS];
 	char plain_pcm[PCM_SAMPLES * CHANNELS * 2];
-	int i;
 
 	od = nugu_decoder_get_driver_data(dec);
 
-	if (od->dump_fd != -1) {
-		if (write(od->dump_fd, data, data_len) < 0)
-			nugu_error("write to fd-%d failed", od->dump_fd);
-	}
+	_dump_input(od, data, data_len);
 
-	/**
-	 * opus 1 frame
-	 *   := 168 bytes (4 bytes[len] + 4 bytes[range] + 160 bytes[payload])
-	 * decoding result
-	 *   := 480 samples (16bit) == 960 bytes
-	 */
 	while (packet < (unsigned char *)data + data_len) {
-		int len = READINT(packet);
+		nsamples = _decode_frame(od, &packet, sample);
+		if (nsamples < 0)
+			break;
+		else if (nsamples == 0)
+			continue;
 
-		packet += 4;
+		nugu_sample_s16_to_le(sample, plain_pcm, nsamples);
+		nugu_buffer_add(out_buf, plain_pcm, nsamples * 2);
+	}
 
-		if (len > 160 || len == 0) {
-			nugu_error("invalid payload length(%d)", len);
-			continue;
-		}
+	return 0;
+}
+
+static int _decoder_decode_to_sink(NuguDecoderDriver *driver, NuguDecoder *dec,
+				   const void *data, size_t data_len)
+{
+	struct opus_data *od;
+	const unsigned char *packet = data;
+	int nsamples;
+	opus_int16 *sample;
 
-		enc_final_range = READINT(packet);
-		packet += 4;
+	od = nugu_decoder_get_driver_data(dec);
 
-		nsamples = opus_decode(od->handle, packet, len, sample,
-				       PCM_SAMPLES, 0);
-		if (nsamples <= 0) {
-			dump_opus_error(nsamples);
-			break;
-		}
+	_dump_input(od, data, data_len);
 
-		packet += len;
+	while (packet < (unsigned char *)data + data_len) {
+		/* decode directly into the pcm buffer of the sink */
+		sample = nugu_decoder_reserve_output(
+			dec, PCM_SAMPLES * CHANNELS * sizeof(opus_int16));
+		if (!sample)
+			return -1;
+
+		nsamples = _decode_frame(od, &packet, sample);
+		if (nsamples <= 0) {
+			/* release the reserved space of the skipped frame */
+			nugu_decoder_commit_output(dec, 0);
+			if (nsamples < 0)
+				break;
 
-		opus_decoder_ctl(od->handle,
-				 OPUS_GET_FINAL_RANGE(&dec_final_range));
-		if (enc_final_range != dec_final_range) {
-			nugu_error("range coder status mismatch (0x%x != 0x%X)",
-				   enc_final_range, dec_final_range);
 			continue;
 		}
 
-		for (i = 0; i < nsamples; i++) {
-			plain_pcm[2 * i] = sample[i] & 0xFF;
-			plain_pcm[2 * i + 1] = (sample[i] & 0xFF00) >> 8;
-		}
+#if G_BYTE_ORDER != G_LITTLE_ENDIAN
+		nugu_sample_s16_swap(sample, sample, nsamples * CHANNELS);
+#endif
 
-		nugu_buffer_add(out_buf, plain_pcm, nsamples * 2);
+		if (nugu_decoder_commit_output(
+			    dec, nsamples * CHANNELS * sizeof(opus_int16)) < 0)
+			return -1;
 	}
 
 	return 0;
@@ -263,10 +323,43 @@ static int _decoder_destroy(NuguDecoderDriver *driver, NuguDecoder *dec)
 	return 0;
 }
 
+static int _decoder_reset(NuguDecoderDriver *driver, NuguDecoder *dec)
+{
+	struct opus_data *od;
+	int err;
+
+	od = nugu_decoder_get_driver_data(dec);
+	if (!od) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	/* keep the allocated decoder and clear only the decoding state */
+	err = opus_decoder_ctl(od->handle, OPUS_RESET_STATE);
+	if (err != OPUS_OK) {
+		dump_opus_error(err);
+		return -1;
+	}
+
+#ifdef NUGU_ENV_DUMP_PATH_DECODER
+	if (od->dump_fd >= 0)
+		close(od->dump_fd);
+
+	od->dump_fd =
+		_dumpfile_open(getenv(NUGU_ENV_DUMP_PATH_DECODER), "opus");
+#endif
+
+	nugu_dbg("opus decoder reset");
+
+	return 0;
+}
+
 static struct nugu_decoder_driver_ops decoder_ops = {
 	.create = _decoder_create,
 	.decode = _decoder_decode,
-	.destroy = _decoder_destroy
+	.destroy = _decoder_destroy,
+	.decode_to_sink = _decoder_decode_to_sink,
+	.reset = _decoder_reset
 };
 
 static int init(NuguPlugin *p)
@@ -312,9 +405,11 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(opus,
+NUGU_PLUGIN_DEFINE_FULL(opus,
 	NUGU_PLUGIN_PRIORITY_DEFAULT,
 	"0.0.1",
 	load,
 	unload,
-	init);
+	init,
+	NUGU_PLUGIN_PROVIDES_DECODER,
+	0);
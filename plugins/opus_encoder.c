@@ -37,6 +37,7 @@
 #include "base/nugu_plugin.h"
 #include "base/nugu_encoder.h"
 #include "base/nugu_pcm.h"
+#include "base/nugu_sample.h"
 
 #define SAMPLERATE 16000
 #define CHANNELS 1
@@ -48,6 +49,9 @@
 
 #define MAX_PACKET_SIZE (PACKET_SIZE * 2)
 
+/* maximum target latency of the batching (NUGU_OPUS_ENCODER_BATCH) */
+#define MAX_BATCH_MSEC 200
+
 struct opus_data {
 	OpusEncoder *enc_handle;
 	ogg_stream_state os;
@@ -59,6 +63,16 @@ struct opus_data {
 
 	NuguBuffer *buf;
 
+	/* packets are kept in the ogg stream until the target latency */
+	int batch_msec;
+	int pending_samples;
+
+	/* statistics */
+	gint64 encode_usec;
+	size_t total_samples;
+	size_t total_bytes;
+	int total_outputs;
+
 #ifdef NUGU_ENV_DUMP_PATH_ENCODER
 	int dump_fd;
 #endif
@@ -165,18 +179,49 @@ static void setup_opus_tags(struct opus_data *od)
 	nugu_buffer_free(header, 1);
 }
 
-static void flush_stream(struct opus_data *od)
+static void flush_stream(struct opus_data *od, NuguBuffer *dest)
 {
 	ogg_page og;
 
 	memset(&og, 0, sizeof(ogg_page));
 
+	/* all pending packets are packed into the pages */
 	while (ogg_stream_flush(&od->os, &og) != 0) {
-		nugu_buffer_add(od->buf, og.header, og.header_len);
-		nugu_buffer_add(od->buf, og.body, og.body_len);
+		nugu_buffer_add(dest, og.header, og.header_len);
+		nugu_buffer_add(dest, og.body, og.body_len);
 	}
 }
 
+static void setup_headers(struct opus_data *od)
+{
+	setup_opus_head(od);
+	setup_opus_tags(od);
+
+	/* the header pages are sent with the first output */
+	flush_stream(od, od->buf);
+}
+
+static int _get_batch_msec(void)
+{
+#ifdef NUGU_ENV_OPUS_ENCODER_BATCH
+	const char *env = getenv(NUGU_ENV_OPUS_ENCODER_BATCH);
+	int msec;
+
+	if (!env)
+		return 0;
+
+	msec = atoi(env);
+	if (msec < 0)
+		msec = 0;
+	else if (msec > MAX_BATCH_MSEC)
+		msec = MAX_BATCH_MSEC;
+
+	return msec;
+#else
+	return 0;
+#endif
+}
+
 static int _encoder_create(NuguEncoderDriver *driver, NuguEncoder *enc,
 			   NuguAudioProperty property)
 {
@@ -199,6 +244,7 @@ static int _encoder_create(NuguEncoderDriver *driver, NuguEncoder *enc,
 	od->buf = nugu_buffer_new(4096);
 	od->packetno = 0;
 	od->granulepos = 0;
+	od->batch_msec = _get_batch_msec();
 	od->enc_handle = opus_encoder_create(SAMPLERATE, CHANNELS,
 					     OPUS_APPLICATION_VOIP, &err);
 
@@ -213,9 +259,10 @@ static int _encoder_create(NuguEncoderDriver *driver, NuguEncoder *enc,
 		return -1;
 	}
 
-	setup_opus_head(od);
-	setup_opus_tags(od);
-	flush_stream(od);
+	setup_headers(od);
+
+	if (od->batch_msec > 0)
+		nugu_dbg("batch the packets up to %d msec", od->batch_msec);
 
 	return 0;
 }
@@ -232,9 +279,8 @@ static int do_encode(struct opus_data *od, int is_last,
 	memset(&od->frames, 0, sizeof(od->frames));
 
 	if (buf) {
-		for (; i < samples; i++)
-			od->frames[i] = (0xFF & buf[2 * i + 1]) << 8 |
-					(0xFF & buf[2 * i]);
+		nugu_sample_s16_from_le(buf, od->frames, samples);
+		i = samples;
 	}
 
 	/* If samples < FRAME_SIZE, fill empty data */
@@ -271,43 +317,85 @@ static int _encoder_encode(NuguEncoderDriver *driver, NuguEncoder *enc,
 {
 	struct opus_data *od;
 	const unsigned char *buf = data;
+	gint64 begin;
+	size_t prev_size;
 	size_t i;
 
 	od = nugu_encoder_get_driver_data(enc);
 	if (!od)
 		return -1;
 
+	begin = g_get_monotonic_time();
+
 	if (data_len == 0) {
 		do_encode(od, is_last, NULL, 0);
+		od->pending_samples += FRAME_SIZE;
 	} else {
-		for (i = 0; i < data_len; i += READSIZE)
+		for (i = 0; i < data_len; i += READSIZE) {
 			do_encode(od, is_last, buf + i, READSIZE);
+			od->pending_samples += FRAME_SIZE;
+		}
 
 		od->packetno++;
 	}
 
-	flush_stream(od);
+	od->encode_usec += g_get_monotonic_time() - begin;
+
+	/* keep the packets until the target latency */
+	if (!is_last &&
+	    od->pending_samples * 1000 < od->batch_msec * SAMPLERATE)
+		return 0;
+
+	od->total_samples += od->pending_samples;
+	od->pending_samples = 0;
+
+	prev_size = nugu_buffer_get_size(out_buf);
+
+	/* header pages */
+	if (nugu_buffer_get_size(od->buf) > 0) {
+		nugu_buffer_add(out_buf, nugu_buffer_peek(od->buf),
+				nugu_buffer_get_size(od->buf));
+		nugu_buffer_clear(od->buf);
+	}
+
+	flush_stream(od, out_buf);
 
-	i = nugu_buffer_get_size(od->buf);
+	i = nugu_buffer_get_size(out_buf) - prev_size;
 	if (i <= 0)
 		return 0;
 
-	nugu_dbg("OPUS encoded %zd bytes (PCM %d)", i, data_len);
+	od->total_bytes += i;
+	od->total_outputs++;
 
-	nugu_buffer_add(out_buf, nugu_buffer_peek(od->buf), i);
+	nugu_dbg("OPUS encoded %zd bytes (PCM %d)", i, data_len);
 
 #ifdef NUGU_ENV_DUMP_PATH_ENCODER
 	if (od->dump_fd != -1) {
-		if (write(od->dump_fd, nugu_buffer_peek(od->buf), i) < 0)
+		if (write(od->dump_fd,
+			  (const char *)nugu_buffer_peek(out_buf) + prev_size,
+			  i) < 0)
 			nugu_error("write to fd-%d failed", od->dump_fd);
 	}
 #endif
 
-	nugu_buffer_clear(od->buf);
-
 	return 0;
 }
 
+static void _print_stats(struct opus_data *od)
+{
+	size_t msec = od->total_samples * 1000 / SAMPLERATE;
+
+	if (msec == 0)
+		return;
+
+	/* bytes-on-wire and cpu time per second of speech */
+	nugu_dbg("encoded %zd msec: %zd bytes in %d outputs, %zd bytes/sec, "
+		 "%zd usec/sec (batch %d msec)",
+		 msec, od->total_bytes, od->total_outputs,
+		 od->total_bytes * 1000 / msec,
+		 (size_t)od->encode_usec * 1000 / msec, od->batch_msec);
+}
+
 static int _encoder_destroy(NuguEncoderDriver *driver, NuguEncoder *enc)
 {
 	struct opus_data *od;
@@ -318,6 +406,8 @@ static int _encoder_destroy(NuguEncoderDriver *driver, NuguEncoder *enc)
 		return -1;
 	}
 
+	_print_stats(od);
+
 #ifdef NUGU_ENV_DUMP_PATH_ENCODER
 	if (od->dump_fd >= 0) {
 		close(od->dump_fd);
@@ -337,10 +427,61 @@ static int _encoder_destroy(NuguEncoderDriver *driver, NuguEncoder *enc)
 	return 0;
 }
 
+static int _encoder_reset(NuguEncoderDriver *driver, NuguEncoder *enc)
+{
+	struct opus_data *od;
+	int err;
+
+	od = nugu_encoder_get_driver_data(enc);
+	if (!od) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	_print_stats(od);
+
+	/* keep the allocated encoder and clear only the encoding state */
+	err = opus_encoder_ctl(od->enc_handle, OPUS_RESET_STATE);
+	if (err != OPUS_OK) {
+		nugu_error("opus_encoder_ctl() failed: %s", opus_strerror(err));
+		return -1;
+	}
+
+	/* start a new logical stream for the next utterance */
+	if (ogg_stream_reset_serialno(&(od->os), rand()) < 0) {
+		nugu_error("ogg_stream_reset_serialno() failed");
+		return -1;
+	}
+
+	od->packetno = 0;
+	od->granulepos = 0;
+	od->pending_samples = 0;
+	od->encode_usec = 0;
+	od->total_samples = 0;
+	od->total_bytes = 0;
+	od->total_outputs = 0;
+
+	nugu_buffer_clear(od->buf);
+	setup_headers(od);
+
+#ifdef NUGU_ENV_DUMP_PATH_ENCODER
+	if (od->dump_fd >= 0)
+		close(od->dump_fd);
+
+	od->dump_fd =
+		_dumpfile_open(getenv(NUGU_ENV_DUMP_PATH_ENCODER), "opus");
+#endif
+
+	nugu_dbg("opus encoder reset");
+
+	return 0;
+}
+
 static struct nugu_encoder_driver_ops encoder_ops = {
 	.create = _encoder_create,
 	.encode = _encoder_encode,
-	.destroy = _encoder_destroy
+	.destroy = _encoder_destroy,
+	.reset = _encoder_reset
 };
 
 static int init(NuguPlugin *p)
@@ -386,9 +527,11 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(opus_encoder,
+NUGU_PLUGIN_DEFINE_FULL(opus_encoder,
 	NUGU_PLUGIN_PRIORITY_DEFAULT,
 	"0.0.1",
 	load,
 	unload,
-	init);
+	init,
+	NUGU_PLUGIN_PROVIDES_ENCODER,
+	0);
@@ -40,12 +40,15 @@
 #include <portaudio.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_plugin.h"
 #include "base/nugu_pcm.h"
 #include "base/nugu_prof.h"
 
 #define FRAME_PER_BUFFER 512
 #define SAMPLE_SILENCE (0.0f)
+#define EOS_POLL_INTERVAL 50
+#define EOS_GUARD_TIME 500
 
 //#define DEBUG_PCM
 
@@ -62,13 +65,17 @@ struct pa_audio_param {
 
 	int stop;
 	int pause;
-	int done;
+	gint done; /* atomic: set by the audio callback */
 
 	int is_start;
 	int is_first;
 
 	guint timer;
 
+	/* push_data() is called on the decoder thread */
+	GMutex eos_lock;
+	guint eos_poller;
+
 #if defined(NUGU_ENV_DUMP_PATH_PCM)
 	int dump_fd;
 #endif
@@ -220,6 +227,51 @@ static gboolean _playerEndOfStream(void *userdata)
 	return FALSE;
 }
 
+static gboolean _pollEndOfStream(void *userdata)
+{
+	struct pa_audio_param *param = userdata;
+
+	if (!g_atomic_int_get(&param->done))
+		return TRUE;
+
+	g_mutex_lock(&param->eos_lock);
+	param->eos_poller = 0;
+	g_mutex_unlock(&param->eos_lock);
+
+	/* wait until the device plays out the remaining audio */
+	if (param->timer != 0)
+		nugu_mainloop_source_remove(param->timer);
+
+	param->timer = nugu_mainloop_timeout_add(EOS_GUARD_TIME,
+						 _playerEndOfStream, param);
+
+	return FALSE;
+}
+
+/* poll the end of stream after all the data is pushed */
+static void _add_eos_poller(struct pa_audio_param *param)
+{
+	g_mutex_lock(&param->eos_lock);
+
+	if (param->is_start && param->eos_poller == 0)
+		param->eos_poller = nugu_mainloop_timeout_add(
+			EOS_POLL_INTERVAL, _pollEndOfStream, param);
+
+	g_mutex_unlock(&param->eos_lock);
+}
+
+static void _remove_eos_poller(struct pa_audio_param *param)
+{
+	g_mutex_lock(&param->eos_lock);
+
+	if (param->eos_poller != 0) {
+		nugu_mainloop_source_remove(param->eos_poller);
+		param->eos_poller = 0;
+	}
+
+	g_mutex_unlock(&param->eos_lock);
+}
+
 /* This routine will be called by the PortAudio engine when audio is needed.
  * It may be called at interrupt level on some machines so don't do anything
  * that could mess up the system like calling malloc() or free().
@@ -234,7 +286,6 @@ static int _playbackCallback(const void *inputBuffer, void *outputBuffer,
 	char *buf = (char *)outputBuffer;
 	int finished = paContinue;
 	int buf_size = framesPerBuffer * param->samplebyte;
-	int guard_time = 500;
 
 	(void)inputBuffer; /* Prevent unused variable warnings. */
 	(void)timeInfo;
@@ -250,13 +301,13 @@ static int _playbackCallback(const void *inputBuffer, void *outputBuffer,
 	if (param->pause)
 		return finished;
 
-	if (nugu_pcm_get_data_size(pcm) > 0) {
+	/* lock-free read, the remaining area is filled with silence */
+	if (nugu_pcm_get_data(pcm, buf, buf_size) > 0) {
 		if (param->is_first) {
 			nugu_prof_mark(NUGU_PROF_TYPE_TTS_FIRST_PCM_WRITE);
 			param->is_first = 0;
 		}
 
-		nugu_pcm_get_data(pcm, buf, buf_size);
 		param->written += buf_size;
 
 #ifdef NUGU_ENV_DUMP_PATH_PCM
@@ -267,15 +318,8 @@ static int _playbackCallback(const void *inputBuffer, void *outputBuffer,
 		}
 #endif
 	} else if (nugu_pcm_receive_is_last_data(pcm)) {
-		// send event to the main loop thread
-		if (!param->done) {
-			if (param->timer != 0)
-				g_source_remove(param->timer);
-
-			param->timer = g_timeout_add(guard_time,
-						     _playerEndOfStream, param);
-			param->done = 1;
-		}
+		// the main loop polls the flag and sends the event
+		g_atomic_int_set(&param->done, 1);
 	}
 
 	if (param->stop)
@@ -295,12 +339,14 @@ static int _pcm_create(NuguPcmDriver *driver, NuguPcm *pcm,
 	int i;
 
 	pcm_param = g_malloc0(sizeof(struct pa_audio_param));
+	g_mutex_init(&pcm_param->eos_lock);
 
 #ifdef DEBUG_PCM
 	nugu_info("#### pcm(%p) param is created(%p) ####", pcm, pcm_param);
 #endif
 
 	if (_set_property_to_param(pcm_param, prop) != 0) {
+		g_mutex_clear(&pcm_param->eos_lock);
 		g_free(pcm_param);
 		return -1;
 	}
@@ -368,12 +414,15 @@ static void _pcm_destroy(NuguPcmDriver *driver, NuguPcm *pcm)
 	if (err != paNoError)
 		nugu_error("Pa_CloseStream return fail(%d)", err);
 
+	_remove_eos_poller(pcm_param);
+
 	if (pcm_param->timer) {
 		nugu_dbg("remove pending timer");
-		g_source_remove(pcm_param->timer);
+		nugu_mainloop_source_remove(pcm_param->timer);
 		pcm_param->timer = 0;
 	}
 
+	g_mutex_clear(&pcm_param->eos_lock);
 	g_free(pcm_param);
 	nugu_pcm_set_driver_data(pcm, NULL);
 
@@ -406,16 +455,24 @@ static int _pcm_start(NuguPcmDriver *driver, NuguPcm *pcm)
 
 	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_READY);
 
-	pcm_param->is_start = 1;
 	pcm_param->is_first = 1;
 	pcm_param->pause = 0;
 	pcm_param->stop = 0;
 	pcm_param->written = 0;
-	pcm_param->done = 0;
+	g_atomic_int_set(&pcm_param->done, 0);
+
+	g_mutex_lock(&pcm_param->eos_lock);
+	pcm_param->is_start = 1;
+	g_mutex_unlock(&pcm_param->eos_lock);
+
+	/* all the data is pushed before the start */
+	if (nugu_pcm_receive_is_last_data(pcm))
+		_add_eos_poller(pcm_param);
 
 	err = Pa_StartStream(pcm_param->stream);
 	if (err != paNoError) {
 		nugu_error("Pa_OpenStream return fail");
+		_remove_eos_poller(pcm_param);
 		g_free(pcm_param);
 		return -1;
 	}
@@ -461,7 +518,12 @@ static int _pcm_stop(NuguPcmDriver *driver, NuguPcm *pcm)
 		return -1;
 	}
 
+	g_mutex_lock(&pcm_param->eos_lock);
 	pcm_param->is_start = 0;
+	g_mutex_unlock(&pcm_param->eos_lock);
+
+	_remove_eos_poller(pcm_param);
+
 	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_STOPPED);
 
 	nugu_dbg("stop done");
@@ -568,6 +630,9 @@ static int _pcm_push_data(NuguPcmDriver *driver, NuguPcm *pcm, const char *data,
 	if (playing_flag)
 		nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_PLAYING);
 
+	if (is_last)
+		_add_eos_poller(pcm_param);
+
 	return 0;
 }
 
@@ -634,12 +699,14 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(
+NUGU_PLUGIN_DEFINE_FULL(
 	/* NUGU SDK Plug-in description */
 	portaudio_pcm_async, /* Plugin name */
 	NUGU_PLUGIN_PRIORITY_DEFAULT + 2, /* Plugin priority */
 	"0.0.2", /* Plugin version */
 	load, /* dlopen */
 	unload, /* dlclose */
-	init /* initialize */
+	init, /* initialize */
+	NUGU_PLUGIN_PROVIDES_PCM, /* Provided drivers */
+	NUGU_PLUGIN_FLAG_LAZY /* Flags */
 );
@@ -41,6 +41,7 @@
 #include <portaudio.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_plugin.h"
 #include "base/nugu_pcm.h"
 #include "base/nugu_prof.h"
@@ -230,7 +231,7 @@ static void *_play_loop(void *data)
 	size_t buf_size = 0;
 	PaError err;
 	int is_last = 0;
-	size_t data_size = 0;
+	int data_size;
 
 	pthread_mutex_lock(&pcm_param->lock);
 	pcm_param->flag = SYNC_FLAG_READY;
@@ -238,6 +239,8 @@ static void *_play_loop(void *data)
 	pthread_mutex_unlock(&pcm_param->lock);
 
 	while (pcm_param->running) {
+		data_size = 0;
+
 		/* wait for new data */
 		pthread_mutex_lock(&pcm_param->lock);
 		if (pcm_param->flag == SYNC_FLAG_READY)
@@ -250,19 +253,25 @@ static void *_play_loop(void *data)
 		} else if (pcm_param->flag == SYNC_FLAG_DATA) {
 			is_last = nugu_pcm_receive_is_last_data(pcm);
 
-			data_size = nugu_pcm_get_data_size(pcm);
-			if (data_size > 0) {
+			size_t size = nugu_pcm_get_data_size(pcm);
+
+			if (size > 0) {
 				/* resize the buffer */
-				if (data_size > buf_size) {
+				if (size > buf_size) {
 					if (buf)
 						free(buf);
 
-					buf_size = data_size;
+					buf_size = size;
 					buf = malloc(buf_size);
 				}
 
-				nugu_pcm_get_data(pcm, buf, buf_size);
-				pcm_param->written += buf_size;
+				data_size = nugu_pcm_get_data(pcm, buf, size);
+				if (data_size < 0) {
+					nugu_error("nugu_pcm_get_data() failed");
+					data_size = 0;
+				} else {
+					pcm_param->written += data_size;
+				}
 			}
 
 			pcm_param->flag = SYNC_FLAG_READY;
@@ -275,7 +284,7 @@ static void *_play_loop(void *data)
 		}
 
 		if (buf && data_size > 0) {
-			nugu_dbg("Pa_WriteStream %zd bytes", data_size);
+			nugu_dbg("Pa_WriteStream %d bytes", data_size);
 			err = Pa_WriteStream(pcm_param->stream, buf,
 					     data_size / pcm_param->samplebyte);
 			if (err != paNoError) {
@@ -287,7 +296,7 @@ static void *_play_loop(void *data)
 
 			if (is_last) {
 				nugu_dbg("last pcm data");
-				g_idle_add(_playerEndOfStream, pcm);
+				nugu_mainloop_idle_add(_playerEndOfStream, pcm);
 			}
 		}
 	}
@@ -672,12 +681,14 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(
+NUGU_PLUGIN_DEFINE_FULL(
 	/* NUGU SDK Plug-in description */
 	portaudio_pcm_sync, /* Plugin name */
 	NUGU_PLUGIN_PRIORITY_DEFAULT + 3, /* Plugin priority */
 	"0.0.2", /* Plugin version */
 	load, /* dlopen */
 	unload, /* dlclose */
-	init /* initialize */
+	init, /* initialize */
+	NUGU_PLUGIN_PROVIDES_PCM, /* Provided drivers */
+	NUGU_PLUGIN_FLAG_LAZY /* Flags */
 );
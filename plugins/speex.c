@@ -275,9 +275,11 @@ static void unload(NuguPlugin *p)
 	nugu_dbg("'%s' plugin unloaded", nugu_plugin_get_description(p)->name);
 }
 
-NUGU_PLUGIN_DEFINE(speex,
+NUGU_PLUGIN_DEFINE_FULL(speex,
 	NUGU_PLUGIN_PRIORITY_DEFAULT,
 	"0.0.1",
 	load,
 	unload,
-	init);
+	init,
+	NUGU_PLUGIN_PROVIDES_ENCODER,
+	0);
@@ -25,6 +25,8 @@
 #include "base/nugu_equeue.h"
 #include "base/nugu_log.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_span.h"
+#include "base/nugu_trace.h"
 
 #include "dg_types.h"
 
@@ -153,6 +155,7 @@ static void on_parsing_header(MultipartParser* parser, const char* data,
 
 static void _body_json(DirParser* dp, const char* data, size_t length)
 {
+    NuguSpanScope span("_body_json");
     NJson::Value root;
     NJson::Value dir_list;
     NJson::ArrayIndex list_size;
@@ -178,6 +181,10 @@ static void _body_json(DirParser* dp, const char* data, size_t length)
     if (dp->json_cb)
         dp->json_cb(dp, data, dp->json_cb_userdata);
 
+    if (nugu_trace_is_enabled())
+        nugu_trace_write(NUGU_TRACE_ID_DIRECTIVES,
+            (dp->debug_msg) ? dp->debug_msg : "", (int)length, data);
+
     if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROTOCOL) != 0) {
         std::string dump;
         int limit;
@@ -42,6 +42,7 @@ typedef SSIZE_T ssize_t;
 #include "curl/curl.h"
 
 #include "base/nugu_log.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_network_manager.h"
 
 #include "threadsync.h"
@@ -81,6 +82,9 @@ struct _http2_network {
 	CURLM *handle;
 	GList *hlist;
 
+	/* number of the handles in the hlist (shared by all networks) */
+	NuguMetric *active_streams;
+
 	/* authorization header */
 	gchar *token;
 
@@ -202,10 +206,23 @@ static int _process_add(HTTP2Network *net, struct request_item *item)
 	}
 
 	net->hlist = g_list_append(net->hlist, curl_h);
+	nugu_metric_add(net->active_streams, 1);
 
 	return 0;
 }
 
+static void _hlist_remove(HTTP2Network *net, CURL *curl_h)
+{
+	GList *link;
+
+	link = g_list_find(net->hlist, curl_h);
+	if (link == NULL)
+		return;
+
+	net->hlist = g_list_delete_link(net->hlist, link);
+	nugu_metric_add(net->active_streams, -1);
+}
+
 static int _process_remove(HTTP2Network *net, struct request_item *item)
 {
 	CURLMcode rc;
@@ -232,7 +249,7 @@ static int _process_remove(HTTP2Network *net, struct request_item *item)
 		return -1;
 	}
 
-	net->hlist = g_list_remove(net->hlist, curl_h);
+	_hlist_remove(net, curl_h);
 
 	pthread_mutex_lock(&net->lock);
 	g_hash_table_remove(net->hash, GINT_TO_POINTER(item->req_id));
@@ -316,7 +333,7 @@ static void _process_completed(HTTP2Network *net, CURLMsg *curl_message)
 	_curl_code_to_result(req, curl_message->data.result);
 
 	curl_multi_remove_handle(net->handle, curl_message->easy_handle);
-	net->hlist = g_list_remove(net->hlist, curl_message->easy_handle);
+	_hlist_remove(net, curl_message->easy_handle);
 
 	req_id = http2_request_get_id(req);
 	pthread_mutex_lock(&net->lock);
@@ -445,6 +462,8 @@ static void *_loop(void *data)
 			cur = cur->next;
 		}
 
+		nugu_metric_add(net->active_streams,
+				-(int64_t)g_list_length(net->hlist));
 		g_list_free(net->hlist);
 		net->hlist = NULL;
 	}
@@ -473,6 +492,10 @@ HTTP2Network *http2_network_new(void)
 	net->wakeup_fds[0] = -1;
 	net->wakeup_fds[1] = -1;
 
+	net->active_streams = nugu_metrics_register(
+		"nugu_http2_active_streams", NUGU_METRIC_TYPE_GAUGE,
+		"Number of the HTTP/2 streams in progress");
+
 #ifdef USE_WINSOCK
 	net->wsock = nugu_winsock_create();
 	if (net->wsock == NULL) {
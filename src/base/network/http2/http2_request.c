@@ -29,7 +29,10 @@
 #include "curl/curl.h"
 
 #include "base/nugu_log.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_span.h"
+#include "base/nugu_trace.h"
 
 #include "nugu_curl_log.h"
 #include "http2_request.h"
@@ -79,8 +82,30 @@ struct _http2_request {
 	char *msg_id;
 	char *dialog_id;
 	char *profiling_contents;
+
+	/* Global byte counters */
+	NuguMetric *sent_bytes;
+	NuguMetric *received_bytes;
 };
 
+static NuguMetric *_sent_bytes_metric;
+static NuguMetric *_received_bytes_metric;
+
+/* length of the text part at the head of the body (e.g. part headers) */
+static int _get_text_length(const char *data, size_t length)
+{
+	size_t i;
+
+	for (i = 0; i < length; i++) {
+		unsigned char c = (unsigned char)data[i];
+
+		if (c < 0x20 && c != '\r' && c != '\n' && c != '\t')
+			break;
+	}
+
+	return (int)i;
+}
+
 static size_t _request_body_cb(char *buffer, size_t size, size_t nitems,
 			       void *userdata)
 {
@@ -114,10 +139,25 @@ static size_t _request_body_cb(char *buffer, size_t size, size_t nitems,
 		return 0;
 	}
 
+	nugu_span_begin("_request_body_cb");
+
 	memcpy(buffer, nugu_buffer_peek(req->send_body), length);
 
 	nugu_dbg("Sent req(%p) %d bytes", req, length);
 
+	/* the binary attachment in the body is not traced */
+	if (nugu_trace_is_enabled())
+		nugu_trace_write(NUGU_TRACE_ID_EVENT,
+				 (req->type ==
+				  HTTP2_REQUEST_CONTENT_TYPE_MULTIPART) ?
+					 "multipart " :
+					 "",
+				 req,
+				 (req->type == HTTP2_REQUEST_CONTENT_TYPE_JSON) ?
+					 (int)length :
+					 _get_text_length(buffer, length),
+				 buffer);
+
 	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROTOCOL) != 0) {
 		int limit = nugu_log_get_protocol_line_limit();
 		const char *multipart = "";
@@ -160,6 +200,10 @@ static size_t _request_body_cb(char *buffer, size_t size, size_t nitems,
 
 	http2_request_unlock_send_data(req);
 
+	nugu_metric_add(req->sent_bytes, (int64_t)length);
+
+	nugu_span_end("_request_body_cb");
+
 	return length;
 }
 
@@ -168,11 +212,17 @@ static size_t _response_body_cb(char *ptr, size_t size, size_t nmemb,
 {
 	HTTP2Request *req = userdata;
 
+	nugu_span_begin("_response_body_cb");
+
+	nugu_metric_add(req->received_bytes, (int64_t)(size * nmemb));
+
 	if (req->body_cb)
 		req->body_cb(req, ptr, size, nmemb, req->body_cb_userdata);
 	else
 		nugu_buffer_add(req->response_body, ptr, size * nmemb);
 
+	nugu_span_end("_response_body_cb");
+
 	return size * nmemb;
 }
 
@@ -181,6 +231,8 @@ static size_t _response_header_cb(char *buffer, size_t size, size_t nmemb,
 {
 	HTTP2Request *req = userdata;
 
+	nugu_span_begin("_response_header_cb");
+
 	if (req->code == -1) {
 		long code = 0;
 
@@ -206,6 +258,8 @@ static size_t _response_header_cb(char *buffer, size_t size, size_t nmemb,
 	else
 		nugu_buffer_add(req->response_header, buffer, size * nmemb);
 
+	nugu_span_end("_response_header_cb");
+
 	return size * nmemb;
 }
 
@@ -225,6 +279,19 @@ HTTP2Request *http2_request_new(void)
 	req->response_header = nugu_buffer_new(0);
 	req->response_body = nugu_buffer_new(0);
 	req->send_body = nugu_buffer_new(0);
+	nugu_buffer_set_memory_tag(req->response_header,
+					   NUGU_MEMORY_TAG_NETWORK);
+	nugu_buffer_set_memory_tag(req->response_body, NUGU_MEMORY_TAG_NETWORK);
+	nugu_buffer_set_memory_tag(req->send_body, NUGU_MEMORY_TAG_NETWORK);
+
+	req->sent_bytes = nugu_metrics_register_once(
+		&_sent_bytes_metric, "nugu_http2_sent_bytes",
+		NUGU_METRIC_TYPE_COUNTER,
+		"Total bytes of the HTTP/2 request bodies");
+	req->received_bytes = nugu_metrics_register_once(
+		&_received_bytes_metric, "nugu_http2_received_bytes",
+		NUGU_METRIC_TYPE_COUNTER,
+		"Total bytes of the HTTP/2 response bodies");
 
 	req->easy = curl_easy_init();
 
@@ -21,6 +21,7 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_buffer.h"
+#include "base/nugu_span.h"
 
 #include "multipart_parser.h"
 
@@ -125,6 +126,8 @@ MultipartParser *multipart_parser_new(void)
 
 	parser->header = nugu_buffer_new(0);
 	parser->body = nugu_buffer_new(0);
+	nugu_buffer_set_memory_tag(parser->header, NUGU_MEMORY_TAG_NETWORK);
+	nugu_buffer_set_memory_tag(parser->body, NUGU_MEMORY_TAG_NETWORK);
 	parser->step = STEP_READY;
 	parser->data = NULL;
 
@@ -206,6 +209,8 @@ int multipart_parser_parse(MultipartParser *parser, const char *src,
 	g_return_val_if_fail(parser != NULL, -1);
 	g_return_val_if_fail(src != NULL, -1);
 
+	nugu_span_begin("multipart_parser_parse");
+
 	end = src + length;
 	b_pos = parser->boundary;
 	b_end = parser->boundary + parser->boundary_length - 1;
@@ -390,6 +395,8 @@ int multipart_parser_parse(MultipartParser *parser, const char *src,
 		}
 	}
 
+	nugu_span_end("multipart_parser_parse");
+
 	return 0;
 }
 
@@ -20,6 +20,7 @@
 #include <glib.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_trace.h"
 
 #include "http2_request.h"
 #include "v1_event_attachment.h"
@@ -123,6 +124,10 @@ int v1_event_attachment_set_data(V1EventAttachment *attach,
 /* invoked in a thread loop */
 static void _on_finish(HTTP2Request *req, void *userdata)
 {
+	if (nugu_trace_is_enabled())
+		nugu_trace_write(NUGU_TRACE_ID_EVENT_ATTACHMENT,
+				 http2_request_peek_url(req));
+
 	nugu_log_protocol_send(NUGU_LOG_LEVEL_INFO, "EventAttachment\n%s",
 			       http2_request_peek_url(req));
 }
@@ -21,6 +21,7 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_equeue.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_prof.h"
 
 #include "http2_request.h"
@@ -59,7 +60,7 @@ void v1_ping_free(V1Ping *ping)
 	g_return_if_fail(ping != NULL);
 
 	if (ping->timer_src)
-		g_source_remove(ping->timer_src);
+		nugu_mainloop_source_remove(ping->timer_src);
 
 	if (ping->url)
 		g_free(ping->url);
@@ -140,8 +141,8 @@ static gboolean _on_timeout(gpointer userdata)
 
 	http2_request_unref(req);
 
-	ping->timer_src = g_timeout_add_seconds(_get_next_timeout(ping),
-						_on_timeout, ping);
+	ping->timer_src = nugu_mainloop_timeout_add_seconds(
+		_get_next_timeout(ping), _on_timeout, ping);
 
 	return FALSE;
 }
@@ -152,8 +153,8 @@ int v1_ping_establish(V1Ping *ping, HTTP2Network *net)
 	g_return_val_if_fail(net != NULL, -1);
 
 	ping->network = net;
-	ping->timer_src = g_timeout_add_seconds(_get_next_timeout(ping),
-						_on_timeout, ping);
+	ping->timer_src = nugu_mainloop_timeout_add_seconds(
+		_get_next_timeout(ping), _on_timeout, ping);
 
 	return 0;
 }
@@ -25,6 +25,7 @@
 #include "base/nugu_equeue.h"
 #include "base/nugu_log.h"
 #include "base/nugu_network_manager.h"
+#include "base/nugu_trace.h"
 
 #include "dg_types.h"
 #include "http2/http2_request.h"
@@ -194,8 +195,13 @@ static void _on_finish(HTTP2Request* req, void* userdata)
         return;
     }
 
-    dump = writer.write(root);
-    nugu_log_protocol_recv(NUGU_LOG_LEVEL_INFO, "Policy\n%s", dump.c_str());
+    if (nugu_trace_is_enabled())
+        nugu_trace_write(NUGU_TRACE_ID_POLICY, (int)nugu_buffer_get_size(buf), message);
+
+    if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROTOCOL) != 0) {
+        dump = writer.write(root);
+        nugu_log_protocol_recv(NUGU_LOG_LEVEL_INFO, "Policy\n%s", dump.c_str());
+    }
 
     if (_parse_health_policy(root) < 0)
         return;
@@ -276,8 +276,10 @@ V2Events *v2_events_new(const char *host, HTTP2Network *net,
 	g_free(tmp);
 
 	buffer = nugu_buffer_new(0);
-	if (buffer)
+	if (buffer) {
+		nugu_buffer_set_memory_tag(buffer, NUGU_MEMORY_TAG_JSON);
 		dir_parser_set_json_buffer(parser, buffer);
+	}
 
 	dir_parser_set_directive_callback(parser, _directive_cb, event->req);
 	dir_parser_set_end_callback(parser, _end_cb, event->req);
@@ -21,6 +21,7 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_buffer.h"
+#include "base/nugu_memory.h"
 
 #ifndef CONFIG_DEFAULT_BUFFER_SIZE
 #define CONFIG_DEFAULT_BUFFER_SIZE 1024
@@ -30,13 +31,15 @@ struct _nugu_buffer {
 	size_t alloc_size;
 	size_t index;
 	unsigned char *data;
+	enum nugu_memory_tag tag;
 };
 
 NuguBuffer *nugu_buffer_new(size_t default_size)
 {
 	NuguBuffer *buf;
 
-	buf = calloc(1, sizeof(struct _nugu_buffer));
+	buf = nugu_memory_alloc(NUGU_MEMORY_TAG_BUFFER,
+				sizeof(struct _nugu_buffer));
 	if (!buf) {
 		nugu_error_nomem();
 		return NULL;
@@ -44,13 +47,14 @@ NuguBuffer *nugu_buffer_new(size_t default_size)
 
 	buf->index = 0;
 	buf->alloc_size = default_size;
+	buf->tag = NUGU_MEMORY_TAG_BUFFER;
 
 	if (default_size == 0)
 		buf->alloc_size = CONFIG_DEFAULT_BUFFER_SIZE;
 
-	buf->data = calloc(1, buf->alloc_size);
+	buf->data = nugu_memory_alloc(buf->tag, buf->alloc_size);
 	if (!buf->data) {
-		free(buf);
+		nugu_memory_free(buf->tag, buf, sizeof(struct _nugu_buffer));
 		nugu_error_nomem();
 		return NULL;
 	}
@@ -60,26 +64,51 @@ NuguBuffer *nugu_buffer_new(size_t default_size)
 
 void *nugu_buffer_free(NuguBuffer *buf, int is_data_free)
 {
+	enum nugu_memory_tag tag;
+
 	g_return_val_if_fail(buf != NULL, NULL);
 
+	tag = buf->tag;
+
 	if (is_data_free == 0) {
 		void *return_data = buf->data;
 
+		/* the caller owns the data from now */
+		nugu_memory_sub(tag, buf->alloc_size);
+
 		memset(buf, 0, sizeof(struct _nugu_buffer));
-		free(buf);
+		nugu_memory_free(tag, buf, sizeof(struct _nugu_buffer));
 
 		return return_data;
 	}
 
 	memset(buf->data, 0, buf->alloc_size);
-	free(buf->data);
+	nugu_memory_free(tag, buf->data, buf->alloc_size);
 
 	memset(buf, 0, sizeof(struct _nugu_buffer));
-	free(buf);
+	nugu_memory_free(tag, buf, sizeof(struct _nugu_buffer));
 
 	return NULL;
 }
 
+void nugu_buffer_set_memory_tag(NuguBuffer *buf, enum nugu_memory_tag tag)
+{
+	size_t size;
+
+	g_return_if_fail(buf != NULL);
+	g_return_if_fail(tag < NUGU_MEMORY_TAG_MAX);
+
+	if (buf->tag == tag)
+		return;
+
+	/* move the accounted memory to the new tag */
+	size = sizeof(struct _nugu_buffer) + buf->alloc_size;
+	nugu_memory_add(tag, size);
+	nugu_memory_sub(buf->tag, size);
+
+	buf->tag = tag;
+}
+
 static int _buffer_resize(NuguBuffer *buf, size_t needed)
 {
 	size_t new_size = buf->alloc_size;
@@ -90,7 +119,8 @@ static int _buffer_resize(NuguBuffer *buf, size_t needed)
 	else
 		new_size += buf->alloc_size;
 
-	tmp = realloc(buf->data, new_size);
+	tmp = nugu_memory_realloc(buf->tag, buf->data, buf->alloc_size,
+				  new_size);
 	if (!tmp) {
 		nugu_error_nomem();
 		return -1;
@@ -0,0 +1,501 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_cache.h"
+
+#define CACHE_SUFFIX ".cache"
+#define CACHE_TMP_SUFFIX ".tmp"
+
+/* unique per writer, so concurrent writers of the same key don't collide */
+#define CACHE_TMP_TEMPLATE ".XXXXXX" CACHE_TMP_SUFFIX
+
+#ifdef _WIN32
+#define fdopen _fdopen
+#endif
+
+struct _cache_item {
+	char *name; /* hash of the key */
+	size_t size;
+	gint64 mtime;
+};
+
+struct _nugu_cache {
+	char *path;
+	size_t max_size;
+	size_t size;
+
+	/* most recently used item first */
+	GList *items;
+
+	struct nugu_cache_stats stats;
+};
+
+struct _nugu_cache_entry {
+	void *data;
+	size_t size;
+	int mapped;
+};
+
+struct _nugu_cache_writer {
+	NuguCache *cache;
+	char *name;
+	char *tmp_path;
+	FILE *fp;
+	size_t size;
+};
+
+static char *_make_name(const char *key)
+{
+	return g_compute_checksum_for_string(G_CHECKSUM_SHA1, key, -1);
+}
+
+static char *_make_path(NuguCache *cache, const char *name,
+			const char *suffix)
+{
+	char *file = g_strconcat(name, suffix, NULL);
+	char *path = g_build_filename(cache->path, file, NULL);
+
+	g_free(file);
+
+	return path;
+}
+
+static void _item_free(struct _cache_item *item)
+{
+	g_free(item->name);
+	g_free(item);
+}
+
+static GList *_find_item(NuguCache *cache, const char *name)
+{
+	GList *cur;
+
+	for (cur = cache->items; cur; cur = cur->next) {
+		if (!strcmp(((struct _cache_item *)cur->data)->name, name))
+			return cur;
+	}
+
+	return NULL;
+}
+
+static void _remove_item(NuguCache *cache, GList *link, int remove_file)
+{
+	struct _cache_item *item = link->data;
+
+	if (remove_file) {
+		char *path = _make_path(cache, item->name, CACHE_SUFFIX);
+
+		if (g_unlink(path) < 0)
+			nugu_error("unlink(%s) failed", path);
+
+		g_free(path);
+	}
+
+	cache->size -= item->size;
+	cache->items = g_list_delete_link(cache->items, link);
+	_item_free(item);
+}
+
+static void _evict(NuguCache *cache, size_t required)
+{
+	while (cache->items && cache->size + required > cache->max_size) {
+		GList *last = g_list_last(cache->items);
+
+		nugu_dbg("evict %s (%zd bytes)",
+			 ((struct _cache_item *)last->data)->name,
+			 ((struct _cache_item *)last->data)->size);
+		_remove_item(cache, last, 1);
+	}
+}
+
+static gint _compare_mtime(gconstpointer a, gconstpointer b)
+{
+	const struct _cache_item *item1 = a;
+	const struct _cache_item *item2 = b;
+
+	if (item1->mtime == item2->mtime)
+		return 0;
+
+	return (item1->mtime > item2->mtime) ? -1 : 1;
+}
+
+static void _load_items(NuguCache *cache)
+{
+	GDir *dir;
+	const char *file;
+
+	dir = g_dir_open(cache->path, 0, NULL);
+	if (!dir) {
+		nugu_error("g_dir_open(%s) failed", cache->path);
+		return;
+	}
+
+	while ((file = g_dir_read_name(dir)) != NULL) {
+		struct _cache_item *item;
+		GStatBuf st;
+		char *path;
+
+		path = g_build_filename(cache->path, file, NULL);
+
+		/* remove the file which is not committed */
+		if (g_str_has_suffix(file, CACHE_TMP_SUFFIX)) {
+			g_unlink(path);
+			g_free(path);
+			continue;
+		}
+
+		if (!g_str_has_suffix(file, CACHE_SUFFIX) ||
+		    g_stat(path, &st) < 0) {
+			g_free(path);
+			continue;
+		}
+
+		g_free(path);
+
+		item = g_malloc0(sizeof(struct _cache_item));
+		item->name = g_strndup(file, strlen(file) - strlen(CACHE_SUFFIX));
+		item->size = st.st_size;
+		item->mtime = st.st_mtime;
+
+		cache->items = g_list_prepend(cache->items, item);
+		cache->size += item->size;
+	}
+
+	g_dir_close(dir);
+
+	cache->items = g_list_sort(cache->items, _compare_mtime);
+	_evict(cache, 0);
+}
+
+static int _map_entry(NuguCacheEntry *entry, const char *path)
+{
+#ifndef _WIN32
+	void *data;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		nugu_error("open(%s) failed", path);
+		return -1;
+	}
+
+	data = mmap(NULL, entry->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		nugu_error("mmap(%s) failed", path);
+		return -1;
+	}
+
+	entry->data = data;
+	entry->mapped = 1;
+
+	return 0;
+#else
+	gchar *contents = NULL;
+	gsize length = 0;
+
+	if (!g_file_get_contents(path, &contents, &length, NULL)) {
+		nugu_error("can't read %s", path);
+		return -1;
+	}
+
+	entry->data = contents;
+	entry->size = length;
+	entry->mapped = 0;
+
+	return 0;
+#endif
+}
+
+NuguCache *nugu_cache_new(const char *path, size_t max_size)
+{
+	NuguCache *cache;
+
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(max_size > 0, NULL);
+
+	if (g_mkdir_with_parents(path, 0700) < 0) {
+		nugu_error("can't create the cache directory(%s)", path);
+		return NULL;
+	}
+
+	cache = g_malloc0(sizeof(struct _nugu_cache));
+	if (!cache) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	cache->path = g_strdup(path);
+	cache->max_size = max_size;
+
+	_load_items(cache);
+
+	nugu_dbg("cache(%s): %d entries, %zd bytes", path,
+		 g_list_length(cache->items), cache->size);
+
+	return cache;
+}
+
+void nugu_cache_free(NuguCache *cache)
+{
+	g_return_if_fail(cache != NULL);
+
+	g_list_free_full(cache->items, (GDestroyNotify)_item_free);
+	g_free(cache->path);
+
+	memset(cache, 0, sizeof(struct _nugu_cache));
+	g_free(cache);
+}
+
+NuguCacheEntry *nugu_cache_lookup(NuguCache *cache, const char *key)
+{
+	struct _cache_item *item;
+	NuguCacheEntry *entry;
+	GList *link;
+	char *name;
+	char *path;
+
+	g_return_val_if_fail(cache != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	name = _make_name(key);
+	link = _find_item(cache, name);
+	g_free(name);
+
+	if (!link || ((struct _cache_item *)link->data)->size == 0) {
+		cache->stats.misses++;
+		return NULL;
+	}
+
+	item = link->data;
+	path = _make_path(cache, item->name, CACHE_SUFFIX);
+
+	entry = g_malloc0(sizeof(struct _nugu_cache_entry));
+	entry->size = item->size;
+
+	if (_map_entry(entry, path) < 0) {
+		/* the file is removed or broken */
+		_remove_item(cache, link, 1);
+		g_free(entry);
+		g_free(path);
+		cache->stats.misses++;
+		return NULL;
+	}
+
+	/* move to the most recently used */
+	item->mtime = g_get_real_time() / G_USEC_PER_SEC;
+	g_utime(path, NULL);
+	g_free(path);
+
+	cache->items = g_list_remove_link(cache->items, link);
+	cache->items = g_list_concat(link, cache->items);
+
+	cache->stats.hits++;
+	cache->stats.hit_bytes += entry->size;
+
+	return entry;
+}
+
+const void *nugu_cache_entry_peek_data(NuguCacheEntry *entry, size_t *size)
+{
+	g_return_val_if_fail(entry != NULL, NULL);
+
+	if (size)
+		*size = entry->size;
+
+	return entry->data;
+}
+
+void nugu_cache_entry_free(NuguCacheEntry *entry)
+{
+	g_return_if_fail(entry != NULL);
+
+#ifndef _WIN32
+	if (entry->mapped)
+		munmap(entry->data, entry->size);
+	else
+		g_free(entry->data);
+#else
+	g_free(entry->data);
+#endif
+
+	g_free(entry);
+}
+
+NuguCacheWriter *nugu_cache_writer_new(NuguCache *cache, const char *key)
+{
+	NuguCacheWriter *writer;
+	int fd;
+
+	g_return_val_if_fail(cache != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	writer = g_malloc0(sizeof(struct _nugu_cache_writer));
+	if (!writer) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	writer->cache = cache;
+	writer->name = _make_name(key);
+	writer->tmp_path = _make_path(cache, writer->name, CACHE_TMP_TEMPLATE);
+
+	fd = g_mkstemp(writer->tmp_path);
+	if (fd >= 0) {
+		writer->fp = fdopen(fd, "wb");
+		if (!writer->fp) {
+			g_close(fd, NULL);
+			g_unlink(writer->tmp_path);
+		}
+	}
+
+	if (!writer->fp) {
+		nugu_error("can't create %s", writer->tmp_path);
+		g_free(writer->tmp_path);
+		g_free(writer->name);
+		g_free(writer);
+		return NULL;
+	}
+
+	return writer;
+}
+
+int nugu_cache_writer_append(NuguCacheWriter *writer, const void *data,
+			     size_t size)
+{
+	g_return_val_if_fail(writer != NULL, -1);
+	g_return_val_if_fail(data != NULL, -1);
+
+	if (!writer->fp)
+		return -1;
+
+	if (writer->size + size > writer->cache->max_size) {
+		nugu_dbg("too big to cache");
+		fclose(writer->fp);
+		writer->fp = NULL;
+		return -1;
+	}
+
+	if (fwrite(data, 1, size, writer->fp) != size) {
+		nugu_error("fwrite(%s) failed", writer->tmp_path);
+		fclose(writer->fp);
+		writer->fp = NULL;
+		return -1;
+	}
+
+	writer->size += size;
+
+	return 0;
+}
+
+static void _writer_free(NuguCacheWriter *writer)
+{
+	if (writer->fp)
+		fclose(writer->fp);
+
+	g_unlink(writer->tmp_path);
+
+	g_free(writer->tmp_path);
+	g_free(writer->name);
+	g_free(writer);
+}
+
+int nugu_cache_writer_commit(NuguCacheWriter *writer)
+{
+	NuguCache *cache;
+	struct _cache_item *item;
+	GList *link;
+	char *path;
+	int ret;
+
+	g_return_val_if_fail(writer != NULL, -1);
+
+	cache = writer->cache;
+
+	if (!writer->fp || writer->size == 0 || fclose(writer->fp) != 0) {
+		writer->fp = NULL;
+		_writer_free(writer);
+		return -1;
+	}
+
+	writer->fp = NULL;
+
+	link = _find_item(cache, writer->name);
+	if (link)
+		_remove_item(cache, link, 0);
+
+	_evict(cache, writer->size);
+
+	path = _make_path(cache, writer->name, CACHE_SUFFIX);
+#ifdef _WIN32
+	/* rename() doesn't replace the existing file on windows */
+	g_unlink(path);
+#endif
+	ret = g_rename(writer->tmp_path, path);
+	g_free(path);
+
+	if (ret < 0) {
+		nugu_error("rename(%s) failed", writer->tmp_path);
+		_writer_free(writer);
+		return -1;
+	}
+
+	item = g_malloc0(sizeof(struct _cache_item));
+	item->name = g_strdup(writer->name);
+	item->size = writer->size;
+	item->mtime = g_get_real_time() / G_USEC_PER_SEC;
+
+	cache->items = g_list_prepend(cache->items, item);
+	cache->size += item->size;
+
+	_writer_free(writer);
+
+	return 0;
+}
+
+void nugu_cache_writer_abort(NuguCacheWriter *writer)
+{
+	g_return_if_fail(writer != NULL);
+
+	_writer_free(writer);
+}
+
+void nugu_cache_get_stats(NuguCache *cache, struct nugu_cache_stats *stats)
+{
+	g_return_if_fail(cache != NULL);
+	g_return_if_fail(stats != NULL);
+
+	memcpy(stats, &cache->stats, sizeof(struct nugu_cache_stats));
+	stats->size = cache->size;
+	stats->entries = g_list_length(cache->items);
+}
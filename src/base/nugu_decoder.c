@@ -22,8 +22,10 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_decoder.h"
+#include "base/nugu_plugin.h"
 
 #define DEFAULT_DECODE_BUFFER_SIZE 65536
+#define DEFAULT_POOL_SIZE 2
 
 struct _nugu_decoder {
 	NuguDecoderDriver *driver;
@@ -31,20 +33,31 @@ struct _nugu_decoder {
 
 	NuguPcm *pcm;
 	NuguBuffer *buf;
+
+	/* decoded data to drop before passing to the pcm (seek) */
+	size_t skip_size;
+	char *reserved;
 };
 
 struct _nugu_decoder_driver {
 	char *name;
 	enum nugu_decoder_type type;
-	struct nugu_decoder_driver_ops *ops;
+	struct nugu_decoder_driver_ops ops;
 	int ref_count;
+
+	/* idle decoders which can be reused after reset */
+	GList *pool;
+	int pool_count;
+	int pool_size;
+	struct nugu_decoder_pool_stats stats;
+	GMutex lock;
 };
 
 static GList *_decoder_drivers;
 
-NuguDecoderDriver *nugu_decoder_driver_new(const char *name,
-					   enum nugu_decoder_type type,
-					   struct nugu_decoder_driver_ops *ops)
+NuguDecoderDriver *nugu_decoder_driver_new_with_size(
+	const char *name, enum nugu_decoder_type type,
+	struct nugu_decoder_driver_ops *ops, size_t ops_size)
 {
 	NuguDecoderDriver *driver;
 
@@ -54,19 +67,136 @@ NuguDecoderDriver *nugu_decoder_driver_new(const char *name,
 	driver = malloc(sizeof(struct _nugu_decoder_driver));
 	driver->name = g_strdup(name);
 	driver->type = type;
-	driver->ops = ops;
+	/* the operations unknown to the driver are not supported */
+	memset(&driver->ops, 0, sizeof(struct nugu_decoder_driver_ops));
+	memcpy(&driver->ops, ops,
+	       MIN(ops_size, sizeof(struct nugu_decoder_driver_ops)));
 	driver->ref_count = 0;
+	driver->pool = NULL;
+	driver->pool_count = 0;
+	driver->pool_size = DEFAULT_POOL_SIZE;
+	memset(&driver->stats, 0, sizeof(struct nugu_decoder_pool_stats));
+	g_mutex_init(&driver->lock);
 
 	return driver;
 }
 
+/* entry point of the drivers built against the older header */
+NuguDecoderDriver *(nugu_decoder_driver_new)(const char *name,
+					    enum nugu_decoder_type type,
+					    struct nugu_decoder_driver_ops *ops)
+{
+	return nugu_decoder_driver_new_with_size(name, type, ops,
+					     NUGU_DECODER_DRIVER_OPS_BASE_SIZE);
+}
+
+static int _decoder_destroy(NuguDecoder *dec)
+{
+	NuguDecoderDriver *driver = dec->driver;
+
+	if (driver->ops.destroy && driver->ops.destroy(driver, dec) < 0)
+		return -1;
+
+	if (dec->buf)
+		nugu_buffer_free(dec->buf, 1);
+
+	memset(dec, 0, sizeof(struct _nugu_decoder));
+	free(dec);
+
+	g_mutex_lock(&driver->lock);
+	driver->stats.destroyed++;
+	g_mutex_unlock(&driver->lock);
+
+	return 0;
+}
+
+/* detach the idle decoders exceeding the size from the pool */
+static GList *_pool_trim(NuguDecoderDriver *driver, int size)
+{
+	GList *removed = NULL;
+
+	g_mutex_lock(&driver->lock);
+
+	while (driver->pool_count > size) {
+		GList *last = g_list_last(driver->pool);
+
+		removed = g_list_prepend(removed, last->data);
+		driver->pool = g_list_delete_link(driver->pool, last);
+		driver->pool_count--;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return removed;
+}
+
+static void _pool_destroy(GList *list)
+{
+	GList *cur;
+
+	for (cur = list; cur; cur = cur->next)
+		_decoder_destroy(cur->data);
+
+	g_list_free(list);
+}
+
+static NuguDecoder *_pool_pop(NuguDecoderDriver *driver)
+{
+	NuguDecoder *dec = NULL;
+
+	g_mutex_lock(&driver->lock);
+
+	if (driver->pool) {
+		dec = driver->pool->data;
+		driver->pool = g_list_delete_link(driver->pool, driver->pool);
+		driver->pool_count--;
+		driver->ref_count++;
+		driver->stats.reused++;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return dec;
+}
+
+static int _pool_push(NuguDecoder *dec)
+{
+	NuguDecoderDriver *driver = dec->driver;
+	int ret = -1;
+
+	if (driver->ops.reset == NULL)
+		return -1;
+
+	g_mutex_lock(&driver->lock);
+
+	if (driver->pool_count < driver->pool_size &&
+	    driver->ops.reset(driver, dec) == 0) {
+		nugu_buffer_clear(dec->buf);
+		dec->pcm = NULL;
+		dec->skip_size = 0;
+		dec->reserved = NULL;
+
+		driver->pool = g_list_prepend(driver->pool, dec);
+		driver->pool_count++;
+		driver->ref_count--;
+		ret = 0;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return ret;
+}
+
 int nugu_decoder_driver_free(NuguDecoderDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
+	_pool_destroy(_pool_trim(driver, 0));
+
 	if (driver->ref_count != 0)
 		return -1;
 
+	g_mutex_clear(&driver->lock);
 	g_free(driver->name);
 
 	memset(driver, 0, sizeof(struct _nugu_decoder_driver));
@@ -75,11 +205,27 @@ int nugu_decoder_driver_free(NuguDecoderDriver *driver)
 	return 0;
 }
 
+static NuguDecoderDriver *_find_driver(const char *name)
+{
+	GList *cur;
+
+	cur = _decoder_drivers;
+	while (cur) {
+		if (g_strcmp0(((NuguDecoderDriver *)cur->data)->name, name) ==
+		    0)
+			return cur->data;
+
+		cur = cur->next;
+	}
+
+	return NULL;
+}
+
 int nugu_decoder_driver_register(NuguDecoderDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
-	if (nugu_decoder_driver_find(driver->name)) {
+	if (_find_driver(driver->name)) {
 		nugu_error("'%s' decoder driver already exist.", driver->name);
 		return -1;
 	}
@@ -104,26 +250,19 @@ int nugu_decoder_driver_remove(NuguDecoderDriver *driver)
 
 NuguDecoderDriver *nugu_decoder_driver_find(const char *name)
 {
-	GList *cur;
-
 	g_return_val_if_fail(name != NULL, NULL);
 
-	cur = _decoder_drivers;
-	while (cur) {
-		if (g_strcmp0(((NuguDecoderDriver *)cur->data)->name, name) ==
-		    0)
-			return cur->data;
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_DECODER);
 
-		cur = cur->next;
-	}
-
-	return NULL;
+	return _find_driver(name);
 }
 
 NuguDecoderDriver *nugu_decoder_driver_find_bytype(enum nugu_decoder_type type)
 {
 	GList *cur;
 
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_DECODER);
+
 	cur = _decoder_drivers;
 	while (cur) {
 		if (((NuguDecoderDriver *)cur->data)->type == type)
@@ -135,29 +274,63 @@ NuguDecoderDriver *nugu_decoder_driver_find_bytype(enum nugu_decoder_type type)
 	return NULL;
 }
 
+int nugu_decoder_driver_set_pool_size(NuguDecoderDriver *driver, int size)
+{
+	g_return_val_if_fail(driver != NULL, -1);
+	g_return_val_if_fail(size >= 0, -1);
+
+	g_mutex_lock(&driver->lock);
+	driver->pool_size = size;
+	g_mutex_unlock(&driver->lock);
+
+	_pool_destroy(_pool_trim(driver, size));
+
+	return 0;
+}
+
+void nugu_decoder_driver_get_pool_stats(NuguDecoderDriver *driver,
+					struct nugu_decoder_pool_stats *stats)
+{
+	g_return_if_fail(driver != NULL);
+	g_return_if_fail(stats != NULL);
+
+	g_mutex_lock(&driver->lock);
+	memcpy(stats, &driver->stats, sizeof(struct nugu_decoder_pool_stats));
+	stats->pooled = driver->pool_count;
+	g_mutex_unlock(&driver->lock);
+}
+
 NuguDecoder *nugu_decoder_new(NuguDecoderDriver *driver, NuguPcm *sink)
 {
 	NuguDecoder *dec;
 
 	g_return_val_if_fail(driver != NULL, NULL);
 
+	dec = _pool_pop(driver);
+	if (dec) {
+		dec->pcm = sink;
+		return dec;
+	}
+
 	dec = malloc(sizeof(struct _nugu_decoder));
 	dec->driver = driver;
 	dec->pcm = sink;
 	dec->buf = nugu_buffer_new(DEFAULT_DECODE_BUFFER_SIZE);
 	dec->driver_data = NULL;
-
-	driver->ref_count++;
-
-	if (driver->ops->create == NULL)
-		return dec;
-
-	if (driver->ops->create(driver, dec) == 0)
+	dec->skip_size = 0;
+	dec->reserved = NULL;
+
+	if (driver->ops.create == NULL ||
+	    driver->ops.create(driver, dec) == 0) {
+		g_mutex_lock(&driver->lock);
+		driver->ref_count++;
+		driver->stats.created++;
+		g_mutex_unlock(&driver->lock);
 		return dec;
+	}
 
 	nugu_error("create() failed from driver");
 
-	driver->ref_count--;
 	nugu_buffer_free(dec->buf, 1);
 	memset(dec, 0, sizeof(struct _nugu_decoder));
 	free(dec);
@@ -167,19 +340,21 @@ NuguDecoder *nugu_decoder_new(NuguDecoderDriver *driver, NuguPcm *sink)
 
 int nugu_decoder_free(NuguDecoder *dec)
 {
+	NuguDecoderDriver *driver;
+
 	g_return_val_if_fail(dec != NULL, -1);
 
-	if (dec->driver->ops->destroy &&
-	    dec->driver->ops->destroy(dec->driver, dec) < 0)
-		return -1;
+	if (_pool_push(dec) == 0)
+		return 0;
 
-	dec->driver->ref_count--;
+	driver = dec->driver;
 
-	if (dec->buf)
-		nugu_buffer_free(dec->buf, 1);
+	if (_decoder_destroy(dec) < 0)
+		return -1;
 
-	memset(dec, 0, sizeof(struct _nugu_decoder));
-	free(dec);
+	g_mutex_lock(&driver->lock);
+	driver->ref_count--;
+	g_mutex_unlock(&driver->lock);
 
 	return 0;
 }
@@ -191,23 +366,52 @@ NuguPcm *nugu_decoder_get_pcm(NuguDecoder *dec)
 	return dec->pcm;
 }
 
+static size_t _skip_output(NuguDecoder *dec, size_t size)
+{
+	size_t skip = dec->skip_size;
+
+	if (skip == 0)
+		return 0;
+
+	if (skip > size)
+		skip = size;
+
+	nugu_dbg("seek pcm audio => %zd/%zd", skip, dec->skip_size);
+	dec->skip_size -= skip;
+
+	return skip;
+}
+
 int nugu_decoder_play(NuguDecoder *dec, const void *data, size_t data_len)
 {
 	int ret;
-	void *out;
+	const char *out;
 	size_t out_length;
+	size_t skip;
 
 	g_return_val_if_fail(dec != NULL, -1);
 	g_return_val_if_fail(data != NULL, -1);
 	g_return_val_if_fail(data_len > 0, -1);
 	g_return_val_if_fail(dec->driver != NULL, -1);
 
-	if (dec->driver->ops->decode == NULL) {
+	if (dec->pcm && dec->driver->ops.decode_to_sink) {
+		ret = dec->driver->ops.decode_to_sink(dec->driver, dec, data,
+						       data_len);
+		if (dec->reserved) {
+			nugu_error("reserved output is not committed");
+			nugu_pcm_commit_data(dec->pcm, 0, 0);
+			dec->reserved = NULL;
+		}
+
+		return (ret == 0) ? 0 : -1;
+	}
+
+	if (dec->driver->ops.decode == NULL) {
 		nugu_error("Not supported");
 		return -1;
 	}
 
-	ret = dec->driver->ops->decode(dec->driver, dec, data, data_len,
+	ret = dec->driver->ops.decode(dec->driver, dec, data, data_len,
 				       dec->buf);
 	if (ret != 0)
 		return -1;
@@ -215,19 +419,18 @@ int nugu_decoder_play(NuguDecoder *dec, const void *data, size_t data_len)
 	if (!dec->pcm)
 		return ret;
 
+	out = nugu_buffer_peek(dec->buf);
 	out_length = nugu_buffer_get_size(dec->buf);
-	out = nugu_buffer_pop(dec->buf, 0);
-	if (!out)
-		return -1;
+	skip = _skip_output(dec, out_length);
 
-	if (nugu_pcm_push_data(dec->pcm, out, out_length, 0) < 0) {
-		free(out);
-		return -1;
-	}
+	if (out_length > skip &&
+	    nugu_pcm_push_data(dec->pcm, out + skip, out_length - skip, 0) <
+		    0)
+		ret = -1;
 
-	free(out);
+	nugu_buffer_clear(dec->buf);
 
-	return 0;
+	return ret;
 }
 
 void *nugu_decoder_decode(NuguDecoder *dec, const void *data, size_t data_len,
@@ -235,6 +438,7 @@ void *nugu_decoder_decode(NuguDecoder *dec, const void *data, size_t data_len,
 {
 	int ret;
 	void *out;
+	size_t skip;
 
 	g_return_val_if_fail(dec != NULL, NULL);
 	g_return_val_if_fail(data != NULL, NULL);
@@ -242,16 +446,20 @@ void *nugu_decoder_decode(NuguDecoder *dec, const void *data, size_t data_len,
 	g_return_val_if_fail(dec->driver != NULL, NULL);
 	g_return_val_if_fail(output_len != NULL, NULL);
 
-	if (dec->driver->ops->decode == NULL) {
+	if (dec->driver->ops.decode == NULL) {
 		nugu_error("Not supported");
 		return NULL;
 	}
 
-	ret = dec->driver->ops->decode(dec->driver, dec, data, data_len,
+	ret = dec->driver->ops.decode(dec->driver, dec, data, data_len,
 				       dec->buf);
 	if (ret != 0)
 		return NULL;
 
+	skip = _skip_output(dec, nugu_buffer_get_size(dec->buf));
+	if (skip > 0)
+		nugu_buffer_shift_left(dec->buf, skip);
+
 	*output_len = nugu_buffer_get_size(dec->buf);
 
 	out = nugu_buffer_pop(dec->buf, 0);
@@ -261,6 +469,48 @@ void *nugu_decoder_decode(NuguDecoder *dec, const void *data, size_t data_len,
 	return out;
 }
 
+int nugu_decoder_set_skip_size(NuguDecoder *dec, size_t size)
+{
+	g_return_val_if_fail(dec != NULL, -1);
+
+	dec->skip_size = size;
+
+	return 0;
+}
+
+void *nugu_decoder_reserve_output(NuguDecoder *dec, size_t size)
+{
+	g_return_val_if_fail(dec != NULL, NULL);
+	g_return_val_if_fail(dec->pcm != NULL, NULL);
+
+	if (dec->reserved) {
+		nugu_warn("previous reserved output is not committed");
+		nugu_pcm_commit_data(dec->pcm, 0, 0);
+		dec->reserved = NULL;
+	}
+
+	dec->reserved = nugu_pcm_reserve_data(dec->pcm, size);
+
+	return dec->reserved;
+}
+
+int nugu_decoder_commit_output(NuguDecoder *dec, size_t size)
+{
+	size_t skip;
+
+	g_return_val_if_fail(dec != NULL, -1);
+	g_return_val_if_fail(dec->pcm != NULL, -1);
+	g_return_val_if_fail(dec->reserved != NULL, -1);
+
+	skip = _skip_output(dec, size);
+	if (skip > 0 && skip < size)
+		memmove(dec->reserved, dec->reserved + skip, size - skip);
+
+	dec->reserved = NULL;
+
+	return nugu_pcm_commit_data(dec->pcm, size - skip, 0);
+}
+
 int nugu_decoder_set_driver_data(NuguDecoder *dec, void *data)
 {
 	g_return_val_if_fail(dec != NULL, -1);
@@ -23,6 +23,7 @@
 #include "base/nugu_log.h"
 #include "base/nugu_buffer.h"
 #include "base/nugu_directive.h"
+#include "base/nugu_memory.h"
 
 struct _nugu_directive {
 	char *name_space;
@@ -43,12 +44,33 @@ struct _nugu_directive {
 
 	char *media_type;
 	NuguBuffer *buf;
+	int64_t data_msec;
 	NuguDirectiveDataCallback callback;
 	void *callback_userdata;
 
 	int ref_count;
 };
 
+static char *_strdup(const char *str)
+{
+	if (!str)
+		return NULL;
+
+	nugu_memory_add(NUGU_MEMORY_TAG_DIRECTIVE, strlen(str) + 1);
+
+	return g_strdup(str);
+}
+
+static void _strfree(char *str)
+{
+	if (!str)
+		return;
+
+	nugu_memory_sub(NUGU_MEMORY_TAG_DIRECTIVE, strlen(str) + 1);
+
+	g_free(str);
+}
+
 NuguDirective *nugu_directive_new(const char *name_space, const char *name,
 				  const char *version, const char *msg_id,
 				  const char *dialog_id,
@@ -65,22 +87,32 @@ NuguDirective *nugu_directive_new(const char *name_space, const char *name,
 	g_return_val_if_fail(json != NULL, NULL);
 	g_return_val_if_fail(groups != NULL, NULL);
 
-	ndir = calloc(1, sizeof(NuguDirective));
-	ndir->name_space = g_strdup(name_space);
-	ndir->name = g_strdup(name);
-	ndir->version = g_strdup(version);
-	ndir->msg_id = g_strdup(msg_id);
-	ndir->dialog_id = g_strdup(dialog_id);
-	ndir->referrer_id = g_strdup(referrer_id);
-	ndir->json = g_strdup(json);
-	ndir->groups = g_strdup(groups);
+	ndir = nugu_memory_alloc(NUGU_MEMORY_TAG_DIRECTIVE,
+				 sizeof(NuguDirective));
+	if (!ndir) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	ndir->name_space = _strdup(name_space);
+	ndir->name = _strdup(name);
+	ndir->version = _strdup(version);
+	ndir->msg_id = _strdup(msg_id);
+	ndir->dialog_id = _strdup(dialog_id);
+	ndir->referrer_id = _strdup(referrer_id);
+	ndir->json = _strdup(json);
+	ndir->groups = _strdup(groups);
 
 	ndir->policy_medium = NUGU_DIRECTIVE_MEDIUM_NONE;
 	ndir->is_policy_block = 0;
 
 	ndir->seq = -1;
 	ndir->is_active = 0;
+	ndir->data_msec = 0;
 	ndir->buf = nugu_buffer_new(0);
+	if (ndir->buf)
+		nugu_buffer_set_memory_tag(ndir->buf,
+					   NUGU_MEMORY_TAG_ATTACHMENT);
 	ndir->media_type = NULL;
 	ndir->ref_count = 1;
 
@@ -94,38 +126,39 @@ static void nugu_directive_free(NuguDirective *ndir)
 	nugu_info("destroy: %s.%s 'id=%s'", ndir->name_space, ndir->name,
 		  ndir->msg_id);
 
-	g_free(ndir->name_space);
+	_strfree(ndir->name_space);
 	ndir->name_space = NULL;
 
-	g_free(ndir->name);
+	_strfree(ndir->name);
 	ndir->name = NULL;
 
-	g_free(ndir->version);
+	_strfree(ndir->version);
 	ndir->version = NULL;
 
-	g_free(ndir->msg_id);
+	_strfree(ndir->msg_id);
 	ndir->msg_id = NULL;
 
-	g_free(ndir->dialog_id);
+	_strfree(ndir->dialog_id);
 	ndir->dialog_id = NULL;
 
-	g_free(ndir->referrer_id);
+	_strfree(ndir->referrer_id);
 	ndir->referrer_id = NULL;
 
-	g_free(ndir->json);
+	_strfree(ndir->json);
 	ndir->json = NULL;
 
-	g_free(ndir->groups);
+	_strfree(ndir->groups);
 	ndir->groups = NULL;
 
 	nugu_buffer_free(ndir->buf, 1);
 	ndir->buf = NULL;
 
 	if (ndir->media_type)
-		g_free(ndir->media_type);
+		_strfree(ndir->media_type);
 
 	memset(ndir, 0, sizeof(NuguDirective));
-	free(ndir);
+	nugu_memory_free(NUGU_MEMORY_TAG_DIRECTIVE, ndir,
+			 sizeof(NuguDirective));
 }
 
 void nugu_directive_ref(NuguDirective *ndir)
@@ -224,14 +257,14 @@ int nugu_directive_set_media_type(NuguDirective *ndir, const char *type)
 	g_return_val_if_fail(ndir != NULL, -1);
 
 	if (ndir->media_type) {
-		g_free(ndir->media_type);
+		_strfree(ndir->media_type);
 		ndir->media_type = NULL;
 	}
 
 	if (type == NULL)
 		return 0;
 
-	ndir->media_type = g_strdup(type);
+	ndir->media_type = _strdup(type);
 
 	return 0;
 }
@@ -264,6 +297,7 @@ int nugu_directive_add_data(NuguDirective *ndir, size_t length,
 		}
 
 		ndir->seq++;
+		ndir->data_msec = g_get_monotonic_time() / 1000;
 	}
 
 	if (nugu_directive_is_active(ndir) == 0) {
@@ -313,6 +347,13 @@ unsigned char *nugu_directive_get_data(NuguDirective *ndir, size_t *length)
 	return buf;
 }
 
+int64_t nugu_directive_get_data_time(const NuguDirective *ndir)
+{
+	g_return_val_if_fail(ndir != NULL, 0);
+
+	return ndir->data_msec;
+}
+
 size_t nugu_directive_get_data_size(const NuguDirective *ndir)
 {
 	size_t size;
@@ -22,28 +22,38 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_encoder.h"
+#include "base/nugu_plugin.h"
 
 #define DEFAULT_ENCODE_BUFFER_SIZE 4096
+#define DEFAULT_POOL_SIZE 2
 
 struct _nugu_encoder {
 	NuguEncoderDriver *driver;
 	void *driver_data;
 
 	NuguBuffer *buf;
+	NuguAudioProperty property;
 };
 
 struct _nugu_encoder_driver {
 	char *name;
 	enum nugu_encoder_type type;
-	struct nugu_encoder_driver_ops *ops;
+	struct nugu_encoder_driver_ops ops;
 	int ref_count;
+
+	/* idle encoders which can be reused after reset */
+	GList *pool;
+	int pool_count;
+	int pool_size;
+	struct nugu_encoder_pool_stats stats;
+	GMutex lock;
 };
 
 static GList *_encoder_drivers;
 
-NuguEncoderDriver *nugu_encoder_driver_new(const char *name,
-					   enum nugu_encoder_type type,
-					   struct nugu_encoder_driver_ops *ops)
+NuguEncoderDriver *nugu_encoder_driver_new_with_size(
+	const char *name, enum nugu_encoder_type type,
+	struct nugu_encoder_driver_ops *ops, size_t ops_size)
 {
 	NuguEncoderDriver *driver;
 
@@ -53,19 +63,147 @@ NuguEncoderDriver *nugu_encoder_driver_new(const char *name,
 	driver = malloc(sizeof(struct _nugu_encoder_driver));
 	driver->name = g_strdup(name);
 	driver->type = type;
-	driver->ops = ops;
+	/* the operations unknown to the driver are not supported */
+	memset(&driver->ops, 0, sizeof(struct nugu_encoder_driver_ops));
+	memcpy(&driver->ops, ops,
+	       MIN(ops_size, sizeof(struct nugu_encoder_driver_ops)));
 	driver->ref_count = 0;
+	driver->pool = NULL;
+	driver->pool_count = 0;
+	driver->pool_size = DEFAULT_POOL_SIZE;
+	memset(&driver->stats, 0, sizeof(struct nugu_encoder_pool_stats));
+	g_mutex_init(&driver->lock);
 
 	return driver;
 }
 
+/* entry point of the drivers built against the older header */
+NuguEncoderDriver *(nugu_encoder_driver_new)(const char *name,
+					    enum nugu_encoder_type type,
+					    struct nugu_encoder_driver_ops *ops)
+{
+	return nugu_encoder_driver_new_with_size(name, type, ops,
+					     NUGU_ENCODER_DRIVER_OPS_BASE_SIZE);
+}
+
+static int _encoder_destroy(NuguEncoder *enc)
+{
+	NuguEncoderDriver *driver = enc->driver;
+
+	if (driver->ops.destroy && driver->ops.destroy(driver, enc) < 0)
+		return -1;
+
+	if (enc->buf)
+		nugu_buffer_free(enc->buf, 1);
+
+	memset(enc, 0, sizeof(struct _nugu_encoder));
+	free(enc);
+
+	g_mutex_lock(&driver->lock);
+	driver->stats.destroyed++;
+	g_mutex_unlock(&driver->lock);
+
+	return 0;
+}
+
+/* detach the idle encoders exceeding the size from the pool */
+static GList *_pool_trim(NuguEncoderDriver *driver, int size)
+{
+	GList *removed = NULL;
+
+	g_mutex_lock(&driver->lock);
+
+	while (driver->pool_count > size) {
+		GList *last = g_list_last(driver->pool);
+
+		removed = g_list_prepend(removed, last->data);
+		driver->pool = g_list_delete_link(driver->pool, last);
+		driver->pool_count--;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return removed;
+}
+
+static void _pool_destroy(GList *list)
+{
+	GList *cur;
+
+	for (cur = list; cur; cur = cur->next)
+		_encoder_destroy(cur->data);
+
+	g_list_free(list);
+}
+
+static int _is_same_property(const NuguAudioProperty *a,
+			     const NuguAudioProperty *b)
+{
+	return (a->samplerate == b->samplerate && a->format == b->format &&
+		a->channel == b->channel);
+}
+
+static NuguEncoder *_pool_pop(NuguEncoderDriver *driver,
+			      const NuguAudioProperty *property)
+{
+	NuguEncoder *enc = NULL;
+	GList *cur;
+
+	g_mutex_lock(&driver->lock);
+
+	for (cur = driver->pool; cur; cur = cur->next) {
+		if (!_is_same_property(
+			    &((NuguEncoder *)cur->data)->property, property))
+			continue;
+
+		enc = cur->data;
+		driver->pool = g_list_delete_link(driver->pool, cur);
+		driver->pool_count--;
+		driver->ref_count++;
+		driver->stats.reused++;
+		break;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return enc;
+}
+
+static int _pool_push(NuguEncoder *enc)
+{
+	NuguEncoderDriver *driver = enc->driver;
+	int ret = -1;
+
+	if (driver->ops.reset == NULL)
+		return -1;
+
+	g_mutex_lock(&driver->lock);
+
+	if (driver->pool_count < driver->pool_size &&
+	    driver->ops.reset(driver, enc) == 0) {
+		nugu_buffer_clear(enc->buf);
+
+		driver->pool = g_list_prepend(driver->pool, enc);
+		driver->pool_count++;
+		driver->ref_count--;
+		ret = 0;
+	}
+
+	g_mutex_unlock(&driver->lock);
+
+	return ret;
+}
+
 int nugu_encoder_driver_free(NuguEncoderDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
+	_pool_destroy(_pool_trim(driver, 0));
+
 	if (driver->ref_count != 0)
 		return -1;
 
+	g_mutex_clear(&driver->lock);
 	g_free(driver->name);
 
 	memset(driver, 0, sizeof(struct _nugu_encoder_driver));
@@ -74,11 +212,27 @@ int nugu_encoder_driver_free(NuguEncoderDriver *driver)
 	return 0;
 }
 
+static NuguEncoderDriver *_find_driver(const char *name)
+{
+	GList *cur;
+
+	cur = _encoder_drivers;
+	while (cur) {
+		if (g_strcmp0(((NuguEncoderDriver *)cur->data)->name, name) ==
+		    0)
+			return cur->data;
+
+		cur = cur->next;
+	}
+
+	return NULL;
+}
+
 int nugu_encoder_driver_register(NuguEncoderDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
-	if (nugu_encoder_driver_find(driver->name)) {
+	if (_find_driver(driver->name)) {
 		nugu_error("'%s' encoder driver already exist.", driver->name);
 		return -1;
 	}
@@ -103,26 +257,19 @@ int nugu_encoder_driver_remove(NuguEncoderDriver *driver)
 
 NuguEncoderDriver *nugu_encoder_driver_find(const char *name)
 {
-	GList *cur;
-
 	g_return_val_if_fail(name != NULL, NULL);
 
-	cur = _encoder_drivers;
-	while (cur) {
-		if (g_strcmp0(((NuguEncoderDriver *)cur->data)->name, name) ==
-		    0)
-			return cur->data;
-
-		cur = cur->next;
-	}
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_ENCODER);
 
-	return NULL;
+	return _find_driver(name);
 }
 
 NuguEncoderDriver *nugu_encoder_driver_find_bytype(enum nugu_encoder_type type)
 {
 	GList *cur;
 
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_ENCODER);
+
 	cur = _encoder_drivers;
 	while (cur) {
 		if (((NuguEncoderDriver *)cur->data)->type == type)
@@ -134,6 +281,32 @@ NuguEncoderDriver *nugu_encoder_driver_find_bytype(enum nugu_encoder_type type)
 	return NULL;
 }
 
+int nugu_encoder_driver_set_pool_size(NuguEncoderDriver *driver, int size)
+{
+	g_return_val_if_fail(driver != NULL, -1);
+	g_return_val_if_fail(size >= 0, -1);
+
+	g_mutex_lock(&driver->lock);
+	driver->pool_size = size;
+	g_mutex_unlock(&driver->lock);
+
+	_pool_destroy(_pool_trim(driver, size));
+
+	return 0;
+}
+
+void nugu_encoder_driver_get_pool_stats(NuguEncoderDriver *driver,
+					struct nugu_encoder_pool_stats *stats)
+{
+	g_return_if_fail(driver != NULL);
+	g_return_if_fail(stats != NULL);
+
+	g_mutex_lock(&driver->lock);
+	memcpy(stats, &driver->stats, sizeof(struct nugu_encoder_pool_stats));
+	stats->pooled = driver->pool_count;
+	g_mutex_unlock(&driver->lock);
+}
+
 NuguEncoder *nugu_encoder_new(NuguEncoderDriver *driver,
 			      NuguAudioProperty property)
 {
@@ -141,22 +314,27 @@ NuguEncoder *nugu_encoder_new(NuguEncoderDriver *driver,
 
 	g_return_val_if_fail(driver != NULL, NULL);
 
+	enc = _pool_pop(driver, &property);
+	if (enc)
+		return enc;
+
 	enc = malloc(sizeof(struct _nugu_encoder));
 	enc->driver = driver;
 	enc->buf = nugu_buffer_new(DEFAULT_ENCODE_BUFFER_SIZE);
 	enc->driver_data = NULL;
-
-	driver->ref_count++;
-
-	if (driver->ops->create == NULL)
-		return enc;
-
-	if (driver->ops->create(driver, enc, property) == 0)
+	enc->property = property;
+
+	if (driver->ops.create == NULL ||
+	    driver->ops.create(driver, enc, property) == 0) {
+		g_mutex_lock(&driver->lock);
+		driver->ref_count++;
+		driver->stats.created++;
+		g_mutex_unlock(&driver->lock);
 		return enc;
+	}
 
 	nugu_error("create() failed from driver");
 
-	driver->ref_count--;
 	nugu_buffer_free(enc->buf, 1);
 	memset(enc, 0, sizeof(struct _nugu_encoder));
 	free(enc);
@@ -166,19 +344,21 @@ NuguEncoder *nugu_encoder_new(NuguEncoderDriver *driver,
 
 int nugu_encoder_free(NuguEncoder *enc)
 {
+	NuguEncoderDriver *driver;
+
 	g_return_val_if_fail(enc != NULL, -1);
 
-	if (enc->driver->ops->destroy &&
-	    enc->driver->ops->destroy(enc->driver, enc) < 0)
-		return -1;
+	if (_pool_push(enc) == 0)
+		return 0;
 
-	enc->driver->ref_count--;
+	driver = enc->driver;
 
-	if (enc->buf)
-		nugu_buffer_free(enc->buf, 1);
+	if (_encoder_destroy(enc) < 0)
+		return -1;
 
-	memset(enc, 0, sizeof(struct _nugu_encoder));
-	free(enc);
+	g_mutex_lock(&driver->lock);
+	driver->ref_count--;
+	g_mutex_unlock(&driver->lock);
 
 	return 0;
 }
@@ -194,12 +374,12 @@ void *nugu_encoder_encode(NuguEncoder *enc, int is_last, const void *data,
 	g_return_val_if_fail(enc->driver != NULL, NULL);
 	g_return_val_if_fail(output_len != NULL, NULL);
 
-	if (enc->driver->ops->encode == NULL) {
+	if (enc->driver->ops.encode == NULL) {
 		nugu_error("Not supported");
 		return NULL;
 	}
 
-	ret = enc->driver->ops->encode(enc->driver, enc, is_last, data,
+	ret = enc->driver->ops.encode(enc->driver, enc, is_last, data,
 				       data_len, enc->buf);
 	if (ret != 0)
 		return NULL;
@@ -38,6 +38,9 @@ typedef SSIZE_T ssize_t;
 
 #include "base/nugu_log.h"
 #include "base/nugu_equeue.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_metrics.h"
+#include "base/nugu_watchdog.h"
 
 struct _equeue_typemap {
 	NuguEqueueCallback callback;
@@ -51,8 +54,9 @@ struct _equeue {
 	 * - pipe is read with fds[0] and writes with fds[1].
 	 */
 	int fds[2];
-	guint source;
+	GSource *source;
 	GAsyncQueue *pendings;
+	NuguMetric *depth;
 	struct _equeue_typemap typemap[NUGU_EQUEUE_TYPE_MAX];
 #ifdef USE_WINSOCK
 	NuguWinSocket *wsock;
@@ -129,11 +133,26 @@ static gboolean on_event(GIOChannel *channel, GIOCondition cond,
 		if (!item)
 			break;
 
+		nugu_metric_add(_equeue->depth, -1);
+
 		handler = &_equeue->typemap[item->type];
-		if (handler->callback)
+		if (handler->callback) {
+			int64_t begin = nugu_watchdog_begin();
+
 			handler->callback(item->type, item->data,
 					  handler->userdata);
 
+			if (begin != 0) {
+				char tag[NUGU_WATCHDOG_MAX_TAG_LEN + 1];
+
+				snprintf(tag, sizeof(tag), "equeue:%d",
+					 item->type);
+				nugu_watchdog_end(tag, begin,
+						  (const void *)handler->callback,
+						  handler->userdata);
+			}
+		}
+
 		if (handler->destroy_callback)
 			handler->destroy_callback(item->data);
 
@@ -146,6 +165,7 @@ static gboolean on_event(GIOChannel *channel, GIOCondition cond,
 int nugu_equeue_initialize(void)
 {
 	GIOChannel *channel;
+	GSource *source;
 #if !defined(HAVE_EVENTFD) && !defined(USE_WINSOCK)
 	GError *error = NULL;
 #endif
@@ -208,10 +228,16 @@ int nugu_equeue_initialize(void)
 #else
 	channel = g_io_channel_unix_new(_equeue->fds[0]);
 #endif
-	_equeue->source = g_io_add_watch(channel, G_IO_IN, on_event, NULL);
+	source = g_io_create_watch(channel, G_IO_IN);
+	g_source_set_callback(source, (GSourceFunc)on_event, NULL, NULL);
+	g_source_attach(source, nugu_mainloop_get_context());
+	_equeue->source = source;
 	g_io_channel_unref(channel);
 
 	_equeue->pendings = g_async_queue_new_full(on_item_destroy);
+	_equeue->depth = nugu_metrics_register("nugu_equeue_depth",
+					       NUGU_METRIC_TYPE_GAUGE,
+					       "Number of pending equeue items");
 
 	pthread_mutex_unlock(&_lock);
 
@@ -236,8 +262,12 @@ void nugu_equeue_deinitialize(void)
 	if (_equeue->fds[1] != -1)
 		close(_equeue->fds[1]);
 #endif
-	if (_equeue->source > 0)
-		g_source_remove(_equeue->source);
+	if (_equeue->source) {
+		/* destroyed in the context which the source is attached to */
+		g_source_destroy(_equeue->source);
+		g_source_unref(_equeue->source);
+		_equeue->source = NULL;
+	}
 
 	if (_equeue->pendings) {
 		/* Remove pendings */
@@ -260,6 +290,7 @@ void nugu_equeue_deinitialize(void)
 		}
 
 		g_async_queue_unref(_equeue->pendings);
+		nugu_metric_set(_equeue->depth, 0);
 	}
 
 	free(_equeue);
@@ -345,6 +376,8 @@ int nugu_equeue_push(enum nugu_equeue_type type, void *data)
 	item->data = data;
 	item->type = type;
 
+	/* count before the push not to be popped first */
+	nugu_metric_add(_equeue->depth, 1);
 	g_async_queue_push(_equeue->pendings, item);
 
 #ifdef USE_WINSOCK
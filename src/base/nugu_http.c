@@ -24,8 +24,10 @@
 #include "curl/curl.h"
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_buffer.h"
 #include "base/nugu_http.h"
+#include "base/nugu_watchdog.h"
 
 #include "nugu_curl_log.h"
 
@@ -416,6 +418,9 @@ static void _curl_perform(NuguHttpRequest *req)
 static gboolean _on_thread_request_done(gpointer user_data)
 {
 	struct _nugu_http_request *req = user_data;
+	NuguHttpCallback callback;
+	void *callback_userdata;
+	int64_t begin;
 	int req_free;
 
 	req->async_completed = TRUE;
@@ -425,7 +430,15 @@ static gboolean _on_thread_request_done(gpointer user_data)
 		return FALSE;
 	}
 
+	callback = req->callback;
+	callback_userdata = req->callback_userdata;
+	begin = nugu_watchdog_begin();
+
 	req_free = req->callback(req, req->resp, req->callback_userdata);
+
+	nugu_watchdog_end("http_request_done", begin, (const void *)callback,
+			  callback_userdata);
+
 	if (req_free)
 		nugu_http_request_free(req);
 
@@ -438,7 +451,7 @@ static gpointer _on_thread_request(gpointer user_data)
 
 	_curl_perform(req);
 
-	g_idle_add(_on_thread_request_done, req);
+	nugu_mainloop_idle_add(_on_thread_request_done, req);
 
 	return NULL;
 }
@@ -485,12 +498,16 @@ static NuguHttpRequest *_request_new(NuguHttpHost *host, const char *path,
 		return NULL;
 	}
 
+	nugu_buffer_set_memory_tag(req->resp_body, NUGU_MEMORY_TAG_NETWORK);
+
 	req->resp_header = nugu_buffer_new(0);
 	if (!req->resp_header) {
 		nugu_http_request_free(req);
 		return NULL;
 	}
 
+	nugu_buffer_set_memory_tag(req->resp_header, NUGU_MEMORY_TAG_NETWORK);
+
 	req->resp = nugu_http_response_new();
 	if (!req->resp) {
 		nugu_http_request_free(req);
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_jitter.h"
+
+#define JITTER_HISTORY 32
+#define JITTER_MAX_ARRIVALS 1024
+
+struct _jitter_arrival {
+	int64_t msec;
+	size_t size;
+};
+
+struct _nugu_jitter {
+	double target_underrun_rate;
+	int max_threshold;
+	int threshold;
+
+	/* arrivals of the current stream */
+	struct _jitter_arrival *arrivals;
+	int num_arrivals;
+	int alloc_arrivals;
+
+	/* required thresholds of the recent streams */
+	int history[JITTER_HISTORY];
+	int history_count;
+	int history_pos;
+
+	struct nugu_jitter_stats stats;
+};
+
+static int _ceil(double value)
+{
+	int integer = (int)value;
+
+	return (value > integer) ? integer + 1 : integer;
+}
+
+static int _compare_int(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * Find the first arrival k where the playback can start without underrun.
+ * The playback started at t(k) consumes the audio in real time, so the
+ * audio arrived before t(i) must cover (t(i) - t(k)) for all i > k.
+ */
+static int _calc_required_threshold(NuguJitter *jitter, int duration)
+{
+	struct _jitter_arrival *arrivals = jitter->arrivals;
+	double *audio;
+	double total = 0;
+	double sum = 0;
+	double limit = 0;
+	int start = 0;
+	int i;
+
+	for (i = 0; i < jitter->num_arrivals; i++)
+		total += arrivals[i].size;
+
+	if (total <= 0)
+		return -1;
+
+	audio = g_new0(double, jitter->num_arrivals);
+
+	/* accumulated audio duration after each arrival */
+	for (i = 0; i < jitter->num_arrivals; i++) {
+		sum += arrivals[i].size;
+		audio[i] = sum * duration / total;
+	}
+
+	start = jitter->num_arrivals - 1;
+
+	for (i = jitter->num_arrivals - 1; i > 0; i--) {
+		double deadline = arrivals[i].msec - audio[i - 1];
+
+		if (i == jitter->num_arrivals - 1 || deadline > limit)
+			limit = deadline;
+
+		if ((double)arrivals[i - 1].msec >= limit)
+			start = i - 1;
+	}
+
+	i = (start > 0) ? _ceil(audio[start - 1]) + 1 : 0;
+	g_free(audio);
+
+	return i;
+}
+
+static void _update_threshold(NuguJitter *jitter)
+{
+	int sorted[JITTER_HISTORY];
+	int index;
+
+	memcpy(sorted, jitter->history, sizeof(int) * jitter->history_count);
+	qsort(sorted, jitter->history_count, sizeof(int), _compare_int);
+
+	/* smallest threshold which covers (1 - target rate) of the streams */
+	index = _ceil((1.0 - jitter->target_underrun_rate) *
+		      jitter->history_count) -
+		1;
+	if (index < 0)
+		index = 0;
+	else if (index >= jitter->history_count)
+		index = jitter->history_count - 1;
+
+	jitter->threshold = sorted[index];
+	if (jitter->threshold > jitter->max_threshold)
+		jitter->threshold = jitter->max_threshold;
+}
+
+NuguJitter *nugu_jitter_new(double target_underrun_rate, int max_threshold)
+{
+	NuguJitter *jitter;
+
+	g_return_val_if_fail(target_underrun_rate >= 0.0, NULL);
+	g_return_val_if_fail(target_underrun_rate <= 1.0, NULL);
+	g_return_val_if_fail(max_threshold >= 0, NULL);
+
+	jitter = g_malloc0(sizeof(struct _nugu_jitter));
+	if (!jitter) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	jitter->target_underrun_rate = target_underrun_rate;
+	jitter->max_threshold = max_threshold;
+
+	return jitter;
+}
+
+void nugu_jitter_free(NuguJitter *jitter)
+{
+	g_return_if_fail(jitter != NULL);
+
+	g_free(jitter->arrivals);
+
+	memset(jitter, 0, sizeof(struct _nugu_jitter));
+	g_free(jitter);
+}
+
+void nugu_jitter_begin(NuguJitter *jitter)
+{
+	g_return_if_fail(jitter != NULL);
+
+	jitter->num_arrivals = 0;
+}
+
+void nugu_jitter_add_arrival(NuguJitter *jitter, int64_t msec, size_t size)
+{
+	struct _jitter_arrival *arrival;
+
+	g_return_if_fail(jitter != NULL);
+
+	/* merge to the last one, it makes the estimation conservative */
+	if (jitter->num_arrivals == JITTER_MAX_ARRIVALS) {
+		arrival = jitter->arrivals + jitter->num_arrivals - 1;
+		arrival->msec = msec;
+		arrival->size += size;
+		return;
+	}
+
+	if (jitter->num_arrivals == jitter->alloc_arrivals) {
+		jitter->alloc_arrivals =
+			jitter->alloc_arrivals ? jitter->alloc_arrivals * 2 : 64;
+		jitter->arrivals =
+			g_renew(struct _jitter_arrival, jitter->arrivals,
+				jitter->alloc_arrivals);
+	}
+
+	arrival = jitter->arrivals + jitter->num_arrivals;
+	arrival->msec = msec;
+	arrival->size = size;
+	jitter->num_arrivals++;
+}
+
+int nugu_jitter_end(NuguJitter *jitter, int duration, unsigned int underruns,
+		    int added_latency)
+{
+	int required;
+
+	g_return_val_if_fail(jitter != NULL, -1);
+
+	if (jitter->num_arrivals == 0 || duration <= 0)
+		return -1;
+
+	required = _calc_required_threshold(jitter, duration);
+	jitter->num_arrivals = 0;
+
+	jitter->stats.streams++;
+	jitter->stats.underruns += underruns;
+	if (underruns > 0)
+		jitter->stats.underrun_streams++;
+	if (added_latency > 0)
+		jitter->stats.added_latency += added_latency;
+
+	if (required < 0)
+		return -1;
+
+	jitter->history[jitter->history_pos] = required;
+	jitter->history_pos = (jitter->history_pos + 1) % JITTER_HISTORY;
+	if (jitter->history_count < JITTER_HISTORY)
+		jitter->history_count++;
+
+	_update_threshold(jitter);
+
+	nugu_dbg("required %d msec, next threshold %d msec (underruns: %u)",
+		 required, jitter->threshold, underruns);
+
+	return required;
+}
+
+int nugu_jitter_get_threshold(NuguJitter *jitter)
+{
+	g_return_val_if_fail(jitter != NULL, 0);
+
+	return jitter->threshold;
+}
+
+void nugu_jitter_get_stats(NuguJitter *jitter, struct nugu_jitter_stats *stats)
+{
+	g_return_if_fail(jitter != NULL);
+	g_return_if_fail(stats != NULL);
+
+	memcpy(stats, &jitter->stats, sizeof(struct nugu_jitter_stats));
+	stats->threshold = jitter->threshold;
+}
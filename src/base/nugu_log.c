@@ -67,6 +67,18 @@
 #define COLOR_OFF ""
 #endif
 
+/* per-thread buffer of the asynchronous logging */
+#define LOG_RING_SIZE (64 * 1024)
+#define LOG_BATCH_SIZE (64 * 1024)
+#define LOG_LINE_MAX (MAX_LOG_LENGTH * 2)
+#define LOG_WRITER_INTERVAL_MSEC 20
+#define LOG_RECORD_WRAP 0xFFFFFFFF
+#define LOG_RECORD_ALIGN(x) (((x) + 7) & ~((gsize)7))
+#define LOG_RECORD_SIZE(r)                                                     \
+	LOG_RECORD_ALIGN(sizeof(struct _log_record) + (r)->len +               \
+			 (r)->filename_len + (r)->funcname_len)
+#define LOG_RECORD_NAME_MAX 1024
+
 #define HEXDUMP_COLUMN_SIZE 32
 #define HEXDUMP_LINE_BUFSIZE                                                   \
 	(8 + (HEXDUMP_COLUMN_SIZE * 3) + 3 + 3 + (HEXDUMP_COLUMN_SIZE) + 2)
@@ -85,6 +97,68 @@ static int _log_override_checked;
 
 static pthread_mutex_t _log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+struct _log_time_cache {
+	time_t sec;
+	char str[16];
+	int len;
+};
+
+struct _log_context {
+	gint64 timestamp;
+	pid_t pid;
+	pid_t tid;
+	int is_main_thread;
+	struct _log_time_cache *time_cache;
+};
+
+/**
+ * Header of each message in the log ring. The message is followed by the
+ * copy of the file and function names, since the caller can be unloaded
+ * (e.g. plugin) before the writer thread formats the prefix.
+ */
+struct _log_record {
+	gint64 timestamp;
+	int line;
+	enum nugu_log_level level;
+	enum nugu_log_system log_system;
+	guint16 filename_len; /* including the NUL. 0 for the NULL */
+	guint16 funcname_len; /* including the NUL. 0 for the NULL */
+	guint32 len; /* message length or LOG_RECORD_WRAP */
+};
+
+/* single producer (owner thread) and single consumer (writer thread) */
+struct _log_ring {
+	char *buf;
+	gsize head; /* atomic: written by the owner thread */
+	gsize tail; /* atomic: written by the writer thread */
+	pid_t tid;
+	int is_main_thread;
+	gint closed; /* atomic: the owner thread is finished */
+};
+
+static void _log_ring_close(gpointer data);
+
+static GPrivate _log_ring_key = G_PRIVATE_INIT(_log_ring_close);
+
+/* serialize the start and stop of the writer thread */
+static pthread_mutex_t _log_async_ctrl = PTHREAD_MUTEX_INITIALIZER;
+
+/* protect the ring list and the writer state */
+static pthread_mutex_t _log_async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _log_async_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t _log_flush_cond = PTHREAD_COND_INITIALIZER;
+static GList *_log_rings;
+static pthread_t _log_writer_tid;
+static int _log_writer_running;
+static int _log_writer_quit;
+static unsigned int _log_writer_passes;
+static int _log_writer_busy;
+static int _log_writer_wakeup;
+static int _log_atexit_registered;
+
+static gint _log_async; /* atomic */
+static gint _log_dropped; /* atomic */
+
 static struct _log_level_info {
 	char mark;
 	int syslog_level;
@@ -195,6 +269,20 @@ static void _log_check_override_module(void)
 }
 #endif
 
+#ifdef NUGU_ENV_LOG_ASYNC
+static void _log_check_override_async(void)
+{
+	const char *env;
+
+	env = getenv(NUGU_ENV_LOG_ASYNC);
+	if (!env)
+		return;
+
+	if (strtol(env, NULL, 10) > 0)
+		nugu_log_set_async(1);
+}
+#endif
+
 #ifdef NUGU_ENV_LOG_PROTOCOL_LINE_LIMIT
 static void _log_check_override_line_limit(void)
 {
@@ -293,73 +381,112 @@ static void _log_check_override(void)
 #ifdef NUGU_ENV_LOG_PREFIX
 	_log_check_override_prefix();
 #endif
+
+#ifdef NUGU_ENV_LOG_ASYNC
+	_log_check_override_async();
+#endif
 }
 
-static int _log_make_prefix(char *prefix, enum nugu_log_level level,
-			    const char *filename, const char *funcname,
-			    int line)
+static pid_t _log_get_tid(pid_t pid, int *is_main_thread)
 {
-	const char *pretty_filename = NULL;
-	int len = 0;
+	pid_t tid;
+
+	*is_main_thread = 1;
+
+#ifdef HAVE_SYSCALL
+#ifdef __APPLE__
+	pthread_threadid_np(NULL, (uint64_t *)&tid);
+	*is_main_thread = pthread_main_np();
+#else
+	tid = (pid_t)syscall(SYS_gettid);
+	if (pid != 0 && pid != tid)
+		*is_main_thread = 0;
+#endif
+#elif defined(__MSYS__) || defined(_WIN32)
+	tid = (pid_t)GetCurrentThreadId();
+	if (pid != 0 && pid != tid)
+		*is_main_thread = 0;
+#else
+	tid = (pid_t)gettid();
+	if (pid != 0 && pid != tid)
+		*is_main_thread = 0;
+#endif
+
+	return tid;
+}
+
+static void _log_get_context(struct _log_context *ctx)
+{
+	ctx->timestamp = g_get_real_time();
+	ctx->pid = 0;
+	ctx->tid = 0;
+	ctx->is_main_thread = 1;
+
+	if (_log_prefix_fields & NUGU_LOG_PREFIX_PID ||
+	    _log_prefix_fields & NUGU_LOG_PREFIX_TID)
+		ctx->pid = getpid();
 
-	if (_log_prefix_fields & NUGU_LOG_PREFIX_TIMESTAMP) {
-		struct tm ti;
-		int msec;
-		gint64 microseconds;
-		time_t now;
+	if (_log_prefix_fields & NUGU_LOG_PREFIX_TID)
+		ctx->tid = _log_get_tid(ctx->pid, &ctx->is_main_thread);
+}
 
-		microseconds = g_get_real_time();
+static int _log_make_timestamp(char *prefix, gint64 microseconds,
+			       struct _log_time_cache *cache)
+{
+	struct tm ti;
+	time_t now;
+	int msec;
+	int len;
 
-		msec = (int)((microseconds % 1000000) / 1000);
-		now = (time_t)(microseconds / 1000000);
+	msec = (int)((microseconds % 1000000) / 1000);
+	now = (time_t)(microseconds / 1000000);
 
+	/* localtime is only needed when the second is changed */
+	if (cache && cache->len > 0 && cache->sec == now) {
+		memcpy(prefix, cache->str, cache->len);
+		len = cache->len;
+	} else {
 #ifdef _WIN32
 		localtime_s(&ti, &now);
 #else
 		localtime_r(&now, &ti);
 #endif
 
-		len += (int)strftime(prefix, 15, "%m-%d %H:%M:%S", &ti);
-		len += snprintf(prefix + len, 6, ".%03d ", msec);
+		len = (int)strftime(prefix, 15, "%m-%d %H:%M:%S", &ti);
+
+		if (cache) {
+			memcpy(cache->str, prefix, len);
+			cache->len = len;
+			cache->sec = now;
+		}
 	}
 
-	if (_log_prefix_fields & NUGU_LOG_PREFIX_PID ||
-	    _log_prefix_fields & NUGU_LOG_PREFIX_TID) {
-		pid_t pid = getpid();
+	len += snprintf(prefix + len, 6, ".%03d ", msec);
 
-		if (_log_prefix_fields & NUGU_LOG_PREFIX_PID)
-			len += sprintf(prefix + len, "%d ", pid);
+	return len;
+}
 
-		if (_log_prefix_fields & NUGU_LOG_PREFIX_TID) {
-			pid_t tid;
-			int is_main_thread = 1;
+static int _log_make_prefix(char *prefix, const struct _log_context *ctx,
+			    enum nugu_log_level level, const char *filename,
+			    const char *funcname, int line)
+{
+	const char *pretty_filename = NULL;
+	int len = 0;
 
-#ifdef HAVE_SYSCALL
-#ifdef __APPLE__
-			pthread_threadid_np(NULL, (uint64_t *)&tid);
-			is_main_thread = pthread_main_np();
-#else
-			tid = (pid_t)syscall(SYS_gettid);
-			if (pid != 0 && pid != tid)
-				is_main_thread = 0;
-#endif
-#elif defined(__MSYS__) || defined(_WIN32)
-			tid = (pid_t)GetCurrentThreadId();
-			if (pid != 0 && pid != tid)
-				is_main_thread = 0;
-#else
-			tid = (pid_t)gettid();
-			if (pid != 0 && pid != tid)
-				is_main_thread = 0;
-#endif
+	if (_log_prefix_fields & NUGU_LOG_PREFIX_TIMESTAMP)
+		len += _log_make_timestamp(prefix, ctx->timestamp,
+					   ctx->time_cache);
 
-			if (is_main_thread == 0 && COLOR_THREAD_ID[0] != '\0')
-				len += sprintf(prefix + len,
-					       COLOR_THREAD_ID "%d " COLOR_OFF,
-					       tid);
-			else
-				len += sprintf(prefix + len, "%d ", tid);
-		}
+	if (_log_prefix_fields & NUGU_LOG_PREFIX_PID)
+		len += sprintf(prefix + len, "%d ", ctx->pid);
+
+	if (_log_prefix_fields & NUGU_LOG_PREFIX_TID) {
+		if (ctx->is_main_thread == 0 && COLOR_THREAD_ID[0] != '\0')
+			len += sprintf(prefix + len,
+				       COLOR_THREAD_ID "%d " COLOR_OFF,
+				       ctx->tid);
+		else
+			len += sprintf(prefix + len, "%d ", ctx->tid);
 	}
 
 	if (_log_prefix_fields & NUGU_LOG_PREFIX_LEVEL) {
@@ -437,11 +564,16 @@ static void _log_formatted(enum nugu_log_module module,
 			   va_list arg)
 {
 	char prefix[MAX_LOG_LENGTH] = { 0 };
+	struct _log_context ctx;
 	int len = 0;
 	FILE *fp = NULL;
 
-	if (_log_prefix_fields > NUGU_LOG_PREFIX_NONE)
-		len = _log_make_prefix(prefix, level, filename, funcname, line);
+	if (_log_prefix_fields > NUGU_LOG_PREFIX_NONE) {
+		_log_get_context(&ctx);
+		ctx.time_cache = NULL;
+		len = _log_make_prefix(prefix, &ctx, level, filename, funcname,
+				       line);
+	}
 
 	if (_log_system == NUGU_LOG_SYSTEM_STDERR)
 		fp = stderr;
@@ -492,6 +624,417 @@ static void _log_formatted(enum nugu_log_module module,
 	pthread_mutex_unlock(&_log_mutex);
 }
 
+/* print to the configured output without the asynchronous ring */
+static void _log_print_direct(enum nugu_log_level level, const char *format,
+			      ...)
+{
+	va_list arg;
+
+	va_start(arg, format);
+	_log_formatted(NUGU_LOG_MODULE_DEFAULT, level, NULL, NULL, -1, format,
+		       arg);
+	va_end(arg);
+}
+
+static void _log_ring_close(gpointer data)
+{
+	struct _log_ring *ring = data;
+
+	/* the writer thread frees the ring after the remaining messages */
+	g_atomic_int_set(&ring->closed, 1);
+}
+
+static void _log_ring_free(struct _log_ring *ring)
+{
+	g_free(ring->buf);
+	g_free(ring);
+}
+
+static struct _log_ring *_log_ring_get(void)
+{
+	struct _log_ring *ring;
+
+	ring = g_private_get(&_log_ring_key);
+	if (ring)
+		return ring;
+
+	ring = g_malloc0(sizeof(struct _log_ring));
+	if (!ring)
+		return NULL;
+
+	ring->buf = g_malloc(LOG_RING_SIZE);
+	if (!ring->buf) {
+		g_free(ring);
+		return NULL;
+	}
+
+	/* the thread id is resolved only once for the thread */
+	ring->tid = _log_get_tid(getpid(), &ring->is_main_thread);
+
+	g_private_set(&_log_ring_key, ring);
+
+	pthread_mutex_lock(&_log_async_lock);
+	_log_rings = g_list_prepend(_log_rings, ring);
+	pthread_mutex_unlock(&_log_async_lock);
+
+	return ring;
+}
+
+static gsize _log_ring_used(struct _log_ring *ring)
+{
+	return ring->head - (gsize)g_atomic_pointer_get(&ring->tail);
+}
+
+static int _log_ring_push(struct _log_ring *ring,
+			  const struct _log_record *record, const char *msg,
+			  const char *filename, const char *funcname)
+{
+	gsize head = ring->head;
+	gsize tail = (gsize)g_atomic_pointer_get(&ring->tail);
+	gsize need;
+	gsize pos;
+	gsize skip = 0;
+
+	need = LOG_RECORD_SIZE(record);
+	pos = head % LOG_RING_SIZE;
+
+	/* the record is always contiguous, so skip the end of the ring */
+	if (LOG_RING_SIZE - pos < need)
+		skip = LOG_RING_SIZE - pos;
+
+	if (head + skip + need - tail > LOG_RING_SIZE)
+		return -1;
+
+	if (skip) {
+		if (skip >= sizeof(struct _log_record))
+			((struct _log_record *)(ring->buf + pos))->len =
+				LOG_RECORD_WRAP;
+		pos = 0;
+	}
+
+	memcpy(ring->buf + pos, record, sizeof(struct _log_record));
+	pos += sizeof(struct _log_record);
+	memcpy(ring->buf + pos, msg, record->len);
+	pos += record->len;
+
+	if (record->filename_len) {
+		memcpy(ring->buf + pos, filename, record->filename_len - 1);
+		ring->buf[pos + record->filename_len - 1] = '\0';
+		pos += record->filename_len;
+	}
+
+	if (record->funcname_len) {
+		memcpy(ring->buf + pos, funcname, record->funcname_len - 1);
+		ring->buf[pos + record->funcname_len - 1] = '\0';
+	}
+
+	g_atomic_pointer_set(&ring->head, (gpointer)(head + skip + need));
+
+	return 0;
+}
+
+static struct _log_record *_log_ring_peek(struct _log_ring *ring)
+{
+	gsize head = (gsize)g_atomic_pointer_get(&ring->head);
+	gsize tail = ring->tail;
+	struct _log_record *record;
+	gsize pos;
+
+	while (tail != head) {
+		pos = tail % LOG_RING_SIZE;
+
+		if (LOG_RING_SIZE - pos >= sizeof(struct _log_record)) {
+			record = (struct _log_record *)(ring->buf + pos);
+			if (record->len != LOG_RECORD_WRAP) {
+				g_atomic_pointer_set(&ring->tail,
+						     (gpointer)tail);
+				return record;
+			}
+		}
+
+		tail += LOG_RING_SIZE - pos;
+	}
+
+	g_atomic_pointer_set(&ring->tail, (gpointer)tail);
+
+	return NULL;
+}
+
+static void _log_ring_pop(struct _log_ring *ring,
+			  const struct _log_record *record)
+{
+	gsize size;
+
+	size = LOG_RECORD_SIZE(record);
+	g_atomic_pointer_set(&ring->tail, (gpointer)(ring->tail + size));
+}
+
+static guint16 _log_record_name_len(const char *name)
+{
+	if (!name)
+		return 0;
+
+	/* the long name is cut at the end, same as the prefix field */
+	return (guint16)(strnlen(name, LOG_RECORD_NAME_MAX - 1) + 1);
+}
+
+static int _log_async_print(enum nugu_log_level level,
+			    const char *filename, const char *funcname,
+			    int line, const char *format, va_list arg)
+{
+	struct _log_record record;
+	struct _log_ring *ring;
+	char msg[MAX_LOG_LENGTH];
+	int len;
+
+	ring = _log_ring_get();
+	if (!ring)
+		return -1;
+
+	/*
+	 * Only the message is formatted by the caller. The prefix is made
+	 * by the writer thread with the timestamp and the cached thread id.
+	 */
+	len = vsnprintf(msg, MAX_LOG_LENGTH, format, arg);
+	if (len < 0)
+		len = 0;
+	else if (len >= MAX_LOG_LENGTH)
+		len = MAX_LOG_LENGTH - 1;
+
+	record.timestamp = g_get_real_time();
+	record.filename_len = _log_record_name_len(filename);
+	record.funcname_len = _log_record_name_len(funcname);
+	record.line = line;
+	record.level = level;
+	record.log_system = _log_system;
+	record.len = (guint32)len;
+
+	if (_log_ring_push(ring, &record, msg, filename, funcname) < 0) {
+		g_atomic_int_inc(&_log_dropped);
+		return 0;
+	}
+
+	/* wake up the writer early for the error or the busy thread */
+	if (level == NUGU_LOG_LEVEL_ERROR ||
+	    _log_ring_used(ring) > LOG_RING_SIZE / 2) {
+		pthread_mutex_lock(&_log_async_lock);
+		_log_writer_wakeup = 1;
+		pthread_cond_signal(&_log_async_cond);
+		pthread_mutex_unlock(&_log_async_lock);
+	}
+
+	return 0;
+}
+
+static int _log_format_record(char *dest, const struct _log_ring *ring,
+			      const struct _log_record *record, pid_t pid,
+			      struct _log_time_cache *cache)
+{
+	struct _log_context ctx;
+	const char *color = _log_level_map[record->level].color;
+	const char *msg = (const char *)record + sizeof(struct _log_record);
+	const char *filename = NULL;
+	const char *funcname = NULL;
+	int len = 0;
+
+	if (record->filename_len)
+		filename = msg + record->len;
+
+	if (record->funcname_len)
+		funcname = msg + record->len + record->filename_len;
+
+	if (_log_prefix_fields > NUGU_LOG_PREFIX_NONE) {
+		ctx.timestamp = record->timestamp;
+		ctx.pid = pid;
+		ctx.tid = ring->tid;
+		ctx.is_main_thread = ring->is_main_thread;
+		ctx.time_cache = cache;
+
+		len = _log_make_prefix(dest, &ctx, record->level, filename,
+				       funcname, record->line);
+		if (len > 0)
+			dest[len++] = ' ';
+	}
+
+	if (color != NULL) {
+		memcpy(dest + len, color, strlen(color));
+		len += (int)strlen(color);
+	}
+
+	memcpy(dest + len, msg, record->len);
+	len += (int)record->len;
+
+	if (color != NULL) {
+		memcpy(dest + len, COLOR_OFF, strlen(COLOR_OFF));
+		len += (int)strlen(COLOR_OFF);
+	}
+
+	dest[len++] = '\n';
+
+	return len;
+}
+
+static void _log_write_batch(FILE *fp, const char *batch, size_t len)
+{
+	if (!fp || len == 0)
+		return;
+
+	/* NOLINTNEXTLINE(cert-err33-c) */
+	fwrite(batch, 1, len, fp);
+
+	/* NOLINTNEXTLINE(cert-err33-c) */
+	fflush(fp);
+}
+
+/*
+ * Write all the queued messages of the snapshot rings in the order of the
+ * timestamp. The rings are released only by the writer thread, so the
+ * snapshot is used without the _log_async_lock.
+ */
+static void _log_writer_flush(GList *rings, char *batch, pid_t pid,
+			      struct _log_time_cache *cache)
+{
+	struct _log_record *record;
+	struct _log_record *min_record;
+	struct _log_ring *min_ring;
+	FILE *batch_fp = NULL;
+	size_t batch_len = 0;
+	GList *l;
+
+	while (1) {
+		FILE *fp;
+
+		min_record = NULL;
+		min_ring = NULL;
+
+		for (l = rings; l; l = l->next) {
+			record = _log_ring_peek(l->data);
+			if (!record)
+				continue;
+
+			if (!min_record ||
+			    record->timestamp < min_record->timestamp) {
+				min_record = record;
+				min_ring = l->data;
+			}
+		}
+
+		if (!min_record)
+			break;
+
+		if (min_record->log_system == NUGU_LOG_SYSTEM_STDOUT)
+			fp = stdout;
+		else
+			fp = stderr;
+
+		if (fp != batch_fp ||
+		    batch_len + LOG_LINE_MAX > LOG_BATCH_SIZE) {
+			_log_write_batch(batch_fp, batch, batch_len);
+			batch_fp = fp;
+			batch_len = 0;
+		}
+
+		batch_len += _log_format_record(batch + batch_len, min_ring,
+						min_record, pid, cache);
+		_log_ring_pop(min_ring, min_record);
+	}
+
+	_log_write_batch(batch_fp, batch, batch_len);
+}
+
+/* release the rings of the finished threads (_log_async_lock is held) */
+static void _log_writer_release(GList *rings)
+{
+	GList *l;
+
+	for (l = rings; l; l = l->next) {
+		struct _log_ring *ring = l->data;
+
+		if (!g_atomic_int_get(&ring->closed) || _log_ring_peek(ring))
+			continue;
+
+		_log_rings = g_list_remove(_log_rings, ring);
+		_log_ring_free(ring);
+	}
+}
+
+static void *_log_writer_loop(void *data)
+{
+	struct _log_time_cache cache;
+	struct timespec spec;
+	gint64 microseconds;
+	GList *rings;
+	char *batch;
+	pid_t pid = getpid();
+	int reported = 0;
+	int dropped;
+	int quit;
+
+	memset(&cache, 0, sizeof(cache));
+
+	batch = g_malloc(LOG_BATCH_SIZE);
+	if (!batch)
+		return NULL;
+
+	pthread_mutex_lock(&_log_async_lock);
+
+	do {
+		quit = _log_writer_quit;
+		_log_writer_wakeup = 0;
+		_log_writer_busy = 1;
+		rings = g_list_copy(_log_rings);
+
+		/* the logging threads are not blocked by the slow output */
+		pthread_mutex_unlock(&_log_async_lock);
+
+		_log_writer_flush(rings, batch, pid, &cache);
+
+		dropped = g_atomic_int_get(&_log_dropped);
+		if (dropped != reported) {
+			_log_print_direct(NUGU_LOG_LEVEL_ERROR,
+					  "nugu_log: %d messages dropped",
+					  dropped - reported);
+			reported = dropped;
+		}
+
+		pthread_mutex_lock(&_log_async_lock);
+
+		_log_writer_release(rings);
+		g_list_free(rings);
+
+		_log_writer_busy = 0;
+		_log_writer_passes++;
+		pthread_cond_broadcast(&_log_flush_cond);
+
+		if (quit)
+			break;
+
+		/* the request during the pass needs one more pass */
+		if (_log_writer_wakeup || _log_writer_quit)
+			continue;
+
+		microseconds =
+			g_get_real_time() + LOG_WRITER_INTERVAL_MSEC * 1000;
+		spec.tv_sec = microseconds / 1000000;
+		spec.tv_nsec = (microseconds % 1000000) * 1000;
+
+		pthread_cond_timedwait(&_log_async_cond, &_log_async_lock,
+				       &spec);
+	} while (1);
+
+	pthread_mutex_unlock(&_log_async_lock);
+
+	g_free(batch);
+
+	return NULL;
+}
+
+static void _log_async_exit(void)
+{
+	/* write the remaining messages before the process is finished */
+	nugu_log_set_async(0);
+}
+
 #ifndef _WIN32
 static void _syslog_formatted(enum nugu_log_module module,
 			      enum nugu_log_level level, const char *filename,
@@ -500,9 +1043,12 @@ static void _syslog_formatted(enum nugu_log_module module,
 {
 	int len;
 	char prefix[MAX_LOG_LENGTH] = { 0 };
+	struct _log_context ctx;
 	GString *buf;
 
-	len = _log_make_prefix(prefix, level, filename, funcname, line);
+	_log_get_context(&ctx);
+	ctx.time_cache = NULL;
+	len = _log_make_prefix(prefix, &ctx, level, filename, funcname, line);
 	if (len > 0) {
 		buf = g_string_new(prefix);
 		g_string_append_c(buf, ' ');
@@ -562,6 +1108,18 @@ void nugu_log_print(enum nugu_log_module module, enum nugu_log_level level,
 #endif
 	case NUGU_LOG_SYSTEM_STDERR:
 	case NUGU_LOG_SYSTEM_STDOUT:
+		if (g_atomic_int_get(&_log_async)) {
+			int ret;
+
+			va_start(arg, format);
+			ret = _log_async_print(level, filename, funcname, line,
+					       format, arg);
+			va_end(arg);
+
+			if (ret == 0)
+				break;
+		}
+		/* fall through */
 	case NUGU_LOG_SYSTEM_CUSTOM:
 		va_start(arg, format);
 		_log_formatted(module, level, filename, funcname, line, format,
@@ -735,6 +1293,78 @@ int nugu_log_get_protocol_line_limit(void)
 	return tmp;
 }
 
+int nugu_log_set_async(int enable)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&_log_async_ctrl);
+
+	if (enable && !_log_writer_running) {
+		_log_writer_quit = 0;
+
+		if (pthread_create(&_log_writer_tid, NULL, _log_writer_loop,
+				   NULL) != 0) {
+			ret = -1;
+		} else {
+			_log_writer_running = 1;
+			g_atomic_int_set(&_log_async, 1);
+
+			if (!_log_atexit_registered) {
+				_log_atexit_registered = 1;
+				atexit(_log_async_exit);
+			}
+		}
+	} else if (!enable && _log_writer_running) {
+		g_atomic_int_set(&_log_async, 0);
+
+		pthread_mutex_lock(&_log_async_lock);
+		_log_writer_quit = 1;
+		pthread_cond_signal(&_log_async_cond);
+		pthread_mutex_unlock(&_log_async_lock);
+
+		/* the writer thread writes all the messages before the exit */
+		pthread_join(_log_writer_tid, NULL);
+		_log_writer_running = 0;
+	}
+
+	pthread_mutex_unlock(&_log_async_ctrl);
+
+	return ret;
+}
+
+int nugu_log_is_async(void)
+{
+	return g_atomic_int_get(&_log_async);
+}
+
+void nugu_log_flush(void)
+{
+	unsigned int passes;
+
+	if (!g_atomic_int_get(&_log_async))
+		return;
+
+	pthread_mutex_lock(&_log_async_lock);
+
+	/*
+	 * Wait for a whole pass of the writer after the request. The pass
+	 * in progress may have missed the messages, so skip it.
+	 */
+	passes = _log_writer_passes + 1 + (_log_writer_busy ? 1 : 0);
+	_log_writer_wakeup = 1;
+	pthread_cond_signal(&_log_async_cond);
+
+	while ((int)(passes - _log_writer_passes) > 0 && !_log_writer_quit)
+		pthread_cond_wait(&_log_flush_cond, &_log_async_lock);
+
+	pthread_mutex_unlock(&_log_async_lock);
+}
+
+unsigned int nugu_log_get_dropped_count(void)
+{
+	return (unsigned int)g_atomic_int_get(&_log_dropped);
+}
+
 void nugu_hexdump(enum nugu_log_module module, const uint8_t *data,
 		  size_t data_size, const char *header, const char *footer,
 		  const char *lineindent)
@@ -747,6 +1377,9 @@ void nugu_hexdump(enum nugu_log_module module, const uint8_t *data,
 	g_return_if_fail(data != NULL);
 	g_return_if_fail(data_size > 0);
 
+	/* keep the order with the queued messages */
+	nugu_log_flush();
+
 	pthread_mutex_lock(&_log_mutex);
 
 	if (!_log_override_checked)
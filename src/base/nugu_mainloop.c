@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+
+struct _invoke_data {
+	NuguMainloopInvokeFunc func;
+	void *userdata;
+	int done;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+struct _source_data {
+	NuguMainloopSourceFunc func;
+	void *userdata;
+	unsigned int id;
+};
+
+/* written under the _lock, read without the lock from any thread */
+static GMainContext *_context;
+static GMainLoop *_loop;
+static GThread *_thread;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * The source ids of the GMainContext are unique only in the context, so the
+ * attached sources are kept with the SDK's own id. The source is removed
+ * from the context it was attached to, even if the SDK main context is
+ * changed after that.
+ */
+static GHashTable *_sources;
+static unsigned int _last_source_id;
+static pthread_mutex_t _sources_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static gpointer _sdk_thread(gpointer userdata)
+{
+	GMainContext *context = userdata;
+
+	g_main_context_push_thread_default(context);
+
+	nugu_info("SDK main loop started");
+	g_main_loop_run(_loop);
+	nugu_info("SDK main loop stopped");
+
+	g_main_context_pop_thread_default(context);
+
+	return NULL;
+}
+
+static gboolean _on_quit(gpointer userdata)
+{
+	g_main_loop_quit(userdata);
+
+	return FALSE;
+}
+
+static gboolean _on_source(gpointer userdata)
+{
+	struct _source_data *data = userdata;
+
+	return data->func(data->userdata) ? TRUE : FALSE;
+}
+
+static void _on_source_destroy(gpointer userdata)
+{
+	struct _source_data *data = userdata;
+
+	pthread_mutex_lock(&_sources_lock);
+	g_hash_table_remove(_sources, GUINT_TO_POINTER(data->id));
+	pthread_mutex_unlock(&_sources_lock);
+
+	free(data);
+}
+
+static unsigned int _attach(GSource *source, NuguMainloopSourceFunc func,
+			    void *userdata)
+{
+	struct _source_data *data;
+	unsigned int id;
+
+	data = malloc(sizeof(struct _source_data));
+	if (!data) {
+		nugu_error_nomem();
+		g_source_unref(source);
+		return 0;
+	}
+
+	data->func = func;
+	data->userdata = userdata;
+
+	pthread_mutex_lock(&_sources_lock);
+
+	if (!_sources)
+		_sources = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	/* 0 is not a valid id */
+	do {
+		id = ++_last_source_id;
+	} while (id == 0 ||
+		 g_hash_table_contains(_sources, GUINT_TO_POINTER(id)));
+
+	data->id = id;
+
+	/* the context keeps the source until it is destroyed */
+	g_hash_table_insert(_sources, GUINT_TO_POINTER(id), source);
+
+	pthread_mutex_unlock(&_sources_lock);
+
+	g_source_set_callback(source, _on_source, data, _on_source_destroy);
+	g_source_attach(source, nugu_mainloop_get_context());
+	g_source_unref(source);
+
+	return id;
+}
+
+static gboolean _on_invoke(gpointer userdata)
+{
+	struct _invoke_data *data = userdata;
+
+	data->func(data->userdata);
+
+	pthread_mutex_lock(&data->lock);
+	data->done = 1;
+	pthread_cond_signal(&data->cond);
+	pthread_mutex_unlock(&data->lock);
+
+	return FALSE;
+}
+
+int nugu_mainloop_start(void)
+{
+	GMainContext *context;
+
+	pthread_mutex_lock(&_lock);
+
+	if (_context) {
+		nugu_error("SDK main loop is already started");
+		pthread_mutex_unlock(&_lock);
+		return -1;
+	}
+
+	context = g_main_context_new();
+	_loop = g_main_loop_new(context, FALSE);
+	g_atomic_pointer_set(&_context, context);
+	_thread = g_thread_new("nugu_mainloop", _sdk_thread, context);
+
+	pthread_mutex_unlock(&_lock);
+
+	return 0;
+}
+
+void nugu_mainloop_stop(void)
+{
+	GMainContext *context;
+	GSource *source;
+
+	pthread_mutex_lock(&_lock);
+
+	if (!_context) {
+		pthread_mutex_unlock(&_lock);
+		return;
+	}
+
+	if (g_thread_self() == _thread) {
+		nugu_error("can't stop the SDK main loop on the SDK thread");
+		pthread_mutex_unlock(&_lock);
+		return;
+	}
+
+	/*
+	 * quit in the loop. g_main_loop_quit() before the SDK thread enters
+	 * g_main_loop_run() is lost.
+	 */
+	source = g_idle_source_new();
+	g_source_set_priority(source, G_PRIORITY_HIGH);
+	g_source_set_callback(source, _on_quit, _loop, NULL);
+	g_source_attach(source, _context);
+	g_source_unref(source);
+
+	g_thread_join(_thread);
+	_thread = NULL;
+
+	g_main_loop_unref(_loop);
+	_loop = NULL;
+
+	context = _context;
+	g_atomic_pointer_set(&_context, NULL);
+
+	pthread_mutex_unlock(&_lock);
+
+	g_main_context_unref(context);
+}
+
+int nugu_mainloop_is_dedicated(void)
+{
+	return (g_atomic_pointer_get(&_context) != NULL);
+}
+
+int nugu_mainloop_is_owner(void)
+{
+	return g_main_context_is_owner(nugu_mainloop_get_context());
+}
+
+void *nugu_mainloop_get_context(void)
+{
+	GMainContext *context = g_atomic_pointer_get(&_context);
+
+	if (context)
+		return context;
+
+	return g_main_context_default();
+}
+
+unsigned int nugu_mainloop_idle_add(NuguMainloopSourceFunc func,
+				    void *userdata)
+{
+	g_return_val_if_fail(func != NULL, 0);
+
+	return _attach(g_idle_source_new(), func, userdata);
+}
+
+unsigned int nugu_mainloop_timeout_add(unsigned int interval_msec,
+				       NuguMainloopSourceFunc func,
+				       void *userdata)
+{
+	g_return_val_if_fail(func != NULL, 0);
+
+	return _attach(g_timeout_source_new(interval_msec), func, userdata);
+}
+
+unsigned int nugu_mainloop_timeout_add_seconds(unsigned int interval_sec,
+					       NuguMainloopSourceFunc func,
+					       void *userdata)
+{
+	g_return_val_if_fail(func != NULL, 0);
+
+	return _attach(g_timeout_source_new_seconds(interval_sec), func,
+		       userdata);
+}
+
+void nugu_mainloop_source_remove(unsigned int id)
+{
+	GSource *source = NULL;
+
+	g_return_if_fail(id > 0);
+
+	pthread_mutex_lock(&_sources_lock);
+
+	if (_sources)
+		source = g_hash_table_lookup(_sources, GUINT_TO_POINTER(id));
+
+	/* keep the source alive until it is destroyed out of the lock */
+	if (source)
+		g_source_ref(source);
+
+	pthread_mutex_unlock(&_sources_lock);
+
+	if (!source) {
+		nugu_warn("can't find the source(%u)", id);
+		return;
+	}
+
+	/* removed from the context which the source is attached to */
+	g_source_destroy(source);
+	g_source_unref(source);
+}
+
+void nugu_mainloop_invoke(NuguMainloopInvokeFunc func, void *userdata)
+{
+	GMainContext *context = nugu_mainloop_get_context();
+	struct _invoke_data data;
+	GSource *source;
+
+	g_return_if_fail(func != NULL);
+
+	/* current thread owns the context or nobody is running it */
+	if (g_main_context_acquire(context)) {
+		func(userdata);
+		g_main_context_release(context);
+		return;
+	}
+
+	data.func = func;
+	data.userdata = userdata;
+	data.done = 0;
+	pthread_mutex_init(&data.lock, NULL);
+	pthread_cond_init(&data.cond, NULL);
+
+	source = g_idle_source_new();
+	g_source_set_priority(source, G_PRIORITY_HIGH);
+	g_source_set_callback(source, _on_invoke, &data, NULL);
+	g_source_attach(source, context);
+	g_source_unref(source);
+
+	pthread_mutex_lock(&data.lock);
+	while (!data.done)
+		pthread_cond_wait(&data.cond, &data.lock);
+	pthread_mutex_unlock(&data.lock);
+
+	pthread_cond_destroy(&data.cond);
+	pthread_mutex_destroy(&data.lock);
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_memory.h"
+
+#ifdef ENABLE_MEMORY_ACCOUNTING
+/**
+ * The usage is updated with the pointer atomics on the allocation path of
+ * the 64-bit platforms, and with the lock on the others to keep the 64-bit
+ * counters from the wrap around.
+ */
+#if GLIB_SIZEOF_VOID_P >= 8
+#define MEMORY_ATOMIC_USAGE
+#else
+static pthread_mutex_t _usage_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+struct _memory_usage {
+	gint64 current; /* atomic */
+	gint64 peak; /* atomic */
+};
+
+static struct _memory_usage _usages[NUGU_MEMORY_TAG_MAX];
+#endif
+
+static const char *_tag_names[NUGU_MEMORY_TAG_MAX] = {
+	"buffer", "network", "directive", "attachment", "pcm", "recorder", "json"
+};
+
+#ifdef ENABLE_MEMORY_ACCOUNTING
+static gint64 _usage_get(gint64 *value)
+{
+#ifdef MEMORY_ATOMIC_USAGE
+	return (gint64)(gssize)g_atomic_pointer_get((gssize *)value);
+#else
+	gint64 tmp;
+
+	pthread_mutex_lock(&_usage_lock);
+	tmp = *value;
+	pthread_mutex_unlock(&_usage_lock);
+
+	return tmp;
+#endif
+}
+
+static void _usage_add(struct _memory_usage *usage, gint64 delta)
+{
+#ifdef MEMORY_ATOMIC_USAGE
+	gssize current;
+	gssize peak;
+
+	current = g_atomic_pointer_add((gssize *)&usage->current,
+				       (gssize)delta) +
+		  (gssize)delta;
+	if (delta < 0)
+		return;
+
+	peak = (gssize)g_atomic_pointer_get((gssize *)&usage->peak);
+	while (current > peak) {
+		if (g_atomic_pointer_compare_and_exchange(
+			    (gssize *)&usage->peak, (gpointer)peak,
+			    (gpointer)current))
+			break;
+
+		peak = (gssize)g_atomic_pointer_get((gssize *)&usage->peak);
+	}
+#else
+	pthread_mutex_lock(&_usage_lock);
+	usage->current += delta;
+	if (usage->current > usage->peak)
+		usage->peak = usage->current;
+	pthread_mutex_unlock(&_usage_lock);
+#endif
+}
+
+static void _usage_reset_peak(struct _memory_usage *usage)
+{
+#ifdef MEMORY_ATOMIC_USAGE
+	g_atomic_pointer_set((gssize *)&usage->peak,
+			     g_atomic_pointer_get((gssize *)&usage->current));
+#else
+	pthread_mutex_lock(&_usage_lock);
+	usage->peak = usage->current;
+	pthread_mutex_unlock(&_usage_lock);
+#endif
+}
+#endif
+
+void nugu_memory_add(enum nugu_memory_tag tag, size_t size)
+{
+#ifdef ENABLE_MEMORY_ACCOUNTING
+	g_return_if_fail(tag < NUGU_MEMORY_TAG_MAX);
+
+	if (size == 0)
+		return;
+
+	_usage_add(&_usages[tag], (gint64)size);
+#endif
+}
+
+void nugu_memory_sub(enum nugu_memory_tag tag, size_t size)
+{
+#ifdef ENABLE_MEMORY_ACCOUNTING
+	g_return_if_fail(tag < NUGU_MEMORY_TAG_MAX);
+
+	if (size == 0)
+		return;
+
+	_usage_add(&_usages[tag], -(gint64)size);
+#endif
+}
+
+void *nugu_memory_alloc(enum nugu_memory_tag tag, size_t size)
+{
+	void *ptr;
+
+	ptr = calloc(1, size);
+	if (!ptr)
+		return NULL;
+
+	nugu_memory_add(tag, size);
+
+	return ptr;
+}
+
+void *nugu_memory_realloc(enum nugu_memory_tag tag, void *ptr,
+			  size_t old_size, size_t new_size)
+{
+	void *tmp;
+
+	tmp = realloc(ptr, new_size);
+	if (!tmp)
+		return NULL;
+
+	if (new_size > old_size)
+		nugu_memory_add(tag, new_size - old_size);
+	else
+		nugu_memory_sub(tag, old_size - new_size);
+
+	return tmp;
+}
+
+void nugu_memory_free(enum nugu_memory_tag tag, void *ptr, size_t size)
+{
+	if (!ptr)
+		return;
+
+	free(ptr);
+	nugu_memory_sub(tag, size);
+}
+
+int nugu_memory_get_stat(enum nugu_memory_tag tag,
+			 struct nugu_memory_stat *stat)
+{
+#ifdef ENABLE_MEMORY_ACCOUNTING
+	g_return_val_if_fail(tag < NUGU_MEMORY_TAG_MAX, -1);
+	g_return_val_if_fail(stat != NULL, -1);
+
+	stat->current = (uint64_t)_usage_get(&_usages[tag].current);
+	stat->peak = (uint64_t)_usage_get(&_usages[tag].peak);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+const char *nugu_memory_get_tag_name(enum nugu_memory_tag tag)
+{
+	g_return_val_if_fail(tag < NUGU_MEMORY_TAG_MAX, NULL);
+
+	return _tag_names[tag];
+}
+
+void nugu_memory_reset_peak(void)
+{
+#ifdef ENABLE_MEMORY_ACCOUNTING
+	int i;
+
+	for (i = 0; i < NUGU_MEMORY_TAG_MAX; i++)
+		_usage_reset_peak(&_usages[i]);
+#endif
+}
+
+void nugu_memory_dump(void)
+{
+	struct nugu_memory_stat stat;
+	int i;
+
+	for (i = 0; i < NUGU_MEMORY_TAG_MAX; i++) {
+		if (nugu_memory_get_stat((enum nugu_memory_tag)i, &stat) < 0) {
+			nugu_info("memory accounting is disabled");
+			return;
+		}
+
+		nugu_info("%-10s current %10" G_GUINT64_FORMAT
+			  " bytes, peak %10" G_GUINT64_FORMAT " bytes",
+			  _tag_names[i], stat.current, stat.peak);
+	}
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_metrics.h"
+
+/**
+ * glib provides the atomic add only for the int and the pointer. So the
+ * 64-bit values are updated with the pointer atomics on the 64-bit
+ * platforms, and with the lock on the others to avoid the wrap around.
+ */
+#if GLIB_SIZEOF_VOID_P >= 8
+#define METRIC_ATOMIC_VALUE
+#else
+static pthread_mutex_t _value_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+struct _nugu_metric {
+	char name[NUGU_METRICS_MAX_NAME_LEN + 1];
+	const char *help;
+	enum nugu_metric_type type;
+	gint64 value; /* atomic */
+	gint64 count; /* atomic */
+	gint buckets[NUGU_METRICS_BUCKETS]; /* atomic */
+};
+
+/**
+ * The metric is appended under the lock and published by the count, so the
+ * readers can walk the array without any lock.
+ */
+static struct _nugu_metric _metrics[NUGU_METRICS_MAX];
+static gint _metric_count; /* atomic */
+static pthread_mutex_t _metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *_type_names[] = { "counter", "gauge", "histogram" };
+
+static gint64 _value_get(gint64 *value)
+{
+#ifdef METRIC_ATOMIC_VALUE
+	return (gint64)(gssize)g_atomic_pointer_get((gssize *)value);
+#else
+	gint64 tmp;
+
+	pthread_mutex_lock(&_value_lock);
+	tmp = *value;
+	pthread_mutex_unlock(&_value_lock);
+
+	return tmp;
+#endif
+}
+
+static void _value_set(gint64 *value, gint64 new_value)
+{
+#ifdef METRIC_ATOMIC_VALUE
+	g_atomic_pointer_set((gssize *)value, (gssize)new_value);
+#else
+	pthread_mutex_lock(&_value_lock);
+	*value = new_value;
+	pthread_mutex_unlock(&_value_lock);
+#endif
+}
+
+static void _value_add(gint64 *value, gint64 delta)
+{
+#ifdef METRIC_ATOMIC_VALUE
+	g_atomic_pointer_add((gssize *)value, (gssize)delta);
+#else
+	pthread_mutex_lock(&_value_lock);
+	*value += delta;
+	pthread_mutex_unlock(&_value_lock);
+#endif
+}
+
+static NuguMetric *_find_metric(const char *name)
+{
+	int count = g_atomic_int_get(&_metric_count);
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (g_strcmp0(_metrics[i].name, name) == 0)
+			return &_metrics[i];
+	}
+
+	return NULL;
+}
+
+static int _bucket_index(gint64 value)
+{
+	int index;
+
+	if (value <= 1)
+		return 0;
+
+	if (value > ((gint64)1 << (NUGU_METRICS_BUCKETS - 1)))
+		return NUGU_METRICS_BUCKETS - 1;
+
+	/* smallest i which satisfies value <= 2^i */
+	index = g_bit_nth_msf((gulong)(value - 1), -1) + 1;
+	if (index >= NUGU_METRICS_BUCKETS)
+		return NUGU_METRICS_BUCKETS - 1;
+
+	return index;
+}
+
+NuguMetric *nugu_metrics_register(const char *name,
+				  enum nugu_metric_type type, const char *help)
+{
+	NuguMetric *metric;
+	int count;
+
+	g_return_val_if_fail(name != NULL, NULL);
+	g_return_val_if_fail(strlen(name) <= NUGU_METRICS_MAX_NAME_LEN, NULL);
+	g_return_val_if_fail(type <= NUGU_METRIC_TYPE_HISTOGRAM, NULL);
+
+	pthread_mutex_lock(&_metrics_lock);
+
+	metric = _find_metric(name);
+	if (metric) {
+		pthread_mutex_unlock(&_metrics_lock);
+
+		if (metric->type != type) {
+			nugu_error("metric(%s) is already registered as %s",
+				   name, _type_names[metric->type]);
+			return NULL;
+		}
+
+		return metric;
+	}
+
+	count = g_atomic_int_get(&_metric_count);
+	if (count >= NUGU_METRICS_MAX) {
+		pthread_mutex_unlock(&_metrics_lock);
+		nugu_error("too many metrics (max %d)", NUGU_METRICS_MAX);
+		return NULL;
+	}
+
+	metric = &_metrics[count];
+	memset(metric, 0, sizeof(struct _nugu_metric));
+	g_strlcpy(metric->name, name, sizeof(metric->name));
+	metric->help = help;
+	metric->type = type;
+
+	g_atomic_int_set(&_metric_count, count + 1);
+
+	pthread_mutex_unlock(&_metrics_lock);
+
+	return metric;
+}
+
+NuguMetric *nugu_metrics_register_once(NuguMetric **handle, const char *name,
+				       enum nugu_metric_type type,
+				       const char *help)
+{
+	NuguMetric *metric;
+
+	g_return_val_if_fail(handle != NULL, NULL);
+
+	/* the registered metric is never removed, so the handle is kept */
+	metric = g_atomic_pointer_get(handle);
+	if (metric)
+		return metric;
+
+	metric = nugu_metrics_register(name, type, help);
+	if (metric)
+		g_atomic_pointer_set(handle, metric);
+
+	return metric;
+}
+
+NuguMetric *nugu_metrics_find(const char *name)
+{
+	g_return_val_if_fail(name != NULL, NULL);
+
+	return _find_metric(name);
+}
+
+void nugu_metric_add(NuguMetric *metric, int64_t value)
+{
+	if (!metric)
+		return;
+
+	if (metric->type == NUGU_METRIC_TYPE_COUNTER && value < 0)
+		return;
+
+	_value_add(&metric->value, value);
+}
+
+void nugu_metric_set(NuguMetric *metric, int64_t value)
+{
+	if (!metric)
+		return;
+
+	_value_set(&metric->value, value);
+}
+
+void nugu_metric_observe(NuguMetric *metric, int64_t value)
+{
+	if (!metric)
+		return;
+
+	g_atomic_int_inc(&metric->buckets[_bucket_index(value)]);
+	_value_add(&metric->value, value);
+	_value_add(&metric->count, 1);
+}
+
+int64_t nugu_metric_get(NuguMetric *metric)
+{
+	g_return_val_if_fail(metric != NULL, 0);
+
+	return _value_get(&metric->value);
+}
+
+static void _fill_snapshot(struct nugu_metric_snapshot *snapshot,
+			   NuguMetric *metric)
+{
+	int i;
+
+	memcpy(snapshot->name, metric->name, sizeof(snapshot->name));
+	snapshot->type = metric->type;
+	snapshot->value = _value_get(&metric->value);
+	snapshot->count = _value_get(&metric->count);
+
+	for (i = 0; i < NUGU_METRICS_BUCKETS; i++)
+		snapshot->buckets[i] = g_atomic_int_get(&metric->buckets[i]);
+}
+
+int nugu_metrics_get_snapshot(struct nugu_metric_snapshot *snapshots, int max)
+{
+	int count = g_atomic_int_get(&_metric_count);
+	int i;
+
+	g_return_val_if_fail(snapshots != NULL, -1);
+
+	if (count > max)
+		count = max;
+
+	for (i = 0; i < count; i++)
+		_fill_snapshot(&snapshots[i], &_metrics[i]);
+
+	return count;
+}
+
+static void _format_histogram(GString *buf,
+			      const struct nugu_metric_snapshot *snapshot)
+{
+	guint64 cumulative = 0;
+	int i;
+
+	for (i = 0; i < NUGU_METRICS_BUCKETS - 1; i++) {
+		cumulative += snapshot->buckets[i];
+		g_string_append_printf(buf,
+				       "%s_bucket{le=\"%lu\"} %" G_GUINT64_FORMAT
+				       "\n",
+				       snapshot->name, 1UL << i, cumulative);
+	}
+
+	cumulative += snapshot->buckets[NUGU_METRICS_BUCKETS - 1];
+	g_string_append_printf(buf,
+			       "%s_bucket{le=\"+Inf\"} %" G_GUINT64_FORMAT "\n",
+			       snapshot->name, cumulative);
+	g_string_append_printf(buf, "%s_sum %" G_GINT64_FORMAT "\n",
+			       snapshot->name, (gint64)snapshot->value);
+	g_string_append_printf(buf, "%s_count %" G_GINT64_FORMAT "\n",
+			       snapshot->name, (gint64)snapshot->count);
+}
+
+char *nugu_metrics_format(void)
+{
+	struct nugu_metric_snapshot snapshot;
+	int count = g_atomic_int_get(&_metric_count);
+	GString *buf;
+	int i;
+
+	buf = g_string_new(NULL);
+
+	for (i = 0; i < count; i++) {
+		_fill_snapshot(&snapshot, &_metrics[i]);
+
+		if (_metrics[i].help)
+			g_string_append_printf(buf, "# HELP %s %s\n",
+					       snapshot.name, _metrics[i].help);
+
+		g_string_append_printf(buf, "# TYPE %s %s\n", snapshot.name,
+				       _type_names[snapshot.type]);
+
+		if (snapshot.type == NUGU_METRIC_TYPE_HISTOGRAM)
+			_format_histogram(buf, &snapshot);
+		else
+			g_string_append_printf(buf, "%s %" G_GINT64_FORMAT "\n",
+					       snapshot.name,
+					       (gint64)snapshot.value);
+	}
+
+	return g_string_free(buf, FALSE);
+}
+
+void nugu_metrics_reset(void)
+{
+	int count = g_atomic_int_get(&_metric_count);
+	int i;
+	int j;
+
+	for (i = 0; i < count; i++) {
+		NuguMetric *metric = &_metrics[i];
+
+		if (metric->type == NUGU_METRIC_TYPE_GAUGE)
+			continue;
+
+		_value_set(&metric->value, 0);
+		_value_set(&metric->count, 0);
+
+		for (j = 0; j < NUGU_METRICS_BUCKETS; j++)
+			g_atomic_int_set(&metric->buckets[j], 0);
+	}
+}
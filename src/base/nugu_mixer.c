@@ -0,0 +1,782 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_resampler.h"
+#include "base/nugu_sample.h"
+#include "base/nugu_mixer.h"
+
+#define MIXER_OUTPUT_NAME "mixer_output"
+
+/* mixing unit */
+#define MIXER_PERIOD_MSEC 10
+
+/* mixed audio kept in the output stream */
+#define MIXER_LATENCY_PERIODS 4
+
+/* stop the output stream after the sources are stopped */
+#define MIXER_IDLE_MSEC 3000
+
+/* maximum gain change per period (0 to 1 in 100 msec) */
+#define MIXER_GAIN_STEP 0.1f
+
+#define MIXER_ATTRIBUTE_MAX (NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND + 1)
+
+struct _mixer_source {
+	NuguPcm *pcm;
+	NuguResampler *resampler;
+
+	int active; /* started and not stopped */
+	int paused;
+	int is_first;
+	float volume;
+	float gain; /* applied gain, ramped to the target */
+
+	/* converted audio which is not mixed yet */
+	char *read_buf;
+	size_t read_size;
+	char *pending;
+	size_t pending_len;
+	size_t pending_alloc;
+	size_t bytes_per_sec;
+	size_t played;
+
+	/* output position of the end of stream */
+	int ended;
+	size_t end_pos;
+	int eos_sent;
+	unsigned int eos_id;
+};
+
+struct _nugu_mixer {
+	NuguPcmDriver *driver;
+	NuguPcm *output;
+	NuguAudioProperty property;
+	size_t period_size;
+
+	pthread_t tid;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int quit;
+
+	/* serialize the start and stop of the output, taken before the lock */
+	pthread_mutex_t output_lock;
+
+	GList *sources;
+	int playing;
+	int output_started;
+	unsigned int idle_id;
+	size_t pushed;
+
+	float ducking[MIXER_ATTRIBUTE_MAX];
+
+	float *mix;
+	float *tmp;
+	int16_t *samples;
+	char *out_buf;
+};
+
+static struct _nugu_mixer *_mixer;
+
+static int _get_rate(enum nugu_audio_sample_rate rate)
+{
+	switch (rate) {
+	case NUGU_AUDIO_SAMPLE_RATE_8K:
+		return 8000;
+	case NUGU_AUDIO_SAMPLE_RATE_16K:
+		return 16000;
+	case NUGU_AUDIO_SAMPLE_RATE_32K:
+		return 32000;
+	case NUGU_AUDIO_SAMPLE_RATE_22K:
+		return 22050;
+	case NUGU_AUDIO_SAMPLE_RATE_44K:
+		return 44100;
+	default:
+		break;
+	}
+
+	return -1;
+}
+
+static int _is_mixing(struct _mixer_source *src)
+{
+	return src->active && !src->paused && !src->eos_sent;
+}
+
+static float _get_target_gain(struct _mixer_source *src)
+{
+	int attr = nugu_pcm_get_audio_attribute(src->pcm);
+
+	if (attr < 0 || attr >= MIXER_ATTRIBUTE_MAX)
+		return src->volume;
+
+	return src->volume * _mixer->ducking[attr];
+}
+
+static gboolean _emit_eos(void *userdata)
+{
+	struct _mixer_source *src = userdata;
+
+	pthread_mutex_lock(&_mixer->lock);
+	src->eos_id = 0;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_pcm_emit_event(src->pcm, NUGU_MEDIA_EVENT_END_OF_STREAM);
+
+	return FALSE;
+}
+
+/* read the source and convert it to the output property */
+static void _fill_pending(struct _mixer_source *src)
+{
+	while (src->pending_len < _mixer->period_size) {
+		size_t out_size;
+		int len;
+
+		len = nugu_pcm_get_data(src->pcm, src->read_buf,
+					src->read_size);
+		if (len <= 0)
+			break;
+
+		src->played += len;
+
+		out_size = nugu_resampler_get_output_size(src->resampler, len);
+		if (src->pending_len + out_size > src->pending_alloc) {
+			src->pending_alloc = src->pending_len + out_size;
+			src->pending =
+				g_realloc(src->pending, src->pending_alloc);
+		}
+
+		len = nugu_resampler_process(src->resampler, src->read_buf,
+					     len, src->pending + src->pending_len,
+					     out_size);
+		if (len > 0)
+			src->pending_len += len;
+	}
+}
+
+static void _mix_source(struct _mixer_source *src)
+{
+	size_t count;
+	size_t len;
+	size_t i;
+	float target;
+	float step;
+	float gain;
+
+	_fill_pending(src);
+
+	len = MIN(src->pending_len, _mixer->period_size);
+	if (len == 0) {
+		if (nugu_pcm_receive_is_last_data(src->pcm) && !src->ended) {
+			/* played out after the mixed audio */
+			src->ended = 1;
+			src->end_pos = _mixer->pushed;
+		}
+		return;
+	}
+
+	count = len / sizeof(int16_t);
+	nugu_sample_s16_from_le(src->pending, _mixer->samples, count);
+	nugu_sample_s16_to_float(_mixer->samples, _mixer->tmp, count);
+
+	/* ramp the gain linearly over the period */
+	target = _get_target_gain(src);
+	if (target > src->gain + MIXER_GAIN_STEP)
+		target = src->gain + MIXER_GAIN_STEP;
+	else if (target < src->gain - MIXER_GAIN_STEP)
+		target = src->gain - MIXER_GAIN_STEP;
+
+	gain = src->gain;
+	step = (target - gain) / count;
+
+	for (i = 0; i < count; i++) {
+		_mixer->mix[i] += _mixer->tmp[i] * gain;
+		gain += step;
+	}
+
+	src->gain = target;
+
+	src->pending_len -= len;
+	memmove(src->pending, src->pending + len, src->pending_len);
+}
+
+/* called with the lock */
+static void _mix_period(void)
+{
+	size_t count = _mixer->period_size / sizeof(int16_t);
+	GList *cur;
+
+	memset(_mixer->mix, 0, count * sizeof(float));
+
+	for (cur = _mixer->sources; cur; cur = cur->next) {
+		struct _mixer_source *src = cur->data;
+
+		if (_is_mixing(src) && !src->ended)
+			_mix_source(src);
+	}
+
+	nugu_sample_float_to_s16(_mixer->mix, _mixer->samples, count);
+	nugu_sample_s16_to_le(_mixer->samples, _mixer->out_buf, count);
+
+	nugu_pcm_push_data(_mixer->output, _mixer->out_buf,
+			   _mixer->period_size, 0);
+	_mixer->pushed += _mixer->period_size;
+}
+
+/* called with the lock */
+static void _check_end_of_stream(size_t played)
+{
+	GList *cur;
+
+	for (cur = _mixer->sources; cur; cur = cur->next) {
+		struct _mixer_source *src = cur->data;
+
+		if (!_is_mixing(src) || !src->ended || src->end_pos > played)
+			continue;
+
+		src->eos_sent = 1;
+		src->eos_id = nugu_mainloop_idle_add(_emit_eos, src);
+	}
+}
+
+static int _has_mixing_source(void)
+{
+	GList *cur;
+
+	for (cur = _mixer->sources; cur; cur = cur->next) {
+		if (_is_mixing(cur->data))
+			return 1;
+	}
+
+	return 0;
+}
+
+static void *_mixer_loop(void *data)
+{
+	size_t latency = _mixer->period_size * MIXER_LATENCY_PERIODS;
+
+	pthread_mutex_lock(&_mixer->lock);
+
+	while (!_mixer->quit) {
+		size_t buffered;
+
+		if (!_mixer->output_started || !_has_mixing_source()) {
+			pthread_cond_wait(&_mixer->cond, &_mixer->lock);
+			continue;
+		}
+
+		buffered = nugu_pcm_get_data_size(_mixer->output);
+		_check_end_of_stream(_mixer->pushed - buffered);
+
+		if (buffered >= latency) {
+			pthread_mutex_unlock(&_mixer->lock);
+			g_usleep(MIXER_PERIOD_MSEC * 1000 / 2);
+			pthread_mutex_lock(&_mixer->lock);
+			continue;
+		}
+
+		_mix_period();
+	}
+
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return NULL;
+}
+
+static gboolean _stop_output(void *userdata)
+{
+	pthread_mutex_lock(&_mixer->output_lock);
+	pthread_mutex_lock(&_mixer->lock);
+
+	_mixer->idle_id = 0;
+
+	if (_mixer->playing > 0 || !_mixer->output_started) {
+		pthread_mutex_unlock(&_mixer->lock);
+		pthread_mutex_unlock(&_mixer->output_lock);
+		return FALSE;
+	}
+
+	_mixer->output_started = 0;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_dbg("stop the output stream");
+	nugu_pcm_stop(_mixer->output);
+
+	pthread_mutex_unlock(&_mixer->output_lock);
+
+	return FALSE;
+}
+
+static int _start_output(void)
+{
+	int started;
+	int ret = 0;
+
+	pthread_mutex_lock(&_mixer->output_lock);
+	pthread_mutex_lock(&_mixer->lock);
+
+	if (_mixer->idle_id) {
+		nugu_mainloop_source_remove(_mixer->idle_id);
+		_mixer->idle_id = 0;
+	}
+
+	started = _mixer->output_started;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	/* the output driver is started without blocking the mixer thread */
+	if (!started) {
+		nugu_dbg("start the output stream");
+		ret = nugu_pcm_start(_mixer->output);
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+
+	if (!started && ret == 0) {
+		_mixer->output_started = 1;
+		_mixer->pushed = 0;
+	}
+
+	pthread_cond_signal(&_mixer->cond);
+	pthread_mutex_unlock(&_mixer->lock);
+
+	pthread_mutex_unlock(&_mixer->output_lock);
+
+	return ret;
+}
+
+static int _mixer_create(NuguPcmDriver *driver, NuguPcm *pcm,
+			 NuguAudioProperty property)
+{
+	struct _mixer_source *src;
+	int rate = _get_rate(property.samplerate);
+
+	if (rate < 0) {
+		nugu_error("not supported sample rate");
+		return -1;
+	}
+
+	src = g_malloc0(sizeof(struct _mixer_source));
+	if (!src) {
+		nugu_error_nomem();
+		return -1;
+	}
+
+	src->resampler = nugu_resampler_new(property, _mixer->property);
+	if (!src->resampler) {
+		g_free(src);
+		return -1;
+	}
+
+	src->pcm = pcm;
+	src->volume = 1.0f;
+	src->bytes_per_sec = (size_t)rate * property.channel * 2;
+
+	/* one period of the source */
+	src->read_size = src->bytes_per_sec * MIXER_PERIOD_MSEC / 1000;
+	src->read_buf = g_malloc(src->read_size);
+
+	nugu_pcm_set_driver_data(pcm, src);
+
+	pthread_mutex_lock(&_mixer->lock);
+	_mixer->sources = g_list_append(_mixer->sources, src);
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return 0;
+}
+
+static void _mixer_destroy(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src)
+		return;
+
+	pthread_mutex_lock(&_mixer->lock);
+
+	_mixer->sources = g_list_remove(_mixer->sources, src);
+	if (src->active)
+		_mixer->playing--;
+
+	if (src->eos_id)
+		nugu_mainloop_source_remove(src->eos_id);
+
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_resampler_free(src->resampler);
+	g_free(src->read_buf);
+	g_free(src->pending);
+	g_free(src);
+
+	nugu_pcm_set_driver_data(pcm, NULL);
+}
+
+static int _mixer_start(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	if (src->active) {
+		nugu_dbg("already started");
+		return 0;
+	}
+
+	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_READY);
+
+	pthread_mutex_lock(&_mixer->lock);
+
+	nugu_resampler_reset(src->resampler);
+	src->pending_len = 0;
+	src->played = 0;
+	src->ended = 0;
+	src->end_pos = 0;
+	src->eos_sent = 0;
+	src->paused = 0;
+	src->is_first = 1;
+	src->gain = _get_target_gain(src);
+	src->active = 1;
+	_mixer->playing++;
+
+	pthread_mutex_unlock(&_mixer->lock);
+
+	if (_start_output() < 0) {
+		nugu_error("can't start the output stream");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int _mixer_stop(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	if (!src->active) {
+		nugu_dbg("already stopped");
+		return 0;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+
+	src->active = 0;
+	if (src->eos_id) {
+		nugu_mainloop_source_remove(src->eos_id);
+		src->eos_id = 0;
+	}
+
+	_mixer->playing--;
+	if (_mixer->playing == 0 && _mixer->idle_id == 0)
+		_mixer->idle_id = nugu_mainloop_timeout_add(MIXER_IDLE_MSEC,
+							    _stop_output, NULL);
+
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_STOPPED);
+
+	return 0;
+}
+
+static int _mixer_pause(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+	src->paused = 1;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_PAUSED);
+
+	return 0;
+}
+
+static int _mixer_resume(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+	src->paused = 0;
+	pthread_cond_signal(&_mixer->cond);
+	pthread_mutex_unlock(&_mixer->lock);
+
+	nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_PLAYING);
+
+	return 0;
+}
+
+static int _mixer_set_volume(NuguPcmDriver *driver, NuguPcm *pcm, int volume)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+	src->volume = (float)volume / NUGU_SET_VOLUME_MAX;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return 0;
+}
+
+static int _mixer_get_position(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+	int position;
+
+	if (!src) {
+		nugu_error("internal error");
+		return -1;
+	}
+
+	if (!src->active) {
+		nugu_error("pcm is not started");
+		return -1;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+	position = (int)(src->played / src->bytes_per_sec);
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return position;
+}
+
+static int _mixer_push_data(NuguPcmDriver *driver, NuguPcm *pcm,
+			    const char *data, size_t size, int is_last)
+{
+	struct _mixer_source *src = nugu_pcm_get_driver_data(pcm);
+
+	if (!src) {
+		nugu_error("pcm is not started");
+		return -1;
+	}
+
+	if (src->is_first) {
+		src->is_first = 0;
+		nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_PLAYING);
+	}
+
+	return 0;
+}
+
+static struct nugu_pcm_driver_ops mixer_ops = {
+	.create = _mixer_create, /* nugu_pcm_new() */
+	.destroy = _mixer_destroy, /* nugu_pcm_free() */
+	.start = _mixer_start, /* nugu_pcm_start() */
+	.stop = _mixer_stop, /* nugu_pcm_stop() */
+	.pause = _mixer_pause, /* nugu_pcm_pause() */
+	.resume = _mixer_resume, /* nugu_pcm_resume() */
+	.push_data = _mixer_push_data, /* nugu_pcm_push_data() */
+	.set_volume = _mixer_set_volume, /* nugu_pcm_set_volume() */
+	.get_position = _mixer_get_position /* nugu_pcm_get_position() */
+};
+
+static void _mixer_free(struct _nugu_mixer *mixer)
+{
+	if (mixer->output)
+		nugu_pcm_free(mixer->output);
+
+	if (mixer->driver)
+		nugu_pcm_driver_free(mixer->driver);
+
+	pthread_mutex_destroy(&mixer->lock);
+	pthread_mutex_destroy(&mixer->output_lock);
+	pthread_cond_destroy(&mixer->cond);
+
+	g_free(mixer->mix);
+	g_free(mixer->tmp);
+	g_free(mixer->samples);
+	g_free(mixer->out_buf);
+	g_free(mixer);
+}
+
+int nugu_mixer_initialize(NuguPcmDriver *output, NuguAudioProperty property)
+{
+	struct _nugu_mixer *mixer;
+	int rate = _get_rate(property.samplerate);
+	size_t count;
+	int i;
+
+	g_return_val_if_fail(output != NULL, -1);
+
+	if (_mixer) {
+		nugu_dbg("already initialized");
+		return 0;
+	}
+
+	if (rate < 0 || property.format != NUGU_AUDIO_FORMAT_S16_LE ||
+	    property.channel < 1) {
+		nugu_error("not supported output property");
+		return -1;
+	}
+
+	mixer = g_malloc0(sizeof(struct _nugu_mixer));
+	if (!mixer) {
+		nugu_error_nomem();
+		return -1;
+	}
+
+	pthread_mutex_init(&mixer->lock, NULL);
+	pthread_mutex_init(&mixer->output_lock, NULL);
+	pthread_cond_init(&mixer->cond, NULL);
+
+	mixer->property = property;
+	mixer->period_size =
+		(size_t)rate * MIXER_PERIOD_MSEC / 1000 * property.channel * 2;
+
+	for (i = 0; i < MIXER_ATTRIBUTE_MAX; i++)
+		mixer->ducking[i] = 1.0f;
+
+	count = mixer->period_size / sizeof(int16_t);
+	mixer->mix = g_new0(float, count);
+	mixer->tmp = g_new0(float, count);
+	mixer->samples = g_new0(int16_t, count);
+	mixer->out_buf = g_malloc0(mixer->period_size);
+
+	mixer->output = nugu_pcm_new(MIXER_OUTPUT_NAME, output, property);
+	if (!mixer->output) {
+		nugu_error("can't create the output stream");
+		_mixer_free(mixer);
+		return -1;
+	}
+
+	mixer->driver = nugu_pcm_driver_new(NUGU_MIXER_DRIVER_NAME, &mixer_ops);
+	if (nugu_pcm_driver_register(mixer->driver) < 0) {
+		_mixer_free(mixer);
+		return -1;
+	}
+
+	_mixer = mixer;
+
+	if (pthread_create(&mixer->tid, NULL, _mixer_loop, NULL) != 0) {
+		nugu_error("pthread_create() failed");
+		nugu_pcm_driver_remove(mixer->driver);
+		_mixer = NULL;
+		_mixer_free(mixer);
+		return -1;
+	}
+
+	nugu_dbg("mixer initialized (period: %zd bytes)", mixer->period_size);
+
+	return 0;
+}
+
+int nugu_mixer_deinitialize(void)
+{
+	if (!_mixer)
+		return 0;
+
+	if (_mixer->sources) {
+		nugu_error("pcm still using the mixer");
+		return -1;
+	}
+
+	pthread_mutex_lock(&_mixer->lock);
+	_mixer->quit = 1;
+	pthread_cond_signal(&_mixer->cond);
+	pthread_mutex_unlock(&_mixer->lock);
+
+	pthread_join(_mixer->tid, NULL);
+
+	if (_mixer->idle_id)
+		nugu_mainloop_source_remove(_mixer->idle_id);
+
+	if (_mixer->output_started)
+		nugu_pcm_stop(_mixer->output);
+
+	nugu_pcm_driver_remove(_mixer->driver);
+	_mixer_free(_mixer);
+	_mixer = NULL;
+
+	return 0;
+}
+
+NuguPcmDriver *nugu_mixer_get_driver(void)
+{
+	if (!_mixer)
+		return NULL;
+
+	return _mixer->driver;
+}
+
+NuguPcm *nugu_mixer_get_output(void)
+{
+	if (!_mixer)
+		return NULL;
+
+	return _mixer->output;
+}
+
+int nugu_mixer_set_ducking(NuguAudioAttribute attr, float gain)
+{
+	g_return_val_if_fail(_mixer != NULL, -1);
+	g_return_val_if_fail(attr > 0 && attr < MIXER_ATTRIBUTE_MAX, -1);
+
+	if (gain < 0.0f)
+		gain = 0.0f;
+	else if (gain > 1.0f)
+		gain = 1.0f;
+
+	nugu_dbg("ducking(%s): %.2f", nugu_audio_get_attribute_str(attr),
+		 gain);
+
+	pthread_mutex_lock(&_mixer->lock);
+	_mixer->ducking[attr] = gain;
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return 0;
+}
+
+float nugu_mixer_get_ducking(NuguAudioAttribute attr)
+{
+	float gain;
+
+	g_return_val_if_fail(_mixer != NULL, 1.0f);
+	g_return_val_if_fail(attr > 0 && attr < MIXER_ATTRIBUTE_MAX, 1.0f);
+
+	pthread_mutex_lock(&_mixer->lock);
+	gain = _mixer->ducking[attr];
+	pthread_mutex_unlock(&_mixer->lock);
+
+	return gain;
+}
@@ -32,6 +32,8 @@
 #include "base/nugu_log.h"
 #include "base/nugu_uuid.h"
 #include "base/nugu_equeue.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_network_manager.h"
 #include "base/nugu_prof.h"
 
@@ -95,6 +97,8 @@ struct _nugu_network {
 	DGServer *server;
 	time_t tsec_connected;
 
+	NuguMetric *reconnects;
+
 	/* Handoff */
 	DGServer *handoff;
 	NuguNetworkManagerHandoffStatusCallback handoff_callback;
@@ -255,11 +259,11 @@ static void on_event_response(enum nugu_equeue_type type, void *data,
 
 	if (nm->connection_type == NUGU_NETWORK_CONNECTION_ONDEMAND) {
 		if (nm->src_ondemand_timeout > 0)
-			g_source_remove(nm->src_ondemand_timeout);
+			nugu_mainloop_source_remove(nm->src_ondemand_timeout);
 
-		nm->src_ondemand_timeout =
-			g_timeout_add_seconds(ONDEMAND_CONNECTION_TIMEOUT_SECS,
-					      _on_ondemand_timeout, nm);
+		nm->src_ondemand_timeout = nugu_mainloop_timeout_add_seconds(
+			ONDEMAND_CONNECTION_TIMEOUT_SECS, _on_ondemand_timeout,
+			nm);
 	}
 
 	if (nm->event_response_callback == NULL)
@@ -379,6 +383,7 @@ static void _try_connect_to_handoff(NetworkManager *nm)
 	/* Retry to connect to handoff server */
 	if (dg_server_is_retry_over(nm->handoff) == 0) {
 		dg_server_increase_retry_count(nm->handoff);
+		nugu_metric_add(nm->reconnects, 1);
 		_log_server_info(nm, nm->handoff);
 
 		if (dg_server_connect_async(nm->handoff) == 0) {
@@ -450,6 +455,7 @@ static void _try_connect_to_servers(NetworkManager *nm)
 		/* Retry to connect to current server */
 		if (dg_server_is_retry_over(nm->server) == 0) {
 			dg_server_increase_retry_count(nm->server);
+			nugu_metric_add(nm->reconnects, 1);
 			_log_server_info(nm, nm->server);
 
 			if (dg_server_connect_async(nm->server) == 0) {
@@ -728,6 +734,10 @@ static NetworkManager *nugu_network_manager_new(void)
 		return NULL;
 	}
 
+	nm->reconnects = nugu_metrics_register(
+		"nugu_network_reconnects", NUGU_METRIC_TYPE_COUNTER,
+		"Number of the retries to connect to the server");
+
 	/* Received message from server */
 	nugu_equeue_set_handler(NUGU_EQUEUE_TYPE_NEW_DIRECTIVE, on_directive,
 				on_destroy_directive, nm);
@@ -776,7 +786,7 @@ static void nugu_network_manager_free(NetworkManager *nm)
 	g_return_if_fail(nm != NULL);
 
 	if (nm->src_ondemand_timeout > 0)
-		g_source_remove(nm->src_ondemand_timeout);
+		nugu_mainloop_source_remove(nm->src_ondemand_timeout);
 
 	if (nm->server_list)
 		g_list_free_full(nm->server_list, free);
@@ -1056,7 +1066,8 @@ int nugu_network_manager_send_event(NuguEvent *nev)
 		}
 
 		if (_network->src_ondemand_timeout > 0) {
-			g_source_remove(_network->src_ondemand_timeout);
+			nugu_mainloop_source_remove(
+				_network->src_ondemand_timeout);
 			_network->src_ondemand_timeout = 0;
 		}
 	}
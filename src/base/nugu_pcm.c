@@ -21,8 +21,34 @@
 #include <glib.h>
 
 #include "base/nugu_log.h"
-#include "base/nugu_buffer.h"
+#include "base/nugu_memory.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_pcm.h"
+#include "base/nugu_plugin.h"
+
+#define PCM_CHUNK_SIZE 16384
+
+/**
+ * PCM data is stored in a linked list of fixed size chunks.
+ *
+ * The list is a single producer (push_data) and single consumer (get_data)
+ * queue without lock. The producer fills the tail chunk and links a new one
+ * when it is full, the consumer reads from the head chunk and moves to the
+ * next one when it is consumed. The chunks behind the head are recycled by
+ * the producer, so the consumer never allocates or frees memory.
+ *
+ * The producer can also reserve a contiguous space in the tail chunk
+ * (reserve_data) and publish it after filling (commit_data). If the tail
+ * chunk doesn't have enough space, it is closed at the current position
+ * by reducing the size and a new chunk is linked.
+ */
+struct _pcm_chunk {
+	struct _pcm_chunk *next; /* atomic */
+	gint wpos; /* atomic: written by the producer */
+	gint rpos; /* accessed only by the consumer */
+	gint size; /* atomic: usable size, reduced when closed early */
+	char data[PCM_CHUNK_SIZE];
+};
 
 struct _nugu_pcm_driver {
 	char *name;
@@ -42,17 +68,172 @@ struct _nugu_pcm {
 	NuguMediaStatusCallback scb;
 	void *eud; /* user data for event callback */
 	void *sud; /* user data for status callback */
-	NuguBuffer *buf;
-	int is_last;
 	int volume;
-	size_t total_size;
-
-	pthread_mutex_t mutex;
+	gsize total_size; /* atomic */
+
+	/* consumer side */
+	struct _pcm_chunk *head; /* atomic */
+	gsize read_total; /* atomic */
+	gint underruns; /* atomic */
+	NuguMetric *total_underruns;
+
+	/* producer side */
+	struct _pcm_chunk *tail;
+	struct _pcm_chunk *first;
+	struct _pcm_chunk *head_copy;
+	gsize written_total; /* atomic */
+	size_t reserved;
+
+	/* data pushed before this position is discarded by the consumer */
+	gsize discard_total; /* atomic */
+	gint is_last; /* atomic */
+
+	/* jitter buffer */
+	gsize start_threshold; /* atomic */
+	gsize started_discard; /* atomic: discard_total + 1 of started stream */
+	gsize first_push_msec; /* atomic */
+	gint start_latency; /* atomic */
 };
 
 static GList *_pcms;
 static GList *_pcm_drivers;
 static NuguPcmDriver *_default_driver;
+static NuguMetric *_underruns_metric;
+
+static struct _pcm_chunk *_chunk_new(NuguPcm *pcm)
+{
+	struct _pcm_chunk *chunk;
+
+	/* reuse the chunks which are already consumed */
+	if (pcm->first == pcm->head_copy)
+		pcm->head_copy = g_atomic_pointer_get(&pcm->head);
+
+	if (pcm->first != pcm->head_copy) {
+		chunk = pcm->first;
+		pcm->first = chunk->next;
+
+		chunk->next = NULL;
+		chunk->rpos = 0;
+		g_atomic_int_set(&chunk->size, PCM_CHUNK_SIZE);
+		g_atomic_int_set(&chunk->wpos, 0);
+
+		return chunk;
+	}
+
+	/* malloc instead of nugu_memory_alloc() to skip the zero-fill */
+	chunk = malloc(sizeof(struct _pcm_chunk));
+	if (!chunk) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	nugu_memory_add(NUGU_MEMORY_TAG_PCM, sizeof(struct _pcm_chunk));
+
+	chunk->next = NULL;
+	chunk->wpos = 0;
+	chunk->rpos = 0;
+	chunk->size = PCM_CHUNK_SIZE;
+
+	return chunk;
+}
+
+static int _chunk_link_new(NuguPcm *pcm)
+{
+	struct _pcm_chunk *chunk = pcm->tail;
+	struct _pcm_chunk *next = _chunk_new(pcm);
+
+	if (!next)
+		return -1;
+
+	/* close the tail chunk at the current position */
+	if (chunk->wpos != chunk->size)
+		g_atomic_int_set(&chunk->size, chunk->wpos);
+
+	g_atomic_pointer_set(&chunk->next, next);
+	pcm->tail = next;
+
+	return 0;
+}
+
+static void _notify_push_data(NuguPcm *pcm, const char *data, size_t size)
+{
+	if (pcm->driver && pcm->driver->ops && pcm->driver->ops->push_data)
+		pcm->driver->ops->push_data(pcm->driver, pcm, data, size,
+					    g_atomic_int_get(&pcm->is_last));
+}
+
+static void _chunk_free_all(NuguPcm *pcm)
+{
+	struct _pcm_chunk *chunk = pcm->first;
+
+	while (chunk) {
+		struct _pcm_chunk *next = chunk->next;
+
+		nugu_memory_free(NUGU_MEMORY_TAG_PCM, chunk,
+				 sizeof(struct _pcm_chunk));
+		chunk = next;
+	}
+
+	pcm->first = NULL;
+	pcm->head = NULL;
+	pcm->tail = NULL;
+	pcm->head_copy = NULL;
+}
+
+static gsize _get_msec(void)
+{
+	/* the difference is still valid when the value is wrapped around */
+	return (gsize)(g_get_monotonic_time() / 1000);
+}
+
+static void _mark_first_push(NuguPcm *pcm, gsize written)
+{
+	if (written != (gsize)g_atomic_pointer_get(&pcm->discard_total))
+		return;
+
+	g_atomic_pointer_set(&pcm->first_push_msec, (gpointer)_get_msec());
+}
+
+/* called by the consumer, returns whether the playback can be started */
+static int _check_start_threshold(NuguPcm *pcm, gsize discard)
+{
+	gsize written;
+	gsize threshold;
+	gsize first;
+
+	if ((gsize)g_atomic_pointer_get(&pcm->started_discard) == discard + 1)
+		return 1;
+
+	/* nothing to play yet */
+	written = (gsize)g_atomic_pointer_get(&pcm->written_total);
+	if (written <= discard)
+		return 0;
+
+	threshold = (gsize)g_atomic_pointer_get(&pcm->start_threshold);
+	if (written - discard < threshold && !g_atomic_int_get(&pcm->is_last))
+		return 0;
+
+	first = (gsize)g_atomic_pointer_get(&pcm->first_push_msec);
+	g_atomic_int_set(&pcm->start_latency, (gint)(_get_msec() - first));
+	g_atomic_pointer_set(&pcm->started_discard, (gpointer)(discard + 1));
+
+	return 1;
+}
+
+static gsize _get_readable_size(NuguPcm *pcm)
+{
+	gsize written = (gsize)g_atomic_pointer_get(&pcm->written_total);
+	gsize read = (gsize)g_atomic_pointer_get(&pcm->read_total);
+	gsize discard = (gsize)g_atomic_pointer_get(&pcm->discard_total);
+
+	if (discard > read)
+		read = discard;
+
+	if (written < read)
+		return 0;
+
+	return written - read;
+}
 
 NuguPcmDriver *nugu_pcm_driver_new(const char *name,
 				   struct nugu_pcm_driver_ops *ops)
@@ -95,11 +276,26 @@ int nugu_pcm_driver_free(NuguPcmDriver *driver)
 	return 0;
 }
 
+static NuguPcmDriver *_find_driver(const char *name)
+{
+	GList *cur;
+
+	cur = _pcm_drivers;
+	while (cur) {
+		if (g_strcmp0(((NuguPcmDriver *)cur->data)->name, name) == 0)
+			return cur->data;
+
+		cur = cur->next;
+	}
+
+	return NULL;
+}
+
 int nugu_pcm_driver_register(NuguPcmDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
-	if (nugu_pcm_driver_find(driver->name)) {
+	if (_find_driver(driver->name)) {
 		nugu_error("'%s' pcm driver already exist.", driver->name);
 		return -1;
 	}
@@ -156,24 +352,18 @@ NuguPcmDriver *nugu_pcm_driver_get_default(void)
 	}
 #endif
 
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PCM);
+
 	return _default_driver;
 }
 
 NuguPcmDriver *nugu_pcm_driver_find(const char *name)
 {
-	GList *cur;
-
 	g_return_val_if_fail(name != NULL, NULL);
 
-	cur = _pcm_drivers;
-	while (cur) {
-		if (g_strcmp0(((NuguPcmDriver *)cur->data)->name, name) == 0)
-			return cur->data;
-
-		cur = cur->next;
-	}
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PCM);
 
-	return NULL;
+	return _find_driver(name);
 }
 
 NuguPcm *nugu_pcm_new(const char *name, NuguPcmDriver *driver,
@@ -190,14 +380,17 @@ NuguPcm *nugu_pcm_new(const char *name, NuguPcmDriver *driver,
 	}
 
 	pcm->name = g_strdup(name);
-	pcm->buf = nugu_buffer_new(0);
-	if (pcm->buf == NULL) {
-		nugu_error("nugu_buffer_new() failed");
+	pcm->head = _chunk_new(pcm);
+	if (pcm->head == NULL) {
 		g_free(pcm->name);
 		g_free(pcm);
 		return NULL;
 	}
 
+	pcm->tail = pcm->head;
+	pcm->first = pcm->head;
+	pcm->head_copy = pcm->head;
+
 	pcm->driver = driver;
 	pcm->is_last = 0;
 	pcm->scb = NULL;
@@ -209,10 +402,13 @@ NuguPcm *nugu_pcm_new(const char *name, NuguPcmDriver *driver,
 	pcm->attr = NUGU_AUDIO_ATTRIBUTE_VOICE_COMMAND;
 	pcm->volume = NUGU_SET_VOLUME_MAX;
 	pcm->total_size = 0;
+	pcm->start_latency = -1;
+	pcm->total_underruns = nugu_metrics_register_once(
+		&_underruns_metric, "nugu_pcm_underruns",
+		NUGU_METRIC_TYPE_COUNTER,
+		"Number of the reads which had not enough pcm data");
 	memcpy(&pcm->property, &property, sizeof(NuguAudioProperty));
 
-	pthread_mutex_init(&pcm->mutex, NULL);
-
 	if (driver == NULL || driver->ops == NULL ||
 	    driver->ops->create == NULL) {
 		nugu_warn("Not supported");
@@ -222,7 +418,7 @@ NuguPcm *nugu_pcm_new(const char *name, NuguPcmDriver *driver,
 	if (pcm->driver->ops->create(pcm->driver, pcm, pcm->property) < 0) {
 		nugu_error("can't create nugu_pcm");
 		g_free(pcm->name);
-		nugu_buffer_free(pcm->buf, 1);
+		_chunk_free_all(pcm);
 		g_free(pcm);
 		return NULL;
 	}
@@ -244,9 +440,7 @@ void nugu_pcm_free(NuguPcm *pcm)
 	}
 
 	g_free(pcm->name);
-	nugu_buffer_free(pcm->buf, 1);
-
-	pthread_mutex_destroy(&pcm->mutex);
+	_chunk_free_all(pcm);
 
 	memset(pcm, 0, sizeof(struct _nugu_pcm));
 	g_free(pcm);
@@ -434,7 +628,7 @@ int nugu_pcm_get_duration(NuguPcm *pcm)
 		break;
 	}
 
-	return (pcm->total_size / samplerate);
+	return ((gsize)g_atomic_pointer_get(&pcm->total_size) / samplerate);
 }
 
 int nugu_pcm_get_position(NuguPcm *pcm)
@@ -518,51 +712,144 @@ void *nugu_pcm_get_driver_data(NuguPcm *pcm)
 void nugu_pcm_clear_buffer(NuguPcm *pcm)
 {
 	g_return_if_fail(pcm != NULL);
-	g_return_if_fail(pcm->buf != NULL);
-
-	pthread_mutex_lock(&pcm->mutex);
 
-	nugu_buffer_clear(pcm->buf);
-	pcm->total_size = 0;
-	pcm->is_last = 0;
-
-	pthread_mutex_unlock(&pcm->mutex);
+	/**
+	 * The consumer may be running on the audio thread, so the data is not
+	 * released here. The consumer skips it on the next read.
+	 */
+	g_atomic_pointer_set(&pcm->discard_total,
+			     g_atomic_pointer_get(&pcm->written_total));
+	g_atomic_int_set(&pcm->is_last, 0);
+	g_atomic_int_set(&pcm->underruns, 0);
+	g_atomic_int_set(&pcm->start_latency, -1);
+	g_atomic_pointer_set(&pcm->total_size, 0);
 }
 
 int nugu_pcm_push_data(NuguPcm *pcm, const char *data, size_t size, int is_last)
 {
-	int ret;
+	const char *ptr = data;
+	size_t remain = size;
+	gsize written;
 
 	g_return_val_if_fail(pcm != NULL, -1);
-	g_return_val_if_fail(pcm->buf != NULL, -1);
+	g_return_val_if_fail(pcm->tail != NULL, -1);
 	g_return_val_if_fail(data != NULL, -1);
 	g_return_val_if_fail(size > 0, -1);
 
-	pthread_mutex_lock(&pcm->mutex);
+	written = (gsize)g_atomic_pointer_get(&pcm->written_total);
+	_mark_first_push(pcm, written);
 
-	pcm->total_size += size;
-	if (!pcm->is_last)
-		pcm->is_last = is_last;
+	while (remain > 0) {
+		struct _pcm_chunk *chunk = pcm->tail;
+		gint wpos = g_atomic_int_get(&chunk->wpos);
+		size_t len;
 
-	ret = nugu_buffer_add(pcm->buf, (void *)data, size);
+		if (wpos == chunk->size) {
+			if (_chunk_link_new(pcm) < 0)
+				return -1;
 
-	pthread_mutex_unlock(&pcm->mutex);
+			continue;
+		}
 
-	if (pcm->driver && pcm->driver->ops && pcm->driver->ops->push_data)
-		pcm->driver->ops->push_data(pcm->driver, pcm, data, size,
-					    pcm->is_last);
-	return ret;
+		len = chunk->size - wpos;
+		if (len > remain)
+			len = remain;
+
+		memcpy(chunk->data + wpos, ptr, len);
+
+		/* publish the data to the consumer */
+		g_atomic_int_set(&chunk->wpos, wpos + (gint)len);
+
+		written += len;
+		g_atomic_pointer_set(&pcm->written_total, written);
+
+		ptr += len;
+		remain -= len;
+	}
+
+	g_atomic_pointer_add((gssize *)&pcm->total_size, (gssize)size);
+	if (is_last)
+		g_atomic_int_set(&pcm->is_last, 1);
+
+	_notify_push_data(pcm, data, size);
+
+	return size;
 }
 
-int nugu_pcm_push_data_done(NuguPcm *pcm)
+char *nugu_pcm_reserve_data(NuguPcm *pcm, size_t size)
 {
+	struct _pcm_chunk *chunk;
+
+	g_return_val_if_fail(pcm != NULL, NULL);
+	g_return_val_if_fail(pcm->tail != NULL, NULL);
+	g_return_val_if_fail(size > 0, NULL);
+
+	if (size > PCM_CHUNK_SIZE) {
+		nugu_error("reserve size(%zd) is too big", size);
+		return NULL;
+	}
+
+	chunk = pcm->tail;
+	if ((size_t)(chunk->size - chunk->wpos) < size) {
+		if (_chunk_link_new(pcm) < 0)
+			return NULL;
+
+		chunk = pcm->tail;
+	}
+
+	pcm->reserved = size;
+
+	return chunk->data + chunk->wpos;
+}
+
+int nugu_pcm_commit_data(NuguPcm *pcm, size_t size, int is_last)
+{
+	struct _pcm_chunk *chunk;
+	gint wpos;
+	gsize written;
+
 	g_return_val_if_fail(pcm != NULL, -1);
+	g_return_val_if_fail(pcm->tail != NULL, -1);
+
+	if (size > pcm->reserved) {
+		nugu_error("commit size(%zd) is bigger than reserved(%zd)",
+			   size, pcm->reserved);
+		return -1;
+	}
+
+	pcm->reserved = 0;
 
-	pthread_mutex_lock(&pcm->mutex);
+	chunk = pcm->tail;
+	wpos = chunk->wpos;
 
-	pcm->is_last = 1;
+	if (size > 0) {
+		/* publish the data to the consumer */
+		g_atomic_int_set(&chunk->wpos, wpos + (gint)size);
 
-	pthread_mutex_unlock(&pcm->mutex);
+		written = (gsize)g_atomic_pointer_get(&pcm->written_total);
+		_mark_first_push(pcm, written);
+		g_atomic_pointer_set(&pcm->written_total, written + size);
+
+		g_atomic_pointer_add((gssize *)&pcm->total_size,
+				     (gssize)size);
+	}
+
+	if (is_last)
+		g_atomic_int_set(&pcm->is_last, 1);
+
+	if (size > 0)
+		_notify_push_data(pcm, chunk->data + wpos, size);
+	else if (is_last)
+		_notify_push_data(pcm, NULL, 0);
+
+	return 0;
+}
+
+int nugu_pcm_push_data_done(NuguPcm *pcm)
+{
+	g_return_val_if_fail(pcm != NULL, -1);
+
+	g_atomic_int_set(&pcm->is_last, 1);
 
 	if (pcm->driver && pcm->driver->ops && pcm->driver->ops->push_data)
 		pcm->driver->ops->push_data(pcm->driver, pcm, NULL, 0, 1);
@@ -572,62 +859,117 @@ int nugu_pcm_push_data_done(NuguPcm *pcm)
 
 int nugu_pcm_get_data(NuguPcm *pcm, char *data, size_t size)
 {
-	size_t data_size;
-	const char *ptr;
-	int ret;
+	gsize read;
+	gsize discard;
+	size_t copied = 0;
 
 	g_return_val_if_fail(pcm != NULL, -1);
-	g_return_val_if_fail(pcm->buf != NULL, -1);
+	g_return_val_if_fail(pcm->head != NULL, -1);
 	g_return_val_if_fail(data != NULL, -1);
 	g_return_val_if_fail(size != 0, -1);
 
-	pthread_mutex_lock(&pcm->mutex);
+	read = (gsize)g_atomic_pointer_get(&pcm->read_total);
+	discard = (gsize)g_atomic_pointer_get(&pcm->discard_total);
 
-	data_size = nugu_buffer_get_size(pcm->buf);
-	if (data_size < size)
-		size = data_size;
+	/* buffering is not counted as the underrun */
+	if (!_check_start_threshold(pcm, discard))
+		return 0;
 
-	ptr = nugu_buffer_peek(pcm->buf);
-	if (ptr == NULL) {
-		pthread_mutex_unlock(&pcm->mutex);
+	/* wait-free: bounded by the number of available chunks */
+	while (copied < size) {
+		struct _pcm_chunk *chunk = pcm->head;
+		gint avail = g_atomic_int_get(&chunk->wpos) - chunk->rpos;
+		size_t len;
 
-		nugu_error("buffer peek is internal error");
-		return -1;
-	}
+		if (avail == 0) {
+			struct _pcm_chunk *next;
 
-	memcpy(data, ptr, size);
+			if (chunk->rpos < g_atomic_int_get(&chunk->size))
+				break;
 
-	ret = nugu_buffer_shift_left(pcm->buf, size);
-	if (ret == -1) {
-		pthread_mutex_unlock(&pcm->mutex);
+			next = g_atomic_pointer_get(&chunk->next);
+			if (!next)
+				break;
 
-		nugu_error("buffer shift left is internal error");
-		return -1;
+			g_atomic_pointer_set(&pcm->head, next);
+			continue;
+		}
+
+		len = avail;
+
+		if (read < discard) {
+			/* skip the cleared data */
+			if (len > discard - read)
+				len = discard - read;
+		} else {
+			if (len > size - copied)
+				len = size - copied;
+
+			memcpy(data + copied, chunk->data + chunk->rpos, len);
+			copied += len;
+		}
+
+		chunk->rpos += (gint)len;
+		read += len;
 	}
 
-	pthread_mutex_unlock(&pcm->mutex);
+	g_atomic_pointer_set(&pcm->read_total, read);
 
-	return size;
+	/* count only after the playback data has started to be pushed */
+	if (copied < size && !g_atomic_int_get(&pcm->is_last) &&
+	    read > discard) {
+		g_atomic_int_inc(&pcm->underruns);
+		nugu_metric_add(pcm->total_underruns, 1);
+	}
+
+	return copied;
 }
 
 size_t nugu_pcm_get_data_size(NuguPcm *pcm)
 {
-	size_t ret;
+	g_return_val_if_fail(pcm != NULL, -1);
+
+	return _get_readable_size(pcm);
+}
 
+int nugu_pcm_receive_is_last_data(NuguPcm *pcm)
+{
 	g_return_val_if_fail(pcm != NULL, -1);
 
-	pthread_mutex_lock(&pcm->mutex);
+	return g_atomic_int_get(&pcm->is_last);
+}
 
-	ret = nugu_buffer_get_size(pcm->buf);
+unsigned int nugu_pcm_get_underrun_count(NuguPcm *pcm)
+{
+	g_return_val_if_fail(pcm != NULL, 0);
 
-	pthread_mutex_unlock(&pcm->mutex);
+	return g_atomic_int_get(&pcm->underruns);
+}
 
-	return ret;
+void nugu_pcm_set_start_threshold(NuguPcm *pcm, size_t size)
+{
+	g_return_if_fail(pcm != NULL);
+
+	g_atomic_pointer_set(&pcm->start_threshold, (gpointer)(gsize)size);
 }
 
-int nugu_pcm_receive_is_last_data(NuguPcm *pcm)
+size_t nugu_pcm_get_start_threshold(NuguPcm *pcm)
+{
+	g_return_val_if_fail(pcm != NULL, 0);
+
+	return (gsize)g_atomic_pointer_get(&pcm->start_threshold);
+}
+
+int nugu_pcm_get_start_latency(NuguPcm *pcm)
 {
 	g_return_val_if_fail(pcm != NULL, -1);
 
-	return pcm->is_last;
+	return g_atomic_int_get(&pcm->start_latency);
+}
+
+size_t nugu_pcm_get_total_size(NuguPcm *pcm)
+{
+	g_return_val_if_fail(pcm != NULL, 0);
+
+	return (gsize)g_atomic_pointer_get(&pcm->total_size);
 }
@@ -22,6 +22,7 @@
 
 #include "base/nugu_log.h"
 #include "base/nugu_player.h"
+#include "base/nugu_plugin.h"
 
 struct _nugu_player_driver {
 	char *name;
@@ -88,11 +89,26 @@ int nugu_player_driver_free(NuguPlayerDriver *driver)
 	return 0;
 }
 
+static NuguPlayerDriver *_find_driver(const char *name)
+{
+	GList *cur;
+
+	cur = _player_drivers;
+	while (cur) {
+		if (g_strcmp0(((NuguPlayerDriver *)cur->data)->name, name) == 0)
+			return cur->data;
+
+		cur = cur->next;
+	}
+
+	return NULL;
+}
+
 int nugu_player_driver_register(NuguPlayerDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
-	if (nugu_player_driver_find(driver->name)) {
+	if (_find_driver(driver->name)) {
 		nugu_error("'%s' player driver already exist.", driver->name);
 		return -1;
 	}
@@ -139,24 +155,18 @@ int nugu_player_driver_set_default(NuguPlayerDriver *driver)
 
 NuguPlayerDriver *nugu_player_driver_get_default(void)
 {
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PLAYER);
+
 	return _default_driver;
 }
 
 NuguPlayerDriver *nugu_player_driver_find(const char *name)
 {
-	GList *cur;
-
 	g_return_val_if_fail(name != NULL, NULL);
 
-	cur = _player_drivers;
-	while (cur) {
-		if (g_strcmp0(((NuguPlayerDriver *)cur->data)->name, name) == 0)
-			return cur->data;
-
-		cur = cur->next;
-	}
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PLAYER);
 
-	return NULL;
+	return _find_driver(name);
 }
 
 NuguPlayer *nugu_player_new(const char *name, NuguPlayerDriver *driver)
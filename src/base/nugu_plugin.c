@@ -45,15 +45,35 @@
 
 struct _plugin {
 	const struct nugu_plugin_desc *desc;
+	struct nugu_plugin_desc_ext ext;
 	void *data;
 	DYNLIB_HANDLE handle;
 	char *filename;
 	gboolean active;
+	gboolean pending;
+	gboolean failed;
 };
 
 static GList *_plugin_list;
 
+/**
+ * The lock protects the list and the lazy plugins against
+ * nugu_plugin_require() on the other threads.
+ */
+static GRecMutex _plugin_lock;
+static gint _pending_count; /* atomic */
+static int _require_depth;
+
+/* the failed plugins are removed after nugu_plugin_initialize() walks */
+static int _initializing;
+
 NuguPlugin *nugu_plugin_new(struct nugu_plugin_desc *desc)
+{
+	return nugu_plugin_new_full(desc, NULL);
+}
+
+NuguPlugin *nugu_plugin_new_full(struct nugu_plugin_desc *desc,
+				 const struct nugu_plugin_desc_ext *ext)
 {
 	NuguPlugin *p;
 
@@ -72,9 +92,18 @@ NuguPlugin *nugu_plugin_new(struct nugu_plugin_desc *desc)
 	}
 
 	p->desc = desc;
+
+	/* the extension of the older plugin has only the known fields */
+	memset(&p->ext, 0, sizeof(struct nugu_plugin_desc_ext));
+	if (ext)
+		memcpy(&p->ext, ext,
+		       MIN(ext->size, sizeof(struct nugu_plugin_desc_ext)));
+
 	p->data = NULL;
 	p->handle = NULL;
 	p->active = FALSE;
+	p->pending = FALSE;
+	p->failed = FALSE;
 	p->filename = NULL;
 
 	return p;
@@ -84,6 +113,7 @@ NuguPlugin *nugu_plugin_new_from_file(const char *filepath)
 {
 	void *handle;
 	struct nugu_plugin_desc *desc;
+	struct nugu_plugin_desc_ext *ext;
 	NuguPlugin *p;
 
 	g_return_val_if_fail(filepath != NULL, NULL);
@@ -102,7 +132,10 @@ NuguPlugin *nugu_plugin_new_from_file(const char *filepath)
 		return NULL;
 	}
 
-	p = nugu_plugin_new(desc);
+	/* optional. not defined in the plugins built with the older sdk */
+	ext = DYNLIB_GETSYM(handle, NUGU_PLUGIN_EXT_SYMBOL);
+
+	p = nugu_plugin_new_full(desc, ext);
 	if (!p) {
 		DYNLIB_UNLOAD(handle);
 		return NULL;
@@ -283,7 +316,8 @@ int nugu_plugin_load_builtin(void)
 	nugu_info("built-in plugin count: %d", length);
 
 	for (i = 0; i < length; i++) {
-		p = nugu_plugin_new(_builtin_list[i]);
+		p = nugu_plugin_new_full(_builtin_list[i],
+					 _builtin_ext_list[i]);
 		if (!p) {
 			nugu_error("nugu_plugin_new() failed");
 			continue;
@@ -302,51 +336,294 @@ static gint _sort_priority_cmp(gconstpointer a, gconstpointer b)
 	       ((NuguPlugin *)b)->desc->priority;
 }
 
+static int _is_serial_init(void)
+{
+#ifdef NUGU_ENV_PLUGIN_INIT
+	const char *value;
+
+	value = getenv(NUGU_ENV_PLUGIN_INIT);
+	if (value && g_strcmp0(value, "serial") == 0) {
+		nugu_info("initialize all plugins serially");
+		return 1;
+	}
+#endif
+
+	return 0;
+}
+
+static void _init_plugin(NuguPlugin *p)
+{
+	int ret;
+
+	ret = p->desc->init(p);
+
+	g_rec_mutex_lock(&_plugin_lock);
+
+	if (ret < 0)
+		p->failed = TRUE;
+	else
+		p->active = TRUE;
+
+	g_rec_mutex_unlock(&_plugin_lock);
+}
+
+static void _init_worker(gpointer data, gpointer userdata)
+{
+	_init_plugin(data);
+}
+
+static void _init_parallel(GList *list)
+{
+	GThreadPool *pool;
+	GError *error = NULL;
+	GList *cur;
+	gint max_threads;
+
+	/* not limited by the processors since init() usually waits for I/O */
+	max_threads = (gint)g_list_length(list);
+	if (max_threads > 1)
+		pool = g_thread_pool_new(_init_worker, NULL, max_threads, FALSE,
+					 &error);
+	else
+		pool = NULL;
+
+	if (!pool) {
+		if (error) {
+			nugu_error("g_thread_pool_new() failed: %s",
+				   error->message);
+			g_error_free(error);
+		}
+
+		for (cur = list; cur; cur = cur->next)
+			_init_plugin(cur->data);
+
+		return;
+	}
+
+	for (cur = list; cur; cur = cur->next)
+		g_thread_pool_push(pool, cur->data, NULL);
+
+	/* wait for all init() */
+	g_thread_pool_free(pool, FALSE, TRUE);
+}
+
+/**
+ * Initialize the plugins with the same priority. The declared plugins which
+ * do not share the driver types are initialized in parallel after the
+ * undeclared plugins, and the others are initialized after them to keep
+ * the registration order (e.g. default driver).
+ */
+static GList *_init_group(GList *first, int serial)
+{
+	unsigned int priority;
+	unsigned int provides = 0;
+	GList *parallel = NULL;
+	GList *later = NULL;
+	GList *cur;
+
+	g_rec_mutex_lock(&_plugin_lock);
+
+	priority = ((NuguPlugin *)first->data)->desc->priority;
+
+	for (cur = first; cur; cur = cur->next) {
+		NuguPlugin *p = cur->data;
+
+		if (p->desc->priority != priority)
+			break;
+
+		if (p->pending)
+			continue;
+
+		if (serial || p->ext.provides == 0)
+			_init_plugin(p);
+		else if ((provides & p->ext.provides) != 0)
+			later = g_list_append(later, p);
+		else {
+			provides |= p->ext.provides;
+			parallel = g_list_append(parallel, p);
+		}
+	}
+
+	g_rec_mutex_unlock(&_plugin_lock);
+
+	/* the lock is not held since the worker can request the driver */
+	if (parallel) {
+		_init_parallel(parallel);
+		g_list_free(parallel);
+	}
+
+	if (later) {
+		GList *item;
+
+		g_rec_mutex_lock(&_plugin_lock);
+
+		for (item = later; item; item = item->next)
+			_init_plugin(item->data);
+
+		g_rec_mutex_unlock(&_plugin_lock);
+
+		g_list_free(later);
+	}
+
+	return cur;
+}
+
+/* Remove failed plugins from managed list (_plugin_lock is held) */
+static void _remove_failed(void)
+{
+	GList *cur = _plugin_list;
+
+	/* nugu_plugin_initialize() is walking the list without the lock */
+	if (_initializing)
+		return;
+
+	while (cur) {
+		GList *next = cur->next;
+		NuguPlugin *p = cur->data;
+
+		if (p->failed) {
+			nugu_error("plugin '%s' initialization failed",
+				   p->desc->name);
+			nugu_plugin_free(p);
+			_plugin_list = g_list_delete_link(_plugin_list, cur);
+		}
+
+		cur = next;
+	}
+}
+
 int nugu_plugin_initialize(void)
 {
 	GList *cur;
+	int serial;
+	int count = 0;
 
 	if (!_plugin_list)
 		return 0;
 
+	serial = _is_serial_init();
+
+	g_rec_mutex_lock(&_plugin_lock);
+
 	_plugin_list = g_list_sort(_plugin_list, _sort_priority_cmp);
+	_initializing = 1;
 
-	cur = _plugin_list;
-	while (cur) {
+	/* mark the lazy plugins before the init() can request the driver */
+	for (cur = _plugin_list; cur; cur = cur->next) {
 		NuguPlugin *p = cur->data;
 
-		if (p->desc->init(p) < 0) {
-			nugu_plugin_free(p);
-			cur->data = NULL;
-		} else
-			p->active = TRUE;
+		if (serial || p->active || p->ext.provides == 0 ||
+		    (p->ext.flags & NUGU_PLUGIN_FLAG_LAZY) == 0)
+			continue;
 
-		cur = cur->next;
+		p->pending = TRUE;
+		g_atomic_int_inc(&_pending_count);
 	}
+	g_rec_mutex_unlock(&_plugin_lock);
 
-	/* Remove failed plugins from managed list */
 	cur = _plugin_list;
-	while (cur) {
-		if (cur->data != NULL) {
-			cur = cur->next;
-			continue;
-		}
+	while (cur)
+		cur = _init_group(cur, serial);
+
+	g_rec_mutex_lock(&_plugin_lock);
 
-		cur = _plugin_list = g_list_remove_link(_plugin_list, cur);
+	_initializing = 0;
+	_remove_failed();
+
+	for (cur = _plugin_list; cur; cur = cur->next) {
+		if (((NuguPlugin *)cur->data)->active)
+			count++;
 	}
 
-	if (!_plugin_list)
+	nugu_info("%d plugins initialized, %d plugins deferred", count,
+		  g_atomic_int_get(&_pending_count));
+
+	g_rec_mutex_unlock(&_plugin_lock);
+
+	return count;
+}
+
+/* driver types of the pending plugins which share any of the types */
+static unsigned int _related_provides(unsigned int provides)
+{
+	unsigned int prev;
+	GList *cur;
+
+	do {
+		prev = provides;
+
+		for (cur = _plugin_list; cur; cur = cur->next) {
+			NuguPlugin *p = cur->data;
+
+			if (p->pending && (p->ext.provides & provides) != 0)
+				provides |= p->ext.provides;
+		}
+	} while (provides != prev);
+
+	return provides;
+}
+
+int nugu_plugin_require(unsigned int provides)
+{
+	GList *cur;
+	int count = 0;
+
+	if (provides == 0 || g_atomic_int_get(&_pending_count) == 0)
 		return 0;
-	else
-		return g_list_length(_plugin_list);
+
+	g_rec_mutex_lock(&_plugin_lock);
+
+	/* requested inside the init() of the lazy plugin */
+	if (_require_depth > 0) {
+		g_rec_mutex_unlock(&_plugin_lock);
+		return 0;
+	}
+
+	_require_depth++;
+
+	/*
+	 * The lazy plugin can provide several driver types. Initialize the
+	 * pending plugins of all the related types in priority order, so the
+	 * higher priority plugin still registers the default driver first.
+	 */
+	provides = _related_provides(provides);
+
+	for (cur = _plugin_list; cur; cur = cur->next) {
+		NuguPlugin *p = cur->data;
+
+		if (!p->pending || (p->ext.provides & provides) == 0)
+			continue;
+
+		p->pending = FALSE;
+		g_atomic_int_add(&_pending_count, -1);
+
+		nugu_dbg("initialize the lazy plugin '%s'", p->desc->name);
+		_init_plugin(p);
+		if (p->active)
+			count++;
+	}
+
+	_remove_failed();
+
+	_require_depth--;
+
+	g_rec_mutex_unlock(&_plugin_lock);
+
+	return count;
 }
 
 void nugu_plugin_deinitialize(void)
 {
 	GList *cur;
 
-	if (_plugin_list == NULL)
+	g_rec_mutex_lock(&_plugin_lock);
+
+	g_atomic_int_set(&_pending_count, 0);
+
+	if (_plugin_list == NULL) {
+		g_rec_mutex_unlock(&_plugin_lock);
 		return;
+	}
 
 	_plugin_list = g_list_reverse(_plugin_list);
 
@@ -361,6 +638,8 @@ void nugu_plugin_deinitialize(void)
 
 	g_list_free_full(_plugin_list, (GDestroyNotify)nugu_plugin_free);
 	_plugin_list = NULL;
+
+	g_rec_mutex_unlock(&_plugin_lock);
 }
 
 NuguPlugin *nugu_plugin_find(const char *name)
@@ -369,15 +648,25 @@ NuguPlugin *nugu_plugin_find(const char *name)
 
 	g_return_val_if_fail(name != NULL, NULL);
 
+	g_rec_mutex_lock(&_plugin_lock);
+
 	cur = _plugin_list;
 	while (cur) {
 		NuguPlugin *p = cur->data;
 
-		if (p && g_strcmp0(p->desc->name, name) == 0)
-			return cur->data;
-
 		cur = cur->next;
+
+		/* not usable until the init() is succeeded */
+		if (!p || p->failed || p->pending)
+			continue;
+
+		if (g_strcmp0(p->desc->name, name) == 0) {
+			g_rec_mutex_unlock(&_plugin_lock);
+			return p;
+		}
 	}
 
+	g_rec_mutex_unlock(&_plugin_lock);
+
 	return NULL;
 }
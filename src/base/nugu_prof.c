@@ -17,16 +17,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <pthread.h>
 
 #include <glib.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_watchdog.h"
 
 #define BUFSIZE_TIMESTR 19
 #define PAYLOAD_MAX 4096
 
+/* wakeup and listening marks waiting for the next ASR.Recognize */
+#define PENDING_MAX 2
+
+/**
+ * Latency histogram: values below 2^HIST_SUB_BITS usec have their own
+ * bucket, and each power of two above is divided into 2^HIST_SUB_BITS
+ * buckets (relative error < 6.25%) up to 2^(HIST_MAX_EXP + 1) usec
+ * (~67 sec). The larger values are counted in the last bucket.
+ */
+#define HIST_SUB_BITS 4
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_MAX_EXP 25
+#define HIST_BUCKETS ((HIST_MAX_EXP - HIST_SUB_BITS + 2) * HIST_SUB_COUNT)
+
 struct nugu_prof_hints {
 	const char *text;
 	enum nugu_prof_type relative_type;
@@ -107,19 +124,157 @@ static const struct nugu_prof_hints _hints[NUGU_PROF_TYPE_MAX + 1] = {
 	{ "Audio_started", NUGU_PROF_TYPE_ASR_RESULT },
 	{ "Audio_finished", NUGU_PROF_TYPE_AUDIO_STARTED },
 
+	/* TTS decoding */
+	{ "TTS_decode_queue", NUGU_PROF_TYPE_TTS_FIRST_DECODING },
+	{ "TTS_last_decoding", NUGU_PROF_TYPE_TTS_LAST_ATTACHMENT },
+
+	/* TTS cache */
+	{ "TTS_cache_hit", NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE },
+	{ "TTS_cache_miss", NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE },
+
+	/* sdk startup phases */
+	{ "Network_init", NUGU_PROF_TYPE_SDK_CREATED },
+	{ "Capability_done", NUGU_PROF_TYPE_SDK_PLUGIN_INIT_DONE },
+	{ "Model_load", NUGU_PROF_TYPE_MAX },
+	{ "Model_loaded", NUGU_PROF_TYPE_SDK_MODEL_LOAD_START },
+
 	/* end */
 	{ "END", NUGU_PROF_TYPE_MAX }
 };
 
 /**
- * Profiling data store
+ * Latency from the relative type of the hints to each type.
+ */
+struct _prof_hist {
+	guint32 buckets[HIST_BUCKETS];
+	guint32 count;
+	gint64 min;
+	gint64 max;
+};
+
+/**
+ * Profiling data store. The entry is a seqlock: the writer of the type
+ * makes the sequence odd while updating, and the reader copies the entry
+ * and retries if the sequence is changed. So the marks of the different
+ * types never wait for each other, and the reader never blocks the mark.
  */
-static struct nugu_prof_data _prof_data[NUGU_PROF_TYPE_MAX + 1];
+struct _prof_entry {
+	gint seq;
+	struct nugu_prof_data data; /* without the contents */
+	gint64 last_ns; /* monotonic timestamp of the last mark */
+	struct _prof_hist hist;
+};
 
+static struct _prof_entry _entries[NUGU_PROF_TYPE_MAX + 1];
+
+/* protect the pair of the callback and the userdata */
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
 static NuguProfCallback _callback;
 static void *_callback_userdata;
-static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
-static gboolean _trace;
+static gint _trace;
+
+/**
+ * Marks waiting for the callback. The slot is claimed by the marking
+ * thread with the compare-and-exchange of the head, and the idle handler
+ * on the mainloop delivers the published slots from the tail. The marks
+ * are dropped if the mainloop doesn't drain the ring in time.
+ */
+#define EMIT_RING_SIZE 256
+
+struct _prof_pending {
+	gint seq; /* index + 1 of the data. 0 while writing */
+	struct nugu_prof_data data; /* contents are owned by the slot */
+};
+
+static struct _prof_pending _pending[EMIT_RING_SIZE];
+static gint _pending_head;
+static gint _pending_tail;
+static gint _pending_dropped;
+static gint _emit_scheduled;
+
+/* spins on the sequence before yielding to the preempted writer */
+#define SEQ_SPIN_LIMIT 100
+
+/**
+ * Timeline ring. The slot is claimed by the atomic increment of the head,
+ * and the sequence of the slot is published after the record is written.
+ * The reader copies the record and checks the sequence again, so neither
+ * the writer nor the reader is blocked.
+ */
+struct _prof_slot {
+	gint seq; /* index + 1 of the record. 0 while writing */
+	struct nugu_prof_record record;
+};
+
+static struct _prof_slot _ring[NUGU_PROF_RING_SIZE];
+static gint _ring_head;
+static gint _ring_tail;
+
+/* dialogs for the marks without the dialog id (seqlock) */
+struct _prof_owner {
+	gint seq;
+	char dialog_id[NUGU_MAX_UUID_STRING_SIZE + 1];
+};
+
+static struct _prof_owner _asr_owner;
+static struct _prof_owner _tts_owner;
+
+static void _seq_backoff(int *spins)
+{
+	if (++(*spins) < SEQ_SPIN_LIMIT)
+		return;
+
+	g_thread_yield();
+	*spins = 0;
+}
+
+static void _seq_write_begin(gint *seq)
+{
+	int spins = 0;
+	gint cur;
+
+	/* serialize the writers of the same sequence */
+	while (1) {
+		cur = g_atomic_int_get(seq);
+		if ((cur & 1) == 0 &&
+		    g_atomic_int_compare_and_exchange(seq, cur, cur + 1))
+			return;
+
+		_seq_backoff(&spins);
+	}
+}
+
+static void _seq_write_end(gint *seq)
+{
+	g_atomic_int_inc(seq);
+}
+
+static void _seq_read(gint *seq, void *dest, const void *src, size_t size)
+{
+	int spins = 0;
+	gint begin;
+
+	while (1) {
+		begin = g_atomic_int_get(seq);
+		if ((begin & 1) != 0) {
+			_seq_backoff(&spins);
+			continue;
+		}
+
+		memcpy(dest, src, size);
+
+		if (g_atomic_int_get(seq) == begin)
+			return;
+	}
+}
+
+static void _read_data(enum nugu_prof_type type, struct nugu_prof_data *dest)
+{
+	struct _prof_entry *entry = &_entries[type];
+
+	_seq_read(&entry->seq, dest, &entry->data,
+		  sizeof(struct nugu_prof_data));
+}
 
 static void _fill_timestr(char *dest_buf, size_t bufsize, gint64 msec)
 {
@@ -148,52 +303,57 @@ static void _fill_timestr(char *dest_buf, size_t bufsize, gint64 msec)
 	snprintf(dest_buf + 14, bufsize - 14, ".%03d", (int)msec);
 }
 
+static void _owner_set(struct _prof_owner *owner, const char *dialog_id)
+{
+	_seq_write_begin(&owner->seq);
+	g_strlcpy(owner->dialog_id, dialog_id, sizeof(owner->dialog_id));
+	_seq_write_end(&owner->seq);
+}
+
 void nugu_prof_clear(void)
 {
-	pthread_mutex_lock(&_lock);
-	memset(_prof_data, 0, sizeof(_prof_data));
-	pthread_mutex_unlock(&_lock);
+	int i;
+
+	for (i = 0; i <= NUGU_PROF_TYPE_MAX; i++) {
+		struct _prof_entry *entry = &_entries[i];
 
-	nugu_dbg("clear profiling cache %d bytes", sizeof(_prof_data));
+		_seq_write_begin(&entry->seq);
+		memset(&entry->data, 0, sizeof(struct nugu_prof_data));
+		memset(&entry->hist, 0, sizeof(struct _prof_hist));
+		entry->last_ns = 0;
+		_seq_write_end(&entry->seq);
+	}
+
+	_owner_set(&_asr_owner, "");
+	_owner_set(&_tts_owner, "");
+
+	g_atomic_int_set(&_ring_tail, g_atomic_int_get(&_ring_head));
+
+	nugu_dbg("clear profiling cache %d bytes", sizeof(_entries));
 }
 
 void nugu_prof_enable_tracelog(void)
 {
-	pthread_mutex_lock(&_lock);
-	_trace = TRUE;
-	pthread_mutex_unlock(&_lock);
+	g_atomic_int_set(&_trace, TRUE);
 }
 
 void nugu_prof_disable_tracelog(void)
 {
-	pthread_mutex_lock(&_lock);
-	_trace = FALSE;
-	pthread_mutex_unlock(&_lock);
+	g_atomic_int_set(&_trace, FALSE);
 }
 
 void nugu_prof_set_callback(NuguProfCallback callback, void *userdata)
 {
 	pthread_mutex_lock(&_lock);
-	_callback = callback;
+	g_atomic_pointer_set(&_callback, callback);
 	_callback_userdata = userdata;
 	pthread_mutex_unlock(&_lock);
 }
 
-/**
- * Profiling callback is not time critical, so it is called in idle time.
- */
-static gboolean _emit_in_idle(gpointer userdata)
+static void _emit_data(const struct nugu_prof_data *data,
+		       NuguProfCallback cb, void *cb_userdata)
 {
-	NuguProfCallback cb;
-	void *cb_userdata;
-	struct nugu_prof_data *data = userdata;
-
-	pthread_mutex_lock(&_lock);
-	cb = _callback;
-	cb_userdata = _callback_userdata;
-	pthread_mutex_unlock(&_lock);
-
-	if (_trace) {
+	if (g_atomic_int_get(&_trace)) {
 		char timestr[25];
 
 		_fill_timestr(timestr, sizeof(timestr), data->timestamp);
@@ -216,89 +376,302 @@ static gboolean _emit_in_idle(gpointer userdata)
 				       " - contents: %s", data->contents);
 	}
 
-	if (cb != NULL)
+	if (cb != NULL) {
+		int64_t begin = nugu_watchdog_begin();
+
 		cb(data->type, data, cb_userdata);
 
-	if (data->contents)
-		g_free(data->contents);
-	free(data);
+		nugu_watchdog_end("prof_callback", begin, (const void *)cb,
+				  cb_userdata);
+	}
+}
+
+/**
+ * Profiling callback is not time critical, so it is called in idle time.
+ * Each mark is delivered in the order of the marking.
+ */
+static gboolean _emit_in_idle(gpointer userdata)
+{
+	struct nugu_prof_data data;
+	NuguProfCallback cb;
+	void *cb_userdata;
+	guint tail;
+	gint dropped;
+
+	/* the marks published from now on schedule the next dispatch */
+	g_atomic_int_set(&_emit_scheduled, 0);
+
+	dropped = g_atomic_int_get(&_pending_dropped);
+	if (dropped > 0) {
+		g_atomic_int_add(&_pending_dropped, -dropped);
+		nugu_warn("%d profiling callbacks are dropped", dropped);
+	}
+
+	pthread_mutex_lock(&_lock);
+	cb = _callback;
+	cb_userdata = _callback_userdata;
+	pthread_mutex_unlock(&_lock);
+
+	tail = (guint)g_atomic_int_get(&_pending_tail);
+
+	while (tail != (guint)g_atomic_int_get(&_pending_head)) {
+		struct _prof_pending *slot = &_pending[tail % EMIT_RING_SIZE];
+
+		/* the writer schedules again after the slot is published */
+		if ((guint)g_atomic_int_get(&slot->seq) != tail + 1)
+			break;
+
+		memcpy(&data, &slot->data, sizeof(struct nugu_prof_data));
+		g_atomic_int_set(&slot->seq, 0);
+
+		tail++;
+		g_atomic_int_set(&_pending_tail, (gint)tail);
+
+		_emit_data(&data, cb, cb_userdata);
+		g_free(data.contents);
+	}
 
 	return FALSE;
 }
 
-static void _emit_callback(enum nugu_prof_type type, const char *contents)
+/* the contents of the data are moved to the pending slot */
+static void _schedule_emit(const struct nugu_prof_data *data)
 {
-	struct nugu_prof_data *data;
+	struct _prof_pending *slot;
+	guint head;
 
-	if (_callback == NULL && _trace == FALSE)
-		return;
+	do {
+		head = (guint)g_atomic_int_get(&_pending_head);
 
-	data = malloc(sizeof(struct nugu_prof_data));
-	if (!data) {
-		nugu_error_nomem();
-		return;
-	}
+		if (head - (guint)g_atomic_int_get(&_pending_tail) >=
+		    EMIT_RING_SIZE) {
+			g_atomic_int_inc(&_pending_dropped);
+			g_free(data->contents);
+			return;
+		}
+	} while (!g_atomic_int_compare_and_exchange(&_pending_head, (gint)head,
+						    (gint)(head + 1)));
+
+	slot = &_pending[head % EMIT_RING_SIZE];
+	memcpy(&slot->data, data, sizeof(struct nugu_prof_data));
+	g_atomic_int_set(&slot->seq, (gint)(head + 1));
+
+	if (g_atomic_int_compare_and_exchange(&_emit_scheduled, 0, 1))
+		nugu_mainloop_idle_add(_emit_in_idle, NULL);
+}
+
+static gint64 _get_monotonic_ns(void)
+{
+#ifdef _WIN32
+	return g_get_monotonic_time() * 1000;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (gint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static int _is_asr_type(enum nugu_prof_type type)
+{
+	return (type >= NUGU_PROF_TYPE_ASR_RECOGNIZE &&
+		type <= NUGU_PROF_TYPE_ASR_RESULT);
+}
+
+static int _is_tts_type(enum nugu_prof_type type)
+{
+	return ((type >= NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE &&
+		 type <= NUGU_PROF_TYPE_TTS_FINISHED) ||
+		(type >= NUGU_PROF_TYPE_TTS_DECODE_QUEUE &&
+		 type <= NUGU_PROF_TYPE_TTS_CACHE_MISS));
+}
 
-	memcpy(data, &_prof_data[type], sizeof(struct nugu_prof_data));
+static int _is_pending_type(enum nugu_prof_type type)
+{
+	return (type == NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED ||
+		type == NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+}
+
+/**
+ * Attribute the mark to the dialog.
+ */
+static void _fill_record(struct nugu_prof_record *record,
+			 enum nugu_prof_type type, const char *dialog_id)
+{
+	struct _prof_owner *owner = NULL;
+
+	record->type = type;
+
+	if (dialog_id && dialog_id[0] != '\0') {
+		if (type == NUGU_PROF_TYPE_ASR_RECOGNIZE)
+			_owner_set(&_asr_owner, dialog_id);
+		else if (type == NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE ||
+			 type == NUGU_PROF_TYPE_TTS_STARTED)
+			_owner_set(&_tts_owner, dialog_id);
+	} else if (_is_asr_type(type)) {
+		owner = &_asr_owner;
+	} else if (_is_tts_type(type)) {
+		owner = &_tts_owner;
+	}
 
-	if (contents)
-		data->contents = g_strdup(contents);
+	if (dialog_id && dialog_id[0] != '\0')
+		g_strlcpy(record->dialog_id, dialog_id,
+			  sizeof(record->dialog_id));
+	else if (owner)
+		_seq_read(&owner->seq, record->dialog_id, owner->dialog_id,
+			  sizeof(record->dialog_id));
 	else
-		data->contents = NULL;
+		record->dialog_id[0] = '\0';
+}
 
-	g_idle_add(_emit_in_idle, data);
+static void _ring_push(const struct nugu_prof_record *record)
+{
+	guint idx;
+	struct _prof_slot *slot;
+
+	idx = (guint)g_atomic_int_add(&_ring_head, 1);
+	slot = &_ring[idx % NUGU_PROF_RING_SIZE];
+
+	g_atomic_int_set(&slot->seq, 0);
+	memcpy(&slot->record, record, sizeof(struct nugu_prof_record));
+	g_atomic_int_set(&slot->seq, (gint)(idx + 1));
 }
 
-static void _set_timestamp_with_emit(enum nugu_prof_type type,
-				     const char *contents)
+static int _ring_read(guint idx, struct nugu_prof_record *record)
 {
-	_prof_data[type].timestamp = g_get_real_time();
-	_prof_data[type].type = type;
+	struct _prof_slot *slot = &_ring[idx % NUGU_PROF_RING_SIZE];
+	guint seq;
 
-	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROFILING) != 0)
-		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
-			       NULL, NULL, -1, "profiling: %d (%s) %s %s", type,
-			       _hints[type].text, _prof_data[type].dialog_id,
-			       _prof_data[type].msg_id);
+	seq = (guint)g_atomic_int_get(&slot->seq);
+	if (seq != idx + 1)
+		return -1;
+
+	memcpy(record, &slot->record, sizeof(struct nugu_prof_record));
+
+	/* overwritten while copying */
+	if ((guint)g_atomic_int_get(&slot->seq) != seq)
+		return -1;
+
+	return 0;
+}
+
+static int _hist_index(gint64 usec)
+{
+	int exp;
+
+	if (usec < HIST_SUB_COUNT)
+		return (usec < 0) ? 0 : (int)usec;
+
+	if (usec >= ((gint64)1 << (HIST_MAX_EXP + 1)))
+		return HIST_BUCKETS - 1;
+
+	exp = g_bit_nth_msf((gulong)usec, -1);
+
+	return (exp - HIST_SUB_BITS + 1) * HIST_SUB_COUNT +
+	       (int)((usec >> (exp - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+}
+
+/* highest value of the bucket */
+static gint64 _hist_value(int index)
+{
+	int exp;
+	gint64 sub;
+
+	if (index < HIST_SUB_COUNT)
+		return index;
+
+	exp = index / HIST_SUB_COUNT + HIST_SUB_BITS - 1;
+	sub = HIST_SUB_COUNT + index % HIST_SUB_COUNT;
+
+	return ((sub + 1) << (exp - HIST_SUB_BITS)) - 1;
+}
 
-	if (_callback != NULL || _trace)
-		_emit_callback(type, contents);
+/**
+ * Update the latency from the relative type. The latency is counted only
+ * once for each mark of the relative type. Must be called in the write
+ * section of the entry.
+ */
+static void _update_latency(enum nugu_prof_type type, gint64 timestamp_ns)
+{
+	enum nugu_prof_type rel = _hints[type].relative_type;
+	struct _prof_entry *entry = &_entries[type];
+	struct _prof_hist *hist = &entry->hist;
+	gint64 rel_ns = 0;
+	gint64 usec;
+
+	if (rel != NUGU_PROF_TYPE_MAX)
+		_seq_read(&_entries[rel].seq, &rel_ns, &_entries[rel].last_ns,
+			  sizeof(rel_ns));
+
+	if (rel_ns != 0 && rel_ns > entry->last_ns) {
+		usec = (timestamp_ns - rel_ns) / 1000;
+
+		hist->buckets[_hist_index(usec)]++;
+		if (hist->count == 0 || usec < hist->min)
+			hist->min = usec;
+		if (usec > hist->max)
+			hist->max = usec;
+		hist->count++;
+	}
+
+	entry->last_ns = timestamp_ns;
 }
 
 int nugu_prof_mark_data(enum nugu_prof_type type, const char *dialog_id,
 			const char *msg_id, const char *contents)
 {
+	struct nugu_prof_record record;
+	struct nugu_prof_data data;
+	struct _prof_entry *entry;
+	int emit;
+
 	g_return_val_if_fail(type < NUGU_PROF_TYPE_MAX, -1);
 
-	pthread_mutex_lock(&_lock);
+	record.timestamp_ns = _get_monotonic_ns();
 
-	memset(&_prof_data[type], 0, sizeof(struct nugu_prof_data));
+	memset(&data, 0, sizeof(struct nugu_prof_data));
+	data.type = type;
+	data.timestamp = g_get_real_time();
 
 	if (dialog_id)
-		memcpy(_prof_data[type].dialog_id, dialog_id,
-		       NUGU_MAX_UUID_STRING_SIZE);
+		memcpy(data.dialog_id, dialog_id, NUGU_MAX_UUID_STRING_SIZE);
 
 	if (msg_id)
-		memcpy(_prof_data[type].msg_id, msg_id,
-		       NUGU_MAX_UUID_STRING_SIZE);
+		memcpy(data.msg_id, msg_id, NUGU_MAX_UUID_STRING_SIZE);
 
-	_set_timestamp_with_emit(type, contents);
+	/* the contents are copied only for the callback */
+	emit = (g_atomic_pointer_get(&_callback) != NULL ||
+		g_atomic_int_get(&_trace));
+	if (emit && contents)
+		data.contents = g_strdup(contents);
 
-	pthread_mutex_unlock(&_lock);
+	_fill_record(&record, type, dialog_id);
+
+	entry = &_entries[type];
+
+	_seq_write_begin(&entry->seq);
+	memcpy(&entry->data, &data, sizeof(struct nugu_prof_data));
+	entry->data.contents = NULL;
+	_update_latency(type, record.timestamp_ns);
+	_seq_write_end(&entry->seq);
+
+	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROFILING) != 0)
+		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
+			       NULL, NULL, -1, "profiling: %d (%s) %s %s", type,
+			       _hints[type].text, data.dialog_id, data.msg_id);
+
+	_ring_push(&record);
+
+	if (emit)
+		_schedule_emit(&data);
 
 	return 0;
 }
 
 int nugu_prof_mark(enum nugu_prof_type type)
 {
-	g_return_val_if_fail(type < NUGU_PROF_TYPE_MAX, -1);
-
-	pthread_mutex_lock(&_lock);
-	memset(&_prof_data[type], 0, sizeof(struct nugu_prof_data));
-	_set_timestamp_with_emit(type, NULL);
-	pthread_mutex_unlock(&_lock);
-
-	return 0;
+	return nugu_prof_mark_data(type, NULL, NULL, NULL);
 }
 
 struct nugu_prof_data *nugu_prof_get_last_data(enum nugu_prof_type type)
@@ -313,9 +686,7 @@ struct nugu_prof_data *nugu_prof_get_last_data(enum nugu_prof_type type)
 		return NULL;
 	}
 
-	pthread_mutex_lock(&_lock);
-	memcpy(tmp, &_prof_data[type], sizeof(struct nugu_prof_data));
-	pthread_mutex_unlock(&_lock);
+	_read_data(type, tmp);
 
 	return tmp;
 }
@@ -340,8 +711,13 @@ int nugu_prof_get_diff_msec_timespec(const struct timespec *ts1,
 int nugu_prof_get_diff_msec_type(enum nugu_prof_type type1,
 				 enum nugu_prof_type type2)
 {
-	return (_prof_data[type1].timestamp - _prof_data[type2].timestamp) /
-	       1000;
+	struct nugu_prof_data data1;
+	struct nugu_prof_data data2;
+
+	_read_data(type1, &data1);
+	_read_data(type2, &data2);
+
+	return (data1.timestamp - data2.timestamp) / 1000;
 }
 
 int nugu_prof_get_diff_msec(const struct nugu_prof_data *prof1,
@@ -405,7 +781,8 @@ static void _fill_timeunit(int msec, char *dest, size_t dest_len)
 	dest[10] = '\0';
 }
 
-static void _fill_relative_part(enum nugu_prof_type type, char *dest,
+static void _fill_relative_part(const struct nugu_prof_data *list,
+				enum nugu_prof_type type, char *dest,
 				size_t dest_len)
 {
 	enum nugu_prof_type rel;
@@ -422,7 +799,7 @@ static void _fill_relative_part(enum nugu_prof_type type, char *dest,
 		return;
 	}
 
-	diff = nugu_prof_get_diff_msec(&_prof_data[rel], &_prof_data[type]);
+	diff = nugu_prof_get_diff_msec(&list[rel], &list[type]);
 
 	_fill_timeunit(diff, buf, sizeof(buf));
 
@@ -431,6 +808,7 @@ static void _fill_relative_part(enum nugu_prof_type type, char *dest,
 
 void nugu_prof_dump(enum nugu_prof_type from, enum nugu_prof_type to)
 {
+	struct nugu_prof_data *list;
 	enum nugu_prof_type cur;
 	char ts_str[255];
 	char relative_part[22];
@@ -446,7 +824,9 @@ void nugu_prof_dump(enum nugu_prof_type from, enum nugu_prof_type to)
 		       NULL, -1, "Profiling: %d(%s) ~ %d(%s)", from,
 		       _hints[from].text, to, _hints[to].text);
 
-	pthread_mutex_lock(&_lock);
+	list = g_new0(struct nugu_prof_data, NUGU_PROF_TYPE_MAX + 1);
+	for (cur = 0; cur < NUGU_PROF_TYPE_MAX; cur++)
+		_read_data(cur, &list[cur]);
 
 	/**
 	 * output format:
@@ -455,14 +835,15 @@ void nugu_prof_dump(enum nugu_prof_type from, enum nugu_prof_type to)
 	for (cur = from; cur <= to; cur++) {
 		const struct nugu_prof_data *prof;
 
-		prof = &_prof_data[cur];
+		prof = &list[cur];
 		if (prof->timestamp == 0)
 			continue;
 
 		_fill_timestr(ts_str, sizeof(ts_str), prof->timestamp);
-		_fill_timeunit(nugu_prof_get_diff_msec(&_prof_data[from], prof),
+		_fill_timeunit(nugu_prof_get_diff_msec(&list[from], prof),
 			       time_from, sizeof(time_from));
-		_fill_relative_part(cur, relative_part, sizeof(relative_part));
+		_fill_relative_part(list, cur, relative_part,
+				    sizeof(relative_part));
 
 		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
 			       NULL, NULL, -1, "[%2d] %20s: <%s> %s %s %s %s",
@@ -470,7 +851,231 @@ void nugu_prof_dump(enum nugu_prof_type from, enum nugu_prof_type to)
 			       relative_part, prof->dialog_id, prof->msg_id);
 	}
 
-	pthread_mutex_unlock(&_lock);
+	g_free(list);
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+}
+
+static void _sort_records(struct nugu_prof_record *records, int count)
+{
+	int i;
+	int j;
+
+	/* records are almost sorted by the claim order of the ring */
+	for (i = 1; i < count; i++) {
+		struct nugu_prof_record tmp = records[i];
+
+		for (j = i - 1; j >= 0; j--) {
+			if (records[j].timestamp_ns <= tmp.timestamp_ns)
+				break;
+			records[j + 1] = records[j];
+		}
+
+		records[j + 1] = tmp;
+	}
+}
+
+int nugu_prof_get_timeline(const char *dialog_id,
+			   struct nugu_prof_record *records, int max)
+{
+	struct nugu_prof_record pending[PENDING_MAX];
+	int pending_count = 0;
+	int count = 0;
+	guint head;
+	guint idx;
+
+	g_return_val_if_fail(dialog_id != NULL, -1);
+	g_return_val_if_fail(records != NULL, -1);
+	g_return_val_if_fail(max > 0, -1);
+
+	head = (guint)g_atomic_int_get(&_ring_head);
+	idx = (guint)g_atomic_int_get(&_ring_tail);
+	if (head - idx > NUGU_PROF_RING_SIZE)
+		idx = head - NUGU_PROF_RING_SIZE;
+
+	for (; idx != head && count < max; idx++) {
+		struct nugu_prof_record record;
+
+		if (_ring_read(idx, &record) < 0)
+			continue;
+
+		if (record.dialog_id[0] == '\0') {
+			if (_is_pending_type(record.type) == 0)
+				continue;
+
+			/* a wakeup or a listening again starts a new turn */
+			if (record.type ==
+				    NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED ||
+			    (pending_count > 0 &&
+			     pending[pending_count - 1].type ==
+				     NUGU_PROF_TYPE_ASR_LISTENING_STARTED))
+				pending_count = 0;
+
+			pending[pending_count++] = record;
+			continue;
+		}
+
+		if (strcmp(record.dialog_id, dialog_id) != 0) {
+			if (record.type == NUGU_PROF_TYPE_ASR_RECOGNIZE)
+				pending_count = 0;
+			continue;
+		}
+
+		if (record.type == NUGU_PROF_TYPE_ASR_RECOGNIZE) {
+			int i;
+
+			for (i = 0; i < pending_count && count < max; i++) {
+				records[count] = pending[i];
+				g_strlcpy(records[count].dialog_id, dialog_id,
+					  sizeof(records[count].dialog_id));
+				count++;
+			}
+
+			pending_count = 0;
+			if (count == max)
+				break;
+		}
+
+		records[count++] = record;
+	}
+
+	_sort_records(records, count);
+
+	return count;
+}
+
+void nugu_prof_dump_timeline(const char *dialog_id)
+{
+	struct nugu_prof_record *records;
+	int count;
+	int i;
+
+	g_return_if_fail(dialog_id != NULL);
+
+	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROFILING) == 0)
+		return;
+
+	records = g_new0(struct nugu_prof_record, NUGU_PROF_RING_SIZE);
+
+	count = nugu_prof_get_timeline(dialog_id, records,
+				       NUGU_PROF_RING_SIZE);
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "Timeline: %s (%d)", dialog_id, count);
+
+	/**
+	 * output format:
+	 *  type text: +elapsed from the first (+delta from the previous)
+	 */
+	for (i = 0; i < count; i++) {
+		gint64 elapsed;
+		gint64 delta = 0;
+
+		elapsed = records[i].timestamp_ns - records[0].timestamp_ns;
+		if (i > 0)
+			delta = records[i].timestamp_ns -
+				records[i - 1].timestamp_ns;
+
+		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
+			       NULL, NULL, -1,
+			       "[%2d] %20s: +%4" G_GINT64_FORMAT
+			       ".%03d msec (+%4" G_GINT64_FORMAT ".%03d msec)",
+			       records[i].type, _hints[records[i].type].text,
+			       elapsed / 1000000, (int)(elapsed / 1000 % 1000),
+			       delta / 1000000, (int)(delta / 1000 % 1000));
+	}
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+
+	g_free(records);
+}
+
+static gint64 _hist_percentile(const struct _prof_hist *hist,
+			       double percentile)
+{
+	guint32 target;
+	guint32 sum = 0;
+	int i;
+
+	target = (guint32)(hist->count * percentile / 100.0 + 0.5);
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < HIST_BUCKETS; i++) {
+		sum += hist->buckets[i];
+		if (sum >= target)
+			return MIN(_hist_value(i), hist->max);
+	}
+
+	return hist->max;
+}
+
+int nugu_prof_get_latency(enum nugu_prof_type type,
+			  struct nugu_prof_latency *latency)
+{
+	struct _prof_entry *entry;
+	struct _prof_hist hist;
+
+	g_return_val_if_fail(type < NUGU_PROF_TYPE_MAX, -1);
+	g_return_val_if_fail(latency != NULL, -1);
+
+	if (_hints[type].relative_type == NUGU_PROF_TYPE_MAX)
+		return -1;
+
+	memset(latency, 0, sizeof(struct nugu_prof_latency));
+	latency->from = _hints[type].relative_type;
+	latency->to = type;
+
+	entry = &_entries[type];
+	_seq_read(&entry->seq, &hist, &entry->hist, sizeof(struct _prof_hist));
+
+	if (hist.count > 0) {
+		latency->count = hist.count;
+		latency->min = hist.min;
+		latency->max = hist.max;
+		latency->p50 = _hist_percentile(&hist, 50);
+		latency->p90 = _hist_percentile(&hist, 90);
+		latency->p99 = _hist_percentile(&hist, 99);
+	}
+
+	return 0;
+}
+
+void nugu_prof_dump_latency(void)
+{
+	enum nugu_prof_type cur;
+
+	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROFILING) == 0)
+		return;
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+
+	/**
+	 * output format:
+	 *  [from ~ to] text: count p50 p90 p99 max (msec)
+	 */
+	for (cur = 0; cur < NUGU_PROF_TYPE_MAX; cur++) {
+		struct nugu_prof_latency latency;
+
+		if (nugu_prof_get_latency(cur, &latency) < 0 ||
+		    latency.count == 0)
+			continue;
+
+		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
+			       NULL, NULL, -1,
+			       "[%2d ~ %2d] %20s: count %5u p50 %5d p90 %5d "
+			       "p99 %5d max %5d msec",
+			       latency.from, latency.to, _hints[cur].text,
+			       latency.count, (int)(latency.p50 / 1000),
+			       (int)(latency.p90 / 1000),
+			       (int)(latency.p99 / 1000),
+			       (int)(latency.max / 1000));
+	}
 
 	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
 		       NULL, -1, "--------------------------");
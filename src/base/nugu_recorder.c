@@ -31,7 +31,9 @@
 #include <glib.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_plugin.h"
 #include "base/nugu_ringbuffer.h"
+#include "base/nugu_resampler.h"
 #include "base/nugu_recorder.h"
 
 //#define RECORDER_FILE_DUMP
@@ -51,6 +53,23 @@ struct _nugu_recorder {
 	int is_recording;
 	pthread_cond_t cond;
 	pthread_mutex_t lock;
+
+	/* recorder which feeds the frames (nugu_recorder_set_source) */
+	NuguRecorder *source;
+	NuguResampler *resampler;
+	char *convert_buf;
+	size_t convert_size;
+
+	/* recording recorders linked to this recorder */
+	GList *sinks;
+
+	/*
+	 * serializes the start and stop of this recorder by the linked
+	 * recorders. The lock is not held while pushing the frames, so the
+	 * driver can push them in the start().
+	 */
+	pthread_mutex_t link_lock;
+	int active_sinks;
 #ifdef RECORDER_FILE_DUMP
 	FILE *file;
 #endif
@@ -94,11 +113,27 @@ int nugu_recorder_driver_free(NuguRecorderDriver *driver)
 	return 0;
 }
 
+static NuguRecorderDriver *_find_driver(const char *name)
+{
+	GList *cur;
+
+	cur = _recorder_drivers;
+	while (cur) {
+		if (g_strcmp0(((NuguRecorderDriver *)cur->data)->name, name) ==
+		    0)
+			return cur->data;
+
+		cur = cur->next;
+	}
+
+	return NULL;
+}
+
 int nugu_recorder_driver_register(NuguRecorderDriver *driver)
 {
 	g_return_val_if_fail(driver != NULL, -1);
 
-	if (nugu_recorder_driver_find(driver->name)) {
+	if (_find_driver(driver->name)) {
 		nugu_error("'%s' recorder driver already exist.", driver->name);
 		return -1;
 	}
@@ -145,25 +180,18 @@ int nugu_recorder_driver_set_default(NuguRecorderDriver *driver)
 
 NuguRecorderDriver *nugu_recorder_driver_get_default(void)
 {
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_RECORDER);
+
 	return _default_driver;
 }
 
 NuguRecorderDriver *nugu_recorder_driver_find(const char *name)
 {
-	GList *cur;
-
 	g_return_val_if_fail(name != NULL, NULL);
 
-	cur = _recorder_drivers;
-	while (cur) {
-		if (g_strcmp0(((NuguRecorderDriver *)cur->data)->name, name) ==
-		    0)
-			return cur->data;
+	nugu_plugin_require(NUGU_PLUGIN_PROVIDES_RECORDER);
 
-		cur = cur->next;
-	}
-
-	return NULL;
+	return _find_driver(name);
 }
 
 NuguRecorder *nugu_recorder_new(const char *name, NuguRecorderDriver *driver)
@@ -177,8 +205,12 @@ NuguRecorder *nugu_recorder_new(const char *name, NuguRecorderDriver *driver)
 	rec->driver = driver;
 	rec->buf = nugu_ring_buffer_new(NUGU_RECORDER_FRAME_SIZE,
 					NUGU_RECORDER_MAX_FRAMES);
+	if (rec->buf)
+		nugu_ring_buffer_set_memory_tag(rec->buf,
+						NUGU_MEMORY_TAG_RECORDER);
 	rec->is_recording = 0;
 	pthread_mutex_init(&rec->lock, NULL);
+	pthread_mutex_init(&rec->link_lock, NULL);
 	pthread_cond_init(&rec->cond, NULL);
 
 #ifdef RECORDER_FILE_DUMP
@@ -194,18 +226,59 @@ NuguRecorder *nugu_recorder_new(const char *name, NuguRecorderDriver *driver)
 	return rec;
 }
 
+/* source->link_lock is held */
+static int _unlink_sink(NuguRecorder *source, NuguRecorder *rec)
+{
+	GList *link;
+
+	pthread_mutex_lock(&source->lock);
+
+	link = g_list_find(source->sinks, rec);
+	if (link)
+		source->sinks = g_list_delete_link(source->sinks, link);
+
+	pthread_mutex_lock(&rec->lock);
+
+	nugu_ring_buffer_clear_items(rec->buf);
+	rec->is_recording = 0;
+	pthread_cond_signal(&rec->cond);
+
+	pthread_mutex_unlock(&rec->lock);
+	pthread_mutex_unlock(&source->lock);
+
+	return (link != NULL);
+}
+
 void nugu_recorder_free(NuguRecorder *rec)
 {
+	GList *cur;
+
 	g_return_if_fail(rec != NULL);
 
+	if (rec->source) {
+		pthread_mutex_lock(&rec->source->link_lock);
+		if (_unlink_sink(rec->source, rec))
+			rec->source->active_sinks--;
+		pthread_mutex_unlock(&rec->source->link_lock);
+	}
+
 	pthread_mutex_lock(&rec->lock);
 
+	for (cur = rec->sinks; cur; cur = cur->next)
+		((NuguRecorder *)cur->data)->source = NULL;
+	g_list_free(rec->sinks);
+
+	if (rec->resampler)
+		nugu_resampler_free(rec->resampler);
+	g_free(rec->convert_buf);
+
 	g_free(rec->name);
 	nugu_ring_buffer_free(rec->buf);
 
 	pthread_mutex_unlock(&rec->lock);
 
 	pthread_mutex_destroy(&rec->lock);
+	pthread_mutex_destroy(&rec->link_lock);
 	pthread_cond_destroy(&rec->cond);
 
 #ifdef RECORDER_FILE_DUMP
@@ -268,10 +341,99 @@ int nugu_recorder_set_property(NuguRecorder *rec, NuguAudioProperty property)
 	return 0;
 }
 
+static void _update_frame_size(NuguRecorder *rec)
+{
+	int size = 0;
+	int max = 0;
+
+	if (nugu_recorder_get_frame_size(rec->source, &size, &max) < 0)
+		return;
+
+	/* same duration as the frame of the source */
+	size = (int)nugu_resampler_convert_size(rec->resampler, size);
+	if (size > 0)
+		nugu_recorder_set_frame_size(rec, size, max);
+}
+
+static int _stop_linked(NuguRecorder *rec)
+{
+	NuguRecorder *source = rec->source;
+	int ret = 0;
+
+	pthread_mutex_lock(&source->link_lock);
+
+	/* the source is stopped by the last linked recorder */
+	if (_unlink_sink(source, rec) && --source->active_sinks == 0 &&
+	    source->is_recording) {
+		nugu_dbg("stop the source recorder '%s'", source->name);
+		ret = nugu_recorder_stop(source);
+	}
+
+	pthread_mutex_unlock(&source->link_lock);
+
+	return ret;
+}
+
+static int _start_linked(NuguRecorder *rec)
+{
+	NuguRecorder *source = rec->source;
+	NuguResampler *resampler;
+
+	pthread_mutex_lock(&source->link_lock);
+	pthread_mutex_lock(&source->lock);
+
+	if (g_list_find(source->sinks, rec)) {
+		pthread_mutex_unlock(&source->lock);
+		pthread_mutex_unlock(&source->link_lock);
+		return 0;
+	}
+
+	resampler = nugu_resampler_new(source->property, rec->property);
+	if (!resampler) {
+		nugu_error("can't convert the audio of '%s'", source->name);
+		pthread_mutex_unlock(&source->lock);
+		pthread_mutex_unlock(&source->link_lock);
+		return -1;
+	}
+
+	if (rec->resampler)
+		nugu_resampler_free(rec->resampler);
+	rec->resampler = resampler;
+
+	pthread_mutex_lock(&rec->lock);
+
+	nugu_ring_buffer_clear_items(rec->buf);
+	rec->is_recording = 1;
+
+	pthread_mutex_unlock(&rec->lock);
+
+	source->sinks = g_list_append(source->sinks, rec);
+
+	pthread_mutex_unlock(&source->lock);
+
+	/* the source is started by the first linked recorder */
+	if (source->active_sinks++ == 0 && !source->is_recording &&
+	    nugu_recorder_start(source) < 0) {
+		_unlink_sink(source, rec);
+		source->active_sinks--;
+		pthread_mutex_unlock(&source->link_lock);
+		return -1;
+	}
+
+	pthread_mutex_unlock(&source->link_lock);
+
+	_update_frame_size(rec);
+
+	return 0;
+}
+
 int nugu_recorder_start(NuguRecorder *rec)
 {
 	g_return_val_if_fail(rec != NULL, -1);
 
+	if (rec->source)
+		return _start_linked(rec);
+
 	if (rec->driver == NULL || rec->driver->ops == NULL ||
 	    rec->driver->ops->start == NULL) {
 		nugu_error("Not supported");
@@ -292,6 +454,9 @@ int nugu_recorder_stop(NuguRecorder *rec)
 {
 	g_return_val_if_fail(rec != NULL, -1);
 
+	if (rec->source)
+		return _stop_linked(rec);
+
 	if (rec->driver == NULL || rec->driver->ops == NULL ||
 	    rec->driver->ops->stop == NULL) {
 		nugu_error("Not supported");
@@ -380,8 +545,53 @@ int nugu_recorder_set_frame_size(NuguRecorder *rec, int size, int max)
 	return ret;
 }
 
+/* called with the lock of the recorder */
+static int _push_frame(NuguRecorder *rec, const char *data, int size)
+{
+	int ret;
+
+#ifdef RECORDER_FILE_DUMP
+	fwrite(data, size, 1, rec->file);
+#endif
+	ret = nugu_ring_buffer_push_data(rec->buf, data, size);
+
+	if (nugu_ring_buffer_get_count(rec->buf))
+		pthread_cond_signal(&rec->cond);
+
+	return ret;
+}
+
+static void _push_sink(NuguRecorder *sink, const char *data, int size)
+{
+	size_t out_size;
+	int len;
+
+	if (nugu_resampler_is_passthrough(sink->resampler)) {
+		pthread_mutex_lock(&sink->lock);
+		_push_frame(sink, data, size);
+		pthread_mutex_unlock(&sink->lock);
+		return;
+	}
+
+	out_size = nugu_resampler_get_output_size(sink->resampler, size);
+	if (out_size > sink->convert_size) {
+		sink->convert_buf = g_realloc(sink->convert_buf, out_size);
+		sink->convert_size = out_size;
+	}
+
+	len = nugu_resampler_process(sink->resampler, data, size,
+				     sink->convert_buf, sink->convert_size);
+	if (len <= 0)
+		return;
+
+	pthread_mutex_lock(&sink->lock);
+	_push_frame(sink, sink->convert_buf, len);
+	pthread_mutex_unlock(&sink->lock);
+}
+
 int nugu_recorder_push_frame(NuguRecorder *rec, const char *data, int size)
 {
+	GList *cur;
 	int ret;
 
 	g_return_val_if_fail(rec != NULL, -1);
@@ -391,13 +601,10 @@ int nugu_recorder_push_frame(NuguRecorder *rec, const char *data, int size)
 
 	pthread_mutex_lock(&rec->lock);
 
-#ifdef RECORDER_FILE_DUMP
-	fwrite(data, size, 1, rec->file);
-#endif
-	ret = nugu_ring_buffer_push_data(rec->buf, data, size);
+	ret = _push_frame(rec, data, size);
 
-	if (nugu_ring_buffer_get_count(rec->buf))
-		pthread_cond_signal(&rec->cond);
+	for (cur = rec->sinks; cur; cur = cur->next)
+		_push_sink(cur->data, data, size);
 
 	pthread_mutex_unlock(&rec->lock);
 
@@ -470,3 +677,25 @@ int nugu_recorder_get_frame_count(NuguRecorder *rec)
 
 	return nugu_ring_buffer_get_count(rec->buf);
 }
+
+int nugu_recorder_set_source(NuguRecorder *rec, NuguRecorder *source)
+{
+	g_return_val_if_fail(rec != NULL, -1);
+	g_return_val_if_fail(rec != source, -1);
+
+	if (rec->is_recording) {
+		nugu_error("'%s' is recording", rec->name);
+		return -1;
+	}
+
+	rec->source = source;
+
+	return 0;
+}
+
+NuguRecorder *nugu_recorder_get_source(NuguRecorder *rec)
+{
+	g_return_val_if_fail(rec != NULL, NULL);
+
+	return rec->source;
+}
@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_sample.h"
+#include "base/nugu_resampler.h"
+
+/* filter length per phase when the rate is not reduced (multiple of 8) */
+#define BASE_TAPS 48
+
+/* cutoff frequency relative to the lower nyquist frequency */
+#define CUTOFF_RATIO 0.92
+
+#define MAX_CHANNELS 8
+#define SAMPLE_BYTES 2
+
+#define PI 3.14159265358979323846
+
+struct _nugu_resampler {
+	NuguAudioProperty in;
+	NuguAudioProperty out;
+
+	int passthrough;
+
+	/* channels of the filter stage */
+	int channels;
+
+	/* output rate / input rate = up / down */
+	int up;
+	int down;
+
+	int taps;
+	float *coefs; /* up phases * taps */
+
+	/* input samples of each channel, preceded by the filter history */
+	float *hist[MAX_CHANNELS];
+	size_t hist_len;
+	size_t hist_alloc;
+
+	/* position of the next output in 1/up input samples */
+	size_t pos;
+
+	/* incomplete input frame */
+	unsigned char partial[MAX_CHANNELS * SAMPLE_BYTES];
+	size_t partial_size;
+
+	/* scratch buffers */
+	int16_t *samples;
+	size_t samples_alloc;
+	float *fout;
+	int16_t *sout;
+	size_t out_alloc;
+};
+
+static int _get_rate(enum nugu_audio_sample_rate rate)
+{
+	switch (rate) {
+	case NUGU_AUDIO_SAMPLE_RATE_8K:
+		return 8000;
+	case NUGU_AUDIO_SAMPLE_RATE_16K:
+		return 16000;
+	case NUGU_AUDIO_SAMPLE_RATE_32K:
+		return 32000;
+	case NUGU_AUDIO_SAMPLE_RATE_22K:
+		return 22050;
+	case NUGU_AUDIO_SAMPLE_RATE_44K:
+		return 44100;
+	default:
+		break;
+	}
+
+	return -1;
+}
+
+static int _is_native_order(enum nugu_audio_format format)
+{
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+	return format == NUGU_AUDIO_FORMAT_S16_LE;
+#else
+	return format == NUGU_AUDIO_FORMAT_S16_BE;
+#endif
+}
+
+static int _gcd(int a, int b)
+{
+	while (b) {
+		int t = a % b;
+
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+/* sin(pi * x) by the Taylor series, to avoid the libm dependency */
+static double _sin_pi(double x)
+{
+	double y;
+	double y2;
+	double term;
+	double sum;
+	int i;
+
+	/* reduce to [-1, 1] and then to [-0.5, 0.5] */
+	x -= 2.0 * (double)(long)(x / 2.0);
+	if (x > 1.0)
+		x -= 2.0;
+	else if (x < -1.0)
+		x += 2.0;
+
+	if (x > 0.5)
+		x = 1.0 - x;
+	else if (x < -0.5)
+		x = -1.0 - x;
+
+	y = PI * x;
+	y2 = y * y;
+	term = y;
+	sum = y;
+
+	for (i = 1; i < 9; i++) {
+		term *= -y2 / ((2 * i) * (2 * i + 1));
+		sum += term;
+	}
+
+	return sum;
+}
+
+static double _cos_pi(double x)
+{
+	return _sin_pi(x + 0.5);
+}
+
+/* windowed sinc at distance d (input samples) from the output position */
+static double _kernel(double d, double cutoff, int taps)
+{
+	double half = taps / 2.0;
+	double sinc;
+	double window;
+
+	if (d <= -half || d >= half)
+		return 0.0;
+
+	if (d == 0.0)
+		sinc = 2.0 * cutoff;
+	else
+		sinc = _sin_pi(2.0 * cutoff * d) / (PI * d);
+
+	/* Blackman window */
+	window = 0.42 + 0.5 * _cos_pi(d / half) +
+		 0.08 * _cos_pi(2.0 * d / half);
+
+	return sinc * window;
+}
+
+static int _make_filter(NuguResampler *rs)
+{
+	double cutoff;
+	int p;
+	int k;
+
+	/* longer filter for the down-sampling to keep the transition band */
+	rs->taps = BASE_TAPS;
+	if (rs->down > rs->up)
+		rs->taps = (BASE_TAPS * rs->down / rs->up + 7) / 8 * 8;
+
+	/* cycles per input sample */
+	cutoff = 0.5 * CUTOFF_RATIO;
+	if (rs->down > rs->up)
+		cutoff = cutoff * rs->up / rs->down;
+
+	rs->coefs = g_try_new(float, (gsize)rs->up * rs->taps);
+	if (!rs->coefs) {
+		nugu_error_nomem();
+		return -1;
+	}
+
+	for (p = 0; p < rs->up; p++) {
+		float *coefs = rs->coefs + (size_t)p * rs->taps;
+		double frac = (double)p / rs->up;
+		double sum = 0;
+
+		for (k = 0; k < rs->taps; k++) {
+			double d = k - (rs->taps / 2 - 1) - frac;
+			double v = _kernel(d, cutoff, rs->taps);
+
+			coefs[k] = (float)v;
+			sum += v;
+		}
+
+		/* unity gain at DC for every phase */
+		for (k = 0; k < rs->taps; k++)
+			coefs[k] = (float)(coefs[k] / sum);
+	}
+
+	return 0;
+}
+
+static int _reserve(void **buf, size_t *alloc, size_t count, size_t size)
+{
+	void *tmp;
+
+	if (count <= *alloc)
+		return 0;
+
+	tmp = g_try_realloc(*buf, count * size);
+	if (!tmp) {
+		nugu_error_nomem();
+		return -1;
+	}
+
+	*buf = tmp;
+	*alloc = count;
+
+	return 0;
+}
+
+static int _reserve_hist(NuguResampler *rs, size_t count)
+{
+	size_t alloc;
+	int i;
+
+	if (count <= rs->hist_alloc)
+		return 0;
+
+	alloc = MAX(count, rs->hist_alloc * 2);
+
+	for (i = 0; i < rs->channels; i++) {
+		float *tmp = g_try_realloc(rs->hist[i], alloc * sizeof(float));
+
+		if (!tmp) {
+			nugu_error_nomem();
+			return -1;
+		}
+
+		rs->hist[i] = tmp;
+	}
+
+	rs->hist_alloc = alloc;
+
+	return 0;
+}
+
+static int _reserve_output(NuguResampler *rs, size_t frames)
+{
+	size_t count = frames * MAX(rs->channels, rs->out.channel);
+	size_t alloc = rs->out_alloc;
+
+	if (_reserve((void **)&rs->fout, &alloc, count, sizeof(float)) < 0)
+		return -1;
+
+	alloc = rs->out_alloc;
+	if (_reserve((void **)&rs->sout, &alloc, count, sizeof(int16_t)) < 0)
+		return -1;
+
+	rs->out_alloc = alloc;
+
+	return 0;
+}
+
+NuguResampler *nugu_resampler_new(NuguAudioProperty in, NuguAudioProperty out)
+{
+	NuguResampler *rs;
+	int in_rate = _get_rate(in.samplerate);
+	int out_rate = _get_rate(out.samplerate);
+	int gcd;
+
+	if (in_rate < 0 || out_rate < 0) {
+		nugu_error("not supported sample rate");
+		return NULL;
+	}
+
+	if ((in.format != NUGU_AUDIO_FORMAT_S16_LE &&
+	     in.format != NUGU_AUDIO_FORMAT_S16_BE) ||
+	    (out.format != NUGU_AUDIO_FORMAT_S16_LE &&
+	     out.format != NUGU_AUDIO_FORMAT_S16_BE)) {
+		nugu_error("not supported format (%d -> %d)", in.format,
+			   out.format);
+		return NULL;
+	}
+
+	if (in.channel < 1 || in.channel > MAX_CHANNELS || out.channel < 1 ||
+	    out.channel > MAX_CHANNELS ||
+	    (in.channel != out.channel && in.channel != 1 &&
+	     out.channel != 1)) {
+		nugu_error("not supported channels (%d -> %d)", in.channel,
+			   out.channel);
+		return NULL;
+	}
+
+	rs = g_malloc0(sizeof(struct _nugu_resampler));
+	if (!rs) {
+		nugu_error_nomem();
+		return NULL;
+	}
+
+	rs->in = in;
+	rs->out = out;
+	rs->channels = (out.channel == 1) ? 1 : in.channel;
+
+	gcd = _gcd(in_rate, out_rate);
+	rs->up = out_rate / gcd;
+	rs->down = in_rate / gcd;
+
+	rs->passthrough = (in_rate == out_rate && in.format == out.format &&
+			   in.channel == out.channel);
+
+	if (rs->up != rs->down && _make_filter(rs) < 0) {
+		g_free(rs);
+		return NULL;
+	}
+
+	nugu_resampler_reset(rs);
+
+	nugu_dbg("resampler %d Hz, %d ch -> %d Hz, %d ch (%d phases, %d taps)",
+		 in_rate, in.channel, out_rate, out.channel, rs->up,
+		 rs->taps);
+
+	return rs;
+}
+
+void nugu_resampler_free(NuguResampler *rs)
+{
+	int i;
+
+	g_return_if_fail(rs != NULL);
+
+	for (i = 0; i < MAX_CHANNELS; i++)
+		g_free(rs->hist[i]);
+
+	g_free(rs->coefs);
+	g_free(rs->samples);
+	g_free(rs->fout);
+	g_free(rs->sout);
+
+	memset(rs, 0, sizeof(struct _nugu_resampler));
+	g_free(rs);
+}
+
+int nugu_resampler_is_passthrough(NuguResampler *rs)
+{
+	g_return_val_if_fail(rs != NULL, 0);
+
+	return rs->passthrough;
+}
+
+void nugu_resampler_reset(NuguResampler *rs)
+{
+	int i;
+
+	g_return_if_fail(rs != NULL);
+
+	rs->partial_size = 0;
+	rs->pos = 0;
+	rs->hist_len = 0;
+
+	if (rs->up == rs->down)
+		return;
+
+	/* zero history to center the first output on the first input */
+	if (_reserve_hist(rs, rs->taps) < 0)
+		return;
+
+	rs->hist_len = rs->taps / 2 - 1;
+	for (i = 0; i < rs->channels; i++)
+		memset(rs->hist[i], 0, rs->hist_len * sizeof(float));
+}
+
+size_t nugu_resampler_get_output_size(NuguResampler *rs, size_t size)
+{
+	size_t frames;
+
+	g_return_val_if_fail(rs != NULL, 0);
+
+	frames = (rs->partial_size + size) / (rs->in.channel * SAMPLE_BYTES);
+	frames = (rs->hist_len + frames) * rs->up / rs->down + 1;
+
+	return frames * rs->out.channel * SAMPLE_BYTES;
+}
+
+size_t nugu_resampler_convert_size(NuguResampler *rs, size_t size)
+{
+	size_t frames;
+
+	g_return_val_if_fail(rs != NULL, 0);
+
+	frames = size / (rs->in.channel * SAMPLE_BYTES);
+
+	return frames * rs->up / rs->down * rs->out.channel * SAMPLE_BYTES;
+}
+
+/* interleaved input frames to the native samples of the filter channels */
+static void _mix_input(NuguResampler *rs, int16_t *samples, size_t frames)
+{
+	int channels = rs->in.channel;
+	size_t i;
+	int c;
+
+	if (!_is_native_order(rs->in.format))
+		nugu_sample_s16_swap(samples, samples, frames * channels);
+
+	if (rs->channels == channels)
+		return;
+
+	if (channels == 2) {
+		nugu_sample_s16_downmix_stereo(samples, samples, frames);
+		return;
+	}
+
+	for (i = 0; i < frames; i++) {
+		int32_t sum = 0;
+
+		for (c = 0; c < channels; c++)
+			sum += samples[i * channels + c];
+
+		samples[i] = (int16_t)(sum / channels);
+	}
+}
+
+/* filter the history and write the interleaved float outputs */
+static size_t _filter(NuguResampler *rs)
+{
+	size_t count = 0;
+	size_t index;
+	int c;
+
+	while ((index = rs->pos / rs->up) + rs->taps <= rs->hist_len) {
+		const float *coefs =
+			rs->coefs + (rs->pos % rs->up) * (size_t)rs->taps;
+
+		for (c = 0; c < rs->channels; c++)
+			rs->fout[count * rs->channels + c] =
+				nugu_sample_float_dot(coefs,
+						      rs->hist[c] + index,
+						      rs->taps);
+
+		count++;
+		rs->pos += rs->down;
+	}
+
+	/* drop the samples which are not used by the next output */
+	index = rs->pos / rs->up;
+	for (c = 0; c < rs->channels; c++)
+		memmove(rs->hist[c], rs->hist[c] + index,
+			(rs->hist_len - index) * sizeof(float));
+
+	rs->hist_len -= index;
+	rs->pos -= index * rs->up;
+
+	return count;
+}
+
+static size_t _resample(NuguResampler *rs, const int16_t *samples,
+			size_t frames)
+{
+	size_t i;
+	int c;
+
+	if (_reserve_hist(rs, rs->hist_len + frames) < 0 ||
+	    _reserve_output(rs, (rs->hist_len + frames) * rs->up / rs->down +
+					1) < 0)
+		return 0;
+
+	/* de-interleave to the history of each channel */
+	if (rs->channels == 1) {
+		nugu_sample_s16_to_float(samples, rs->hist[0] + rs->hist_len,
+					 frames);
+	} else {
+		for (c = 0; c < rs->channels; c++) {
+			float *dest = rs->hist[c] + rs->hist_len;
+
+			for (i = 0; i < frames; i++)
+				dest[i] = samples[i * rs->channels + c] *
+					  (1.0f / 32768.0f);
+		}
+	}
+
+	rs->hist_len += frames;
+
+	frames = _filter(rs);
+	nugu_sample_float_to_s16(rs->fout, rs->sout, frames * rs->channels);
+
+	return frames;
+}
+
+static void _write_output(NuguResampler *rs, const int16_t *samples,
+			  size_t frames, void *out)
+{
+	int16_t *dest = out;
+	size_t count = frames * rs->out.channel;
+	size_t i;
+	int c;
+
+	if (rs->channels == rs->out.channel) {
+		memcpy(dest, samples, count * SAMPLE_BYTES);
+	} else {
+		/* duplicate the mono channel */
+		for (i = 0; i < frames; i++)
+			for (c = 0; c < rs->out.channel; c++)
+				dest[i * rs->out.channel + c] = samples[i];
+	}
+
+	if (!_is_native_order(rs->out.format))
+		nugu_sample_s16_swap(dest, dest, count);
+}
+
+int nugu_resampler_process(NuguResampler *rs, const void *data, size_t size,
+			   void *out, size_t out_size)
+{
+	size_t frame_size;
+	size_t frames;
+	size_t total;
+	size_t remain;
+	size_t alloc;
+	const int16_t *result;
+
+	g_return_val_if_fail(rs != NULL, -1);
+	g_return_val_if_fail(data != NULL || size == 0, -1);
+	g_return_val_if_fail(out != NULL, -1);
+
+	if (out_size < nugu_resampler_get_output_size(rs, size)) {
+		nugu_error("output buffer is too small");
+		return -1;
+	}
+
+	if (rs->passthrough && rs->partial_size == 0) {
+		memcpy(out, data, size);
+		return (int)size;
+	}
+
+	frame_size = rs->in.channel * SAMPLE_BYTES;
+	total = rs->partial_size + size;
+	frames = total / frame_size;
+	remain = total % frame_size;
+
+	if (frames == 0) {
+		memcpy(rs->partial + rs->partial_size, data, size);
+		rs->partial_size += size;
+		return 0;
+	}
+
+	alloc = rs->samples_alloc;
+	if (_reserve((void **)&rs->samples, &alloc,
+		     frames * rs->in.channel, sizeof(int16_t)) < 0)
+		return -1;
+	rs->samples_alloc = alloc;
+
+	/* unaligned byte stream to the aligned samples */
+	memcpy(rs->samples, rs->partial, rs->partial_size);
+	memcpy((char *)rs->samples + rs->partial_size, data, size - remain);
+	memcpy(rs->partial, (const char *)data + size - remain, remain);
+	rs->partial_size = remain;
+
+	if (rs->passthrough) {
+		memcpy(out, rs->samples, frames * frame_size);
+		return (int)(frames * frame_size);
+	}
+
+	_mix_input(rs, rs->samples, frames);
+
+	if (rs->up == rs->down) {
+		result = rs->samples;
+	} else {
+		frames = _resample(rs, rs->samples, frames);
+		result = rs->sout;
+	}
+
+	_write_output(rs, result, frames, out);
+
+	return (int)(frames * rs->out.channel * SAMPLE_BYTES);
+}
@@ -21,6 +21,8 @@
 #include <glib.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_memory.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_ringbuffer.h"
 
 //#define DEBUG_RINGBUFFER
@@ -33,8 +35,12 @@ struct _nugu_ring_buffer {
 	int count;
 	unsigned long woffset;
 	pthread_mutex_t mutex;
+	NuguMetric *overruns;
+	enum nugu_memory_tag tag;
 };
 
+static NuguMetric *_overruns_metric;
+
 static void _calculate_count(NuguRingBuffer *buf, int write_item, int size)
 {
 	int write_index = buf->woffset / buf->item_size;
@@ -56,18 +62,25 @@ NuguRingBuffer *nugu_ring_buffer_new(int item_size, int max_items)
 	g_return_val_if_fail(item_size > 0, NULL);
 	g_return_val_if_fail(max_items > 0, NULL);
 
-	buffer = (NuguRingBuffer *)calloc(1, sizeof(struct _nugu_ring_buffer));
+	buffer = (NuguRingBuffer *)nugu_memory_alloc(
+		NUGU_MEMORY_TAG_BUFFER, sizeof(struct _nugu_ring_buffer));
 	if (!buffer) {
 		nugu_error_nomem();
 		return NULL;
 	}
 
-	buffer->buf = (unsigned char *)calloc(1, item_size * max_items);
+	buffer->tag = NUGU_MEMORY_TAG_BUFFER;
+	buffer->buf = (unsigned char *)nugu_memory_alloc(
+		buffer->tag, item_size * max_items);
 	buffer->item_size = item_size;
 	buffer->max_items = max_items;
 	buffer->read_index = 0;
 	buffer->woffset = 0;
 	buffer->count = 0;
+	buffer->overruns = nugu_metrics_register_once(
+		&_overruns_metric, "nugu_ringbuffer_overruns",
+		NUGU_METRIC_TYPE_COUNTER,
+		"Number of the pushes which overwrote the unread items");
 
 	pthread_mutex_init(&buffer->mutex, NULL);
 
@@ -79,8 +92,31 @@ void nugu_ring_buffer_free(NuguRingBuffer *buf)
 	g_return_if_fail(buf->buf != NULL);
 
 	pthread_mutex_destroy(&buf->mutex);
-	free(buf->buf);
-	free(buf);
+	nugu_memory_free(buf->tag, buf->buf, buf->item_size * buf->max_items);
+	nugu_memory_free(buf->tag, buf, sizeof(struct _nugu_ring_buffer));
+}
+
+void nugu_ring_buffer_set_memory_tag(NuguRingBuffer *buf,
+				     enum nugu_memory_tag tag)
+{
+	size_t size;
+
+	g_return_if_fail(buf != NULL);
+	g_return_if_fail(tag < NUGU_MEMORY_TAG_MAX);
+
+	pthread_mutex_lock(&buf->mutex);
+
+	if (buf->tag != tag) {
+		/* move the accounted memory to the new tag */
+		size = sizeof(struct _nugu_ring_buffer) +
+		       buf->item_size * buf->max_items;
+		nugu_memory_add(tag, size);
+		nugu_memory_sub(buf->tag, size);
+
+		buf->tag = tag;
+	}
+
+	pthread_mutex_unlock(&buf->mutex);
 }
 
 int nugu_ring_buffer_resize(NuguRingBuffer *buf, int item_size, int max_items)
@@ -95,8 +131,9 @@ int nugu_ring_buffer_resize(NuguRingBuffer *buf, int item_size, int max_items)
 
 	pthread_mutex_lock(&buf->mutex);
 
-	free(buf->buf);
-	buf->buf = (unsigned char *)calloc(1, item_size * max_items);
+	nugu_memory_free(buf->tag, buf->buf, buf->item_size * buf->max_items);
+	buf->buf = (unsigned char *)nugu_memory_alloc(buf->tag,
+						      item_size * max_items);
 	buf->item_size = item_size;
 	buf->max_items = max_items;
 	buf->read_index = 0;
@@ -156,6 +193,8 @@ int nugu_ring_buffer_push_data(NuguRingBuffer *buf, const char *data, int size)
 			buf->read_index = buf->read_index - buf->max_items;
 
 		pthread_mutex_unlock(&buf->mutex);
+
+		nugu_metric_add(buf->overruns, 1);
 	}
 
 	if ((buf->woffset + size) >= buf_size) {
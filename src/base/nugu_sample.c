@@ -0,0 +1,669 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_sample.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define HAVE_SAMPLE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(HAVE_SAMPLE_SSE2) && defined(__GNUC__) &&                          \
+	(defined(__x86_64__) || defined(__i386__))
+#define HAVE_SAMPLE_AVX2
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define HAVE_SAMPLE_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * Adding and subtracting 1.5 * 2^23 rounds a float in the 16-bit range to
+ * the nearest integer (ties to even), same as the default rounding mode
+ * of the SIMD conversion instructions, without libm.
+ */
+#define ROUND_MAGIC 12582912.0f
+
+struct sample_ops {
+	enum nugu_sample_isa isa;
+	void (*swap)(const int16_t *src, int16_t *dest, size_t count);
+	void (*to_float)(const int16_t *src, float *dest, size_t count);
+	void (*from_float)(const float *src, int16_t *dest, size_t count,
+			   float scale);
+	void (*downmix)(const int16_t *src, int16_t *dest, size_t frames);
+	void (*gain)(const int16_t *src, int16_t *dest, size_t count,
+		     float gain);
+	float (*dot)(const float *a, const float *b, size_t count);
+};
+
+static inline int16_t _saturate_round(float v)
+{
+	/* NaN is mapped to the minimum value like the SIMD versions */
+	if (!(v >= -32768.0f))
+		return -32768;
+	if (v > 32767.0f)
+		return 32767;
+
+	return (int16_t)((v + ROUND_MAGIC) - ROUND_MAGIC);
+}
+
+static void _swap_scalar(const int16_t *src, int16_t *dest, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		uint16_t v = (uint16_t)src[i];
+
+		dest[i] = (int16_t)((v << 8) | (v >> 8));
+	}
+}
+
+static void _to_float_scalar(const int16_t *src, float *dest, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+		dest[i] = (float)src[i] * (1.0f / 32768.0f);
+}
+
+static void _from_float_scalar(const float *src, int16_t *dest, size_t count,
+			       float scale)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+		dest[i] = _saturate_round(src[i] * scale);
+}
+
+static void _downmix_scalar(const int16_t *src, int16_t *dest, size_t frames)
+{
+	size_t i;
+
+	for (i = 0; i < frames; i++)
+		dest[i] = (int16_t)(((int32_t)src[2 * i] + src[2 * i + 1]) >>
+				    1);
+}
+
+static void _gain_scalar(const int16_t *src, int16_t *dest, size_t count,
+			 float gain)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+		dest[i] = _saturate_round((float)src[i] * gain);
+}
+
+static float _dot_scalar(const float *a, const float *b, size_t count)
+{
+	float sum = 0.0f;
+	size_t i;
+
+	for (i = 0; i < count; i++)
+		sum += a[i] * b[i];
+
+	return sum;
+}
+
+static const struct sample_ops ops_scalar = {
+	NUGU_SAMPLE_ISA_SCALAR, _swap_scalar, _to_float_scalar,
+	_from_float_scalar, _downmix_scalar, _gain_scalar, _dot_scalar
+};
+
+#ifdef HAVE_SAMPLE_SSE2
+static void _swap_sse2(const int16_t *src, int16_t *dest, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *)(dest + i), v);
+	}
+
+	_swap_scalar(src + i, dest + i, count - i);
+}
+
+static void _to_float_sse2(const int16_t *src, float *dest, size_t count)
+{
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(dest + i + 4,
+			      _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+
+	_to_float_scalar(src + i, dest + i, count - i);
+}
+
+static inline __m128i _pack_sse2(__m128 lo, __m128 hi)
+{
+	const __m128 min = _mm_set1_ps(-32768.0f);
+	const __m128 max = _mm_set1_ps(32767.0f);
+
+	/* max_ps returns the second operand for NaN */
+	lo = _mm_min_ps(_mm_max_ps(lo, min), max);
+	hi = _mm_min_ps(_mm_max_ps(hi, min), max);
+
+	return _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+}
+
+static void _from_float_sse2(const float *src, int16_t *dest, size_t count,
+			     float scale)
+{
+	const __m128 s = _mm_set1_ps(scale);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m128 lo = _mm_mul_ps(_mm_loadu_ps(src + i), s);
+		__m128 hi = _mm_mul_ps(_mm_loadu_ps(src + i + 4), s);
+
+		_mm_storeu_si128((__m128i *)(dest + i), _pack_sse2(lo, hi));
+	}
+
+	_from_float_scalar(src + i, dest + i, count - i, scale);
+}
+
+static void _downmix_sse2(const int16_t *src, int16_t *dest, size_t frames)
+{
+	const __m128i ones = _mm_set1_epi16(1);
+	size_t i = 0;
+
+	for (; i + 8 <= frames; i += 8) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + 2 * i + 8));
+
+		/* madd with ones: 32-bit (left + right) for each frame */
+		a = _mm_srai_epi32(_mm_madd_epi16(a, ones), 1);
+		b = _mm_srai_epi32(_mm_madd_epi16(b, ones), 1);
+		_mm_storeu_si128((__m128i *)(dest + i), _mm_packs_epi32(a, b));
+	}
+
+	_downmix_scalar(src + 2 * i, dest + i, frames - i);
+}
+
+static void _gain_sse2(const int16_t *src, int16_t *dest, size_t count,
+		       float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+		v = _pack_sse2(_mm_mul_ps(_mm_cvtepi32_ps(lo), g),
+			       _mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+		_mm_storeu_si128((__m128i *)(dest + i), v);
+	}
+
+	_gain_scalar(src + i, dest + i, count - i, gain);
+}
+
+static float _dot_sse2(const float *a, const float *b, size_t count)
+{
+	__m128 acc = _mm_setzero_ps();
+	float lanes[4];
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i),
+						 _mm_loadu_ps(b + i)));
+
+	_mm_storeu_ps(lanes, acc);
+
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+	       _dot_scalar(a + i, b + i, count - i);
+}
+
+static const struct sample_ops ops_sse2 = { NUGU_SAMPLE_ISA_SSE2, _swap_sse2,
+					    _to_float_sse2, _from_float_sse2,
+					    _downmix_sse2, _gain_sse2,
+					    _dot_sse2 };
+#endif
+
+#ifdef HAVE_SAMPLE_AVX2
+TARGET_AVX2 static void _swap_avx2(const int16_t *src, int16_t *dest,
+				   size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+
+		v = _mm256_or_si256(_mm256_slli_epi16(v, 8),
+				    _mm256_srli_epi16(v, 8));
+		_mm256_storeu_si256((__m256i *)(dest + i), v);
+	}
+
+	_swap_scalar(src + i, dest + i, count - i);
+}
+
+TARGET_AVX2 static void _to_float_avx2(const int16_t *src, float *dest,
+				       size_t count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		__m256i w = _mm256_cvtepi16_epi32(v);
+
+		_mm256_storeu_ps(dest + i,
+				 _mm256_mul_ps(_mm256_cvtepi32_ps(w), scale));
+	}
+
+	_to_float_scalar(src + i, dest + i, count - i);
+}
+
+TARGET_AVX2 static void _from_float_avx2(const float *src, int16_t *dest,
+					 size_t count, float scale)
+{
+	const __m256 s = _mm256_set1_ps(scale);
+	const __m256 min = _mm256_set1_ps(-32768.0f);
+	const __m256 max = _mm256_set1_ps(32767.0f);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m256 lo = _mm256_mul_ps(_mm256_loadu_ps(src + i), s);
+		__m256 hi = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), s);
+		__m256i v;
+
+		lo = _mm256_min_ps(_mm256_max_ps(lo, min), max);
+		hi = _mm256_min_ps(_mm256_max_ps(hi, min), max);
+
+		/* packs works per 128-bit lane, restore the sample order */
+		v = _mm256_packs_epi32(_mm256_cvtps_epi32(lo),
+				       _mm256_cvtps_epi32(hi));
+		v = _mm256_permute4x64_epi64(v, 0xD8);
+		_mm256_storeu_si256((__m256i *)(dest + i), v);
+	}
+
+	_from_float_scalar(src + i, dest + i, count - i, scale);
+}
+
+TARGET_AVX2 static void _downmix_avx2(const int16_t *src, int16_t *dest,
+				      size_t frames)
+{
+	const __m256i ones = _mm256_set1_epi16(1);
+	size_t i = 0;
+
+	for (; i + 16 <= frames; i += 16) {
+		__m256i a =
+			_mm256_loadu_si256((const __m256i *)(src + 2 * i));
+		__m256i b =
+			_mm256_loadu_si256((const __m256i *)(src + 2 * i + 16));
+		__m256i v;
+
+		a = _mm256_srai_epi32(_mm256_madd_epi16(a, ones), 1);
+		b = _mm256_srai_epi32(_mm256_madd_epi16(b, ones), 1);
+		v = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+		_mm256_storeu_si256((__m256i *)(dest + i), v);
+	}
+
+	_downmix_scalar(src + 2 * i, dest + i, frames - i);
+}
+
+TARGET_AVX2 static void _gain_avx2(const int16_t *src, int16_t *dest,
+				   size_t count, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	const __m256 min = _mm256_set1_ps(-32768.0f);
+	const __m256 max = _mm256_set1_ps(32767.0f);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m256i a = _mm256_cvtepi16_epi32(
+			_mm_loadu_si128((const __m128i *)(src + i)));
+		__m256i b = _mm256_cvtepi16_epi32(
+			_mm_loadu_si128((const __m128i *)(src + i + 8)));
+		__m256 lo = _mm256_mul_ps(_mm256_cvtepi32_ps(a), g);
+		__m256 hi = _mm256_mul_ps(_mm256_cvtepi32_ps(b), g);
+		__m256i v;
+
+		lo = _mm256_min_ps(_mm256_max_ps(lo, min), max);
+		hi = _mm256_min_ps(_mm256_max_ps(hi, min), max);
+
+		v = _mm256_packs_epi32(_mm256_cvtps_epi32(lo),
+				       _mm256_cvtps_epi32(hi));
+		v = _mm256_permute4x64_epi64(v, 0xD8);
+		_mm256_storeu_si256((__m256i *)(dest + i), v);
+	}
+
+	_gain_scalar(src + i, dest + i, count - i, gain);
+}
+
+TARGET_AVX2 static float _dot_avx2(const float *a, const float *b,
+				   size_t count)
+{
+	__m256 acc = _mm256_setzero_ps();
+	__m128 sum;
+	float lanes[4];
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+						       _mm256_loadu_ps(b + i)));
+
+	sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+			 _mm256_extractf128_ps(acc, 1));
+	_mm_storeu_ps(lanes, sum);
+
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+	       _dot_scalar(a + i, b + i, count - i);
+}
+
+static const struct sample_ops ops_avx2 = { NUGU_SAMPLE_ISA_AVX2, _swap_avx2,
+					    _to_float_avx2, _from_float_avx2,
+					    _downmix_avx2, _gain_avx2,
+					    _dot_avx2 };
+#endif
+
+#ifdef HAVE_SAMPLE_NEON
+static void _swap_neon(const int16_t *src, int16_t *dest, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)(src + i));
+
+		vst1q_u8((uint8_t *)(dest + i), vrev16q_u8(v));
+	}
+
+	_swap_scalar(src + i, dest + i, count - i);
+}
+
+static void _to_float_neon(const int16_t *src, float *dest, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t v = vld1q_s16(src + i);
+		int32x4_t lo = vmovl_s16(vget_low_s16(v));
+		int32x4_t hi = vmovl_s16(vget_high_s16(v));
+
+		vst1q_f32(dest + i,
+			  vmulq_n_f32(vcvtq_f32_s32(lo), 1.0f / 32768.0f));
+		vst1q_f32(dest + i + 4,
+			  vmulq_n_f32(vcvtq_f32_s32(hi), 1.0f / 32768.0f));
+	}
+
+	_to_float_scalar(src + i, dest + i, count - i);
+}
+
+static void _from_float_neon(const float *src, int16_t *dest, size_t count,
+			     float scale)
+{
+	const float32x4_t min = vdupq_n_f32(-32768.0f);
+	const float32x4_t max = vdupq_n_f32(32767.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		float32x4_t lo = vmulq_n_f32(vld1q_f32(src + i), scale);
+		float32x4_t hi = vmulq_n_f32(vld1q_f32(src + i + 4), scale);
+
+		/* maxnm returns the number for NaN */
+		lo = vminq_f32(vmaxnmq_f32(lo, min), max);
+		hi = vminq_f32(vmaxnmq_f32(hi, min), max);
+
+		vst1q_s16(dest + i,
+			  vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)),
+				       vqmovn_s32(vcvtnq_s32_f32(hi))));
+	}
+
+	_from_float_scalar(src + i, dest + i, count - i, scale);
+}
+
+static void _downmix_neon(const int16_t *src, int16_t *dest, size_t frames)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= frames; i += 8) {
+		int16x8x2_t v = vld2q_s16(src + 2 * i);
+
+		/* halving add: (left + right) >> 1 without overflow */
+		vst1q_s16(dest + i, vhaddq_s16(v.val[0], v.val[1]));
+	}
+
+	_downmix_scalar(src + 2 * i, dest + i, frames - i);
+}
+
+static void _gain_neon(const int16_t *src, int16_t *dest, size_t count,
+		       float gain)
+{
+	const float32x4_t min = vdupq_n_f32(-32768.0f);
+	const float32x4_t max = vdupq_n_f32(32767.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t v = vld1q_s16(src + i);
+		float32x4_t lo =
+			vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+		float32x4_t hi =
+			vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+
+		lo = vminq_f32(vmaxnmq_f32(vmulq_n_f32(lo, gain), min), max);
+		hi = vminq_f32(vmaxnmq_f32(vmulq_n_f32(hi, gain), min), max);
+
+		vst1q_s16(dest + i,
+			  vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)),
+				       vqmovn_s32(vcvtnq_s32_f32(hi))));
+	}
+
+	_gain_scalar(src + i, dest + i, count - i, gain);
+}
+
+static float _dot_neon(const float *a, const float *b, size_t count)
+{
+	float32x4_t acc = vdupq_n_f32(0.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+		acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+
+	return vaddvq_f32(acc) + _dot_scalar(a + i, b + i, count - i);
+}
+
+static const struct sample_ops ops_neon = { NUGU_SAMPLE_ISA_NEON, _swap_neon,
+					    _to_float_neon, _from_float_neon,
+					    _downmix_neon, _gain_neon,
+					    _dot_neon };
+#endif
+
+static const struct sample_ops *_ops;
+
+static const struct sample_ops *_find_ops(enum nugu_sample_isa isa)
+{
+	switch (isa) {
+	case NUGU_SAMPLE_ISA_AUTO:
+#if defined(HAVE_SAMPLE_AVX2)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return &ops_avx2;
+#endif
+#if defined(HAVE_SAMPLE_SSE2)
+		return &ops_sse2;
+#elif defined(HAVE_SAMPLE_NEON)
+		return &ops_neon;
+#else
+		return &ops_scalar;
+#endif
+	case NUGU_SAMPLE_ISA_SCALAR:
+		return &ops_scalar;
+#ifdef HAVE_SAMPLE_SSE2
+	case NUGU_SAMPLE_ISA_SSE2:
+		return &ops_sse2;
+#endif
+#ifdef HAVE_SAMPLE_AVX2
+	case NUGU_SAMPLE_ISA_AVX2:
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return &ops_avx2;
+		return NULL;
+#endif
+#ifdef HAVE_SAMPLE_NEON
+	case NUGU_SAMPLE_ISA_NEON:
+		return &ops_neon;
+#endif
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+static inline const struct sample_ops *_get_ops(void)
+{
+	const struct sample_ops *ops = g_atomic_pointer_get(&_ops);
+
+	if (ops)
+		return ops;
+
+	ops = _find_ops(NUGU_SAMPLE_ISA_AUTO);
+	nugu_dbg("sample conversion: %s", nugu_sample_isa_name(ops->isa));
+	g_atomic_pointer_set(&_ops, (gpointer)ops);
+
+	return ops;
+}
+
+int nugu_sample_set_isa(enum nugu_sample_isa isa)
+{
+	const struct sample_ops *ops = _find_ops(isa);
+
+	if (!ops) {
+		nugu_error("not supported: %s", nugu_sample_isa_name(isa));
+		return -1;
+	}
+
+	g_atomic_pointer_set(&_ops, (gpointer)ops);
+
+	return 0;
+}
+
+enum nugu_sample_isa nugu_sample_get_isa(void)
+{
+	return _get_ops()->isa;
+}
+
+const char *nugu_sample_isa_name(enum nugu_sample_isa isa)
+{
+	switch (isa) {
+	case NUGU_SAMPLE_ISA_AUTO:
+		return "auto";
+	case NUGU_SAMPLE_ISA_SCALAR:
+		return "scalar";
+	case NUGU_SAMPLE_ISA_SSE2:
+		return "sse2";
+	case NUGU_SAMPLE_ISA_AVX2:
+		return "avx2";
+	case NUGU_SAMPLE_ISA_NEON:
+		return "neon";
+	default:
+		break;
+	}
+
+	return "unknown";
+}
+
+void nugu_sample_s16_to_le(const int16_t *src, void *dest, size_t count)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+	memcpy(dest, src, count * 2);
+#else
+	_get_ops()->swap(src, (int16_t *)dest, count);
+#endif
+}
+
+void nugu_sample_s16_from_le(const void *src, int16_t *dest, size_t count)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+	memcpy(dest, src, count * 2);
+#else
+	_get_ops()->swap((const int16_t *)src, dest, count);
+#endif
+}
+
+void nugu_sample_s16_swap(const int16_t *src, int16_t *dest, size_t count)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+	_get_ops()->swap(src, dest, count);
+}
+
+void nugu_sample_s16_to_float(const int16_t *src, float *dest, size_t count)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+	_get_ops()->to_float(src, dest, count);
+}
+
+void nugu_sample_float_to_s16(const float *src, int16_t *dest, size_t count)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+	_get_ops()->from_float(src, dest, count, 32768.0f);
+}
+
+void nugu_sample_s16_downmix_stereo(const int16_t *src, int16_t *dest,
+				    size_t frames)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+	_get_ops()->downmix(src, dest, frames);
+}
+
+void nugu_sample_s16_gain(const int16_t *src, int16_t *dest, size_t count,
+			  float gain)
+{
+	g_return_if_fail(src != NULL);
+	g_return_if_fail(dest != NULL);
+
+	_get_ops()->gain(src, dest, count, gain);
+}
+
+float nugu_sample_float_dot(const float *a, const float *b, size_t count)
+{
+	g_return_val_if_fail(a != NULL, 0.0f);
+	g_return_val_if_fail(b != NULL, 0.0f);
+
+	return _get_ops()->dot(a, b, count);
+}
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#ifdef HAVE_SYSCALL
+#include <sys/syscall.h>
+#endif
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#if defined(__MSYS__) || defined(_WIN32)
+#include <windows.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "base/nugu_log.h"
+#include "base/nugu_span.h"
+
+/* events of each thread (24 bytes per event) */
+#define SPAN_BUFFER_EVENTS 4096
+
+/* running threads beyond the limit are not recorded */
+#define SPAN_MAX_THREADS 64
+
+#define SPAN_THREAD_NAME_SIZE 17
+
+struct _span_event {
+	const char *name;
+	gint64 timestamp_ns;
+	char phase;
+};
+
+/**
+ * The buffer is only written by the owner thread, and the head is published
+ * after the event is written. The buffer is kept after the thread exits
+ * to dump the spans of the finished threads, until the slot is recycled
+ * for a new thread or the spans are cleared.
+ */
+struct _span_buffer {
+	long tid;
+	char thread_name[SPAN_THREAD_NAME_SIZE];
+	int finished; /* protected by _span_lock */
+	gint head; /* atomic */
+	struct _span_event events[SPAN_BUFFER_EVENTS];
+};
+
+static void _span_release_buffer(gpointer data);
+
+/* protected by _span_lock */
+static struct _span_buffer *_buffers[SPAN_MAX_THREADS];
+static int _thread_count;
+
+static GPrivate _buffer_key = G_PRIVATE_INIT(_span_release_buffer);
+
+/* mark of the thread which has no buffer */
+static char _no_buffer;
+
+static pthread_mutex_t _span_lock = PTHREAD_MUTEX_INITIALIZER;
+static gint _span_enabled; /* atomic */
+static int _span_env_checked;
+static gint64 _span_clear_ns; /* protected by _span_lock */
+
+static gint64 _span_get_monotonic_ns(void)
+{
+#ifdef _WIN32
+	return g_get_monotonic_time() * 1000;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (gint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static long _span_get_tid(int index)
+{
+#if defined(HAVE_SYSCALL) && defined(__linux__)
+	return (long)syscall(SYS_gettid);
+#elif defined(__MSYS__) || defined(_WIN32)
+	return (long)GetCurrentThreadId();
+#else
+	return index + 1;
+#endif
+}
+
+/* no event after the last clear. must be called with the _span_lock */
+static int _span_buffer_is_empty(const struct _span_buffer *buffer)
+{
+	guint head = (guint)g_atomic_int_get(&buffer->head);
+
+	if (head == 0)
+		return 1;
+
+	return buffer->events[(head - 1) % SPAN_BUFFER_EVENTS].timestamp_ns <
+	       _span_clear_ns;
+}
+
+/**
+ * Find an empty slot, or recycle the slot of a finished thread.
+ * Must be called with the _span_lock.
+ */
+static int _span_find_slot(void)
+{
+	int recycle = -1;
+	int i;
+
+	for (i = 0; i < SPAN_MAX_THREADS; i++) {
+		if (!_buffers[i])
+			return i;
+
+		if (recycle < 0 && _buffers[i]->finished)
+			recycle = i;
+	}
+
+	if (recycle >= 0) {
+		free(_buffers[recycle]);
+		_buffers[recycle] = NULL;
+	}
+
+	return recycle;
+}
+
+static struct _span_buffer *_span_get_buffer(void)
+{
+	struct _span_buffer *buffer;
+	int slot;
+
+	buffer = g_private_get(&_buffer_key);
+	if (buffer == (struct _span_buffer *)&_no_buffer)
+		return NULL;
+	else if (buffer)
+		return buffer;
+
+	pthread_mutex_lock(&_span_lock);
+
+	slot = _span_find_slot();
+	if (slot < 0) {
+		pthread_mutex_unlock(&_span_lock);
+		g_private_set(&_buffer_key, &_no_buffer);
+		return NULL;
+	}
+
+	buffer = calloc(1, sizeof(struct _span_buffer));
+	if (!buffer) {
+		pthread_mutex_unlock(&_span_lock);
+		nugu_error_nomem();
+		g_private_set(&_buffer_key, &_no_buffer);
+		return NULL;
+	}
+
+	buffer->tid = _span_get_tid(_thread_count);
+#ifdef __linux__
+	prctl(PR_GET_NAME, buffer->thread_name, 0, 0, 0);
+#endif
+	if (buffer->thread_name[0] == '\0')
+		snprintf(buffer->thread_name, sizeof(buffer->thread_name),
+			 "thread-%d", _thread_count);
+
+	_thread_count++;
+	_buffers[slot] = buffer;
+
+	pthread_mutex_unlock(&_span_lock);
+
+	g_private_set(&_buffer_key, buffer);
+
+	return buffer;
+}
+
+/* called at the exit of the thread */
+static void _span_release_buffer(gpointer data)
+{
+	struct _span_buffer *buffer = data;
+	int i;
+
+	if (buffer == (struct _span_buffer *)&_no_buffer)
+		return;
+
+	pthread_mutex_lock(&_span_lock);
+
+	if (!_span_buffer_is_empty(buffer)) {
+		/* keep the spans to dump until the slot is needed */
+		buffer->finished = 1;
+		pthread_mutex_unlock(&_span_lock);
+		return;
+	}
+
+	for (i = 0; i < SPAN_MAX_THREADS; i++) {
+		if (_buffers[i] == buffer) {
+			_buffers[i] = NULL;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&_span_lock);
+
+	free(buffer);
+}
+
+static void _span_add(const char *name, char phase)
+{
+	struct _span_buffer *buffer;
+	struct _span_event *event;
+	guint idx;
+
+	if (!nugu_span_is_enabled() || !name)
+		return;
+
+	buffer = _span_get_buffer();
+	if (!buffer)
+		return;
+
+	idx = (guint)buffer->head;
+	event = &buffer->events[idx % SPAN_BUFFER_EVENTS];
+	event->name = name;
+	event->phase = phase;
+	event->timestamp_ns = _span_get_monotonic_ns();
+
+	g_atomic_int_set(&buffer->head, (gint)(idx + 1));
+}
+
+static void _span_write_string(FILE *fp, const char *str)
+{
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			fputc('\\', fp);
+
+		if ((unsigned char)*str < 0x20)
+			fputc(' ', fp);
+		else
+			fputc(*str, fp);
+	}
+}
+
+static int _span_write_buffer(FILE *fp, const struct _span_buffer *buffer,
+			      int pid, gint64 clear_ns, int count)
+{
+	guint head;
+	guint idx;
+	int depth = 0;
+
+	/* NOLINTNEXTLINE(cert-err33-c) */
+	fprintf(fp,
+		"%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"tid\":%ld,\"args\":{\"name\":\"",
+		(count > 0) ? ",\n" : "", pid, buffer->tid);
+	_span_write_string(fp, buffer->thread_name);
+	fputs("\"}}", fp);
+	count++;
+
+	head = (guint)g_atomic_int_get(&buffer->head);
+	idx = (head > SPAN_BUFFER_EVENTS) ? head - SPAN_BUFFER_EVENTS : 0;
+
+	for (; idx != head; idx++) {
+		const struct _span_event *event;
+
+		event = &buffer->events[idx % SPAN_BUFFER_EVENTS];
+		if (event->timestamp_ns < clear_ns || !event->name)
+			continue;
+
+		/* the begin of the span is overwritten or cleared */
+		if (event->phase == 'E' && depth == 0)
+			continue;
+
+		depth += (event->phase == 'B') ? 1 : -1;
+
+		/* NOLINTNEXTLINE(cert-err33-c) */
+		fprintf(fp, ",\n{\"name\":\"");
+		_span_write_string(fp, event->name);
+		/* NOLINTNEXTLINE(cert-err33-c) */
+		fprintf(fp,
+			"\",\"ph\":\"%c\",\"ts\":%" G_GINT64_FORMAT
+			".%03d,\"pid\":%d,\"tid\":%ld}",
+			event->phase, event->timestamp_ns / 1000,
+			(int)(event->timestamp_ns % 1000), pid, buffer->tid);
+		count++;
+	}
+
+	return count;
+}
+
+static int _span_dump(const char *path)
+{
+	FILE *fp;
+	int count = 0;
+	int i;
+
+	fp = fopen(path, "w");
+	if (!fp) {
+		nugu_error("fopen(%s) failed", path);
+		return -1;
+	}
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp);
+
+	/* the buffers of the finished threads are freed under the lock */
+	pthread_mutex_lock(&_span_lock);
+
+	for (i = 0; i < SPAN_MAX_THREADS; i++) {
+		if (_buffers[i])
+			count = _span_write_buffer(fp, _buffers[i],
+						   (int)getpid(),
+						   _span_clear_ns, count);
+	}
+
+	pthread_mutex_unlock(&_span_lock);
+
+	fputs("\n]}\n", fp);
+
+	if (fclose(fp) != 0) {
+		nugu_error("fclose(%s) failed", path);
+		return -1;
+	}
+
+	nugu_dbg("dump %d span events to %s", count, path);
+
+	return count;
+}
+
+#ifdef NUGU_ENV_SPAN_PATH
+static void _span_dump_at_exit(void)
+{
+	const char *path = getenv(NUGU_ENV_SPAN_PATH);
+
+	if (path)
+		_span_dump(path);
+}
+#endif
+
+static void _span_check_env(void)
+{
+#ifdef NUGU_ENV_SPAN_PATH
+	const char *path;
+
+	path = getenv(NUGU_ENV_SPAN_PATH);
+	if (!path || path[0] == '\0')
+		return;
+
+	g_atomic_int_set(&_span_enabled, 1);
+
+	if (atexit(_span_dump_at_exit) != 0)
+		nugu_error("atexit() failed");
+#endif
+}
+
+void nugu_span_enable(void)
+{
+	pthread_mutex_lock(&_span_lock);
+	_span_env_checked = 1;
+	g_atomic_int_set(&_span_enabled, 1);
+	pthread_mutex_unlock(&_span_lock);
+}
+
+void nugu_span_disable(void)
+{
+	pthread_mutex_lock(&_span_lock);
+	_span_env_checked = 1;
+	g_atomic_int_set(&_span_enabled, 0);
+	pthread_mutex_unlock(&_span_lock);
+}
+
+int nugu_span_is_enabled(void)
+{
+	if (!_span_env_checked) {
+		pthread_mutex_lock(&_span_lock);
+		if (!_span_env_checked) {
+			_span_env_checked = 1;
+			_span_check_env();
+		}
+		pthread_mutex_unlock(&_span_lock);
+	}
+
+	return g_atomic_int_get(&_span_enabled);
+}
+
+void nugu_span_begin(const char *name)
+{
+	_span_add(name, 'B');
+}
+
+void nugu_span_end(const char *name)
+{
+	_span_add(name, 'E');
+}
+
+void nugu_span_clear(void)
+{
+	int i;
+
+	pthread_mutex_lock(&_span_lock);
+
+	_span_clear_ns = _span_get_monotonic_ns();
+
+	/* nothing is left to dump in the buffers of the finished threads */
+	for (i = 0; i < SPAN_MAX_THREADS; i++) {
+		if (!_buffers[i] || !_buffers[i]->finished)
+			continue;
+
+		free(_buffers[i]);
+		_buffers[i] = NULL;
+	}
+
+	pthread_mutex_unlock(&_span_lock);
+}
+
+int nugu_span_dump(const char *path)
+{
+	g_return_val_if_fail(path != NULL, -1);
+
+	return _span_dump(path);
+}
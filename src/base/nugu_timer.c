@@ -20,7 +20,9 @@
 #include <glib.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_timer.h"
+#include "base/nugu_watchdog.h"
 
 struct _nugu_timer {
 	GSource *source;
@@ -33,9 +35,13 @@ struct _nugu_timer {
 static gboolean _nugu_timer_callback(gpointer userdata)
 {
 	NuguTimer *timer = (NuguTimer *)userdata;
+	int64_t begin = nugu_watchdog_begin();
 
 	timer->cb(timer->userdata);
 
+	nugu_watchdog_end("timer", begin, (const void *)timer->cb,
+			  timer->userdata);
+
 	return !timer->singleshot;
 }
 
@@ -112,7 +118,7 @@ void nugu_timer_start(NuguTimer *timer)
 	timer->source = g_timeout_source_new(timer->interval);
 	g_source_set_callback(timer->source, _nugu_timer_callback,
 			      (gpointer)timer, NULL);
-	g_source_attach(timer->source, g_main_context_default());
+	g_source_attach(timer->source, nugu_mainloop_get_context());
 }
 
 void nugu_timer_stop(NuguTimer *timer)
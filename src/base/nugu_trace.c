@@ -0,0 +1,777 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_trace.h"
+
+#define TRACE_MAGIC "NUGUTRC"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 64
+#define TRACE_BLOCK_SIZE (16 * 1024)
+#define TRACE_DEFAULT_SIZE_KB 1024
+#define TRACE_ALIGN(x) (((x) + 7) & ~((size_t)7))
+
+#define TRACE_FLAG_TRUNCATED 0x0001
+
+struct _trace_file_header {
+	char magic[8];
+	guint32 version;
+	guint32 block_size;
+	guint32 block_count;
+	guint32 reserved;
+	gint64 created;
+};
+
+struct _trace_block_header {
+	guint64 seq; /* 0: unused block */
+	guint32 used; /* size of the header and the records */
+	guint32 reserved;
+};
+
+struct _trace_record {
+	guint32 size;
+	guint16 id;
+	guint16 flags;
+	gint64 timestamp;
+};
+
+enum _trace_arg {
+	TRACE_ARG_NONE,
+	TRACE_ARG_INT,
+	TRACE_ARG_UINT,
+	TRACE_ARG_LONG,
+	TRACE_ARG_ULONG,
+	TRACE_ARG_SIZE,
+	TRACE_ARG_PTR,
+	TRACE_ARG_STR,
+	TRACE_ARG_SLICE /* "%.*s" */
+};
+
+struct _nugu_trace {
+	char *map;
+	size_t map_size;
+	guint32 block_size;
+	guint32 block_count;
+	guint32 current;
+	guint64 seq;
+};
+
+static const char *_formats[NUGU_TRACE_ID_MAX] = {
+	[NUGU_TRACE_ID_EVENT] = "--> Event %s(%p)\n%.*s",
+	[NUGU_TRACE_ID_EVENT_ATTACHMENT] = "--> EventAttachment\n%s",
+	[NUGU_TRACE_ID_DIRECTIVES] = "<-- Directives%s\n%.*s",
+	[NUGU_TRACE_ID_POLICY] = "<-- Policy\n%.*s"
+};
+
+static pthread_mutex_t _trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct _nugu_trace *_trace;
+static gint _trace_enabled; /* atomic */
+static gint _trace_env_checked; /* atomic */
+
+/* find the next conversion of the format and return the end of it */
+static const char *_next_conversion(const char *fmt, const char **begin,
+				    enum _trace_arg *type)
+{
+	int is_slice = 0;
+	int longs = 0;
+	int is_size = 0;
+
+	*type = TRACE_ARG_NONE;
+
+	while (*fmt) {
+		if (*fmt != '%') {
+			fmt++;
+			continue;
+		}
+
+		if (*(fmt + 1) == '%') {
+			fmt += 2;
+			continue;
+		}
+
+		break;
+	}
+
+	if (*fmt == '\0')
+		return fmt;
+
+	*begin = fmt++;
+
+	while (*fmt && strchr("-+ #0", *fmt))
+		fmt++;
+	while (*fmt >= '0' && *fmt <= '9')
+		fmt++;
+
+	if (*fmt == '.') {
+		fmt++;
+		if (*fmt == '*') {
+			is_slice = 1;
+			fmt++;
+		}
+		while (*fmt >= '0' && *fmt <= '9')
+			fmt++;
+	}
+
+	while (*fmt == 'l' || *fmt == 'z' || *fmt == 'h') {
+		if (*fmt == 'l')
+			longs++;
+		else if (*fmt == 'z')
+			is_size = 1;
+		fmt++;
+	}
+
+	switch (*fmt) {
+	case 'd':
+	case 'i':
+		if (is_size)
+			*type = TRACE_ARG_SIZE;
+		else
+			*type = longs ? TRACE_ARG_LONG : TRACE_ARG_INT;
+		break;
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'c':
+		if (is_size)
+			*type = TRACE_ARG_SIZE;
+		else
+			*type = longs ? TRACE_ARG_ULONG : TRACE_ARG_UINT;
+		break;
+	case 'p':
+		*type = TRACE_ARG_PTR;
+		break;
+	case 's':
+		*type = is_slice ? TRACE_ARG_SLICE : TRACE_ARG_STR;
+		break;
+	default:
+		/* not supported conversion */
+		return fmt + strlen(fmt);
+	}
+
+	/* "ll" is not supported */
+	if (longs > 1) {
+		*type = TRACE_ARG_NONE;
+		return fmt + strlen(fmt);
+	}
+
+	return fmt + 1;
+}
+
+/* size of the encoded arguments without the truncation */
+static size_t _measure(const char *fmt, va_list arg)
+{
+	const char *begin = NULL;
+	enum _trace_arg type;
+	size_t size = 0;
+
+	while (1) {
+		const char *str;
+		int len;
+
+		fmt = _next_conversion(fmt, &begin, &type);
+		if (type == TRACE_ARG_NONE)
+			break;
+
+		switch (type) {
+		case TRACE_ARG_INT:
+			(void)va_arg(arg, int);
+			break;
+		case TRACE_ARG_UINT:
+			(void)va_arg(arg, unsigned int);
+			break;
+		case TRACE_ARG_LONG:
+			(void)va_arg(arg, long);
+			break;
+		case TRACE_ARG_ULONG:
+			(void)va_arg(arg, unsigned long);
+			break;
+		case TRACE_ARG_SIZE:
+			(void)va_arg(arg, size_t);
+			break;
+		case TRACE_ARG_PTR:
+			(void)va_arg(arg, void *);
+			break;
+		case TRACE_ARG_STR:
+			str = va_arg(arg, const char *);
+			size += str ? strlen(str) : 0;
+			break;
+		case TRACE_ARG_SLICE:
+			len = va_arg(arg, int);
+			str = va_arg(arg, const char *);
+			size += (str && len > 0) ? (size_t)len : 0;
+			break;
+		default:
+			break;
+		}
+
+		if (type == TRACE_ARG_STR || type == TRACE_ARG_SLICE)
+			size += sizeof(guint32);
+		else
+			size += sizeof(guint64);
+	}
+
+	return size;
+}
+
+static void _put_value(char **dest, guint64 value)
+{
+	memcpy(*dest, &value, sizeof(value));
+	*dest += sizeof(value);
+}
+
+static void _put_string(char **dest, const char *str, guint32 len)
+{
+	memcpy(*dest, &len, sizeof(len));
+	*dest += sizeof(len);
+
+	if (len > 0) {
+		memcpy(*dest, str, len);
+		*dest += len;
+	}
+}
+
+/*
+ * Encode the arguments into dest. The strings are truncated when the
+ * arguments don't fit in the size.
+ */
+static size_t _encode(const char *fmt, va_list arg, char *dest, size_t size,
+		      int *truncated)
+{
+	const char *begin = NULL;
+	enum _trace_arg type;
+	char *pos = dest;
+	size_t fixed = 0;
+	const char *walk;
+
+	/* space of the values and the string lengths */
+	walk = fmt;
+	while (1) {
+		walk = _next_conversion(walk, &begin, &type);
+		if (type == TRACE_ARG_NONE)
+			break;
+
+		if (type == TRACE_ARG_STR || type == TRACE_ARG_SLICE)
+			fixed += sizeof(guint32);
+		else
+			fixed += sizeof(guint64);
+	}
+
+	if (fixed > size)
+		return 0;
+
+	while (1) {
+		const char *str;
+		size_t len;
+		size_t avail;
+
+		fmt = _next_conversion(fmt, &begin, &type);
+		if (type == TRACE_ARG_NONE)
+			break;
+
+		switch (type) {
+		case TRACE_ARG_INT:
+			_put_value(&pos, (guint64)(gint64)va_arg(arg, int));
+			break;
+		case TRACE_ARG_UINT:
+			_put_value(&pos, (guint64)va_arg(arg, unsigned int));
+			break;
+		case TRACE_ARG_LONG:
+			_put_value(&pos, (guint64)(gint64)va_arg(arg, long));
+			break;
+		case TRACE_ARG_ULONG:
+			_put_value(&pos, (guint64)va_arg(arg, unsigned long));
+			break;
+		case TRACE_ARG_SIZE:
+			_put_value(&pos, (guint64)va_arg(arg, size_t));
+			break;
+		case TRACE_ARG_PTR:
+			_put_value(&pos,
+				   (guint64)(uintptr_t)va_arg(arg, void *));
+			break;
+		case TRACE_ARG_STR:
+		case TRACE_ARG_SLICE:
+			if (type == TRACE_ARG_SLICE) {
+				int tmp = va_arg(arg, int);
+
+				str = va_arg(arg, const char *);
+				len = (str && tmp > 0) ? (size_t)tmp : 0;
+			} else {
+				str = va_arg(arg, const char *);
+				len = str ? strlen(str) : 0;
+			}
+
+			fixed -= sizeof(guint32);
+			avail = size - (size_t)(pos - dest) - sizeof(guint32) -
+				fixed;
+			if (len > avail) {
+				len = avail;
+				*truncated = 1;
+			}
+
+			_put_string(&pos, str, (guint32)len);
+			break;
+		default:
+			break;
+		}
+
+		if (type != TRACE_ARG_STR && type != TRACE_ARG_SLICE)
+			fixed -= sizeof(guint64);
+	}
+
+	return (size_t)(pos - dest);
+}
+
+static struct _trace_block_header *_get_block(struct _nugu_trace *trace,
+					      guint32 index)
+{
+	return (struct _trace_block_header *)(trace->map + TRACE_HEADER_SIZE +
+					      (size_t)index *
+						      trace->block_size);
+}
+
+static void _next_block(struct _nugu_trace *trace)
+{
+	struct _trace_block_header *block;
+
+	trace->current = (trace->current + 1) % trace->block_count;
+
+	/* the records of the previous lap are invalidated first */
+	block = _get_block(trace, trace->current);
+	block->used = sizeof(struct _trace_block_header);
+	block->seq = ++trace->seq;
+}
+
+#ifndef _WIN32
+static int _trace_open(const char *path, size_t size)
+{
+	struct _trace_file_header *header;
+	struct _nugu_trace *trace;
+	guint32 count;
+	int fd;
+
+	count = (guint32)((size - TRACE_HEADER_SIZE) / TRACE_BLOCK_SIZE);
+	if (size < TRACE_HEADER_SIZE || count < 2) {
+		nugu_error("too small trace size: %zd", size);
+		return -1;
+	}
+
+	trace = g_malloc0(sizeof(struct _nugu_trace));
+	if (!trace) {
+		nugu_error_nomem();
+		return -1;
+	}
+
+	trace->block_size = TRACE_BLOCK_SIZE;
+	trace->block_count = count;
+	trace->map_size = TRACE_HEADER_SIZE + (size_t)count * TRACE_BLOCK_SIZE;
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		nugu_error("open(%s) failed", path);
+		g_free(trace);
+		return -1;
+	}
+
+	if (ftruncate(fd, (off_t)trace->map_size) < 0) {
+		nugu_error("ftruncate(%s) failed", path);
+		close(fd);
+		g_free(trace);
+		return -1;
+	}
+
+	trace->map = mmap(NULL, trace->map_size, PROT_READ | PROT_WRITE,
+			  MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (trace->map == MAP_FAILED) {
+		nugu_error("mmap(%s) failed", path);
+		g_free(trace);
+		return -1;
+	}
+
+	header = (struct _trace_file_header *)trace->map;
+	memcpy(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	header->version = TRACE_VERSION;
+	header->block_size = trace->block_size;
+	header->block_count = trace->block_count;
+	header->created = g_get_real_time();
+
+	/* start from the first block */
+	trace->current = trace->block_count - 1;
+	_next_block(trace);
+
+	_trace = trace;
+	g_atomic_int_set(&_trace_enabled, 1);
+
+	nugu_info("trace opened: %s (%d blocks)", path, count);
+
+	return 0;
+}
+
+static void _trace_close(void)
+{
+	g_atomic_int_set(&_trace_enabled, 0);
+
+	if (!_trace)
+		return;
+
+	munmap(_trace->map, _trace->map_size);
+	g_free(_trace);
+	_trace = NULL;
+}
+#else
+static int _trace_open(const char *path, size_t size)
+{
+	nugu_error("trace is not supported");
+	return -1;
+}
+
+static void _trace_close(void)
+{
+}
+#endif
+
+static void _trace_check_env(void)
+{
+#ifdef NUGU_ENV_TRACE_PATH
+	const char *path;
+	size_t size = TRACE_DEFAULT_SIZE_KB;
+
+	path = getenv(NUGU_ENV_TRACE_PATH);
+	if (!path)
+		return;
+
+#ifdef NUGU_ENV_TRACE_SIZE
+	{
+		const char *tmp = getenv(NUGU_ENV_TRACE_SIZE);
+
+		if (tmp && strtol(tmp, NULL, 10) > 0)
+			size = (size_t)strtol(tmp, NULL, 10);
+	}
+#endif
+
+	_trace_open(path, size * 1024);
+#endif
+}
+
+int nugu_trace_open(const char *path, size_t size)
+{
+	int ret;
+
+	g_return_val_if_fail(path != NULL, -1);
+
+	pthread_mutex_lock(&_trace_lock);
+
+	g_atomic_int_set(&_trace_env_checked, 1);
+	_trace_close();
+	ret = _trace_open(path, size);
+
+	pthread_mutex_unlock(&_trace_lock);
+
+	return ret;
+}
+
+void nugu_trace_close(void)
+{
+	pthread_mutex_lock(&_trace_lock);
+	_trace_close();
+	pthread_mutex_unlock(&_trace_lock);
+}
+
+int nugu_trace_is_enabled(void)
+{
+	if (!g_atomic_int_get(&_trace_env_checked)) {
+		pthread_mutex_lock(&_trace_lock);
+		if (!_trace_env_checked) {
+			_trace_check_env();
+			g_atomic_int_set(&_trace_env_checked, 1);
+		}
+		pthread_mutex_unlock(&_trace_lock);
+	}
+
+	return g_atomic_int_get(&_trace_enabled);
+}
+
+const char *nugu_trace_get_format(enum nugu_trace_id id)
+{
+	if (id <= 0 || id >= NUGU_TRACE_ID_MAX)
+		return NULL;
+
+	return _formats[id];
+}
+
+int nugu_trace_write(enum nugu_trace_id id, ...)
+{
+	struct _trace_block_header *block;
+	struct _trace_record *record;
+	const char *fmt;
+	size_t capacity;
+	size_t need;
+	size_t len;
+	int truncated = 0;
+	va_list arg;
+
+	if (!nugu_trace_is_enabled())
+		return -1;
+
+	fmt = nugu_trace_get_format(id);
+	if (!fmt)
+		return -1;
+
+	pthread_mutex_lock(&_trace_lock);
+
+	if (!_trace) {
+		pthread_mutex_unlock(&_trace_lock);
+		return -1;
+	}
+
+	va_start(arg, id);
+	need = TRACE_ALIGN(sizeof(struct _trace_record) + _measure(fmt, arg));
+	va_end(arg);
+
+	/*
+	 * A message never crosses the block, so move to the next block when
+	 * the message doesn't fit. The message larger than the block is
+	 * truncated.
+	 */
+	block = _get_block(_trace, _trace->current);
+	if (block->used + need > _trace->block_size &&
+	    block->used > sizeof(struct _trace_block_header)) {
+		_next_block(_trace);
+		block = _get_block(_trace, _trace->current);
+	}
+
+	record = (struct _trace_record *)((char *)block + block->used);
+	capacity = (_trace->block_size - block->used -
+		    sizeof(struct _trace_record)) &
+		   ~((size_t)7);
+
+	va_start(arg, id);
+	len = _encode(fmt, arg, (char *)record + sizeof(struct _trace_record),
+		      capacity, &truncated);
+	va_end(arg);
+
+	record->size = (guint32)TRACE_ALIGN(sizeof(struct _trace_record) + len);
+	record->id = (guint16)id;
+	record->flags = truncated ? TRACE_FLAG_TRUNCATED : 0;
+	record->timestamp = g_get_real_time();
+
+	block->used += record->size;
+
+	pthread_mutex_unlock(&_trace_lock);
+
+	return 0;
+}
+
+static int _decode_record(const struct _trace_record *record, FILE *out)
+{
+	const char *data = (const char *)record + sizeof(struct _trace_record);
+	const char *end = (const char *)record + record->size;
+	const char *fmt;
+	const char *begin = NULL;
+	const char *next;
+	enum _trace_arg type;
+	char timestr[32];
+	struct tm ti;
+	time_t now;
+
+	fmt = nugu_trace_get_format((enum nugu_trace_id)record->id);
+	if (!fmt)
+		return -1;
+
+	now = (time_t)(record->timestamp / 1000000);
+#ifdef _WIN32
+	localtime_s(&ti, &now);
+#else
+	localtime_r(&now, &ti);
+#endif
+	strftime(timestr, sizeof(timestr), "%m-%d %H:%M:%S", &ti);
+	fprintf(out, "%s.%03d ", timestr,
+		(int)((record->timestamp % 1000000) / 1000));
+
+	while (1) {
+		char spec[32];
+		guint64 value = 0;
+		guint32 len = 0;
+
+		next = _next_conversion(fmt, &begin, &type);
+		if (type == TRACE_ARG_NONE) {
+			fputs(fmt, out);
+			break;
+		}
+
+		/* literal text before the conversion */
+		fwrite(fmt, 1, begin - fmt, out);
+
+		if (type == TRACE_ARG_STR || type == TRACE_ARG_SLICE) {
+			if (data + sizeof(len) > end)
+				return -1;
+
+			memcpy(&len, data, sizeof(len));
+			data += sizeof(len);
+
+			if (data + len > end)
+				return -1;
+
+			fwrite(data, 1, len, out);
+			data += len;
+		} else {
+			if (data + sizeof(value) > end)
+				return -1;
+
+			memcpy(&value, data, sizeof(value));
+			data += sizeof(value);
+
+			if ((size_t)(next - begin) >= sizeof(spec))
+				return -1;
+
+			memcpy(spec, begin, next - begin);
+			spec[next - begin] = '\0';
+
+			switch (type) {
+			case TRACE_ARG_INT:
+				fprintf(out, spec, (int)(gint64)value);
+				break;
+			case TRACE_ARG_UINT:
+				fprintf(out, spec, (unsigned int)value);
+				break;
+			case TRACE_ARG_LONG:
+				fprintf(out, spec, (long)(gint64)value);
+				break;
+			case TRACE_ARG_ULONG:
+				fprintf(out, spec, (unsigned long)value);
+				break;
+			case TRACE_ARG_SIZE:
+				fprintf(out, spec, (size_t)value);
+				break;
+			case TRACE_ARG_PTR:
+				fprintf(out, spec, (void *)(uintptr_t)value);
+				break;
+			default:
+				break;
+			}
+		}
+
+		fmt = next;
+	}
+
+	if (record->flags & TRACE_FLAG_TRUNCATED)
+		fputs("<...too long...>", out);
+
+	fputc('\n', out);
+
+	return 0;
+}
+
+static gint _compare_seq(gconstpointer a, gconstpointer b)
+{
+	const struct _trace_block_header *block_a = a;
+	const struct _trace_block_header *block_b = b;
+
+	if (block_a->seq < block_b->seq)
+		return -1;
+
+	return (block_a->seq > block_b->seq) ? 1 : 0;
+}
+
+int nugu_trace_decode(const char *path, FILE *out)
+{
+	struct _trace_file_header *header;
+	gchar *contents = NULL;
+	gsize length = 0;
+	GList *blocks = NULL;
+	GList *l;
+	guint32 i;
+	int count = 0;
+
+	g_return_val_if_fail(path != NULL, -1);
+	g_return_val_if_fail(out != NULL, -1);
+
+	if (!g_file_get_contents(path, &contents, &length, NULL)) {
+		nugu_error("can't read %s", path);
+		return -1;
+	}
+
+	header = (struct _trace_file_header *)contents;
+	if (length < TRACE_HEADER_SIZE ||
+	    memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+	    header->version != TRACE_VERSION ||
+	    header->block_size < sizeof(struct _trace_block_header) ||
+	    TRACE_HEADER_SIZE +
+			    (gsize)header->block_size * header->block_count >
+		    length) {
+		nugu_error("invalid trace file: %s", path);
+		g_free(contents);
+		return -1;
+	}
+
+	for (i = 0; i < header->block_count; i++) {
+		struct _trace_block_header *block;
+
+		block = (struct _trace_block_header
+				 *)(contents + TRACE_HEADER_SIZE +
+				    (gsize)i * header->block_size);
+		if (block->seq == 0)
+			continue;
+
+		blocks = g_list_insert_sorted(blocks, block, _compare_seq);
+	}
+
+	/* from the oldest block */
+	for (l = blocks; l; l = l->next) {
+		struct _trace_block_header *block = l->data;
+		guint32 pos = sizeof(struct _trace_block_header);
+		guint32 used = block->used;
+
+		if (used > header->block_size)
+			used = header->block_size;
+
+		while (pos + sizeof(struct _trace_record) <= used) {
+			struct _trace_record *record;
+
+			record = (struct _trace_record *)((char *)block + pos);
+			if (record->size < sizeof(struct _trace_record) ||
+			    pos + record->size > header->block_size)
+				break;
+
+			if (_decode_record(record, out) == 0)
+				count++;
+
+			pos += record->size;
+		}
+	}
+
+	g_list_free(blocks);
+	g_free(contents);
+
+	return count;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_watchdog.h"
+
+#define MAX_STATS 64
+#define LAG_CHECK_INTERVAL_MSEC 100
+
+static struct nugu_watchdog_stat _stats[MAX_STATS];
+static int _stats_count;
+static unsigned int _stats_dropped;
+static unsigned int _lag_buckets[NUGU_WATCHDOG_LAG_BUCKETS];
+static gint64 _lag_expected;
+static guint _lag_source;
+static int _enabled;
+static gint64 _threshold_usec = NUGU_WATCHDOG_DEFAULT_THRESHOLD * 1000;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int _get_lag_bucket(gint64 lag_usec)
+{
+	gint64 msec = lag_usec / 1000;
+	int i;
+
+	for (i = 0; i < NUGU_WATCHDOG_LAG_BUCKETS - 1; i++) {
+		if (msec < (1 << i))
+			return i;
+	}
+
+	return NUGU_WATCHDOG_LAG_BUCKETS - 1;
+}
+
+/**
+ * The timeout source is dispatched 'interval' after the previous dispatch,
+ * so the delay from the expected time is the lag of the main loop.
+ */
+static gboolean _on_lag_check(gpointer userdata)
+{
+	gint64 now = g_get_monotonic_time();
+	gint64 lag = now - _lag_expected;
+
+	if (lag < 0)
+		lag = 0;
+
+	pthread_mutex_lock(&_lock);
+	_lag_buckets[_get_lag_bucket(lag)]++;
+	pthread_mutex_unlock(&_lock);
+
+	_lag_expected = now + LAG_CHECK_INTERVAL_MSEC * 1000;
+
+	return TRUE;
+}
+
+static struct nugu_watchdog_stat *_find_stat(const char *tag)
+{
+	struct nugu_watchdog_stat *stat;
+	int i;
+
+	for (i = 0; i < _stats_count; i++) {
+		if (strncmp(_stats[i].tag, tag, NUGU_WATCHDOG_MAX_TAG_LEN) == 0)
+			return &_stats[i];
+	}
+
+	if (_stats_count >= MAX_STATS) {
+		_stats_dropped++;
+		return NULL;
+	}
+
+	stat = &_stats[_stats_count++];
+	g_strlcpy(stat->tag, tag, sizeof(stat->tag));
+
+	return stat;
+}
+
+static int _compare_stat(const void *a, const void *b)
+{
+	const struct nugu_watchdog_stat *stat_a = a;
+	const struct nugu_watchdog_stat *stat_b = b;
+
+	if (stat_a->max == stat_b->max)
+		return 0;
+
+	return (stat_a->max < stat_b->max) ? 1 : -1;
+}
+
+void nugu_watchdog_enable(int threshold_msec)
+{
+	g_return_if_fail(threshold_msec > 0);
+
+	pthread_mutex_lock(&_lock);
+
+	_threshold_usec = (gint64)threshold_msec * 1000;
+	_enabled = 1;
+
+	if (_lag_source == 0) {
+		_lag_expected = g_get_monotonic_time() +
+				LAG_CHECK_INTERVAL_MSEC * 1000;
+		_lag_source = nugu_mainloop_timeout_add(
+			LAG_CHECK_INTERVAL_MSEC, _on_lag_check, NULL);
+	}
+
+	pthread_mutex_unlock(&_lock);
+
+	nugu_info("watchdog enabled (threshold: %d msec)", threshold_msec);
+}
+
+void nugu_watchdog_disable(void)
+{
+	pthread_mutex_lock(&_lock);
+
+	_enabled = 0;
+
+	if (_lag_source > 0) {
+		nugu_mainloop_source_remove(_lag_source);
+		_lag_source = 0;
+	}
+
+	pthread_mutex_unlock(&_lock);
+
+	nugu_info("watchdog disabled");
+}
+
+int nugu_watchdog_is_enabled(void)
+{
+	return _enabled;
+}
+
+void nugu_watchdog_check_env(void)
+{
+#ifdef NUGU_ENV_WATCHDOG
+	const char *env;
+	int threshold;
+
+	env = getenv(NUGU_ENV_WATCHDOG);
+	if (!env)
+		return;
+
+	threshold = (int)strtol(env, NULL, 10);
+	if (threshold <= 0)
+		threshold = NUGU_WATCHDOG_DEFAULT_THRESHOLD;
+
+	nugu_watchdog_enable(threshold);
+#endif
+}
+
+int64_t nugu_watchdog_begin(void)
+{
+	if (!_enabled)
+		return 0;
+
+	return g_get_monotonic_time();
+}
+
+void nugu_watchdog_end(const char *tag, int64_t begin, const void *func,
+		       const void *userdata)
+{
+	struct nugu_watchdog_stat *stat;
+	gint64 elapsed;
+	int is_stall;
+
+	if (begin == 0 || !_enabled || tag == NULL)
+		return;
+
+	elapsed = g_get_monotonic_time() - begin;
+	is_stall = (elapsed >= _threshold_usec);
+
+	pthread_mutex_lock(&_lock);
+
+	stat = _find_stat(tag);
+	if (stat) {
+		stat->count++;
+		stat->total += elapsed;
+		if (elapsed > stat->max)
+			stat->max = elapsed;
+		if (is_stall)
+			stat->stalls++;
+	}
+
+	pthread_mutex_unlock(&_lock);
+
+	if (is_stall)
+		nugu_warn("[watchdog] '%s' <func %p, userdata %p> blocked the "
+			  "main loop %d.%03d msec",
+			  tag, func, userdata, (int)(elapsed / 1000),
+			  (int)(elapsed % 1000));
+}
+
+int nugu_watchdog_get_stats(struct nugu_watchdog_stat *stats, int max_count)
+{
+	struct nugu_watchdog_stat snapshot[MAX_STATS];
+	int count;
+
+	g_return_val_if_fail(stats != NULL, -1);
+	g_return_val_if_fail(max_count > 0, -1);
+
+	/* sort the copy, the _stats is updated by the dispatch */
+	pthread_mutex_lock(&_lock);
+	count = _stats_count;
+	memcpy(snapshot, _stats, sizeof(struct nugu_watchdog_stat) * count);
+	pthread_mutex_unlock(&_lock);
+
+	qsort(snapshot, count, sizeof(struct nugu_watchdog_stat),
+	      _compare_stat);
+
+	if (count > max_count)
+		count = max_count;
+
+	memcpy(stats, snapshot, sizeof(struct nugu_watchdog_stat) * count);
+
+	return count;
+}
+
+void nugu_watchdog_get_lag_histogram(unsigned int *buckets)
+{
+	g_return_if_fail(buckets != NULL);
+
+	pthread_mutex_lock(&_lock);
+	memcpy(buckets, _lag_buckets, sizeof(_lag_buckets));
+	pthread_mutex_unlock(&_lock);
+}
+
+void nugu_watchdog_reset(void)
+{
+	pthread_mutex_lock(&_lock);
+
+	memset(_stats, 0, sizeof(_stats));
+	memset(_lag_buckets, 0, sizeof(_lag_buckets));
+	_stats_count = 0;
+	_stats_dropped = 0;
+
+	pthread_mutex_unlock(&_lock);
+}
+
+void nugu_watchdog_dump(int max_count)
+{
+	struct nugu_watchdog_stat stats[MAX_STATS];
+	unsigned int buckets[NUGU_WATCHDOG_LAG_BUCKETS];
+	int count;
+	int i;
+
+	if ((nugu_log_get_modules() & NUGU_LOG_MODULE_PROFILING) == 0)
+		return;
+
+	if (max_count <= 0 || max_count > MAX_STATS)
+		max_count = MAX_STATS;
+
+	count = nugu_watchdog_get_stats(stats, max_count);
+	nugu_watchdog_get_lag_histogram(buckets);
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "Watchdog: slowest callbacks (dropped tags: %u)",
+		       _stats_dropped);
+
+	/**
+	 * output format:
+	 *  tag: count stalls avg max
+	 */
+	for (i = 0; i < count; i++)
+		nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO,
+			       NULL, NULL, -1,
+			       "%40s: count=%u stalls=%u avg=%d usec max=%d usec",
+			       stats[i].tag, stats[i].count, stats[i].stalls,
+			       (int)(stats[i].total / stats[i].count),
+			       (int)stats[i].max);
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "Watchdog: loop lag histogram");
+
+	for (i = 0; i < NUGU_WATCHDOG_LAG_BUCKETS; i++) {
+		if (i == NUGU_WATCHDOG_LAG_BUCKETS - 1)
+			nugu_log_print(NUGU_LOG_MODULE_PROFILING,
+				       NUGU_LOG_LEVEL_INFO, NULL, NULL, -1,
+				       "  >= %4d msec: %u", 1 << (i - 1),
+				       buckets[i]);
+		else
+			nugu_log_print(NUGU_LOG_MODULE_PROFILING,
+				       NUGU_LOG_LEVEL_INFO, NULL, NULL, -1,
+				       "  <  %4d msec: %u", 1 << i, buckets[i]);
+	}
+
+	nugu_log_print(NUGU_LOG_MODULE_PROFILING, NUGU_LOG_LEVEL_INFO, NULL,
+		       NULL, -1, "--------------------------");
+}
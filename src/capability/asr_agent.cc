@@ -65,6 +65,9 @@ ASRAgent::ASRAgent()
     , epd_attribute({})
     , default_epd_attribute({})
 {
+    addDirectiveHandler("ExpectSpeech", [&](const char* message) { handleExpectSpeech(); });
+    addDirectiveHandler("NotifyResult", [&](const char* message) { parsingNotifyResult(message); });
+    addDirectiveHandler("CancelRecognize", [&](const char* message) { parsingCancelRecognize(message); });
 }
 
 void ASRAgent::setAttribute(ASRAttribute&& attribute)
@@ -241,18 +244,6 @@ void ASRAgent::preprocessDirective(NuguDirective* ndir)
         parsingExpectSpeech(std::string(nugu_directive_peek_dialog_id(ndir)), message);
 }
 
-void ASRAgent::parsingDirective(const char* dname, const char* message)
-{
-    if (!strcmp(dname, "ExpectSpeech"))
-        handleExpectSpeech();
-    else if (!strcmp(dname, "NotifyResult"))
-        parsingNotifyResult(message);
-    else if (!strcmp(dname, "CancelRecognize"))
-        parsingCancelRecognize(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-}
-
 void ASRAgent::cancelDirective(NuguDirective* ndir)
 {
     resetExpectSpeechState();
@@ -539,7 +530,8 @@ void ASRAgent::parsingNotifyResult(const char* message)
         return;
     }
 
-    nugu_prof_mark(NUGU_PROF_TYPE_ASR_RESULT);
+    nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RESULT,
+        getRecognizeDialogId().c_str(), nullptr, nullptr);
 
     clearResponseTimeout();
 
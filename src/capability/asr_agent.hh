@@ -51,7 +51,6 @@ public:
     void finishRecognition() override;
 
     void preprocessDirective(NuguDirective* ndir) override;
-    void parsingDirective(const char* dname, const char* message) override;
     void cancelDirective(NuguDirective* ndir) override;
     void updateInfoForContext(NJson::Value& ctx) override;
 
@@ -51,6 +51,17 @@ AudioPlayerAgent::AudioPlayerAgent()
     , render_helper(std::unique_ptr<DisplayRenderHelper>(new DisplayRenderHelper()))
     , display_listener(nullptr)
 {
+    addDirectiveHandler("Play", [&](const char* message) { parsingPlay(message); });
+    addDirectiveHandler("Pause", [&](const char* message) { parsingPause(message); });
+    addDirectiveHandler("Stop", [&](const char* message) { parsingStop(message); });
+    addDirectiveHandler("UpdateMetadata", [&](const char* message) { parsingUpdateMetadata(message); });
+    addDirectiveHandler("ShowLyrics", [&](const char* message) { parsingShowLyrics(message); });
+    addDirectiveHandler("HideLyrics", [&](const char* message) { parsingHideLyrics(message); });
+    addDirectiveHandler("ControlLyricsPage", [&](const char* message) { parsingControlLyricsPage(message); });
+    addDirectiveHandler("RequestPlayCommand", [&](const char* message) { parsingRequestPlayCommand("RequestPlayCommand", message); });
+
+    for (const auto& dname : { "RequestResumeCommand", "RequestNextCommand", "RequestPreviousCommand", "RequestPauseCommand", "RequestStopCommand" })
+        addDirectiveHandler(dname, [this, dname](const char* message) { parsingRequestOthersCommand(dname, message); });
 }
 
 void AudioPlayerAgent::initialize()
@@ -259,31 +270,7 @@ void AudioPlayerAgent::parsingDirective(const char* dname, const char* message)
     if (hasToSetPauseState(dname))
         is_paused = strcmp(dname, "Pause") == 0;
 
-    // directive name check
-    if (!strcmp(dname, "Play"))
-        parsingPlay(message);
-    else if (!strcmp(dname, "Pause"))
-        parsingPause(message);
-    else if (!strcmp(dname, "Stop"))
-        parsingStop(message);
-    else if (!strcmp(dname, "UpdateMetadata"))
-        parsingUpdateMetadata(message);
-    else if (!strcmp(dname, "ShowLyrics"))
-        parsingShowLyrics(message);
-    else if (!strcmp(dname, "HideLyrics"))
-        parsingHideLyrics(message);
-    else if (!strcmp(dname, "ControlLyricsPage"))
-        parsingControlLyricsPage(message);
-    else if (!strcmp(dname, "RequestPlayCommand"))
-        parsingRequestPlayCommand(dname, message);
-    else if (!strcmp(dname, "RequestResumeCommand")
-        || !strcmp(dname, "RequestNextCommand")
-        || !strcmp(dname, "RequestPreviousCommand")
-        || !strcmp(dname, "RequestPauseCommand")
-        || !strcmp(dname, "RequestStopCommand"))
-        parsingRequestOthersCommand(dname, message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void AudioPlayerAgent::updateInfoForContext(NJson::Value& ctx)
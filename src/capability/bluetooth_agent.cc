@@ -28,6 +28,13 @@ static const char* DEFAULT_PLAY_SERVICE_ID = "nugu.builtin.bluetooth";
 BluetoothAgent::BluetoothAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("StartDiscoverableMode", [&](const char* message) { parsingStartDiscoverableMode(message); });
+    addDirectiveHandler("FinishDiscoverableMode", [&](const char* message) { parsingFinishDiscoverableMode(message); });
+    addDirectiveHandler("Play", [&](const char* message) { parsingPlay(message); });
+    addDirectiveHandler("Stop", [&](const char* message) { parsingStop(message); });
+    addDirectiveHandler("Pause", [&](const char* message) { parsingPause(message); });
+    addDirectiveHandler("Next", [&](const char* message) { parsingNext(message); });
+    addDirectiveHandler("Previous", [&](const char* message) { parsingPrevious(message); });
 }
 
 void BluetoothAgent::initialize()
@@ -72,22 +79,7 @@ void BluetoothAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "StartDiscoverableMode"))
-        parsingStartDiscoverableMode(message);
-    else if (!strcmp(dname, "FinishDiscoverableMode"))
-        parsingFinishDiscoverableMode(message);
-    else if (!strcmp(dname, "Play"))
-        parsingPlay(message);
-    else if (!strcmp(dname, "Stop"))
-        parsingStop(message);
-    else if (!strcmp(dname, "Pause"))
-        parsingPause(message);
-    else if (!strcmp(dname, "Next"))
-        parsingNext(message);
-    else if (!strcmp(dname, "Previous"))
-        parsingPrevious(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void BluetoothAgent::updateInfoForContext(NJson::Value& ctx)
@@ -27,6 +27,7 @@ static const char* CAPABILITY_VERSION = "1.2";
 ChipsAgent::ChipsAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Render", [&](const char* message) { parsingRender(message); });
 }
 
 void ChipsAgent::initialize()
@@ -75,10 +76,7 @@ void ChipsAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Render"))
-        parsingRender(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void ChipsAgent::parsingRender(const char* message)
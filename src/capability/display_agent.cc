@@ -35,6 +35,10 @@ DisplayAgent::DisplayAgent()
     , keep_history(false)
     , interaction_mode(InteractionMode::NONE)
 {
+    addDirectiveHandler("Close", [&](const char* message) { parsingClose(message); });
+    addDirectiveHandler("ControlFocus", [&](const char* message) { parsingControlFocus(message); });
+    addDirectiveHandler("ControlScroll", [&](const char* message) { parsingControlScroll(message); });
+    addDirectiveHandler("Update", [&](const char* message) { parsingUpdate(message); });
 }
 
 void DisplayAgent::initialize()
@@ -107,17 +111,8 @@ void DisplayAgent::parsingDirective(const char* dname, const char* message)
         return;
     }
 
-    if (!strcmp(dname, "Close")) {
-        parsingClose(message);
-    } else if (!strcmp(dname, "ControlFocus")) {
-        parsingControlFocus(message);
-    } else if (!strcmp(dname, "ControlScroll")) {
-        parsingControlScroll(message);
-    } else if (!strcmp(dname, "Update")) {
-        parsingUpdate(message);
-    } else {
+    if (!dispatchDirective(dname, message))
         parsingTemplates(message);
-    }
 }
 
 void DisplayAgent::updateInfoForContext(NJson::Value& ctx)
@@ -27,6 +27,7 @@ static const char* CAPABILITY_VERSION = "1.1";
 ExtensionAgent::ExtensionAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Action", [&](const char* message) { parsingAction(message); });
 }
 
 void ExtensionAgent::initialize()
@@ -85,10 +86,7 @@ void ExtensionAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Action"))
-        parsingAction(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void ExtensionAgent::actionSucceeded()
@@ -34,6 +34,10 @@ MessageAgent::MessageAgent()
     , is_finished(false)
     , interaction_mode(InteractionMode::NONE)
 {
+    addDirectiveHandler("SendCandidates", [&](const char* message) { parsingSendCandidates(message); });
+    addDirectiveHandler("SendMessage", [&](const char* message) { parsingSendMessage(message); });
+    addDirectiveHandler("GetMessage", [&](const char* message) { parsingGetMessage(message); });
+    addDirectiveHandler("ReadMessage", [&](const char* message) { parsingReadMessage(message); });
 }
 
 void MessageAgent::initialize()
@@ -100,16 +104,7 @@ void MessageAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "SendCandidates"))
-        parsingSendCandidates(message);
-    else if (!strcmp(dname, "SendMessage"))
-        parsingSendMessage(message);
-    else if (!strcmp(dname, "GetMessage"))
-        parsingGetMessage(message);
-    else if (!strcmp(dname, "ReadMessage"))
-        parsingReadMessage(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void MessageAgent::directiveDataCallback(NuguDirective* ndir, int seq, void* userdata)
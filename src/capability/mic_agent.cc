@@ -29,6 +29,7 @@ MicAgent::MicAgent()
     , mic_listener(nullptr)
     , cur_status(MicStatus::ON)
 {
+    addDirectiveHandler("SetMic", [&](const char* message) { parsingSetMic(message); });
 }
 
 void MicAgent::initialize()
@@ -53,12 +54,7 @@ void MicAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    // directive name check
-    if (!strcmp(dname, "SetMic"))
-        parsingSetMic(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void MicAgent::updateInfoForContext(NJson::Value& ctx)
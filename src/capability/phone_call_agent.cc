@@ -31,6 +31,12 @@ PhoneCallAgent::PhoneCallAgent()
     , focus_state(FocusState::NONE)
     , blockable(false)
 {
+    addDirectiveHandler("SendCandidates", [&](const char* message) { parsingSendCandidates(message); });
+    addDirectiveHandler("MakeCall", [&](const char* message) { parsingMakeCall(message); });
+    addDirectiveHandler("EndCall", [&](const char* message) { parsingEndCall(message); });
+    addDirectiveHandler("AcceptCall", [&](const char* message) { parsingAcceptCall(message); });
+    addDirectiveHandler("BlockIncomingCall", [&](const char* message) { parsingBlockIncomingCall(message); });
+    addDirectiveHandler("BlockNumber", [&](const char* message) { parsingBlockNumber(message); });
 }
 
 void PhoneCallAgent::initialize()
@@ -69,22 +75,7 @@ void PhoneCallAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    // directive name check
-    if (!strcmp(dname, "SendCandidates"))
-        parsingSendCandidates(message);
-    else if (!strcmp(dname, "MakeCall"))
-        parsingMakeCall(message);
-    else if (!strcmp(dname, "EndCall"))
-        parsingEndCall(message);
-    else if (!strcmp(dname, "AcceptCall"))
-        parsingAcceptCall(message);
-    else if (!strcmp(dname, "BlockIncomingCall"))
-        parsingBlockIncomingCall(message);
-    else if (!strcmp(dname, "BlockNumber"))
-        parsingBlockNumber(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void PhoneCallAgent::updateInfoForContext(NJson::Value& ctx)
@@ -27,6 +27,13 @@ static const char* CAPABILITY_VERSION = "1.3";
 RoutineAgent::RoutineAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Start", [&](const char* message) { parsingStart(message); });
+    addDirectiveHandler("Stop", [&](const char* message) { parsingStop(message); });
+    addDirectiveHandler("Continue", [&](const char* message) { parsingContinue(message); });
+    addDirectiveHandler("Move", [&](const char* message) {
+        if (!handlePendingActionTimeout())
+            parsingMove(message);
+    });
 }
 
 void RoutineAgent::initialize()
@@ -255,17 +262,7 @@ void RoutineAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Start")) {
-        parsingStart(message);
-    } else if (!strcmp(dname, "Stop")) {
-        parsingStop(message);
-    } else if (!strcmp(dname, "Continue")) {
-        parsingContinue(message);
-    } else if (!strcmp(dname, "Move")) {
-        if (!handlePendingActionTimeout())
-            parsingMove(message);
-    } else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void RoutineAgent::parsingStart(const char* message)
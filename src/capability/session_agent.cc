@@ -27,6 +27,7 @@ static const char* CAPABILITY_VERSION = "1.0";
 SessionAgent::SessionAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Set", [&](const char* message) { parsingSet(message); });
 }
 
 void SessionAgent::initialize()
@@ -76,12 +77,7 @@ void SessionAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Set"))
-        parsingSet(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive",
-            getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void SessionAgent::parsingSet(const char* message)
@@ -27,6 +27,7 @@ static const char* CAPABILITY_VERSION = "1.0";
 SoundAgent::SoundAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Beep", [&](const char* message) { parsingBeep(message); });
 }
 
 void SoundAgent::initialize()
@@ -80,12 +81,7 @@ void SoundAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Beep"))
-        parsingBeep(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive",
-            getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void SoundAgent::parsingBeep(const char* message)
@@ -28,6 +28,8 @@ SpeakerAgent::SpeakerAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
     , speaker_listener(nullptr)
 {
+    addDirectiveHandler("SetVolume", [&](const char* message) { parsingSetVolume(message); });
+    addDirectiveHandler("SetMute", [&](const char* message) { parsingSetMute(message); });
 }
 
 void SpeakerAgent::initialize()
@@ -59,14 +61,7 @@ void SpeakerAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    // directive name check
-    if (!strcmp(dname, "SetVolume"))
-        parsingSetVolume(message);
-    else if (!strcmp(dname, "SetMute"))
-        parsingSetMute(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void SpeakerAgent::updateInfoForContext(NJson::Value& ctx)
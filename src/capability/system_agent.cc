@@ -54,6 +54,16 @@ SystemAgent::SystemAgent()
             }
         },
         this);
+
+    addDirectiveHandler("ResetUserInactivity", [&](const char* message) { parsingResetUserInactivity(message); });
+    addDirectiveHandler("HandoffConnection", [&](const char* message) { parsingHandoffConnection(message); });
+    addDirectiveHandler("ResetConnection", [&](const char* message) { parsingResetConnection(message); });
+    addDirectiveHandler("TurnOff", [&](const char* message) { parsingTurnOff(message); });
+    addDirectiveHandler("UpdateState", [&](const char* message) { parsingUpdateState(message); });
+    addDirectiveHandler("Exception", [&](const char* message) { parsingException(message); });
+    addDirectiveHandler("NoDirectives", [&](const char* message) { parsingNoDirectives(message); });
+    addDirectiveHandler("Revoke", [&](const char* message) { parsingRevoke(message); });
+    addDirectiveHandler("Noop", [&](const char* message) { parsingNoop(message); });
 }
 
 void SystemAgent::initialize()
@@ -89,30 +99,6 @@ void SystemAgent::deInitialize()
     initialized = false;
 }
 
-void SystemAgent::parsingDirective(const char* dname, const char* message)
-{
-    if (!strcmp(dname, "ResetUserInactivity"))
-        parsingResetUserInactivity(message);
-    else if (!strcmp(dname, "HandoffConnection"))
-        parsingHandoffConnection(message);
-    else if (!strcmp(dname, "ResetConnection"))
-        parsingResetConnection(message);
-    else if (!strcmp(dname, "TurnOff"))
-        parsingTurnOff(message);
-    else if (!strcmp(dname, "UpdateState"))
-        parsingUpdateState(message);
-    else if (!strcmp(dname, "Exception"))
-        parsingException(message);
-    else if (!strcmp(dname, "NoDirectives"))
-        parsingNoDirectives(message);
-    else if (!strcmp(dname, "Revoke"))
-        parsingRevoke(message);
-    else if (!strcmp(dname, "Noop"))
-        parsingNoop(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-}
-
 void SystemAgent::updateInfoForContext(NJson::Value& ctx)
 {
     NJson::Value root;
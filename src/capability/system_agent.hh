@@ -31,7 +31,6 @@ public:
     void initialize() override;
     void deInitialize() override;
 
-    void parsingDirective(const char* dname, const char* message) override;
     void updateInfoForContext(NJson::Value& ctx) override;
     void setCapabilityListener(ICapabilityListener* clistener) override;
 
@@ -35,6 +35,9 @@ TextAgent::TextAgent()
     , focus_state(FocusState::NONE)
     , response_timeout(NUGU_SERVER_RESPONSE_TIMEOUT_SEC)
 {
+    addDirectiveHandler("TextSource", [&](const char* message) { parsingTextSource(message); });
+    addDirectiveHandler("TextRedirect", [&](const char* message) { parsingTextRedirect(message); });
+    addDirectiveHandler("ExpectTyping", [&](const char* message) { parsingExpectTyping(message); });
 }
 
 void TextAgent::setAttribute(TextAttribute&& attribute)
@@ -112,17 +115,7 @@ void TextAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    // directive name check
-    if (!strcmp(dname, "TextSource"))
-        parsingTextSource(message);
-    else if (!strcmp(dname, "TextRedirect"))
-        parsingTextRedirect(message);
-    else if (!strcmp(dname, "ExpectTyping"))
-        parsingExpectTyping(message);
-    else {
-        nugu_warn("%s[%s] is not support %s directive",
-            getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void TextAgent::updateInfoForContext(NJson::Value& ctx)
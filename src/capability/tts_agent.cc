@@ -50,6 +50,8 @@ TTSAgent::TTSAgent()
     , speak_dir(nullptr)
     , tts_engine(NUGU_TTS_ENGINE)
 {
+    addDirectiveHandler("Speak", [&](const char* message) { parsingSpeak(message); });
+    addDirectiveHandler("Stop", [&](const char* message) { parsingStop(message); });
 }
 
 void TTSAgent::setAttribute(TTSAttribute&& attribute)
@@ -88,6 +90,11 @@ void TTSAgent::initialize()
     player->addListener(this);
     player->setVolume(volume);
     player->setAudioAttribute(NUGU_AUDIO_ATTRIBUTE_VOICE_COMMAND);
+    player->setWritableCallback([&] {
+        // resume the attachments which are kept in the directive
+        if (speak_dir)
+            getAttachmentData(speak_dir, 1, this);
+    });
 
     addReferrerEvents("SpeechStarted", "Speak");
     addReferrerEvents("SpeechFinished", "Speak");
@@ -155,14 +162,7 @@ void TTSAgent::parsingDirective(const char* dname, const char* message)
 
     is_prehandling = false;
 
-    // directive name check
-    if (!strcmp(dname, "Speak")) {
-        parsingSpeak(message);
-    } else if (!strcmp(dname, "Stop")) {
-        parsingStop(message);
-    } else {
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
-    }
+    Capability::parsingDirective(dname, message);
 }
 
 void TTSAgent::cancelDirective(NuguDirective* ndir)
@@ -463,6 +463,7 @@ void TTSAgent::parsingSpeak(const char* message)
 
     cur_token = token;
     ps_id = play_service_id;
+    cache_key = format + ":" + text;
 
     is_finished = false;
     speak_dir = getNuguDirective();
@@ -547,7 +548,12 @@ void TTSAgent::executeOnForegroundAction()
                 nugu_directive_peek_dialog_id(speak_dir),
                 nugu_directive_peek_msg_id(speak_dir), NULL);
         }
+    } else if (speak_dir && cache_key.size()) {
+        // the attachments are ignored by the player if the audio is cached
+        if (player->setCacheKey(cache_key))
+            nugu_dbg("play the cached tts audio");
     }
+    cache_key.clear();
 
     if (speak_dir) {
         if (nugu_directive_get_data_size(speak_dir) > 0)
@@ -642,15 +648,25 @@ void TTSAgent::getAttachmentData(NuguDirective* ndir, int seq, void* userdata)
     TTSAgent* tts = static_cast<TTSAgent*>(userdata);
     unsigned char* buf;
     size_t length = 0;
+    int64_t received;
+
+    // keep the data in the directive until the decode queue is drained
+    if (!tts->player->isWritable()) {
+        nugu_dbg("tts player is busy, defer the attachment");
+        return;
+    }
+
+    // the deferred data is written with the time when it is received
+    received = nugu_directive_get_data_time(ndir);
 
     buf = nugu_directive_get_data(ndir, &length);
     if (buf) {
         if (seq == 0 && length > TTS_FIRST_ATTACHMENT_LIMIT) {
             nugu_dbg("first attachment is too big(%d > %d)", length, TTS_FIRST_ATTACHMENT_LIMIT);
-            tts->player->writeAudio((const char*)buf, TTS_FIRST_ATTACHMENT_LIMIT);
-            tts->player->writeAudio((const char*)buf + TTS_FIRST_ATTACHMENT_LIMIT, length - TTS_FIRST_ATTACHMENT_LIMIT);
+            tts->player->writeReceivedAudio((const char*)buf, TTS_FIRST_ATTACHMENT_LIMIT, received);
+            tts->player->writeReceivedAudio((const char*)buf + TTS_FIRST_ATTACHMENT_LIMIT, length - TTS_FIRST_ATTACHMENT_LIMIT, received);
         } else {
-            tts->player->writeAudio((const char*)buf, length);
+            tts->player->writeReceivedAudio((const char*)buf, length, received);
         }
         free(buf);
     }
@@ -98,6 +98,7 @@ private:
     int volume;
 
     NuguDirective* speak_dir;
+    std::string cache_key;
 
     std::string dialog_id;
     std::string ps_id;
@@ -27,6 +27,7 @@ static const char* CAPABILITY_VERSION = "1.0";
 UtilityAgent::UtilityAgent()
     : Capability(CAPABILITY_NAME, CAPABILITY_VERSION)
 {
+    addDirectiveHandler("Block", [&](const char* message) { parsingBlock(message); });
 }
 
 void UtilityAgent::initialize()
@@ -75,10 +76,7 @@ void UtilityAgent::parsingDirective(const char* dname, const char* message)
 {
     nugu_dbg("message: %s", message);
 
-    if (!strcmp(dname, "Block"))
-        parsingBlock(message);
-    else
-        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    Capability::parsingDirective(dname, message);
 }
 
 void UtilityAgent::parsingBlock(const char* message)
@@ -14,15 +14,39 @@
  * limitations under the License.
  */
 
+#include <cstdint>
 #include <cstring>
 #include <string.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_span.h"
 
 #include "clientkit/capability.hh"
 
 namespace NuguClientKit {
 
+/*
+ * The dispatch table grows until every registered directive name maps to
+ * its own slot. If that is not possible within the limit, the lookup falls
+ * back to a linear search of the registered handlers.
+ */
+#define DISPATCH_TABLE_MAX_SIZE 4096
+
+/* FNV-1a hash of directive name (constexpr, usable at compile time) */
+static constexpr uint32_t directive_hash(const char* str, uint32_t hash = 2166136261u)
+{
+    return *str ? directive_hash(str + 1, (hash ^ static_cast<unsigned char>(*str)) * 16777619u) : hash;
+}
+
+static_assert(directive_hash("") == 2166136261u, "FNV-1a offset basis");
+static_assert(directive_hash("a") == 0xe40c292cu, "FNV-1a hash of 'a'");
+
+struct DirectiveDispatchEntry {
+    uint32_t hash;
+    std::string dname;
+    Capability::DirectiveHandler handler;
+};
+
 struct Capability::Impl {
     std::string cname;
     std::string version;
@@ -33,7 +57,14 @@ struct Capability::Impl {
     bool cancel_previous_dialog = true;
     std::map<std::string, std::string> referrer_events;
     std::map<std::string, std::string> referrer_dirs;
-
+    std::vector<DirectiveDispatchEntry> dispatch_entries;
+    std::vector<unsigned short> dispatch_slots;
+    uint32_t dispatch_mask = 0;
+    bool dispatch_perfect = true;
+    bool dispatch_built = false;
+
+    void buildDispatchTable();
+    const DirectiveDispatchEntry* findDirectiveHandler(const char* dname);
     bool parseEventResultDesc(const std::string& desc, std::string& ename, std::string& msg_id, std::string& dialog_id, bool& success, int& code);
 };
 
@@ -316,6 +347,8 @@ void Capability::cancelDirective(NuguDirective* ndir)
 
 void Capability::processDirective(NuguDirective* ndir)
 {
+    NuguSpanScope span("Capability::processDirective");
+
     if (!ndir) {
         nugu_error("The directive is not exist.");
         return;
@@ -401,7 +434,54 @@ NuguDirective* Capability::getNuguDirective()
 
 void Capability::parsingDirective(const char* dname, const char* message)
 {
-    nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+    if (!dispatchDirective(dname, message))
+        nugu_warn("%s[%s] is not support %s directive", getName().c_str(), getVersion().c_str(), dname);
+}
+
+void Capability::addDirectiveHandler(const std::string& dname, DirectiveHandler handler)
+{
+    if (dname.size() == 0 || handler == nullptr)
+        return;
+
+    uint32_t hash = directive_hash(dname.c_str());
+
+    for (auto& entry : pimpl->dispatch_entries) {
+        if (entry.dname == dname) {
+            entry.handler = std::move(handler);
+            return;
+        }
+
+        if (entry.hash == hash)
+            nugu_warn("%s and %s directive have same hash", entry.dname.c_str(), dname.c_str());
+    }
+
+    // the table is built once at the first dispatch, after all handlers are added
+    pimpl->dispatch_entries.push_back({ hash, dname, std::move(handler) });
+    pimpl->dispatch_built = false;
+}
+
+std::vector<std::string> Capability::getDirectiveNames()
+{
+    std::vector<std::string> dnames;
+
+    for (const auto& entry : pimpl->dispatch_entries)
+        dnames.emplace_back(entry.dname);
+
+    return dnames;
+}
+
+bool Capability::dispatchDirective(const char* dname, const char* message)
+{
+    if (!dname)
+        return false;
+
+    const DirectiveDispatchEntry* entry = pimpl->findDirectiveHandler(dname);
+    if (!entry)
+        return false;
+
+    entry->handler(message);
+
+    return true;
 }
 
 bool Capability::getProperty(const std::string& property, std::string& value)
@@ -452,6 +532,75 @@ void Capability::sendAttachmentEvent(CapabilityEvent* event, bool is_end, size_t
     event->sendAttachmentEvent(is_end, size, data);
 }
 
+void Capability::Impl::buildDispatchTable()
+{
+    size_t size = 1;
+
+    while (size < dispatch_entries.size())
+        size <<= 1;
+
+    for (; size <= DISPATCH_TABLE_MAX_SIZE; size <<= 1) {
+        std::vector<unsigned short> slots(size, 0);
+        bool collision = false;
+
+        for (size_t i = 0; i < dispatch_entries.size(); i++) {
+            unsigned short& slot = slots[dispatch_entries[i].hash & (size - 1)];
+
+            if (slot) {
+                collision = true;
+                break;
+            }
+
+            /* slot value 0 is reserved for the empty slot */
+            slot = i + 1;
+        }
+
+        if (!collision) {
+            dispatch_slots = std::move(slots);
+            dispatch_mask = size - 1;
+            dispatch_perfect = true;
+            return;
+        }
+    }
+
+    nugu_warn("can't build perfect hash table for %zd directives", dispatch_entries.size());
+
+    dispatch_slots.clear();
+    dispatch_mask = 0;
+    dispatch_perfect = false;
+}
+
+const DirectiveDispatchEntry* Capability::Impl::findDirectiveHandler(const char* dname)
+{
+    uint32_t hash = directive_hash(dname);
+
+    if (!dispatch_built) {
+        buildDispatchTable();
+        dispatch_built = true;
+    }
+
+    if (!dispatch_perfect) {
+        for (const auto& entry : dispatch_entries)
+            if (entry.hash == hash && entry.dname == dname)
+                return &entry;
+
+        return nullptr;
+    }
+
+    if (dispatch_slots.empty())
+        return nullptr;
+
+    unsigned short slot = dispatch_slots[hash & dispatch_mask];
+    if (!slot)
+        return nullptr;
+
+    const DirectiveDispatchEntry& entry = dispatch_entries[slot - 1];
+    if (entry.hash != hash || entry.dname != dname)
+        return nullptr;
+
+    return &entry;
+}
+
 bool Capability::Impl::parseEventResultDesc(const std::string& desc, std::string& ename, std::string& msg_id, std::string& dialog_id, bool& success, int& code)
 {
     char* temp = (char*)desc.c_str();
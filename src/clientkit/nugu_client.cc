@@ -45,7 +45,13 @@ NuguClient::CapabilityBuilder* NuguClient::CapabilityBuilder::setWakeupModel(con
 
 bool NuguClient::CapabilityBuilder::construct()
 {
-    return (client_impl->create() == 0);
+    int ret = -1;
+
+    client_impl->invokeOnMainContext([&] {
+        ret = client_impl->create();
+    });
+
+    return (ret == 0);
 }
 
 /*******************************************************************************
@@ -53,7 +59,12 @@ bool NuguClient::CapabilityBuilder::construct()
  ******************************************************************************/
 
 NuguClient::NuguClient()
-    : impl(std::unique_ptr<NuguClientImpl>(new NuguClientImpl()))
+    : NuguClient(MainContext::Default)
+{
+}
+
+NuguClient::NuguClient(MainContext main_context)
+    : impl(std::unique_ptr<NuguClientImpl>(new NuguClientImpl(main_context == MainContext::Dedicated)))
 {
     cap_builder = new CapabilityBuilder(impl.get());
 }
@@ -78,22 +89,38 @@ NuguClient::CapabilityBuilder* NuguClient::getCapabilityBuilder()
 
 bool NuguClient::loadPlugins(const std::string& path)
 {
-    return impl->loadPlugins(path);
+    bool ret = false;
+
+    impl->invokeOnMainContext([&] {
+        ret = impl->loadPlugins(path);
+    });
+
+    return ret;
 }
 
 void NuguClient::unloadPlugins(void)
 {
-    impl->unloadPlugins();
+    impl->invokeOnMainContext([&] {
+        impl->unloadPlugins();
+    });
 }
 
 bool NuguClient::initialize(void)
 {
-    return impl->initialize();
+    bool ret = false;
+
+    impl->invokeOnMainContext([&] {
+        ret = impl->initialize();
+    });
+
+    return ret;
 }
 
 void NuguClient::deInitialize(void)
 {
-    impl->deInitialize();
+    impl->invokeOnMainContext([&] {
+        impl->deInitialize();
+    });
 }
 
 INuguCoreContainer* NuguClient::getNuguCoreContainer()
@@ -131,4 +158,14 @@ void NuguClient::removeDialogUXStateListener(IDialogUXStateAggregatorListener* l
     impl->removeDialogUXStateListener(listener);
 }
 
+std::map<std::string, int64_t> NuguClient::getMetrics()
+{
+    return impl->getMetrics();
+}
+
+std::string NuguClient::getMetricsText()
+{
+    return impl->getMetricsText();
+}
+
 } // NuguClientKit
@@ -14,14 +14,19 @@
  * limitations under the License.
  */
 
+#include <cstdlib>
 #include <string>
 
 #include "nugu.h"
 
 #include "base/nugu_equeue.h"
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_metrics.h"
+#include "base/nugu_mixer.h"
 #include "base/nugu_plugin.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_watchdog.h"
 #if defined(__MSYS__) || defined(_WIN32)
 #define USE_WINSOCK
 #include "base/nugu_winsock.h"
@@ -33,9 +38,8 @@ namespace NuguClientKit {
 
 using namespace NuguCore;
 
-NuguClientImpl::NuguClientImpl()
-    : nugu_core_container(std::unique_ptr<NuguCoreContainer>(new NuguCoreContainer()))
-    , speech_recognizer_aggregator(std::unique_ptr<SpeechRecognizerAggregator>(new SpeechRecognizerAggregator()))
+NuguClientImpl::NuguClientImpl(bool use_dedicated_context)
+    : dedicated_context(use_dedicated_context)
 {
     nugu_info("NUGU SDK v%s", NUGU_VERSION);
 
@@ -45,11 +49,26 @@ NuguClientImpl::NuguClientImpl()
 #ifdef USE_WINSOCK
     nugu_winsock_init();
 #endif
+
+    // all SDK sources are attached to the SDK main context from here,
+    // so start it before any SDK object is created
+    if (dedicated_context && nugu_mainloop_start() < 0) {
+        nugu_error("failed to start the dedicated main context");
+        dedicated_context = false;
+    }
+
+    nugu_watchdog_check_env();
+
+    nugu_core_container = std::unique_ptr<NuguCoreContainer>(new NuguCoreContainer());
+    speech_recognizer_aggregator = std::unique_ptr<SpeechRecognizerAggregator>(new SpeechRecognizerAggregator());
+
     nugu_equeue_initialize();
 
     network_manager = std::unique_ptr<INetworkManager>(nugu_core_container->createNetworkManager());
     network_manager->addListener(nugu_core_container->getNetworkManagerListener());
 
+    nugu_prof_mark(NUGU_PROF_TYPE_SDK_NETWORK_INIT_DONE);
+
     capa_helper = nugu_core_container->getCapabilityHelper();
 
     auto session_manager(capa_helper->getSessionManager());
@@ -58,18 +77,56 @@ NuguClientImpl::NuguClientImpl()
 
 NuguClientImpl::~NuguClientImpl()
 {
-    nugu_core_container->destroyAudioRecorderManager();
-    nugu_core_container->destroyInstance();
+    invokeOnMainContext([&] {
+        nugu_core_container->destroyAudioRecorderManager();
+
+        // the mixer manager observes the focus manager of the capabilities
+        nugu_core_container->destroyAudioMixerManager();
+        nugu_core_container->destroyInstance();
+
+        // the players of the capabilities are not using the mixer anymore
+        if (nugu_mixer_deinitialize() < 0)
+            nugu_error("failed to deinitialize the mixer");
 
-    if (plugin_loaded)
-        unloadPlugins();
+        if (plugin_loaded)
+            unloadPlugins();
+
+        if (nugu_watchdog_is_enabled()) {
+            nugu_watchdog_dump(0);
+            nugu_watchdog_disable();
+        }
+
+        nugu_equeue_deinitialize();
+
+        // release the SDK objects before the SDK main context is destroyed
+        speech_recognizer_aggregator.reset();
+        dialog_ux_state_aggregator.reset();
+        nugu_core_container.reset();
+        network_manager.reset();
+    });
+
+    if (dedicated_context)
+        nugu_mainloop_stop();
 
-    nugu_equeue_deinitialize();
 #ifdef USE_WINSOCK
     nugu_winsock_deinit();
 #endif
 }
 
+void NuguClientImpl::invokeOnMainContext(const std::function<void()>& func)
+{
+    if (!dedicated_context) {
+        func();
+        return;
+    }
+
+    nugu_mainloop_invoke(
+        [](void* userdata) {
+            (*static_cast<const std::function<void()>*>(userdata))();
+        },
+        (void*)&func);
+}
+
 void NuguClientImpl::setWakeupWord(const std::string& wakeup_word)
 {
     if (!wakeup_word.empty())
@@ -143,6 +200,36 @@ ISpeechRecognizerAggregator* NuguClientImpl::getSpeechRecognizerAggregator()
     return speech_recognizer_aggregator.get();
 }
 
+std::map<std::string, int64_t> NuguClientImpl::getMetrics()
+{
+    std::map<std::string, int64_t> metrics;
+    struct nugu_metric_snapshot snapshots[NUGU_METRICS_MAX];
+    int count = nugu_metrics_get_snapshot(snapshots, NUGU_METRICS_MAX);
+
+    for (int i = 0; i < count; i++) {
+        std::string name = snapshots[i].name;
+
+        if (snapshots[i].type == NUGU_METRIC_TYPE_HISTOGRAM) {
+            metrics[name + "_sum"] = snapshots[i].value;
+            metrics[name + "_count"] = snapshots[i].count;
+        } else {
+            metrics[name] = snapshots[i].value;
+        }
+    }
+
+    return metrics;
+}
+
+std::string NuguClientImpl::getMetricsText()
+{
+    char* text = nugu_metrics_format();
+    std::string result = text ? text : "";
+
+    free(text);
+
+    return result;
+}
+
 int NuguClientImpl::create(void)
 {
     if (createCapabilities() <= 0) {
@@ -235,6 +322,11 @@ bool NuguClientImpl::initialize(void)
 
     nugu_core_container->createAudioRecorderManager();
 
+#ifdef NUGU_ENV_PCM_MIXER
+    if (getenv(NUGU_ENV_PCM_MIXER))
+        nugu_core_container->createAudioMixerManager(capa_helper->getFocusManager());
+#endif
+
     if (icapability_map.empty())
         create();
 
@@ -247,6 +339,8 @@ bool NuguClientImpl::initialize(void)
         nugu_dbg("'%s' capability initialized", cname.c_str());
     }
 
+    nugu_prof_mark(NUGU_PROF_TYPE_SDK_CAPABILITY_INIT_DONE);
+
     registerDialogUXStateAggregator();
     setupSpeechRecognizerAggregator();
 
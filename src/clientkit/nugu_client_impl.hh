@@ -17,6 +17,7 @@
 #ifndef __NUGU_CLIENT_IMPL_H__
 #define __NUGU_CLIENT_IMPL_H__
 
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -33,9 +34,11 @@ using namespace NuguCore;
 
 class NuguClientImpl {
 public:
-    NuguClientImpl();
+    explicit NuguClientImpl(bool use_dedicated_context = false);
     virtual ~NuguClientImpl();
 
+    void invokeOnMainContext(const std::function<void()>& func);
+
     void setWakeupWord(const std::string& wakeup_word);
     void setWakeupModel(const WakeupModelFile& model_file);
     void registerCapability(ICapabilityInterface* capability);
@@ -52,6 +55,8 @@ public:
     INetworkManager* getNetworkManager();
     IFocusManager* getFocusManager();
     ISpeechRecognizerAggregator* getSpeechRecognizerAggregator();
+    std::map<std::string, int64_t> getMetrics();
+    std::string getMetricsText();
 
 private:
     int createCapabilities(void);
@@ -73,6 +78,7 @@ private:
     std::unique_ptr<DialogUXStateAggregator> dialog_ux_state_aggregator = nullptr;
     std::unique_ptr<SpeechRecognizerAggregator> speech_recognizer_aggregator = nullptr;
     ICapabilityHelper* capa_helper = nullptr;
+    bool dedicated_context = false;
     bool initialized = false;
     bool plugin_loaded = false;
     WakeupModelFile wakeup_model_file {};
@@ -18,14 +18,23 @@
 #include <pthread.h>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_watchdog.h"
 
 #include "audio_input_processor.hh"
 
 namespace NuguCore {
 
-class SyncEvent {
-public:
-    std::function<void()> action;
+typedef struct {
+    GSource source;
+    AudioInputProcessor* processor;
+} AudioInputEventSource;
+
+static GSourceFuncs event_source_funcs = {
+    nullptr, /* prepare */
+    nullptr, /* check */
+    AudioInputProcessor::onEventSourceDispatch,
+    nullptr, /* finalize */
 };
 
 AudioInputProcessor::~AudioInputProcessor()
@@ -41,6 +50,12 @@ AudioInputProcessor::~AudioInputProcessor()
     if (thread.joinable())
         thread.join();
 
+    if (event_source) {
+        g_source_destroy(event_source);
+        g_source_unref(event_source);
+        event_source = nullptr;
+    }
+
     if (recorder) {
         delete recorder;
         recorder = nullptr;
@@ -56,6 +71,12 @@ void AudioInputProcessor::init(std::string&& name, std::string& sample, std::str
 
     recorder = AudioRecorderManager::getInstance()->requestRecorder(sample, format, channel);
 
+    event_source = g_source_new(&event_source_funcs, sizeof(AudioInputEventSource));
+    ((AudioInputEventSource*)event_source)->processor = this;
+    g_source_set_ready_time(event_source, -1);
+    g_source_set_priority(event_source, G_PRIORITY_DEFAULT_IDLE);
+    g_source_attach(event_source, (GMainContext*)nugu_mainloop_get_context());
+
     thread_created = false;
     destroy = 0;
     thread = std::thread([this] {
@@ -125,25 +146,61 @@ void AudioInputProcessor::stop()
         recorder->stop();
 }
 
-static gboolean invoke_event(gpointer userdata)
+gboolean AudioInputProcessor::onEventSourceDispatch(GSource* source, GSourceFunc callback, gpointer userdata)
+{
+    // reset before draining, so a push during dispatching wakes up again
+    g_source_set_ready_time(source, -1);
+    ((AudioInputEventSource*)source)->processor->dispatchPendingEvents();
+
+    return G_SOURCE_CONTINUE;
+}
+
+void AudioInputProcessor::dispatchPendingEvents()
 {
-    SyncEvent* e = static_cast<SyncEvent*>(userdata);
+    unsigned int head = event_head.load(std::memory_order_relaxed);
+    unsigned int tail = event_tail.load(std::memory_order_acquire);
+
+    while (head != tail) {
+        int64_t begin = nugu_watchdog_begin();
+
+        dispatchEvent(event_ring[head % AUDIO_INPUT_EVENT_RING_SIZE]);
 
-    if (e->action)
-        e->action();
+        nugu_watchdog_end("audio_input_event", begin, (const void*)onEventSourceDispatch, this);
 
-    delete e;
-    return FALSE;
+        event_head.store(++head, std::memory_order_release);
+        tail = event_tail.load(std::memory_order_acquire);
+    }
 }
 
-void AudioInputProcessor::sendEvent(const std::function<void()>& action)
+bool AudioInputProcessor::sendEvent(int state, const std::string& id, float noise, float speech)
 {
-    g_return_if_fail(action != nullptr);
+    unsigned int tail = event_tail.load(std::memory_order_relaxed);
+    unsigned int head = event_head.load(std::memory_order_acquire);
+
+    // never block or allocate on the audio thread
+    if (tail - head >= AUDIO_INPUT_EVENT_RING_SIZE) {
+        event_dropped.fetch_add(1, std::memory_order_relaxed);
+        nugu_warn("event ring is full, drop the event(%d)", state);
+        return false;
+    }
+
+    AudioInputEvent& event = event_ring[tail % AUDIO_INPUT_EVENT_RING_SIZE];
+    event.state = state;
+    g_strlcpy(event.id, id.c_str(), sizeof(event.id));
+    event.noise = noise;
+    event.speech = speech;
 
-    SyncEvent* data = new SyncEvent;
-    data->action = action;
+    event_tail.store(tail + 1, std::memory_order_release);
 
-    g_idle_add(invoke_event, (void*)data);
+    if (event_source)
+        g_source_set_ready_time(event_source, 0);
+
+    return true;
+}
+
+unsigned int AudioInputProcessor::getDroppedEventCount()
+{
+    return event_dropped.load(std::memory_order_relaxed);
 }
 
 } // NuguCore
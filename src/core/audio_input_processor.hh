@@ -19,6 +19,7 @@
 
 #include <glib.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -28,20 +29,36 @@
 
 #include "audio_recorder_manager.hh"
 
+#define AUDIO_INPUT_EVENT_ID_SIZE 64
+#define AUDIO_INPUT_EVENT_RING_SIZE 32
+
 namespace NuguCore {
 
+/* Typed state event passed from the audio thread to the main context */
+struct AudioInputEvent {
+    int state;
+    char id[AUDIO_INPUT_EVENT_ID_SIZE];
+    float noise;
+    float speech;
+};
+
 class AudioInputProcessor {
 public:
     AudioInputProcessor() = default;
     virtual ~AudioInputProcessor();
 
+    static gboolean onEventSourceDispatch(GSource* source, GSourceFunc callback, gpointer userdata);
+
 protected:
     void init(std::string&& name, std::string& sample, std::string& format, std::string& channel);
     bool start(const std::function<void()>& extra_func = nullptr);
     void stop();
-    void sendEvent(const std::function<void()>& action = nullptr);
+    bool sendEvent(int state, const std::string& id, float noise = 0, float speech = 0);
+    unsigned int getDroppedEventCount();
 
     virtual void loop() = 0;
+    /* The callback is invoked in the main context. */
+    virtual void dispatchEvent(const AudioInputEvent& event) = 0;
 
     bool is_initialized = false;
     bool is_running = false;
@@ -53,6 +70,16 @@ protected:
     std::mutex mutex;
     std::string listening_id;
     IAudioRecorder* recorder = nullptr;
+
+private:
+    void dispatchPendingEvents();
+
+    /* single producer (serialized by the mutex), single consumer ring */
+    AudioInputEvent event_ring[AUDIO_INPUT_EVENT_RING_SIZE] = {};
+    std::atomic<unsigned int> event_head { 0 };
+    std::atomic<unsigned int> event_tail { 0 };
+    std::atomic<unsigned int> event_dropped { 0 };
+    GSource* event_source = nullptr;
 };
 
 } // NuguCore
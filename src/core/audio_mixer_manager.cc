@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/nugu_log.h"
+#include "base/nugu_mixer.h"
+
+#include "audio_mixer_manager.hh"
+
+namespace NuguCore {
+
+constexpr float AudioMixerManager::DUCKING_GAIN;
+
+AudioMixerManager* AudioMixerManager::instance = nullptr;
+
+AudioMixerManager::AudioMixerManager(IFocusManager* focus_manager)
+    : focus_manager(focus_manager)
+    , output_driver(nugu_pcm_driver_get_default())
+    , enabled(false)
+{
+    NuguAudioProperty property;
+
+    if (!output_driver) {
+        nugu_error("there is no pcm driver for the mixer output");
+        return;
+    }
+
+    // same property with the TTS stream to skip the resampling
+    property.samplerate = NUGU_AUDIO_SAMPLE_RATE_22K;
+    property.format = NUGU_AUDIO_FORMAT_S16_LE;
+    property.channel = 1;
+
+    if (nugu_mixer_initialize(output_driver, property) < 0) {
+        nugu_error("failed to initialize the mixer");
+        return;
+    }
+
+    nugu_pcm_driver_set_default(nugu_mixer_get_driver());
+    enabled = true;
+
+    if (focus_manager)
+        focus_manager->addObserver(this);
+}
+
+AudioMixerManager::~AudioMixerManager()
+{
+    if (!enabled)
+        return;
+
+    if (focus_manager)
+        focus_manager->removeObserver(this);
+
+    // the new pcm doesn't use the mixer. the mixer itself is deinitialized
+    // after the players using it are destroyed.
+    nugu_pcm_driver_set_default(output_driver);
+}
+
+AudioMixerManager* AudioMixerManager::createInstance(IFocusManager* focus_manager)
+{
+    if (!instance) {
+        instance = new AudioMixerManager(focus_manager);
+    }
+    return instance;
+}
+
+void AudioMixerManager::destroyInstance()
+{
+    if (instance) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+bool AudioMixerManager::isEnabled()
+{
+    return enabled;
+}
+
+void AudioMixerManager::onFocusChanged(const FocusConfiguration& configuration, FocusState state, const std::string& name)
+{
+    NuguAudioAttribute attribute = getAudioAttribute(configuration.type);
+
+    if (attribute == (NuguAudioAttribute)0)
+        return;
+
+    if (state == FocusState::NONE)
+        focus_states.erase(configuration.type);
+    else
+        focus_states[configuration.type] = state;
+
+    updateDucking(attribute);
+}
+
+NuguAudioAttribute AudioMixerManager::getAudioAttribute(const std::string& type)
+{
+    if (type == CALL_FOCUS_TYPE)
+        return NUGU_AUDIO_ATTRIBUTE_CALL;
+    else if (type == INFO_FOCUS_TYPE || type == ASR_USER_FOCUS_TYPE || type == ASR_DM_FOCUS_TYPE)
+        return NUGU_AUDIO_ATTRIBUTE_VOICE_COMMAND;
+    else if (type == ALERTS_FOCUS_TYPE)
+        return NUGU_AUDIO_ATTRIBUTE_ALARM;
+    else if (type == MEDIA_FOCUS_TYPE)
+        return NUGU_AUDIO_ATTRIBUTE_MUSIC;
+    else if (type == SOUND_FOCUS_TYPE || type == ASR_BEEP_FOCUS_TYPE)
+        return NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND;
+
+    return (NuguAudioAttribute)0;
+}
+
+void AudioMixerManager::updateDucking(NuguAudioAttribute attribute)
+{
+    float gain = 1.0f;
+
+    // duck the attribute while any of its focus waits in the background
+    for (const auto& focus_state : focus_states) {
+        if (focus_state.second == FocusState::BACKGROUND
+            && getAudioAttribute(focus_state.first) == attribute) {
+            gain = DUCKING_GAIN;
+            break;
+        }
+    }
+
+    if (nugu_mixer_get_ducking(attribute) == gain)
+        return;
+
+    nugu_dbg("ducking gain of the attribute(%d): %.2f", attribute, gain);
+    nugu_mixer_set_ducking(attribute, gain);
+}
+
+} // NuguCore
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NUGU_AUDIO_MIXER_MANAGER_H__
+#define __NUGU_AUDIO_MIXER_MANAGER_H__
+
+#include <map>
+#include <string>
+
+#include "base/nugu_audio.h"
+#include "base/nugu_pcm.h"
+#include "clientkit/focus_manager_interface.hh"
+
+namespace NuguCore {
+
+using namespace NuguClientKit;
+
+/**
+ * Route the pcm streams of the SDK to the playback mixer, and duck the
+ * sources of the audio attribute whose focus goes to the background.
+ */
+class AudioMixerManager : public IFocusManagerObserver {
+public:
+    explicit AudioMixerManager(IFocusManager* focus_manager);
+    virtual ~AudioMixerManager();
+
+    static AudioMixerManager* createInstance(IFocusManager* focus_manager);
+    static void destroyInstance();
+
+    bool isEnabled();
+
+    // implements IFocusManagerObserver
+    void onFocusChanged(const FocusConfiguration& configuration, FocusState state, const std::string& name) override;
+
+private:
+    NuguAudioAttribute getAudioAttribute(const std::string& type);
+    void updateDucking(NuguAudioAttribute attribute);
+
+    static AudioMixerManager* instance;
+    static constexpr float DUCKING_GAIN = 0.3f;
+
+    IFocusManager* focus_manager;
+    NuguPcmDriver* output_driver;
+    std::map<std::string, FocusState> focus_states;
+    bool enabled;
+};
+
+} // NuguCore
+
+#endif /* __NUGU_AUDIO_MIXER_MANAGER_H__ */
@@ -23,6 +23,29 @@
 
 namespace NuguCore {
 
+static int getSampleRate(enum nugu_audio_sample_rate samplerate)
+{
+    switch (samplerate) {
+    case NUGU_AUDIO_SAMPLE_RATE_8K:
+        return 8000;
+    case NUGU_AUDIO_SAMPLE_RATE_16K:
+        return 16000;
+    case NUGU_AUDIO_SAMPLE_RATE_22K:
+        return 22050;
+    case NUGU_AUDIO_SAMPLE_RATE_32K:
+        return 32000;
+    case NUGU_AUDIO_SAMPLE_RATE_44K:
+        return 44100;
+    default:
+        return 0;
+    }
+}
+
+static bool isResamplerFormat(enum nugu_audio_format format)
+{
+    return format == NUGU_AUDIO_FORMAT_S16_LE || format == NUGU_AUDIO_FORMAT_S16_BE;
+}
+
 AudioRecorder::AudioRecorder(std::string& samplerate, std::string& format, std::string& channel)
     : samplerate(samplerate)
     , format(format)
@@ -87,8 +110,12 @@ bool AudioRecorder::getAudioFrame(char* data, int* size, int timeout)
 
 AudioRecorderManager* AudioRecorderManager::instance = nullptr;
 AudioRecorderManager::AudioRecorderManager()
-    : muted(false)
+    : native_recorder(nullptr)
+    , muted(false)
 {
+    native_property.samplerate = NUGU_AUDIO_SAMPLE_RATE_8K;
+    native_property.format = NUGU_AUDIO_FORMAT_S16_LE;
+    native_property.channel = 1;
 }
 
 AudioRecorderManager::~AudioRecorderManager()
@@ -98,6 +125,11 @@ AudioRecorderManager::~AudioRecorderManager()
     for (const auto& container : nugu_recorders)
         nugu_recorder_free(container.second);
     nugu_recorders.clear();
+
+    if (native_recorder) {
+        nugu_recorder_free(native_recorder);
+        native_recorder = nullptr;
+    }
 }
 
 AudioRecorderManager* AudioRecorderManager::getInstance()
@@ -126,9 +158,7 @@ IAudioRecorder* AudioRecorderManager::requestRecorder(std::string& samplerate, s
     if (nugu_recorders.find(key) != nugu_recorders.end()) {
         nugu_dbg("already created nugu recorder - key:%s", key.c_str());
     } else {
-        NuguRecorder* nugu_recorder = nugu_recorder_new(key.c_str(), nugu_recorder_driver_get_default());
-        nugu_recorder_set_property(nugu_recorder, property);
-        nugu_recorders[key] = nugu_recorder;
+        nugu_recorders[key] = createNuguRecorder(key, property);
         nugu_dbg("create new nugu recorder - key:%s", key.c_str());
     }
 
@@ -222,6 +252,9 @@ bool AudioRecorderManager::setMute(bool mute)
     if (muted == false) {
         for (const auto& container : nugu_recorders)
             nugu_recorder_clear(container.second);
+
+        if (native_recorder)
+            nugu_recorder_clear(native_recorder);
     }
 
     return true;
@@ -335,6 +368,36 @@ std::string AudioRecorderManager::extractRecorderKey(const std::string& sample,
     return sample + "," + format + "," + channel;
 }
 
+NuguRecorder* AudioRecorderManager::createNuguRecorder(const std::string& key, NuguAudioProperty& property)
+{
+    NuguRecorder* nugu_recorder;
+
+    // the other formats are captured by a dedicated recorder
+    if (!isResamplerFormat(property.format)) {
+        nugu_recorder = nugu_recorder_new(key.c_str(), nugu_recorder_driver_get_default());
+        nugu_recorder_set_property(nugu_recorder, property);
+        return nugu_recorder;
+    }
+
+    if (!native_recorder)
+        native_recorder = nugu_recorder_new("native", nugu_recorder_driver_get_default());
+
+    // capture the highest quality among the requested properties
+    if (getSampleRate(property.samplerate) > getSampleRate(native_property.samplerate))
+        native_property.samplerate = property.samplerate;
+    if (property.channel > native_property.channel)
+        native_property.channel = property.channel;
+
+    if (!nugu_recorder_is_recording(native_recorder))
+        nugu_recorder_set_property(native_recorder, native_property);
+
+    nugu_recorder = nugu_recorder_new(key.c_str(), nullptr);
+    nugu_recorder_set_property(nugu_recorder, property);
+    nugu_recorder_set_source(nugu_recorder, native_recorder);
+
+    return nugu_recorder;
+}
+
 NuguRecorder* AudioRecorderManager::extractNuguRecorder(IAudioRecorder* recorder)
 {
     std::lock_guard<std::mutex> lock(mutex);
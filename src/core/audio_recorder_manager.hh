@@ -77,10 +77,14 @@ private:
     NuguAudioProperty convertNuguAudioProperty(std::string& sample, std::string& format, std::string& channel);
     std::string extractRecorderKey(const std::string& sample, const std::string& format, const std::string& channel);
     NuguRecorder* extractNuguRecorder(IAudioRecorder* recorder);
+    NuguRecorder* createNuguRecorder(const std::string& key, NuguAudioProperty& property);
 
 private:
     static AudioRecorderManager* instance;
     std::map<std::string, NuguRecorder*> nugu_recorders;
+    // single capture which feeds the recorders of S16 formats
+    NuguRecorder* native_recorder;
+    NuguAudioProperty native_property;
     std::map<NuguRecorder*, std::list<IAudioRecorder*>> recorders;
     std::mutex mutex;
     bool muted;
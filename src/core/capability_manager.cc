@@ -240,11 +240,10 @@ std::string CapabilityManager::getWakeupWord()
 
 ICapabilityInterface* CapabilityManager::findCapability(const std::string& cname)
 {
-    try {
-        return caps.at(cname);
-    } catch (std::out_of_range& exception) {
-        return nullptr;
-    }
+    // it's called for every directive, so avoid the exception of at() on miss
+    auto iter = caps.find(cname);
+
+    return iter != caps.end() ? iter->second : nullptr;
 }
 
 std::string CapabilityManager::makeContextInfo(const std::string& cname, NJson::Value& cap_ctx)
@@ -17,8 +17,12 @@
 #include <algorithm>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_metrics.h"
 #include "base/nugu_network_manager.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_span.h"
+#include "base/nugu_watchdog.h"
 
 #include "directive_sequencer.hh"
 
@@ -148,7 +152,7 @@ void LookupTable::dump()
  */
 class DialogDirectiveList {
 public:
-    explicit DialogDirectiveList(const std::string& title);
+    DialogDirectiveList(const std::string& title, const char* metric_name, const char* metric_help);
     virtual ~DialogDirectiveList();
 
     bool push(NuguDirective* ndir);
@@ -173,13 +177,27 @@ public:
     using DialogListMap = std::map<std::string, std::vector<NuguDirective*>>;
 
 private:
+    void updateMetric();
+
     std::string title;
     DialogListMap listmap;
+    NuguMetric* metric;
 };
 
-DialogDirectiveList::DialogDirectiveList(const std::string& title)
+DialogDirectiveList::DialogDirectiveList(const std::string& title, const char* metric_name, const char* metric_help)
     : title(title)
 {
+    metric = nugu_metrics_register(metric_name, NUGU_METRIC_TYPE_GAUGE, metric_help);
+}
+
+void DialogDirectiveList::updateMetric()
+{
+    size_t count = 0;
+
+    for (auto& list : listmap)
+        count += list.second.size();
+
+    nugu_metric_set(metric, count);
 }
 
 DialogDirectiveList::~DialogDirectiveList()
@@ -191,6 +209,7 @@ bool DialogDirectiveList::push(NuguDirective* ndir)
     const char* dialog_id = nugu_directive_peek_dialog_id(ndir);
 
     listmap[dialog_id].push_back(ndir);
+    updateMetric();
 
     return true;
 }
@@ -229,6 +248,8 @@ bool DialogDirectiveList::remove(NuguDirective* ndir)
     if (dlist.size() == 0)
         listmap.erase(dialog_id);
 
+    updateMetric();
+
     return true;
 }
 
@@ -243,6 +264,7 @@ bool DialogDirectiveList::remove(const std::string& dialog_id, NOTIFY notify)
         notify(item);
 
     listmap.erase(dialog_id);
+    updateMetric();
 
     return true;
 }
@@ -277,6 +299,8 @@ bool DialogDirectiveList::removeByName(const std::string& dialog_id, const std::
     if (dlist.size() == 0)
         listmap.erase(dialog_id);
 
+    updateMetric();
+
     return true;
 }
 
@@ -330,6 +354,7 @@ void DialogDirectiveList::erase(const char* dialog_id)
 
     iter->second.clear();
     listmap.erase(dialog_id);
+    updateMetric();
 }
 
 template <typename NOTIFY>
@@ -342,6 +367,7 @@ void DialogDirectiveList::clear(NOTIFY notify)
     }
 
     listmap.clear();
+    updateMetric();
 }
 
 NuguDirective* DialogDirectiveList::find(const char* name_space, const char* name)
@@ -393,8 +419,10 @@ DirectiveSequencer::DirectiveSequencer()
     : idler_src(0)
 {
     msgid_lookup = new LookupTable("Msg-id Lookup table");
-    pending = new DialogDirectiveList("PendingList");
-    active = new DialogDirectiveList("ActiveList");
+    pending = new DialogDirectiveList("PendingList", "nugu_directive_pending",
+        "Number of the directives waiting for the blocking directives");
+    active = new DialogDirectiveList("ActiveList", "nugu_directive_active",
+        "Number of the directives being handled by the agents");
 
     last_cancel_dialog_id = "";
 
@@ -418,7 +446,7 @@ void DirectiveSequencer::reset()
 {
     /* Cancel the pending idler */
     if (idler_src != 0)
-        g_source_remove(idler_src);
+        nugu_mainloop_source_remove(idler_src);
     idler_src = 0;
 
     dump_policies(policy_map);
@@ -483,9 +511,21 @@ gboolean DirectiveSequencer::onNext(gpointer userdata)
 
     nugu_dbg("idle callback: process next directives (%d)", list.size());
 
-    for (auto& ndir : list)
+    for (auto& ndir : list) {
+        int64_t begin = nugu_watchdog_begin();
+        std::string tag;
+
+        // the directive can be destroyed during handling
+        if (begin)
+            tag = std::string("directive:") + nugu_directive_peek_namespace(ndir)
+                + "." + nugu_directive_peek_name(ndir);
+
         sequencer->handleDirective(ndir);
 
+        if (begin)
+            nugu_watchdog_end(tag.c_str(), begin, nullptr, ndir);
+    }
+
     return FALSE;
 }
 
@@ -506,6 +546,7 @@ bool DirectiveSequencer::preHandleDirective(NuguDirective* ndir)
 
 void DirectiveSequencer::handleDirective(NuguDirective* ndir)
 {
+    NuguSpanScope span("DirectiveSequencer::handleDirective");
     const char* name_space = nugu_directive_peek_namespace(ndir);
     const char* name = nugu_directive_peek_name(ndir);
 
@@ -589,7 +630,7 @@ void DirectiveSequencer::nextDirective(const std::string& dialog_id)
     nugu_dbg("- search done");
 
     if (idler_src == 0)
-        idler_src = g_idle_add(onNext, this);
+        idler_src = nugu_mainloop_idle_add(onNext, this);
 }
 
 bool DirectiveSequencer::complete(NuguDirective* ndir)
@@ -625,6 +666,8 @@ bool DirectiveSequencer::complete(NuguDirective* ndir)
 
 bool DirectiveSequencer::add(NuguDirective* ndir)
 {
+    NuguSpanScope span("DirectiveSequencer::add");
+
     if (ndir == nullptr) {
         nugu_error("ndir is NULL");
         return false;
@@ -15,6 +15,7 @@
  */
 
 #include "base/nugu_log.h"
+#include "audio_mixer_manager.hh"
 #include "capability_helper.hh"
 #include "capability_manager.hh"
 #include "media_player.hh"
@@ -119,4 +120,14 @@ void NuguCoreContainer::destroyAudioRecorderManager()
     AudioRecorderManager::destroyInstance();
 }
 
+void NuguCoreContainer::createAudioMixerManager(IFocusManager* focus_manager)
+{
+    AudioMixerManager::createInstance(focus_manager);
+}
+
+void NuguCoreContainer::destroyAudioMixerManager()
+{
+    AudioMixerManager::destroyInstance();
+}
+
 } // NuguCore
@@ -48,6 +48,10 @@ public:
     // wrapping AudioRecorderManager functions
     void createAudioRecorderManager();
     void destroyAudioRecorderManager();
+
+    // wrapping AudioMixerManager functions
+    void createAudioMixerManager(IFocusManager* focus_manager);
+    void destroyAudioMixerManager();
 };
 
 } // NuguCore
@@ -14,142 +14,180 @@
  * limitations under the License.
  */
 
-#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
+#include <future>
 #include <glib.h>
-#include <map>
 #include <memory>
-#include <mutex>
-#include <thread>
 #include <utility>
-#include <vector>
 
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_watchdog.h"
 #include "nugu_runner_impl.hh"
 
 using namespace NuguClientKit;
 
 namespace NuguCore {
 
+enum class TaskStatus {
+    Pending,
+    Running,
+    Cancelled
+};
+
+/*
+ * The task is shared between the caller and the dispatcher. The caller
+ * waits on its own completion future, so a blocking caller is released
+ * only by its own task.
+ */
+struct NuguRunnerTask {
+    std::string tag;
+    NuguRunner::request_method method;
+    ExecuteType type;
+    std::atomic<TaskStatus> status { TaskStatus::Pending };
+    std::promise<void> completion;
+};
+
+struct NuguRunnerTaskNode {
+    std::shared_ptr<NuguRunnerTask> task;
+    NuguRunnerTaskNode* next;
+};
+
+struct NuguRunnerSource {
+    GSource source;
+    NuguRunnerImplPrivate* d;
+};
+
 class NuguRunnerImplPrivate {
 public:
-    NuguRunnerImplPrivate()
-        : done(0)
-        , src_id(0)
-    {
-    }
-    ~NuguRunnerImplPrivate()
-    {
-        std::lock_guard<std::mutex> guard(m);
+    NuguRunnerImplPrivate();
+    ~NuguRunnerImplPrivate();
 
-        tag_vector.clear();
-        type_map.clear();
-        method_map.clear();
-    }
-    static gboolean method_dispatch_cb(void* userdata);
-    void add_method(const std::string& tag, NuguRunner::request_method method, ExecuteType type);
-    void remove_method(const std::string& tag);
+    void push(NuguRunnerTaskNode* node);
+    void dispatch();
+
+    static gboolean source_dispatch_cb(GSource* source, GSourceFunc callback, gpointer userdata);
 
 public:
-    static std::map<NuguRunnerImpl*, NuguRunnerImplPrivate*> private_map;
-    std::vector<std::string> tag_vector;
-    std::map<std::string, ExecuteType> type_map;
-    std::map<std::string, NuguRunner::request_method> method_map;
-    std::mutex m;
-    std::condition_variable cv;
-    static int unique;
-    int done;
-    guint src_id;
+    /* multiple producers push to the head, the nugu loop takes all at once */
+    std::atomic<NuguRunnerTaskNode*> head;
+    GSource* source;
 };
 
-int NuguRunnerImplPrivate::unique = 0;
-std::map<NuguRunnerImpl*, NuguRunnerImplPrivate*> NuguRunnerImplPrivate::private_map;
+static GSourceFuncs runner_source_funcs = {
+    nullptr, /* prepare */
+    nullptr, /* check */
+    NuguRunnerImplPrivate::source_dispatch_cb,
+    nullptr, /* finalize */
+};
 
-gboolean NuguRunnerImplPrivate::method_dispatch_cb(void* userdata)
+NuguRunnerImplPrivate::NuguRunnerImplPrivate()
+    : head(nullptr)
 {
-    NuguRunnerImpl* runner = static_cast<NuguRunnerImpl*>(userdata);
-    NuguRunnerImplPrivate* d = NuguRunnerImplPrivate::private_map[runner];
+    source = g_source_new(&runner_source_funcs, sizeof(NuguRunnerSource));
+    ((NuguRunnerSource*)source)->d = this;
+    g_source_set_ready_time(source, -1);
+    // same priority as the g_idle_add() which was used, so I/O is dispatched first
+    g_source_set_priority(source, G_PRIORITY_DEFAULT_IDLE);
+    g_source_attach(source, (GMainContext*)nugu_mainloop_get_context());
+}
 
-    if (!d) {
-        nugu_error("Nugu Runner is something wrong");
-        return FALSE;
-    }
+NuguRunnerImplPrivate::~NuguRunnerImplPrivate()
+{
+    NuguRunnerTaskNode* node = head.exchange(nullptr);
 
-    std::lock_guard<std::mutex> guard(d->m);
+    g_source_destroy(source);
+    g_source_unref(source);
 
-    for (const auto& tag : d->tag_vector) {
-        nugu_info("[Method: %s] will execute", tag.c_str());
-        if (d->method_map[tag])
-            d->method_map[tag]();
+    while (node) {
+        NuguRunnerTaskNode* next = node->next;
 
-        ExecuteType type = d->type_map[tag];
-        if (type == ExecuteType::Blocking) {
-            d->done = 1;
-            nugu_info("[Method: %s] release blocking", tag.c_str());
-            d->cv.notify_one();
-        }
+        nugu_info("[Method: %s] is removed", node->task->tag.c_str());
+        delete node;
+        node = next;
     }
+}
 
-    d->tag_vector.clear();
-    d->method_map.clear();
-    d->type_map.clear();
-    d->src_id = 0;
+void NuguRunnerImplPrivate::push(NuguRunnerTaskNode* node)
+{
+    NuguRunnerTaskNode* prev = head.load(std::memory_order_relaxed);
 
-    return FALSE;
+    do {
+        node->next = prev;
+    } while (!head.compare_exchange_weak(prev, node, std::memory_order_release, std::memory_order_relaxed));
+
+    // wake up the nugu loop only when the queue was empty
+    if (prev == nullptr)
+        g_source_set_ready_time(source, 0);
 }
 
-void NuguRunnerImplPrivate::add_method(const std::string& tag, NuguRunner::request_method method, ExecuteType type)
+void NuguRunnerImplPrivate::dispatch()
 {
-    nugu_info("[Method: %s] is reserved", tag.c_str());
+    NuguRunnerTaskNode* node = head.exchange(nullptr, std::memory_order_acquire);
+    NuguRunnerTaskNode* fifo = nullptr;
+
+    // the pushed list is LIFO, so reverse it to keep the request order
+    while (node) {
+        NuguRunnerTaskNode* next = node->next;
 
-    if (std::find(tag_vector.begin(), tag_vector.end(), tag) == tag_vector.end())
-        tag_vector.push_back(tag);
+        node->next = fifo;
+        fifo = node;
+        node = next;
+    }
+
+    while (fifo) {
+        NuguRunnerTaskNode* next = fifo->next;
+        std::shared_ptr<NuguRunnerTask>& task = fifo->task;
+        TaskStatus expected = TaskStatus::Pending;
+
+        if (task->status.compare_exchange_strong(expected, TaskStatus::Running)) {
+            nugu_info("[Method: %s] will execute", task->tag.c_str());
+            if (task->method) {
+                int64_t begin = nugu_watchdog_begin();
+
+                task->method();
+
+                if (begin)
+                    nugu_watchdog_end(("runner:" + task->tag).c_str(), begin, nullptr, task.get());
+            }
+
+            if (task->type == ExecuteType::Blocking)
+                nugu_info("[Method: %s] release blocking", task->tag.c_str());
 
-    method_map[tag] = std::move(method);
-    type_map[tag] = type;
+            task->completion.set_value();
+        }
+
+        delete fifo;
+        fifo = next;
+    }
 }
 
-void NuguRunnerImplPrivate::remove_method(const std::string& tag)
+gboolean NuguRunnerImplPrivate::source_dispatch_cb(GSource* source, GSourceFunc callback, gpointer userdata)
 {
-    nugu_info("[Method: %s] is removed", tag.c_str());
+    NuguRunnerImplPrivate* d = ((NuguRunnerSource*)source)->d;
 
-    auto tag_iter = std::find(tag_vector.begin(), tag_vector.end(), tag);
-    if (tag_iter != tag_vector.end())
-        tag_vector.erase(tag_iter);
+    // reset before taking the queue, so a push during dispatching wakes up again
+    g_source_set_ready_time(source, -1);
+    d->dispatch();
 
-    auto type_iter = type_map.find(tag);
-    if (type_iter != type_map.end())
-        type_map.erase(type_iter);
-
-    auto method_iter = method_map.find(tag);
-    if (method_iter != method_map.end())
-        method_map.erase(method_iter);
+    return G_SOURCE_CONTINUE;
 }
 
 NuguRunnerImpl::NuguRunnerImpl()
     : d(new NuguRunnerImplPrivate())
 {
-    d->private_map[this] = d;
 }
 
 NuguRunnerImpl::~NuguRunnerImpl()
 {
-    auto private_iter = d->private_map.find(this);
-    if (private_iter != d->private_map.end())
-        d->private_map.erase(private_iter);
-
-    if (d->src_id > 0)
-        g_source_remove(d->src_id);
-
     delete d;
 }
 
 bool NuguRunnerImpl::invokeMethod(const std::string& tag, NuguRunner::request_method method, ExecuteType type, int timeout)
 {
     if (type != ExecuteType::Queued) {
-        if (g_main_context_is_owner(g_main_context_default()) == TRUE) {
+        if (nugu_mainloop_is_owner()) {
             nugu_info("[Method: %s] is executed immediately", tag.c_str());
             if (method)
                 method();
@@ -157,43 +195,46 @@ bool NuguRunnerImpl::invokeMethod(const std::string& tag, NuguRunner::request_me
         }
     }
 
-    std::string unique_tag = tag + std::to_string(d->unique++);
-    addMethod2Dispatcher(unique_tag, std::move(method), type);
+    std::shared_ptr<NuguRunnerTask> task(new NuguRunnerTask());
+    std::future<void> done;
 
-    if (type == ExecuteType::Blocking) {
-        std::mutex mtx;
-        std::unique_lock<std::mutex> lk(mtx);
+    task->tag = tag;
+    task->method = std::move(method);
+    task->type = type;
 
-        if (timeout <= 0) {
-            if (d->done == 0)
-                d->cv.wait(lk);
-            return true;
-        }
+    if (type == ExecuteType::Blocking)
+        done = task->completion.get_future();
 
-        auto now = std::chrono::system_clock::now();
-        if (!d->cv.wait_until(lk, now + std::chrono::milliseconds(timeout * 1000),
-                [&]() { return d->done == 1; })) {
-            std::lock_guard<std::mutex> guard(d->m);
+    addMethod2Dispatcher(task);
 
-            nugu_warn("The method(%s) is released blocking by timeout (%d sec)", unique_tag.c_str(), timeout);
-            d->remove_method(unique_tag);
-            return false;
-        }
+    if (type != ExecuteType::Blocking)
+        return true;
+
+    if (timeout <= 0) {
+        done.wait();
+        return true;
     }
 
-    return true;
-}
+    if (done.wait_for(std::chrono::seconds(timeout)) == std::future_status::ready)
+        return true;
 
-void NuguRunnerImpl::addMethod2Dispatcher(const std::string& tag, NuguRunner::request_method method, ExecuteType type)
-{
-    std::lock_guard<std::mutex> guard(d->m);
+    TaskStatus expected = TaskStatus::Pending;
+    if (!task->status.compare_exchange_strong(expected, TaskStatus::Cancelled)) {
+        // the method is already running on nugu loop
+        done.wait();
+        return true;
+    }
 
-    d->add_method(tag, std::move(method), type);
+    nugu_warn("The method(%s) is released blocking by timeout (%d sec)", tag.c_str(), timeout);
 
-    if (!d->src_id)
-        d->src_id = g_idle_add(d->method_dispatch_cb, (void*)this);
+    return false;
+}
+
+void NuguRunnerImpl::addMethod2Dispatcher(std::shared_ptr<NuguRunnerTask> task)
+{
+    nugu_info("[Method: %s] is reserved", task->tag.c_str());
 
-    d->done = 0;
+    d->push(new NuguRunnerTaskNode { std::move(task), nullptr });
 }
 
 } // NuguClientKit
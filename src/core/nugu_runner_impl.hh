@@ -17,11 +17,14 @@
 #ifndef __NUGU_RUNNER_IMPL_H__
 #define __NUGU_RUNNER_IMPL_H__
 
+#include <memory>
+
 #include "clientkit/nugu_runner.hh"
 
 namespace NuguCore {
 
 class NuguRunnerImplPrivate;
+struct NuguRunnerTask;
 
 class NuguRunnerImpl {
 public:
@@ -34,9 +37,7 @@ public:
         int timeout = 0);
 
 private:
-    void addMethod2Dispatcher(const std::string& tag,
-        NuguClientKit::NuguRunner::request_method method,
-        NuguClientKit::ExecuteType type);
+    void addMethod2Dispatcher(std::shared_ptr<NuguRunnerTask> task);
 
 private:
     NuguRunnerImplPrivate* d;
@@ -21,6 +21,7 @@
 #include "base/nugu_encoder.h"
 #include "base/nugu_log.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_span.h"
 
 #include "nugu_timer.hh"
 #include "speech_recognizer.hh"
@@ -134,13 +135,16 @@ void SpeechRecognizer::sendListeningEvent(ListeningState state, const std::strin
         return;
 
     mutex.lock();
-    AudioInputProcessor::sendEvent([=] {
-        if (listener)
-            listener->onListeningState(state, id);
-    });
+    AudioInputProcessor::sendEvent(static_cast<int>(state), id);
     mutex.unlock();
 }
 
+void SpeechRecognizer::dispatchEvent(const AudioInputEvent& event)
+{
+    if (listener)
+        listener->onListeningState(static_cast<ListeningState>(event.state), event.id);
+}
+
 void SpeechRecognizer::setListener(ISpeechRecognizerListener* listener)
 {
     this->listener = listener;
@@ -284,6 +288,8 @@ void SpeechRecognizer::loop()
                 break;
             }
 
+            NuguSpanScope span("SpeechRecognizer::epd");
+
             epd_ret = epd_client_run(pcm_buf, pcm_size);
             if (epd_ret < 0 || epd_ret > EPD_END_CHECK) {
                 nugu_error("epd_client_run() failed: %d", epd_ret);
@@ -484,6 +490,8 @@ void SpeechRecognizer::loop()
                 break;
             }
 
+            NuguSpanScope span("SpeechRecognizer::encode");
+
             if (pcm_size > 0) {
                 std::lock_guard<std::mutex> lock(mtx);
                 unsigned char* encoded;
@@ -55,6 +55,7 @@ public:
 private:
     void initialize(Attribute&& attribute);
     void loop() override;
+    void dispatchEvent(const AudioInputEvent& event) override;
     void sendListeningEvent(ListeningState state, const std::string& id);
 
     int epd_ret;
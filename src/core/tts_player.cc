@@ -15,16 +15,26 @@
  */
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
+#include <mutex>
+#include <thread>
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <glib.h>
 
+#include "base/nugu_cache.h"
 #include "base/nugu_decoder.h"
+#include "base/nugu_jitter.h"
 #include "base/nugu_log.h"
+#include "base/nugu_mainloop.h"
 #include "base/nugu_pcm.h"
 #include "base/nugu_prof.h"
+#include "base/nugu_span.h"
 
 #include "nugu_timer.hh"
 #include "tts_player.hh"
@@ -36,8 +46,34 @@ namespace NuguCore {
 #define MEDIA_PLAYER_NAME "MediaPlayerAttachment"
 #define MEDIA_SAMPLERATE_22K 22050
 
+// decode ahead of the playback up to this duration (NUGU_TTS_DECODE_LOOKAHEAD)
+#define DECODE_LOOKAHEAD_MSEC 2000
+// encoded data size over this limit makes the player not writable
+#define DECODE_QUEUE_LIMIT (32 * 1024)
+#define DECODE_WAIT_MSEC 20
+
+// ratio of the streams allowed to underrun (NUGU_TTS_JITTER_BUFFER=0 disables)
+#define JITTER_TARGET_UNDERRUN_RATE 0.05
+#define JITTER_MAX_THRESHOLD_MSEC 1000
+
+// decoded audio cache is enabled by NUGU_TTS_CACHE_PATH
+#define CACHE_MAX_SIZE_KB (16 * 1024)
+
 static int uniq_id = 0;
 
+struct DecodePacket {
+    int generation;
+    bool is_end;
+    std::string data;
+};
+
+// status or event of the pcm which is emitted on the worker thread
+struct MediaNotification {
+    int generation;
+    bool is_status;
+    int value;
+};
+
 class TTSPlayerPrivate {
 public:
     explicit TTSPlayerPrivate(int vol)
@@ -50,14 +86,45 @@ public:
         , position(0)
         , duration(0)
         , seek_time(0)
-        , seek_size(0)
         , total_size(0)
         , mute(false)
         , count(0)
+        , owner(nullptr)
+        , lookahead_size(DECODE_LOOKAHEAD_MSEC * MEDIA_SAMPLERATE_22K * 2 / 1000)
+        , generation(0)
+        , queued_size(0)
+        , queue_depth(0)
+        , max_queue_depth(0)
+        , use_worker(false)
+        , end_pending(false)
+        , writable_pending(false)
+        , quit(false)
+        , event_src(0)
+        , jitter(nullptr)
+        , cache_writer(nullptr)
+        , cache_hit(false)
     {
     }
     ~TTSPlayerPrivate() {}
 
+    void startWorker();
+    void stopWorker();
+    void clearQueue();
+    bool pushPacket(const char* data, int size, bool is_end);
+    void decodeLoop();
+    bool decodePacket(const char* data, size_t size);
+    void handleDecodeEvents();
+    void handleStatus(enum nugu_media_status status);
+    void handleEvent(enum nugu_media_event event);
+    bool deferNotification(bool is_status, int value);
+    void startStream();
+    void finishStream();
+    void abortCache();
+    void appendCache(const void* data, size_t size);
+    void markCacheStats(enum nugu_prof_type type);
+
+    static int onDecodeEvent(void* userdata);
+
 public:
     static std::map<TTSPlayer*, TTSPlayerPrivate*> mp_map;
     std::list<IMediaPlayerListener*> listeners;
@@ -70,12 +137,394 @@ public:
     int position;
     int duration;
     int seek_time;
-    size_t seek_size;
     size_t total_size;
     bool mute;
     int count;
+
+    // decode pipeline: worker thread decodes the queued packets into the
+    // pcm ahead of the playback and the main loop handles the end of stream
+    TTSPlayer* owner;
+    size_t lookahead_size;
+    std::thread worker;
+    std::mutex queue_lock;
+    std::condition_variable queue_cond;
+    std::deque<DecodePacket> decode_queue;
+    int generation;
+    size_t queued_size;
+    int queue_depth;
+    int max_queue_depth;
+    bool use_worker;
+    bool end_pending;
+    bool writable_pending;
+    bool quit;
+    unsigned int event_src;
+    std::function<void()> writable_callback;
+    std::deque<MediaNotification> notifications;
+
+    // serialize the decoder and the cache writer between the main loop
+    // and the worker
+    std::mutex decode_lock;
+
+    // learns the attachment arrivals to select the start threshold
+    NuguJitter* jitter;
+
+    // decoded audio cache shared by all tts players
+    static NuguCache* cache;
+    static int cache_refs;
+    NuguCacheWriter* cache_writer;
+    bool cache_hit;
 };
 std::map<TTSPlayer*, TTSPlayerPrivate*> TTSPlayerPrivate::mp_map;
+NuguCache* TTSPlayerPrivate::cache = nullptr;
+int TTSPlayerPrivate::cache_refs = 0;
+
+void TTSPlayerPrivate::startWorker()
+{
+    if (worker.joinable())
+        return;
+
+    // the worker compares its id in deferNotification() after this lock
+    std::lock_guard<std::mutex> lock(queue_lock);
+
+    quit = false;
+    worker = std::thread([this] { this->decodeLoop(); });
+
+#ifdef HAVE_PTHREAD_SETNAME_NP
+#if !defined(__APPLE__) && !defined(__MSYS__) && !defined(_WIN32)
+    if (pthread_setname_np(worker.native_handle(), "tts_decoder") < 0)
+        nugu_error("pthread_setname_np() failed");
+#endif
+#endif
+}
+
+void TTSPlayerPrivate::stopWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_lock);
+        quit = true;
+        queue_cond.notify_all();
+    }
+
+    if (worker.joinable())
+        worker.join();
+}
+
+// the pcm driver emits the status and the event in push_data() which is
+// called on the worker, so they are passed to the listeners on the main loop
+bool TTSPlayerPrivate::deferNotification(bool is_status, int value)
+{
+    if (std::this_thread::get_id() != worker.get_id())
+        return false;
+
+    std::lock_guard<std::mutex> lock(queue_lock);
+
+    notifications.push_back({ generation, is_status, value });
+
+    if (!event_src)
+        event_src = nugu_mainloop_idle_add(onDecodeEvent, this);
+
+    return true;
+}
+
+void TTSPlayerPrivate::clearQueue()
+{
+    // wait for the packet which is being decoded into the pcm
+    std::lock_guard<std::mutex> dlock(decode_lock);
+    std::lock_guard<std::mutex> lock(queue_lock);
+
+    // the packet which is taken but not decoded yet is dropped by the generation
+    generation++;
+
+    decode_queue.clear();
+    notifications.clear();
+    queued_size = 0;
+    queue_depth = 0;
+    max_queue_depth = 0;
+    use_worker = false;
+    end_pending = false;
+}
+
+bool TTSPlayerPrivate::pushPacket(const char* data, int size, bool is_end)
+{
+    startWorker();
+
+    std::lock_guard<std::mutex> lock(queue_lock);
+
+    decode_queue.push_back({ generation, is_end, std::string(data ? data : "", size) });
+    queued_size += size;
+    queue_depth++;
+    use_worker = true;
+
+    if (queue_depth > max_queue_depth) {
+        std::string contents = "depth=" + std::to_string(queue_depth)
+            + ",size=" + std::to_string(queued_size);
+
+        max_queue_depth = queue_depth;
+        nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_DECODE_QUEUE, nullptr, nullptr, contents.c_str());
+    }
+
+    queue_cond.notify_all();
+
+    return true;
+}
+
+void TTSPlayerPrivate::decodeLoop()
+{
+    std::unique_lock<std::mutex> lock(queue_lock);
+
+    while (!quit) {
+        if (decode_queue.empty()) {
+            queue_cond.wait(lock);
+            continue;
+        }
+
+        // keep the decoded data within the lookahead window of the playback
+        if (!decode_queue.front().is_end
+            && nugu_pcm_get_data_size(player) > lookahead_size) {
+            queue_cond.wait_for(lock, std::chrono::milliseconds(DECODE_WAIT_MSEC));
+            continue;
+        }
+
+        DecodePacket packet = std::move(decode_queue.front());
+
+        decode_queue.pop_front();
+        queued_size -= packet.data.size();
+        queue_depth--;
+
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> dlock(decode_lock);
+
+            // clearQueue() holds the decode_lock to change the generation
+            if (packet.generation == generation) {
+                if (packet.is_end)
+                    nugu_pcm_push_data_done(player);
+                else
+                    decodePacket(packet.data.data(), packet.data.size());
+            }
+        }
+
+        lock.lock();
+
+        if (packet.generation != generation)
+            continue;
+
+        if (packet.is_end)
+            end_pending = true;
+
+        if (!event_src && (end_pending || (writable_pending && queued_size < DECODE_QUEUE_LIMIT)))
+            event_src = nugu_mainloop_idle_add(onDecodeEvent, this);
+    }
+}
+
+bool TTSPlayerPrivate::decodePacket(const char* data, size_t size)
+{
+    if (!cache_writer) {
+        // decode into the pcm buffer without the intermediate copy
+        if (nugu_decoder_play(decoder, (const void*)data, size) < 0) {
+            nugu_error("failed to decode %zd bytes", size);
+            return false;
+        }
+        return true;
+    }
+
+    size_t pcm_size = 0;
+    void* pcm = nugu_decoder_decode(decoder, (const void*)data, size, &pcm_size);
+
+    if (!pcm) {
+        nugu_error("failed to decode %zd bytes", size);
+        return false;
+    }
+
+    if (pcm_size > 0) {
+        nugu_pcm_push_data(player, (const char*)pcm, pcm_size, false);
+        appendCache(pcm, pcm_size);
+    }
+
+    free(pcm);
+
+    return true;
+}
+
+void TTSPlayerPrivate::handleDecodeEvents()
+{
+    bool notify_end = false;
+    bool notify_writable = false;
+    std::deque<MediaNotification> pending;
+    int max_depth;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_lock);
+
+        event_src = 0;
+        max_depth = max_queue_depth;
+
+        // drop the notifications emitted before the queue is cleared
+        for (const auto& notification : notifications)
+            if (notification.generation == generation)
+                pending.push_back(notification);
+        notifications.clear();
+
+        notify_end = end_pending;
+        end_pending = false;
+
+        if (writable_pending && queued_size < DECODE_QUEUE_LIMIT) {
+            writable_pending = false;
+            notify_writable = true;
+        }
+    }
+
+    for (const auto& notification : pending) {
+        if (notification.is_status)
+            handleStatus((enum nugu_media_status)notification.value);
+        else
+            handleEvent((enum nugu_media_event)notification.value);
+    }
+
+    if (notify_end) {
+        std::string contents = "max_depth=" + std::to_string(max_depth);
+
+        nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_LAST_DECODING, nullptr, nullptr, contents.c_str());
+        owner->setDuration(nugu_pcm_get_duration(player));
+        finishStream();
+    }
+
+    if (notify_writable && writable_callback)
+        writable_callback();
+}
+
+void TTSPlayerPrivate::handleStatus(enum nugu_media_status status)
+{
+    switch (status) {
+    case NUGU_MEDIA_STATUS_STOPPED:
+        owner->setState(MediaPlayerState::STOPPED);
+        break;
+    case NUGU_MEDIA_STATUS_READY:
+        owner->setState(MediaPlayerState::READY);
+        break;
+    case NUGU_MEDIA_STATUS_PLAYING:
+        owner->setState(MediaPlayerState::PLAYING);
+        break;
+    case NUGU_MEDIA_STATUS_PAUSED:
+        owner->setState(MediaPlayerState::PAUSED);
+        break;
+    default:
+        owner->setState(MediaPlayerState::STOPPED);
+        break;
+    }
+}
+
+void TTSPlayerPrivate::handleEvent(enum nugu_media_event event)
+{
+    switch (event) {
+    case NUGU_MEDIA_EVENT_MEDIA_SOURCE_CHANGED:
+        break;
+    case NUGU_MEDIA_EVENT_MEDIA_INVALID:
+        break;
+    case NUGU_MEDIA_EVENT_MEDIA_LOAD_FAILED:
+        for (auto l : listeners)
+            l->mediaEventReport(MediaPlayerEvent::LOADING_MEDIA_FAILED);
+        break;
+    case NUGU_MEDIA_EVENT_MEDIA_LOADED:
+        for (auto l : listeners)
+            l->mediaEventReport(MediaPlayerEvent::LOADING_MEDIA_SUCCESS);
+        break;
+    case NUGU_MEDIA_EVENT_END_OF_STREAM:
+        state = MediaPlayerState::STOPPED;
+        for (auto l : listeners)
+            l->mediaEventReport(MediaPlayerEvent::PLAYING_MEDIA_FINISHED);
+        break;
+    default:
+        break;
+    }
+}
+
+void TTSPlayerPrivate::startStream()
+{
+    size_t threshold = 0;
+
+    if (jitter) {
+        nugu_jitter_begin(jitter);
+        threshold = (size_t)nugu_jitter_get_threshold(jitter) * MEDIA_SAMPLERATE_22K * 2 / 1000;
+    }
+
+    // the decoder can't buffer more than the lookahead
+    nugu_pcm_set_start_threshold(player, std::min(threshold, lookahead_size));
+}
+
+void TTSPlayerPrivate::finishStream()
+{
+    struct nugu_jitter_stats stats;
+    int duration;
+
+    {
+        std::lock_guard<std::mutex> lock(decode_lock);
+
+        if (cache_writer) {
+            nugu_cache_writer_commit(cache_writer);
+            cache_writer = nullptr;
+        }
+    }
+
+    if (!jitter)
+        return;
+
+    duration = (int)(nugu_pcm_get_total_size(player) * 1000 / (MEDIA_SAMPLERATE_22K * 2));
+    nugu_jitter_end(jitter, duration, nugu_pcm_get_underrun_count(player),
+        nugu_pcm_get_start_latency(player));
+
+    nugu_jitter_get_stats(jitter, &stats);
+    nugu_dbg("jitter buffer: threshold %d msec, underruns %u (%u/%u streams), added latency %lu msec",
+        stats.threshold, stats.underruns, stats.underrun_streams, stats.streams, stats.added_latency);
+}
+
+void TTSPlayerPrivate::abortCache()
+{
+    std::lock_guard<std::mutex> lock(decode_lock);
+
+    if (cache_writer) {
+        nugu_cache_writer_abort(cache_writer);
+        cache_writer = nullptr;
+    }
+
+    cache_hit = false;
+}
+
+// called with the decode_lock
+void TTSPlayerPrivate::appendCache(const void* data, size_t size)
+{
+    if (!cache_writer)
+        return;
+
+    // give up caching the audio which exceeds the cache size
+    if (nugu_cache_writer_append(cache_writer, data, size) < 0) {
+        nugu_cache_writer_abort(cache_writer);
+        cache_writer = nullptr;
+    }
+}
+
+void TTSPlayerPrivate::markCacheStats(enum nugu_prof_type type)
+{
+    struct nugu_cache_stats stats;
+    unsigned int lookups;
+    char contents[128];
+
+    nugu_cache_get_stats(cache, &stats);
+
+    lookups = stats.hits + stats.misses;
+    snprintf(contents, sizeof(contents), "hits=%u,misses=%u,hit_rate=%u%%,saved=%zd",
+        stats.hits, stats.misses, lookups ? stats.hits * 100 / lookups : 0, stats.hit_bytes);
+
+    nugu_prof_mark_data(type, nullptr, nullptr, contents);
+}
+
+int TTSPlayerPrivate::onDecodeEvent(void* userdata)
+{
+    static_cast<TTSPlayerPrivate*>(userdata)->handleDecodeEvents();
+
+    return 0;
+}
 
 TTSPlayer::TTSPlayer(int volume)
     : d(new TTSPlayerPrivate(volume))
@@ -83,6 +532,38 @@ TTSPlayer::TTSPlayer(int volume)
     d->player_name = MEDIA_PLAYER_NAME + std::to_string(uniq_id++);
     nugu_dbg("player's name: %s", d->player_name.c_str());
 
+    d->owner = this;
+
+#ifdef NUGU_ENV_TTS_DECODE_LOOKAHEAD
+    const char* lookahead = getenv(NUGU_ENV_TTS_DECODE_LOOKAHEAD);
+    if (lookahead && atoi(lookahead) > 0)
+        d->lookahead_size = (size_t)atoi(lookahead) * MEDIA_SAMPLERATE_22K * 2 / 1000;
+#endif
+
+    bool use_jitter = true;
+#ifdef NUGU_ENV_TTS_JITTER_BUFFER
+    const char* jitter_buffer = getenv(NUGU_ENV_TTS_JITTER_BUFFER);
+    if (jitter_buffer && !strcmp(jitter_buffer, "0"))
+        use_jitter = false;
+#endif
+    if (use_jitter)
+        d->jitter = nugu_jitter_new(JITTER_TARGET_UNDERRUN_RATE, JITTER_MAX_THRESHOLD_MSEC);
+
+#ifdef NUGU_ENV_TTS_CACHE_PATH
+    const char* cache_path = getenv(NUGU_ENV_TTS_CACHE_PATH);
+    if (cache_path && !d->cache) {
+        size_t cache_size = CACHE_MAX_SIZE_KB;
+#ifdef NUGU_ENV_TTS_CACHE_SIZE
+        const char* size_str = getenv(NUGU_ENV_TTS_CACHE_SIZE);
+        if (size_str && atoi(size_str) > 0)
+            cache_size = (size_t)atoi(size_str);
+#endif
+        d->cache = nugu_cache_new(cache_path, cache_size * 1024);
+    }
+#endif
+    if (d->cache)
+        d->cache_refs++;
+
     d->player = nugu_pcm_new(d->player_name.c_str(), nugu_pcm_driver_get_default(),
         { NUGU_AUDIO_SAMPLE_RATE_22K, NUGU_AUDIO_FORMAT_S16_LE, 1 });
     if (!d->player) {
@@ -95,24 +576,12 @@ TTSPlayer::TTSPlayer(int volume)
 
     NuguMediaStatusCallback scb = [](enum nugu_media_status status, void* userdata) {
         TTSPlayer* tplayer = static_cast<TTSPlayer*>(userdata);
+        TTSPlayerPrivate* d = tplayer->d;
 
-        switch (status) {
-        case NUGU_MEDIA_STATUS_STOPPED:
-            tplayer->setState(MediaPlayerState::STOPPED);
-            break;
-        case NUGU_MEDIA_STATUS_READY:
-            tplayer->setState(MediaPlayerState::READY);
-            break;
-        case NUGU_MEDIA_STATUS_PLAYING:
-            tplayer->setState(MediaPlayerState::PLAYING);
-            break;
-        case NUGU_MEDIA_STATUS_PAUSED:
-            tplayer->setState(MediaPlayerState::PAUSED);
-            break;
-        default:
-            tplayer->setState(MediaPlayerState::STOPPED);
-            break;
-        }
+        if (d->deferNotification(true, status))
+            return;
+
+        d->handleStatus(status);
     };
     nugu_pcm_set_status_callback(d->player, scb, this);
 
@@ -128,27 +597,10 @@ TTSPlayer::TTSPlayer(int volume)
         if (!player)
             return;
 
-        switch (event) {
-        case NUGU_MEDIA_EVENT_MEDIA_SOURCE_CHANGED:
-            break;
-        case NUGU_MEDIA_EVENT_MEDIA_INVALID:
-            break;
-        case NUGU_MEDIA_EVENT_MEDIA_LOAD_FAILED:
-            for (auto l : d->listeners)
-                l->mediaEventReport(MediaPlayerEvent::LOADING_MEDIA_FAILED);
-            break;
-        case NUGU_MEDIA_EVENT_MEDIA_LOADED:
-            for (auto l : d->listeners)
-                l->mediaEventReport(MediaPlayerEvent::LOADING_MEDIA_SUCCESS);
-            break;
-        case NUGU_MEDIA_EVENT_END_OF_STREAM:
-            d->state = MediaPlayerState::STOPPED;
-            for (auto l : d->listeners)
-                l->mediaEventReport(MediaPlayerEvent::PLAYING_MEDIA_FINISHED);
-            break;
-        default:
-            break;
-        }
+        if (d->deferNotification(false, event))
+            return;
+
+        d->handleEvent(event);
     };
     nugu_pcm_set_event_callback(d->player, ecb, this);
 
@@ -169,6 +621,14 @@ TTSPlayer::~TTSPlayer()
 {
     d->listeners.clear();
 
+    d->stopWorker();
+    d->clearQueue();
+
+    if (d->event_src) {
+        nugu_mainloop_source_remove(d->event_src);
+        d->event_src = 0;
+    }
+
     if (d->player) {
         nugu_pcm_set_status_callback(d->player, nullptr, nullptr);
         nugu_pcm_set_event_callback(d->player, nullptr, nullptr);
@@ -188,6 +648,17 @@ TTSPlayer::~TTSPlayer()
         d->pos_timer = nullptr;
     }
 
+    if (d->jitter) {
+        nugu_jitter_free(d->jitter);
+        d->jitter = nullptr;
+    }
+
+    d->abortCache();
+    if (d->cache && --d->cache_refs == 0) {
+        nugu_cache_free(d->cache);
+        d->cache = nullptr;
+    }
+
     d->mp_map.erase(this);
     delete d;
 }
@@ -211,43 +682,120 @@ void TTSPlayer::setAudioAttribute(NuguAudioAttribute attr)
 
 bool TTSPlayer::writeAudio(const char* data, int size)
 {
-    unsigned char* dbuf;
-    size_t dsize;
-    bool ret = true;
-
-    dbuf = (unsigned char*)nugu_decoder_decode(d->decoder, (const void*)data, size, &dsize);
-
-    if (d->seek_size) {
-        if (d->seek_size >= dsize) {
-            nugu_dbg("seek pcm audio => %d/%d", dsize, d->seek_size);
-            d->seek_size -= dsize;
-            dsize = 0;
-        } else {
-            nugu_dbg("seek pcm audio => %d/%d", dsize, d->seek_size);
-            dsize -= d->seek_size;
-            d->seek_size = 0;
-        }
-    }
+    return writeReceivedAudio(data, size, g_get_monotonic_time() / 1000);
+}
+
+bool TTSPlayer::writeReceivedAudio(const char* data, int size, int64_t received_msec)
+{
+    NuguSpanScope span("TTSPlayer::writeAudio");
+    bool ret;
 
-    nugu_dbg("opus %d bytes -> pcm %d bytes", size, dsize);
+    if (!data || size <= 0)
+        return false;
+
+    // the cached audio is already written
+    if (d->cache_hit)
+        return true;
 
     if (d->count == 0)
-        nugu_prof_mark(NUGU_PROF_TYPE_TTS_FIRST_DECODING);
+        d->startStream();
+
+    if (d->jitter)
+        nugu_jitter_add_arrival(d->jitter, received_msec, size);
 
-    d->count++;
+    if (d->count++ > 0) {
+        // decode on the worker thread ahead of the playback
+        nugu_dbg("queue opus %d bytes", size);
+        return d->pushPacket(data, size, false);
+    }
 
-    if (dsize)
-        ret = (nugu_pcm_push_data(d->player, (const char*)dbuf, dsize, false) >= 0);
+    // decode the first packet inline to keep the first audio latency low
+    {
+        std::lock_guard<std::mutex> lock(d->decode_lock);
+        ret = d->decodePacket(data, size);
+    }
 
-    free(dbuf);
+    nugu_dbg("opus %d bytes decoded inline", size);
+    nugu_prof_mark(NUGU_PROF_TYPE_TTS_FIRST_DECODING);
 
     return ret;
 }
 
 void TTSPlayer::writeDone()
 {
+    if (d->cache_hit)
+        return;
+
+    if (d->use_worker) {
+        // the worker passes the end after the remaining packets
+        d->pushPacket(nullptr, 0, true);
+        return;
+    }
+
+    nugu_pcm_push_data_done(d->player);
+    setDuration(nugu_pcm_get_duration(d->player));
+    d->finishStream();
+}
+
+bool TTSPlayer::setCacheKey(const std::string& key)
+{
+    NuguCacheEntry* entry;
+    const void* data;
+    size_t size = 0;
+
+    d->abortCache();
+
+    if (!d->cache || key.empty())
+        return false;
+
+    // the cached audio can't replace the audio which is already written
+    if (d->count > 0) {
+        nugu_warn("the audio is already written");
+        return false;
+    }
+
+    entry = nugu_cache_lookup(d->cache, key.c_str());
+    if (!entry) {
+        // store the decoded audio of this stream
+        {
+            std::lock_guard<std::mutex> lock(d->decode_lock);
+            d->cache_writer = nugu_cache_writer_new(d->cache, key.c_str());
+        }
+
+        d->markCacheStats(NUGU_PROF_TYPE_TTS_CACHE_MISS);
+        return false;
+    }
+
+    data = nugu_cache_entry_peek_data(entry, &size);
+    nugu_dbg("play the cached audio(%zd bytes)", size);
+
+    nugu_pcm_push_data(d->player, (const char*)data, size, false);
+    nugu_cache_entry_free(entry);
+
     nugu_pcm_push_data_done(d->player);
     setDuration(nugu_pcm_get_duration(d->player));
+
+    d->cache_hit = true;
+    d->markCacheStats(NUGU_PROF_TYPE_TTS_CACHE_HIT);
+
+    return true;
+}
+
+bool TTSPlayer::isWritable()
+{
+    std::lock_guard<std::mutex> lock(d->queue_lock);
+
+    if (d->queued_size < DECODE_QUEUE_LIMIT)
+        return true;
+
+    d->writable_pending = true;
+
+    return false;
+}
+
+void TTSPlayer::setWritableCallback(std::function<void()> callback)
+{
+    d->writable_callback = std::move(callback);
 }
 
 bool TTSPlayer::setSource(const std::string& url)
@@ -268,7 +816,13 @@ bool TTSPlayer::play()
 
     d->pos_timer->restart();
 
-    return (nugu_pcm_start(d->player) >= 0);
+    bool ret = (nugu_pcm_start(d->player) >= 0);
+
+    // resume decoding the packets which are queued before the play
+    if (d->use_worker)
+        d->startWorker();
+
+    return ret;
 }
 
 bool TTSPlayer::stop()
@@ -278,6 +832,9 @@ bool TTSPlayer::stop()
 
     d->pos_timer->stop();
 
+    // the worker can't push the data to the pcm which is being stopped
+    d->stopWorker();
+
     return (nugu_pcm_stop(d->player) >= 0);
 }
 
@@ -307,7 +864,15 @@ bool TTSPlayer::seek(int sec)
         return false;
     }
 
-    d->seek_size = sec * MEDIA_SAMPLERATE_22K;
+    // the audio from the seek position is not cached
+    d->abortCache();
+
+    // the decoder drops the pcm data before the seek position
+    if (d->decoder) {
+        std::lock_guard<std::mutex> lock(d->decode_lock);
+        nugu_decoder_set_skip_size(d->decoder, sec * MEDIA_SAMPLERATE_22K);
+    }
+
     d->seek_time = sec;
     return true;
 }
@@ -486,8 +1051,16 @@ std::string TTSPlayer::url()
 void TTSPlayer::clearContent()
 {
     d->position = d->duration = 0;
-    d->seek_time = d->seek_size = 0;
+    d->seek_time = 0;
     d->count = 0;
+
+    d->clearQueue();
+    d->abortCache();
+
+    if (d->decoder) {
+        std::lock_guard<std::mutex> lock(d->decode_lock);
+        nugu_decoder_set_skip_size(d->decoder, 0);
+    }
 }
 
 void TTSPlayer::StopB4Start()
@@ -496,6 +1069,9 @@ void TTSPlayer::StopB4Start()
     MediaPlayerState prev_state = state();
 
     d->state = MediaPlayerState::STOPPED;
+
+    // the worker can't push the data to the pcm which is being stopped
+    d->stopWorker();
     nugu_pcm_stop(d->player);
     d->state = prev_state;
 }
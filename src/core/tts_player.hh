@@ -36,7 +36,11 @@ public:
     void removeListener(IMediaPlayerListener* listener) override;
 
     bool writeAudio(const char *data, int size) override;
+    bool writeReceivedAudio(const char *data, int size, int64_t received_msec) override;
     void writeDone() override;
+    bool isWritable() override;
+    void setWritableCallback(std::function<void()> callback) override;
+    bool setCacheKey(const std::string& key) override;
 
     void setAudioAttribute(NuguAudioAttribute attr) override;
     bool setSource(const std::string& url) override;
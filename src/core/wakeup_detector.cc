@@ -53,13 +53,16 @@ void WakeupDetector::sendWakeupEvent(WakeupState state, const std::string& id, f
         return;
 
     mutex.lock();
-    AudioInputProcessor::sendEvent([=] {
-        if (listener)
-            listener->onWakeupState(state, id, noise, speech);
-    });
+    AudioInputProcessor::sendEvent(static_cast<int>(state), id, noise, speech);
     mutex.unlock();
 }
 
+void WakeupDetector::dispatchEvent(const AudioInputEvent& event)
+{
+    if (listener)
+        listener->onWakeupState(static_cast<WakeupState>(event.state), event.id, event.noise, event.speech);
+}
+
 void WakeupDetector::setListener(IWakeupDetectorListener* listener)
 {
     this->listener = listener;
@@ -307,10 +310,14 @@ void WakeupDetector::setModelFile(const std::string& model_net_file, const std::
 void WakeupDetector::preloadModelFile()
 {
 #ifdef ENABLE_VENDOR_LIBRARY
+    nugu_prof_mark(NUGU_PROF_TYPE_SDK_MODEL_LOAD_START);
+
     if (kwd_initialize(model_net_file.c_str(), model_search_file.c_str()) < 0)
         nugu_error("kwd_initialize() failed");
 
     kwd_deinitialize();
+
+    nugu_prof_mark(NUGU_PROF_TYPE_SDK_MODEL_LOAD_DONE);
 #endif
 }
 
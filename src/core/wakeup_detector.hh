@@ -63,6 +63,7 @@ public:
 private:
     void initialize(Attribute&& attribute);
     void loop() override;
+    void dispatchEvent(const AudioInputEvent& event) override;
     void sendWakeupEvent(WakeupState state, const std::string& id, float noise = 0, float speech = 0);
     void setPower(float power);
     void getPower(float& noise, float& speech);
@@ -16,13 +16,34 @@
 
 #include <glib.h>
 #include <memory>
-
+#include <string.h>
+
+#include "capability/asr_interface.hh"
+#include "capability/audio_player_interface.hh"
+#include "capability/bluetooth_interface.hh"
+#include "capability/chips_interface.hh"
+#include "capability/display_interface.hh"
+#include "capability/extension_interface.hh"
+#include "capability/message_interface.hh"
+#include "capability/mic_interface.hh"
+#include "capability/phone_call_interface.hh"
+#include "capability/routine_interface.hh"
+#include "capability/session_interface.hh"
+#include "capability/sound_interface.hh"
+#include "capability/speaker_interface.hh"
+#include "capability/system_interface.hh"
+#include "capability/text_interface.hh"
+#include "capability/tts_interface.hh"
+#include "capability/utility_interface.hh"
+#include "capability/capability_factory.hh"
 #include "clientkit/capability.hh"
 #include "clientkit/nugu_client.hh"
 
 using namespace NuguClientKit;
+using namespace NuguCapability;
 
 static const char* NAMESPACE = "Fake";
+static const char* DISPATCH_NAMESPACE = "Dispatch";
 
 class FakeAgent final : public Capability,
                         public IDirectiveSequencerListener {
@@ -69,6 +90,47 @@ private:
     bool is_destroy_directive_by_agent = true;
 };
 
+// agent which handles the directives by the default parsingDirective()
+class DispatchAgent final : public Capability,
+                            public IDirectiveSequencerListener {
+public:
+    DispatchAgent()
+        : Capability(DISPATCH_NAMESPACE, "1.0")
+    {
+        addDirectiveHandler("Speak", [&](const char* message) {
+            handled.emplace_back(std::string("Speak:") + message);
+        });
+        addDirectiveHandler("Stop", [&](const char* message) {
+            handled.emplace_back(std::string("Stop:") + message);
+        });
+    }
+
+    void updateInfoForContext(NJson::Value& ctx) override { }
+
+    void updateCompactContext(NJson::Value& ctx) override { }
+
+    void onCancelDirective(NuguDirective* ndir) override { }
+
+    bool onPreHandleDirective(NuguDirective* ndir) override
+    {
+        return false;
+    }
+
+    bool onHandleDirective(NuguDirective* ndir) override
+    {
+        processDirective(ndir);
+
+        return true;
+    }
+
+    std::string getContextInfo() override
+    {
+        return "";
+    }
+
+    std::vector<std::string> handled;
+};
+
 using TestFixture = struct _TestFixture {
     std::unique_ptr<NuguClient> nugu_client;
     std::unique_ptr<FakeAgent> agent;
@@ -159,6 +221,172 @@ static void test_capability_handle_multiple_dialogs_as_hold(TestFixture* fixture
     fixture->agent->destroyDirective(fixture->ndir_second);
 }
 
+static void test_capability_dispatch_directive(TestFixture* fixture, gconstpointer ignored)
+{
+    std::string handled;
+
+    fixture->agent->addDirectiveHandler("Speak", [&](const char* message) { handled = std::string("Speak:") + message; });
+    fixture->agent->addDirectiveHandler("Stop", [&](const char* message) { handled = std::string("Stop:") + message; });
+
+    g_assert(fixture->agent->dispatchDirective("Speak", "{}"));
+    g_assert(handled == "Speak:{}");
+
+    g_assert(fixture->agent->dispatchDirective("Stop", "{}"));
+    g_assert(handled == "Stop:{}");
+
+    // not registered or partially matched directive name
+    handled.clear();
+    g_assert(!fixture->agent->dispatchDirective("Play", "{}"));
+    g_assert(!fixture->agent->dispatchDirective("Spea", "{}"));
+    g_assert(!fixture->agent->dispatchDirective("", "{}"));
+    g_assert(!fixture->agent->dispatchDirective(nullptr, "{}"));
+    g_assert(handled.empty());
+
+    // overwrite the handler of same directive name
+    fixture->agent->addDirectiveHandler("Stop", [&](const char* message) { handled = "NewStop"; });
+    g_assert(fixture->agent->dispatchDirective("Stop", "{}"));
+    g_assert(handled == "NewStop");
+}
+
+static void test_capability_dispatch_received_directive(TestFixture* fixture, gconstpointer ignored)
+{
+    std::unique_ptr<DispatchAgent> agent(new DispatchAgent());
+
+    agent->setNuguCoreContainer(fixture->nugu_client->getNuguCoreContainer());
+    fixture->dir_seq->addListener(DISPATCH_NAMESPACE, agent.get());
+
+    // the received directive reaches its handler with the payload
+    g_assert(fixture->dir_seq->add(nugu_directive_new(DISPATCH_NAMESPACE, "Speak", "1.0", "msg_1", "dlg_1", "ref_1", "{\"token\":\"1\"}", "[]")));
+    g_assert_cmpuint(agent->handled.size(), ==, 1);
+    g_assert(agent->handled[0] == "Speak:{\"token\":\"1\"}");
+
+    // the directive is completed after the handler returns
+    g_assert(!agent->getNuguDirective());
+
+    g_assert(fixture->dir_seq->add(nugu_directive_new(DISPATCH_NAMESPACE, "Stop", "1.0", "msg_2", "dlg_1", "ref_1", "{}", "[]")));
+    g_assert_cmpuint(agent->handled.size(), ==, 2);
+    g_assert(agent->handled[1] == "Stop:{}");
+
+    // the directive without the handler is completed without the dispatch
+    g_assert(fixture->dir_seq->add(nugu_directive_new(DISPATCH_NAMESPACE, "Play", "1.0", "msg_3", "dlg_1", "ref_1", "{}", "[]")));
+    g_assert_cmpuint(agent->handled.size(), ==, 2);
+    g_assert(!agent->getNuguDirective());
+
+    fixture->dir_seq->removeListener(DISPATCH_NAMESPACE, agent.get());
+}
+
+/* directive names which are added to the dispatch table of the built-in capability agents */
+template <typename T, typename V>
+static void collect_directive_names(std::vector<std::vector<std::string>>& builtin_directives)
+{
+    Capability* agent = dynamic_cast<Capability*>(CapabilityFactory::makeCapability<T, V>());
+
+    g_assert(agent != nullptr);
+    builtin_directives.emplace_back(agent->getDirectiveNames());
+
+    delete agent;
+}
+
+static std::vector<std::vector<std::string>> get_builtin_directives()
+{
+    std::vector<std::vector<std::string>> builtin_directives;
+
+    collect_directive_names<ASRAgent, IASRHandler>(builtin_directives);
+    collect_directive_names<AudioPlayerAgent, IAudioPlayerHandler>(builtin_directives);
+    collect_directive_names<BluetoothAgent, IBluetoothHandler>(builtin_directives);
+    collect_directive_names<ChipsAgent, IChipsHandler>(builtin_directives);
+    collect_directive_names<DisplayAgent, IDisplayHandler>(builtin_directives);
+    collect_directive_names<ExtensionAgent, IExtensionHandler>(builtin_directives);
+    collect_directive_names<MessageAgent, IMessageHandler>(builtin_directives);
+    collect_directive_names<MicAgent, IMicHandler>(builtin_directives);
+    collect_directive_names<PhoneCallAgent, IPhoneCallHandler>(builtin_directives);
+    collect_directive_names<RoutineAgent, IRoutineHandler>(builtin_directives);
+    collect_directive_names<SessionAgent, ISessionHandler>(builtin_directives);
+    collect_directive_names<SoundAgent, ISoundHandler>(builtin_directives);
+    collect_directive_names<SpeakerAgent, ISpeakerHandler>(builtin_directives);
+    collect_directive_names<SystemAgent, ISystemHandler>(builtin_directives);
+    collect_directive_names<TextAgent, ITextHandler>(builtin_directives);
+    collect_directive_names<TTSAgent, ITTSHandler>(builtin_directives);
+    collect_directive_names<UtilityAgent, IUtilityHandler>(builtin_directives);
+
+    return builtin_directives;
+}
+
+static void test_capability_dispatch_builtin(TestFixture* fixture, gconstpointer ignored)
+{
+    for (const auto& dnames : get_builtin_directives()) {
+        std::unique_ptr<FakeAgent> agent(new FakeAgent());
+        std::string handled;
+
+        g_assert(!dnames.empty());
+
+        for (const auto& dname : dnames)
+            agent->addDirectiveHandler(dname, [&, dname](const char* message) { handled = dname; });
+
+        // every directive is routed to its own handler
+        for (const auto& dname : dnames) {
+            handled.clear();
+            g_assert(agent->dispatchDirective(dname.c_str(), "{}"));
+            g_assert(handled == dname);
+        }
+    }
+}
+
+#define DISPATCH_BENCHMARK_LOOP 100000
+
+static void test_capability_dispatch_benchmark(TestFixture* fixture, gconstpointer ignored)
+{
+    const auto builtin_directives = get_builtin_directives();
+    std::vector<std::unique_ptr<FakeAgent>> agents;
+    unsigned int count = 0;
+    unsigned int expected = 0;
+    GTimer* timer = g_timer_new();
+
+    for (const auto& dnames : builtin_directives) {
+        FakeAgent* agent = new FakeAgent();
+
+        for (const auto& dname : dnames)
+            agent->addDirectiveHandler(dname, [&](const char* message) { count++; });
+
+        agents.emplace_back(agent);
+    }
+
+    // strcmp chain which was used by parsingDirective() of each agent
+    g_timer_start(timer);
+    for (int loop = 0; loop < DISPATCH_BENCHMARK_LOOP; loop++) {
+        for (const auto& dnames : builtin_directives) {
+            for (const auto& dname : dnames) {
+                for (const auto& candidate : dnames) {
+                    if (!strcmp(dname.c_str(), candidate.c_str())) {
+                        count++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    g_timer_stop(timer);
+    g_test_message("strcmp chain: %f sec", g_timer_elapsed(timer, NULL));
+
+    expected = count;
+    count = 0;
+
+    // dispatch table
+    g_timer_start(timer);
+    for (int loop = 0; loop < DISPATCH_BENCHMARK_LOOP; loop++) {
+        for (size_t i = 0; i < builtin_directives.size(); i++) {
+            for (const auto& dname : builtin_directives[i])
+                agents[i]->dispatchDirective(dname.c_str(), "{}");
+        }
+    }
+    g_timer_stop(timer);
+    g_test_minimized_result(g_timer_elapsed(timer, NULL), "dispatch table: %f sec", g_timer_elapsed(timer, NULL));
+
+    g_assert(count == expected);
+
+    g_timer_destroy(timer);
+}
+
 #define G_TEST_ADD_FUNC(name, func) \
     g_test_add(name, TestFixture, nullptr, setup, func, teardown);
 
@@ -174,6 +402,12 @@ int main(int argc, char* argv[])
     G_TEST_ADD_FUNC("/clientkit/Capability/handleSingleDialog", test_capability_handle_single_dialog);
     G_TEST_ADD_FUNC("/clientkit/Capability/handleMultipleDialogsAsCancel", test_capability_handle_multiple_dialogs_as_cancel);
     G_TEST_ADD_FUNC("/clientkit/Capability/handleMultipleDialogsAsHold", test_capability_handle_multiple_dialogs_as_hold);
+    G_TEST_ADD_FUNC("/clientkit/Capability/dispatchDirective", test_capability_dispatch_directive);
+    G_TEST_ADD_FUNC("/clientkit/Capability/dispatchBuiltinDirectives", test_capability_dispatch_builtin);
+    G_TEST_ADD_FUNC("/clientkit/Capability/dispatchReceivedDirective", test_capability_dispatch_received_directive);
+
+    if (g_test_perf())
+        G_TEST_ADD_FUNC("/clientkit/Capability/dispatchBenchmark", test_capability_dispatch_benchmark);
 
     return g_test_run();
 }
@@ -314,6 +314,77 @@ static void test_nugu_runner_execute_multiple_method_on_anther_thread(nuguFixtur
     g_main_loop_run(loop);
 }
 
+#define STRESS_THREADS 8
+#define STRESS_INVOKES 1000
+
+typedef struct _stressData {
+    TestExecutor* executor;
+    GMainLoop* loop;
+    gint* running;
+    gint64 elapsed;
+    gint64 max_latency;
+} stressData;
+
+static void* _invoke_method_stress_on_another_thread(gpointer userdata)
+{
+    stressData* data = (stressData*)userdata;
+
+    for (int i = 0; i < STRESS_INVOKES; i++) {
+        int executed = 0;
+        gint64 start = g_get_monotonic_time();
+
+        g_assert(data->executor->invokeMethod(
+            __func__, [&]() {
+                executed = i;
+            },
+            ExecuteType::Blocking));
+
+        gint64 latency = g_get_monotonic_time() - start;
+
+        // the caller should be released by its own method
+        g_assert(executed == i);
+
+        data->elapsed += latency;
+        if (latency > data->max_latency)
+            data->max_latency = latency;
+    }
+
+    if (g_atomic_int_dec_and_test(data->running))
+        g_main_loop_quit(data->loop);
+
+    return NULL;
+}
+
+static void test_nugu_runner_invoke_method_stress(nuguFixture* fixture, gconstpointer ignored)
+{
+    TestExecutor test_executor;
+    stressData data[STRESS_THREADS];
+    pthread_t tid[STRESS_THREADS];
+    gint running = STRESS_THREADS;
+    gint64 elapsed = 0;
+    gint64 max_latency = 0;
+
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        data[i] = { &test_executor, fixture->loop, &running, 0, 0 };
+        pthread_create(&tid[i], NULL, _invoke_method_stress_on_another_thread, (gpointer)&data[i]);
+    }
+
+    g_main_loop_run(fixture->loop);
+
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(tid[i], NULL);
+
+        elapsed += data[i].elapsed;
+        if (data[i].max_latency > max_latency)
+            max_latency = data[i].max_latency;
+    }
+
+    g_test_message("max invoke latency: %" G_GINT64_FORMAT " usec", max_latency);
+    g_test_minimized_result((double)elapsed / (STRESS_THREADS * STRESS_INVOKES),
+        "average invoke latency: %.2f usec (%d threads x %d calls)",
+        (double)elapsed / (STRESS_THREADS * STRESS_INVOKES), STRESS_THREADS, STRESS_INVOKES);
+}
+
 int main(int argc, char* argv[])
 {
 #if !GLIB_CHECK_VERSION(2, 36, 0)
@@ -329,6 +400,9 @@ int main(int argc, char* argv[])
     G_TEST_ADD_FUNC("/app/NuguRunnerExecuteMethodReturnType", test_nugu_runner_execute_method_return_type);
     G_TEST_ADD_FUNC("/app/NuguRunnerExecuteMultipleMethodOnAnotherThread", test_nugu_runner_execute_multiple_method_on_anther_thread);
 
+    if (g_test_perf())
+        G_TEST_ADD_FUNC("/app/NuguRunnerInvokeMethodStress", test_nugu_runner_invoke_method_stress);
+
     if (getenv("UNIT_TEST_ONLY_LOCAL") != NULL)
         G_TEST_ADD_FUNC("/app/NuguRunnerExecuteMethodBlockingOnAnotherThread", test_nugu_runner_execute_method_blocking_on_another_thread);
 
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "base/nugu_mainloop.h"
+#include "audio_input_processor.hh"
+
+using namespace NuguCore;
+
+#define TEST_EVENT_COUNT 10
+#define TEST_DROP_COUNT 5
+
+class TestProcessor : public AudioInputProcessor {
+public:
+    TestProcessor()
+    {
+        std::string sample = "16k";
+        std::string format = "s16le";
+        std::string channel = "1";
+
+        init("test", sample, format, channel);
+    }
+
+    bool send(int state, const std::string& id, float noise = 0, float speech = 0)
+    {
+        return sendEvent(state, id, noise, speech);
+    }
+
+    unsigned int getDropped()
+    {
+        return getDroppedEventCount();
+    }
+
+    std::vector<AudioInputEvent> events;
+    std::vector<GThread*> threads;
+
+private:
+    void loop() override
+    {
+        mutex.lock();
+        thread_created = true;
+        cond.notify_all();
+        mutex.unlock();
+
+        while (g_atomic_int_get(&destroy) == 0) {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    void dispatchEvent(const AudioInputEvent& event) override
+    {
+        events.push_back(event);
+        threads.push_back(g_thread_self());
+    }
+};
+
+static void drain_mainloop(void)
+{
+    while (g_main_context_iteration((GMainContext*)nugu_mainloop_get_context(), FALSE))
+        ;
+}
+
+static gboolean on_default_source(gpointer userdata)
+{
+    TestProcessor* processor = static_cast<TestProcessor*>(userdata);
+
+    // the audio input events are dispatched after the default sources
+    g_assert(processor->events.empty());
+
+    return FALSE;
+}
+
+static void test_audio_input_processor_handoff(void)
+{
+    TestProcessor processor;
+    GThread* main_thread = g_thread_self();
+
+    std::thread sender([&] {
+        for (int i = 0; i < TEST_EVENT_COUNT; i++) {
+            std::string id = "id_" + std::to_string(i);
+
+            g_assert(processor.send(i, id, (float)i, (float)i * 2) == true);
+        }
+    });
+    sender.join();
+
+    // not dispatched until the main context runs
+    g_assert(processor.events.empty());
+
+    GSource* source = g_idle_source_new();
+    g_source_set_priority(source, G_PRIORITY_DEFAULT);
+    g_source_set_callback(source, on_default_source, &processor, NULL);
+    g_source_attach(source, (GMainContext*)nugu_mainloop_get_context());
+    g_source_unref(source);
+
+    drain_mainloop();
+
+    // the events are passed in order on the main context
+    g_assert_cmpuint(processor.events.size(), ==, TEST_EVENT_COUNT);
+
+    for (int i = 0; i < TEST_EVENT_COUNT; i++) {
+        std::string id = "id_" + std::to_string(i);
+        const AudioInputEvent& event = processor.events[i];
+
+        g_assert_cmpint(event.state, ==, i);
+        g_assert_cmpstr(event.id, ==, id.c_str());
+        g_assert(event.noise == (float)i);
+        g_assert(event.speech == (float)i * 2);
+        g_assert(processor.threads[i] == main_thread);
+    }
+
+    g_assert_cmpuint(processor.getDropped(), ==, 0);
+}
+
+static void test_audio_input_processor_drop(void)
+{
+    TestProcessor processor;
+    int total = AUDIO_INPUT_EVENT_RING_SIZE + TEST_DROP_COUNT;
+    int i;
+
+    // the events over the ring size are dropped and counted
+    for (i = 0; i < total; i++)
+        g_assert(processor.send(i, "id") == (i < AUDIO_INPUT_EVENT_RING_SIZE));
+
+    g_assert_cmpuint(processor.getDropped(), ==, TEST_DROP_COUNT);
+
+    drain_mainloop();
+
+    g_assert_cmpuint(processor.events.size(), ==, AUDIO_INPUT_EVENT_RING_SIZE);
+    for (i = 0; i < AUDIO_INPUT_EVENT_RING_SIZE; i++)
+        g_assert_cmpint(processor.events[i].state, ==, i);
+
+    // the ring accepts the event again after the dispatch
+    g_assert(processor.send(total, "id") == true);
+    drain_mainloop();
+
+    g_assert_cmpuint(processor.events.size(), ==, AUDIO_INPUT_EVENT_RING_SIZE + 1);
+    g_assert_cmpint(processor.events.back().state, ==, total);
+    g_assert_cmpuint(processor.getDropped(), ==, TEST_DROP_COUNT);
+}
+
+int main(int argc, char* argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+    g_type_init();
+#endif
+
+    g_test_init(&argc, &argv, (void*)NULL);
+    g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+    g_test_add_func("/core/AudioInputProcessor/Handoff", test_audio_input_processor_handoff);
+    g_test_add_func("/core/AudioInputProcessor/Drop", test_audio_input_processor_drop);
+
+    return g_test_run();
+}
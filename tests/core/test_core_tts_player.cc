@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include "base/nugu_decoder.h"
+#include "base/nugu_pcm.h"
+#include "tts_player.hh"
+
+// 100 msec of 22050Hz S16_LE mono
+#define TEST_FRAME_SIZE 4410
+// default lookahead(2000 msec) of the TTSPlayer
+#define TEST_LOOKAHEAD_SIZE (20 * TEST_FRAME_SIZE)
+#define TEST_PACKET_SIZE 4096
+#define TEST_WAIT_MSEC 3000
+
+using namespace NuguCore;
+
+typedef struct _ttsPlayerFixture {
+    NuguPcmDriver* pcm_driver;
+    NuguDecoderDriver* decoder_driver;
+    TTSPlayer* player;
+} ttsPlayerFixture;
+
+static NuguPcm* test_pcm;
+static GThread* main_thread;
+static int decoded_count;
+static int worker_decoded_count;
+
+class TTSPlayerListener : public IMediaPlayerListener {
+public:
+    void mediaStateChanged(MediaPlayerState state) override
+    {
+        if (state == MediaPlayerState::PLAYING)
+            playing_thread = g_thread_self();
+    }
+    void mediaEventReport(MediaPlayerEvent event) override
+    {
+        if (event == MediaPlayerEvent::PLAYING_MEDIA_FINISHED)
+            finished_thread = g_thread_self();
+    }
+    void mediaChanged(const std::string& url) override
+    {
+    }
+    void durationChanged(int duration) override
+    {
+    }
+    void positionChanged(int position) override
+    {
+    }
+    void volumeChanged(int volume) override
+    {
+    }
+    void muteChanged(int mute) override
+    {
+    }
+
+    GThread* playing_thread = nullptr;
+    GThread* finished_thread = nullptr;
+};
+
+static int pcm_create(NuguPcmDriver* driver, NuguPcm* pcm, NuguAudioProperty property)
+{
+    test_pcm = pcm;
+    return 0;
+}
+
+static void pcm_destroy(NuguPcmDriver* driver, NuguPcm* pcm)
+{
+    test_pcm = NULL;
+}
+
+static int pcm_dummy(NuguPcmDriver* driver, NuguPcm* pcm)
+{
+    return 0;
+}
+
+static int pcm_set_volume(NuguPcmDriver* driver, NuguPcm* pcm, int volume)
+{
+    return 0;
+}
+
+static int pcm_get_position(NuguPcmDriver* driver, NuguPcm* pcm)
+{
+    return 0;
+}
+
+/* emit the status and the event like the portaudio and gstreamer drivers */
+static int pcm_push_data(NuguPcmDriver* driver, NuguPcm* pcm, const char* data,
+    size_t size, int is_last)
+{
+    if (is_last)
+        nugu_pcm_emit_event(pcm, NUGU_MEDIA_EVENT_END_OF_STREAM);
+    else if (nugu_pcm_get_data_size(pcm) >= 3 * TEST_FRAME_SIZE)
+        nugu_pcm_emit_status(pcm, NUGU_MEDIA_STATUS_PLAYING);
+
+    return 0;
+}
+
+static struct nugu_pcm_driver_ops pcm_ops = {
+    pcm_create, /* create */
+    pcm_destroy, /* destroy */
+    pcm_dummy, /* start */
+    pcm_push_data, /* push_data */
+    pcm_dummy, /* stop */
+    pcm_dummy, /* pause */
+    pcm_dummy, /* resume */
+    pcm_set_volume, /* set_volume */
+    pcm_get_position /* get_position */
+};
+
+static int decoder_create(NuguDecoderDriver* driver, NuguDecoder* dec)
+{
+    return 0;
+}
+
+static int decoder_destroy(NuguDecoderDriver* driver, NuguDecoder* dec)
+{
+    return 0;
+}
+
+static void count_decoded(void)
+{
+    g_atomic_int_inc(&decoded_count);
+
+    if (g_thread_self() != main_thread)
+        g_atomic_int_inc(&worker_decoded_count);
+}
+
+static int decoder_decode(NuguDecoderDriver* driver, NuguDecoder* dec,
+    const void* data, size_t data_len, NuguBuffer* out_buf)
+{
+    char frame[TEST_FRAME_SIZE];
+
+    memset(frame, 0, sizeof(frame));
+    nugu_buffer_add(out_buf, frame, sizeof(frame));
+    count_decoded();
+
+    return 0;
+}
+
+/* decode directly into the pcm buffer */
+static int decoder_decode_to_sink(NuguDecoderDriver* driver, NuguDecoder* dec,
+    const void* data, size_t data_len)
+{
+    void* out = nugu_decoder_reserve_output(dec, TEST_FRAME_SIZE);
+
+    if (!out)
+        return -1;
+
+    memset(out, 0, TEST_FRAME_SIZE);
+    count_decoded();
+
+    return nugu_decoder_commit_output(dec, TEST_FRAME_SIZE);
+}
+
+static struct nugu_decoder_driver_ops decoder_ops = {
+    decoder_create, /* create */
+    decoder_decode, /* decode */
+    decoder_destroy, /* destroy */
+    decoder_decode_to_sink, /* decode_to_sink */
+    NULL /* reset */
+};
+
+static void setup(ttsPlayerFixture* fixture, gconstpointer user_data)
+{
+    main_thread = g_thread_self();
+    decoded_count = 0;
+    worker_decoded_count = 0;
+
+    fixture->pcm_driver = nugu_pcm_driver_new("test_pcm", &pcm_ops);
+    nugu_pcm_driver_register(fixture->pcm_driver);
+    nugu_pcm_driver_set_default(fixture->pcm_driver);
+
+    fixture->decoder_driver = nugu_decoder_driver_new("test_opus", NUGU_DECODER_TYPE_OPUS, &decoder_ops);
+    nugu_decoder_driver_register(fixture->decoder_driver);
+
+    fixture->player = new TTSPlayer();
+    g_assert(test_pcm != NULL);
+
+    fixture->player->setSource("attachment");
+}
+
+static void teardown(ttsPlayerFixture* fixture, gconstpointer user_data)
+{
+    delete fixture->player;
+
+    nugu_decoder_driver_remove(fixture->decoder_driver);
+    nugu_decoder_driver_free(fixture->decoder_driver);
+
+    nugu_pcm_driver_remove(fixture->pcm_driver);
+    nugu_pcm_driver_free(fixture->pcm_driver);
+}
+
+#define G_TEST_ADD_FUNC(name, func) \
+    g_test_add(name, ttsPlayerFixture, NULL, setup, func, teardown);
+
+/* run the main loop until the condition is met or timed out */
+#define WAIT_FOR(cond)                                                           \
+    {                                                                            \
+        gint64 limit = g_get_monotonic_time() + TEST_WAIT_MSEC * 1000;           \
+        while (!(cond) && g_get_monotonic_time() < limit) {                      \
+            if (!g_main_context_iteration(NULL, FALSE))                          \
+                g_usleep(1000);                                                  \
+        }                                                                        \
+    }
+
+static void write_packets(TTSPlayer* player, int count)
+{
+    char packet[TEST_PACKET_SIZE];
+
+    memset(packet, 0, sizeof(packet));
+
+    for (int i = 0; i < count; i++)
+        g_assert(player->writeAudio(packet, sizeof(packet)) == true);
+}
+
+static void test_ttsplayer_worker(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+
+    write_packets(player, 5);
+
+    // the first packet is decoded inline and the others on the worker
+    WAIT_FOR(g_atomic_int_get(&decoded_count) == 5);
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), ==, 5);
+    g_assert_cmpint(g_atomic_int_get(&worker_decoded_count), ==, 4);
+
+    // the worker decodes into the pcm without the main loop
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), ==, 5 * TEST_FRAME_SIZE);
+
+    // the end of stream is passed after the remaining packets
+    player->writeDone();
+    WAIT_FOR(player->duration() > 0);
+    g_assert(nugu_pcm_receive_is_last_data(test_pcm) == 1);
+    g_assert_cmpint(player->duration(), ==, nugu_pcm_get_duration(test_pcm));
+}
+
+static void test_ttsplayer_lookahead(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+    char buf[TEST_FRAME_SIZE];
+
+    write_packets(player, 40);
+
+    // the worker stops decoding over the lookahead of the playback
+    WAIT_FOR(nugu_pcm_get_data_size(test_pcm) > TEST_LOOKAHEAD_SIZE);
+    g_usleep(100 * 1000);
+
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), <, 40);
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), <=, TEST_LOOKAHEAD_SIZE + TEST_FRAME_SIZE);
+
+    // the playback makes the worker resume
+    while (g_atomic_int_get(&decoded_count) < 40) {
+        gint64 limit = g_get_monotonic_time() + TEST_WAIT_MSEC * 1000;
+
+        while (nugu_pcm_get_data_size(test_pcm) == 0 && g_get_monotonic_time() < limit)
+            g_usleep(1000);
+
+        g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), >, 0);
+        nugu_pcm_get_data(test_pcm, buf, sizeof(buf));
+    }
+
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), ==, 40);
+}
+
+static void test_ttsplayer_writable(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+    char buf[TEST_FRAME_SIZE];
+    int notified = 0;
+
+    player->setWritableCallback([&]() {
+        notified++;
+    });
+
+    g_assert(player->isWritable() == true);
+
+    // 1 inline + 21 packets over the lookahead are decoded, 18 are queued
+    write_packets(player, 40);
+    WAIT_FOR(nugu_pcm_get_data_size(test_pcm) > TEST_LOOKAHEAD_SIZE);
+    g_usleep(100 * 1000);
+
+    g_assert(player->isWritable() == false);
+
+    // not notified until the queue is drained under the limit
+    while (g_main_context_iteration(NULL, FALSE))
+        ;
+    g_assert_cmpint(notified, ==, 0);
+
+    // the playback drains the queue
+    while (notified == 0 && g_atomic_int_get(&decoded_count) < 40) {
+        if (nugu_pcm_get_data_size(test_pcm) > 0)
+            nugu_pcm_get_data(test_pcm, buf, sizeof(buf));
+
+        WAIT_FOR(notified > 0 || nugu_pcm_get_data_size(test_pcm) > TEST_LOOKAHEAD_SIZE);
+    }
+
+    WAIT_FOR(notified > 0);
+    g_assert_cmpint(notified, ==, 1);
+    g_assert(player->isWritable() == true);
+}
+
+static void test_ttsplayer_stop(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+
+    write_packets(player, 40);
+    WAIT_FOR(nugu_pcm_get_data_size(test_pcm) > TEST_LOOKAHEAD_SIZE);
+
+    // the queued packets are dropped
+    g_assert(player->stop() == true);
+    g_assert(player->isWritable() == true);
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), ==, 0);
+
+    g_usleep(100 * 1000);
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), <, 40);
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), ==, 0);
+}
+
+static void test_ttsplayer_cache(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+
+    // the decoded audio of the missed key is stored at the end of stream
+    g_assert(player->setCacheKey("hello") == false);
+    write_packets(player, 3);
+    player->writeDone();
+    WAIT_FOR(player->duration() > 0);
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), ==, 3);
+
+    player->stop();
+    player->setSource("attachment");
+
+    // the cached audio is written without decoding
+    g_assert(player->setCacheKey("hello") == true);
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), ==, 3 * TEST_FRAME_SIZE);
+    g_assert(nugu_pcm_receive_is_last_data(test_pcm) == 1);
+
+    write_packets(player, 3);
+    player->writeDone();
+    g_assert_cmpint(g_atomic_int_get(&decoded_count), ==, 3);
+
+    player->stop();
+    player->setSource("attachment");
+
+    // the cached audio can't follow the audio which is already written
+    write_packets(player, 1);
+    g_assert(player->setCacheKey("hello") == false);
+    g_assert_cmpuint(nugu_pcm_get_data_size(test_pcm), ==, TEST_FRAME_SIZE);
+}
+
+static void test_ttsplayer_notify(ttsPlayerFixture* fixture, gconstpointer ignored)
+{
+    TTSPlayer* player = fixture->player;
+    TTSPlayerListener listener;
+
+    player->addListener(&listener);
+
+    // the status emitted on the worker is passed on the main loop
+    write_packets(player, 5);
+    WAIT_FOR(g_atomic_int_get(&worker_decoded_count) == 4);
+    player->writeDone();
+
+    WAIT_FOR(listener.finished_thread != nullptr);
+    g_assert(listener.playing_thread == main_thread);
+    g_assert(listener.finished_thread == main_thread);
+    g_assert(player->state() == MediaPlayerState::STOPPED);
+
+    // the status emitted before the stop is dropped
+    player->setSource("attachment");
+    listener.playing_thread = nullptr;
+
+    write_packets(player, 5);
+    while (g_atomic_int_get(&worker_decoded_count) < 8)
+        g_usleep(1000);
+    g_assert(player->stop() == true);
+
+    while (g_main_context_iteration(NULL, FALSE))
+        ;
+    g_assert(listener.playing_thread == nullptr);
+
+    player->removeListener(&listener);
+}
+
+static void remove_dir(const char* path)
+{
+    GDir* dir = g_dir_open(path, 0, NULL);
+    const char* file;
+
+    if (!dir)
+        return;
+
+    while ((file = g_dir_read_name(dir)) != NULL) {
+        char* filename = g_build_filename(path, file, NULL);
+
+        g_unlink(filename);
+        g_free(filename);
+    }
+
+    g_dir_close(dir);
+    g_rmdir(path);
+}
+
+int main(int argc, char* argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+    g_type_init();
+#endif
+
+    g_test_init(&argc, &argv, (void*)NULL);
+    g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+    // start the playback without the jitter buffering
+    g_setenv("NUGU_TTS_JITTER_BUFFER", "0", TRUE);
+
+    char* cache_path = g_dir_make_tmp("nugu_tts_cache_XXXXXX", NULL);
+    g_setenv("NUGU_TTS_CACHE_PATH", cache_path, TRUE);
+
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Worker", test_ttsplayer_worker);
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Lookahead", test_ttsplayer_lookahead);
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Writable", test_ttsplayer_writable);
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Stop", test_ttsplayer_stop);
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Cache", test_ttsplayer_cache);
+    G_TEST_ADD_FUNC("/core/TTSPlayer/Notify", test_ttsplayer_notify);
+
+    int ret = g_test_run();
+
+    remove_dir(cache_path);
+    g_free(cache_path);
+
+    return ret;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "base/nugu_cache.h"
+
+static void _remove_dir(const char *path)
+{
+	GDir *dir;
+	const char *file;
+
+	dir = g_dir_open(path, 0, NULL);
+	g_assert(dir != NULL);
+
+	while ((file = g_dir_read_name(dir)) != NULL) {
+		char *filename = g_build_filename(path, file, NULL);
+
+		g_unlink(filename);
+		g_free(filename);
+	}
+
+	g_dir_close(dir);
+	g_rmdir(path);
+}
+
+static int _add_entry(NuguCache *cache, const char *key, const char *data)
+{
+	NuguCacheWriter *writer;
+
+	writer = nugu_cache_writer_new(cache, key);
+	g_assert(writer != NULL);
+
+	if (nugu_cache_writer_append(writer, data, strlen(data)) < 0) {
+		nugu_cache_writer_abort(writer);
+		return -1;
+	}
+
+	return nugu_cache_writer_commit(writer);
+}
+
+static int _check_entry(NuguCache *cache, const char *key, const char *data)
+{
+	NuguCacheEntry *entry;
+	const void *ptr;
+	size_t size = 0;
+
+	entry = nugu_cache_lookup(cache, key);
+	if (!entry)
+		return -1;
+
+	ptr = nugu_cache_entry_peek_data(entry, &size);
+	g_assert(size == strlen(data));
+	g_assert(memcmp(ptr, data, size) == 0);
+
+	nugu_cache_entry_free(entry);
+
+	return 0;
+}
+
+static void test_cache_default(void)
+{
+	struct nugu_cache_stats stats;
+	NuguCacheWriter *writer;
+	NuguCache *cache;
+	char *path;
+
+	path = g_dir_make_tmp("nugu_cache_XXXXXX", NULL);
+	g_assert(path != NULL);
+
+	g_assert(nugu_cache_new(NULL, 100) == NULL);
+	g_assert(nugu_cache_new(path, 0) == NULL);
+
+	cache = nugu_cache_new(path, 100);
+	g_assert(cache != NULL);
+
+	g_assert(nugu_cache_lookup(cache, "<skml>hello</skml>") == NULL);
+
+	g_assert(_add_entry(cache, "<skml>hello</skml>", "hello") == 0);
+	g_assert(_check_entry(cache, "<skml>hello</skml>", "hello") == 0);
+
+	/* aborted entry is not added */
+	writer = nugu_cache_writer_new(cache, "abort");
+	g_assert(writer != NULL);
+	g_assert(nugu_cache_writer_append(writer, "abc", 3) == 0);
+	nugu_cache_writer_abort(writer);
+	g_assert(nugu_cache_lookup(cache, "abort") == NULL);
+
+	/* empty entry is not added */
+	writer = nugu_cache_writer_new(cache, "empty");
+	g_assert(writer != NULL);
+	g_assert(nugu_cache_writer_commit(writer) == -1);
+
+	/* replace the entry */
+	g_assert(_add_entry(cache, "<skml>hello</skml>", "hello world") == 0);
+	g_assert(_check_entry(cache, "<skml>hello</skml>", "hello world") == 0);
+
+	nugu_cache_get_stats(cache, &stats);
+	g_assert(stats.hits == 2);
+	g_assert(stats.misses == 2);
+	g_assert(stats.hit_bytes == 16);
+	g_assert(stats.size == 11);
+	g_assert(stats.entries == 1);
+
+	/* entries are kept after restarting */
+	nugu_cache_free(cache);
+	cache = nugu_cache_new(path, 100);
+	g_assert(cache != NULL);
+
+	nugu_cache_get_stats(cache, &stats);
+	g_assert(stats.hits == 0);
+	g_assert(stats.size == 11);
+	g_assert(stats.entries == 1);
+	g_assert(_check_entry(cache, "<skml>hello</skml>", "hello world") == 0);
+
+	nugu_cache_free(cache);
+
+	_remove_dir(path);
+	g_free(path);
+}
+
+static void test_cache_lru(void)
+{
+	struct nugu_cache_stats stats;
+	NuguCache *cache;
+	char *path;
+
+	path = g_dir_make_tmp("nugu_cache_XXXXXX", NULL);
+	g_assert(path != NULL);
+
+	cache = nugu_cache_new(path, 10);
+	g_assert(cache != NULL);
+
+	g_assert(_add_entry(cache, "a", "aaaa") == 0);
+	g_assert(_add_entry(cache, "b", "bbbb") == 0);
+
+	/* 'b' is the least recently used */
+	g_assert(_check_entry(cache, "a", "aaaa") == 0);
+	g_assert(_add_entry(cache, "c", "cccc") == 0);
+
+	g_assert(_check_entry(cache, "b", "bbbb") == -1);
+	g_assert(_check_entry(cache, "a", "aaaa") == 0);
+	g_assert(_check_entry(cache, "c", "cccc") == 0);
+
+	/* too big to cache */
+	g_assert(_add_entry(cache, "d", "dddddddddddd") == -1);
+	g_assert(_check_entry(cache, "d", "dddddddddddd") == -1);
+
+	nugu_cache_get_stats(cache, &stats);
+	g_assert(stats.size == 8);
+	g_assert(stats.entries == 2);
+
+	nugu_cache_free(cache);
+
+	/* the bound is applied to the existing entries */
+	cache = nugu_cache_new(path, 5);
+	g_assert(cache != NULL);
+
+	nugu_cache_get_stats(cache, &stats);
+	g_assert(stats.size == 4);
+	g_assert(stats.entries == 1);
+
+	nugu_cache_free(cache);
+
+	_remove_dir(path);
+	g_free(path);
+}
+
+static void test_cache_same_key(void)
+{
+	struct nugu_cache_stats stats;
+	NuguCacheWriter *writer1;
+	NuguCacheWriter *writer2;
+	NuguCache *cache;
+	char *path;
+
+	path = g_dir_make_tmp("nugu_cache_XXXXXX", NULL);
+	g_assert(path != NULL);
+
+	cache = nugu_cache_new(path, 100);
+	g_assert(cache != NULL);
+
+	/* the writers of the same key don't share the temporary file */
+	writer1 = nugu_cache_writer_new(cache, "a");
+	g_assert(writer1 != NULL);
+	writer2 = nugu_cache_writer_new(cache, "a");
+	g_assert(writer2 != NULL);
+
+	g_assert(nugu_cache_writer_append(writer1, "1111", 4) == 0);
+	g_assert(nugu_cache_writer_append(writer2, "222222", 6) == 0);
+
+	/* the last committed one replaces the entry */
+	g_assert(nugu_cache_writer_commit(writer1) == 0);
+	g_assert(_check_entry(cache, "a", "1111") == 0);
+	g_assert(nugu_cache_writer_commit(writer2) == 0);
+	g_assert(_check_entry(cache, "a", "222222") == 0);
+
+	nugu_cache_get_stats(cache, &stats);
+	g_assert(stats.size == 6);
+	g_assert(stats.entries == 1);
+
+	/* the aborted writer doesn't affect the entry */
+	writer1 = nugu_cache_writer_new(cache, "a");
+	g_assert(writer1 != NULL);
+	g_assert(nugu_cache_writer_append(writer1, "3", 1) == 0);
+	nugu_cache_writer_abort(writer1);
+	g_assert(_check_entry(cache, "a", "222222") == 0);
+
+	nugu_cache_free(cache);
+
+	_remove_dir(path);
+	g_free(path);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/cache/default", test_cache_default);
+	g_test_add_func("/cache/lru", test_cache_lru);
+	g_test_add_func("/cache/same_key", test_cache_same_key);
+
+	return g_test_run();
+}
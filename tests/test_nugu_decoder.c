@@ -21,6 +21,11 @@
 #include <glib.h>
 
 #include "base/nugu_decoder.h"
+#include "base/nugu_pcm.h"
+
+#define TEST_FRAME_SIZE 960
+#define BENCHMARK_FRAMES 10
+#define BENCHMARK_LOOP 20000
 
 static int _check_put_data;
 
@@ -85,6 +90,197 @@ static void test_decoder_decode(void)
 
 static struct nugu_decoder_driver_ops empty_ops = { .decode = NULL };
 
+/**
+ * each byte of the data is decoded to a frame filled with the byte
+ */
+static int frame_decode(NuguDecoderDriver *driver, NuguDecoder *dec,
+			const void *data, size_t data_len, NuguBuffer *out_buf)
+{
+	char frame[TEST_FRAME_SIZE];
+	size_t i;
+
+	for (i = 0; i < data_len; i++) {
+		/* 0 is an invalid frame which is skipped */
+		if (((const char *)data)[i] == 0)
+			continue;
+
+		memset(frame, ((const char *)data)[i], TEST_FRAME_SIZE);
+		nugu_buffer_add(out_buf, frame, TEST_FRAME_SIZE);
+	}
+
+	return 0;
+}
+
+static int frame_decode_to_sink(NuguDecoderDriver *driver, NuguDecoder *dec,
+				const void *data, size_t data_len)
+{
+	char *frame;
+	size_t i;
+
+	for (i = 0; i < data_len; i++) {
+		frame = nugu_decoder_reserve_output(dec, TEST_FRAME_SIZE);
+		if (!frame)
+			return -1;
+
+		/* release the reserved space of the skipped frame */
+		if (((const char *)data)[i] == 0) {
+			nugu_decoder_commit_output(dec, 0);
+			continue;
+		}
+
+		memset(frame, ((const char *)data)[i], TEST_FRAME_SIZE);
+
+		if (nugu_decoder_commit_output(dec, TEST_FRAME_SIZE) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static struct nugu_decoder_driver_ops frame_ops = { .decode = frame_decode };
+
+static struct nugu_decoder_driver_ops frame_direct_ops = {
+	.decode = frame_decode,
+	.decode_to_sink = frame_decode_to_sink
+};
+
+static void check_play(struct nugu_decoder_driver_ops *ops)
+{
+	NuguAudioProperty prop = { NUGU_AUDIO_SAMPLE_RATE_22K,
+				   NUGU_AUDIO_FORMAT_S16_LE, 1 };
+	NuguDecoderDriver *driver;
+	NuguDecoder *dec;
+	NuguPcm *pcm;
+	char data[64];
+	char *out;
+	int i;
+
+	driver = nugu_decoder_driver_new("frame", NUGU_DECODER_TYPE_CUSTOM,
+					 ops);
+	g_assert(driver != NULL);
+
+	pcm = nugu_pcm_new("sink", NULL, prop);
+	g_assert(pcm != NULL);
+
+	dec = nugu_decoder_new(driver, pcm);
+	g_assert(dec != NULL);
+	g_assert(nugu_decoder_get_pcm(dec) == pcm);
+
+	/* drop the first frame and 40 bytes of the second frame */
+	g_assert(nugu_decoder_set_skip_size(dec, TEST_FRAME_SIZE + 40) == 0);
+	g_assert(nugu_decoder_play(dec, "\x01\x02\x03", 3) == 0);
+	g_assert(nugu_pcm_get_data_size(pcm) == TEST_FRAME_SIZE * 2 - 40);
+
+	out = g_malloc0(TEST_FRAME_SIZE * 64);
+	g_assert(nugu_pcm_get_data(pcm, out, TEST_FRAME_SIZE * 2) ==
+		 TEST_FRAME_SIZE * 2 - 40);
+	g_assert(out[0] == 2 && out[TEST_FRAME_SIZE - 41] == 2);
+	g_assert(out[TEST_FRAME_SIZE - 40] == 3);
+	g_assert(out[TEST_FRAME_SIZE * 2 - 41] == 3);
+
+	/* frames over the multiple pcm chunks */
+	for (i = 0; i < 64; i++)
+		data[i] = (char)(i + 1);
+
+	g_assert(nugu_decoder_play(dec, data, 32) == 0);
+	g_assert(nugu_decoder_play(dec, data + 32, 32) == 0);
+	g_assert(nugu_pcm_get_data_size(pcm) == TEST_FRAME_SIZE * 64);
+	g_assert(nugu_pcm_get_data(pcm, out, TEST_FRAME_SIZE * 64) ==
+		 TEST_FRAME_SIZE * 64);
+
+	for (i = 0; i < 64; i++) {
+		g_assert(out[i * TEST_FRAME_SIZE] == (char)(i + 1));
+		g_assert(out[(i + 1) * TEST_FRAME_SIZE - 1] == (char)(i + 1));
+	}
+
+	/* the last frame is skipped */
+	g_assert(nugu_decoder_play(dec, "\x04\x00", 2) == 0);
+	g_assert(nugu_decoder_play(dec, "\x05", 1) == 0);
+	g_assert(nugu_pcm_get_data_size(pcm) == TEST_FRAME_SIZE * 2);
+	g_assert(nugu_pcm_get_data(pcm, out, TEST_FRAME_SIZE * 2) ==
+		 TEST_FRAME_SIZE * 2);
+	g_assert(out[0] == 4 && out[TEST_FRAME_SIZE] == 5);
+
+	g_free(out);
+
+	nugu_decoder_free(dec);
+	nugu_pcm_free(pcm);
+	g_assert(nugu_decoder_driver_free(driver) == 0);
+}
+
+static void test_decoder_play(void)
+{
+	check_play(&frame_ops);
+	check_play(&frame_direct_ops);
+}
+
+static void test_decoder_play_benchmark(void)
+{
+	NuguAudioProperty prop = { NUGU_AUDIO_SAMPLE_RATE_22K,
+				   NUGU_AUDIO_FORMAT_S16_LE, 1 };
+	NuguDecoderDriver *driver;
+	NuguDecoder *dec;
+	NuguPcm *pcm;
+	GTimer *timer;
+	char data[BENCHMARK_FRAMES];
+	size_t total = TEST_FRAME_SIZE * BENCHMARK_FRAMES;
+	char *expected;
+	char *out;
+	size_t out_len;
+	int loop;
+	int i;
+
+	driver = nugu_decoder_driver_new("frame", NUGU_DECODER_TYPE_CUSTOM,
+					 &frame_direct_ops);
+	pcm = nugu_pcm_new("sink", NULL, prop);
+	dec = nugu_decoder_new(driver, pcm);
+	out = g_malloc(total);
+	for (i = 0; i < BENCHMARK_FRAMES; i++)
+		data[i] = (char)(i + 1);
+
+	/* reference output of the decode path */
+	expected = nugu_decoder_decode(dec, data, sizeof(data), &out_len);
+	g_assert(expected != NULL);
+	g_assert_cmpuint(out_len, ==, total);
+
+	timer = g_timer_new();
+
+	/* decode to the allocated buffer and push to the pcm */
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++) {
+		char *buf = nugu_decoder_decode(dec, data, sizeof(data),
+						&out_len);
+
+		g_assert(buf != NULL);
+		g_assert(nugu_pcm_push_data(pcm, buf, out_len, 0) ==
+			 (int)out_len);
+		free(buf);
+
+		g_assert(nugu_pcm_get_data(pcm, out, total) == (int)total);
+		g_assert(memcmp(out, expected, total) == 0);
+	}
+	g_test_message("decode and push: %f sec",
+		       g_timer_elapsed(timer, NULL));
+
+	/* decode directly into the pcm */
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++) {
+		g_assert(nugu_decoder_play(dec, data, sizeof(data)) == 0);
+		g_assert(nugu_pcm_get_data_size(pcm) == total);
+
+		g_assert(nugu_pcm_get_data(pcm, out, total) == (int)total);
+		g_assert(memcmp(out, expected, total) == 0);
+	}
+	g_test_message("decode to sink: %f sec", g_timer_elapsed(timer, NULL));
+
+	g_timer_destroy(timer);
+	free(expected);
+	g_free(out);
+
+	nugu_decoder_free(dec);
+	nugu_pcm_free(pcm);
+	nugu_decoder_driver_free(driver);
+}
+
 static void test_decoder_default(void)
 {
 	NuguDecoderDriver *driver;
@@ -161,6 +357,80 @@ static void test_decoder_default(void)
 	g_assert(nugu_decoder_driver_free(driver) == 0);
 }
 
+static int dummy_reset(NuguDecoderDriver *driver, NuguDecoder *dec)
+{
+	return 0;
+}
+
+static struct nugu_decoder_driver_ops pool_ops = {
+	.create = dummy_create,
+	.decode = dummy_decode,
+	.destroy = dummy_destroy,
+	.reset = dummy_reset
+};
+
+static void test_decoder_pool(void)
+{
+	NuguAudioProperty prop = { NUGU_AUDIO_SAMPLE_RATE_22K,
+				   NUGU_AUDIO_FORMAT_S16_LE, 1 };
+	NuguDecoderDriver *driver;
+	NuguDecoder *dec1;
+	NuguDecoder *dec2;
+	NuguPcm *pcm;
+	struct nugu_decoder_pool_stats stats;
+
+	g_assert(nugu_decoder_driver_set_pool_size(NULL, 1) < 0);
+
+	driver = nugu_decoder_driver_new("test", NUGU_DECODER_TYPE_CUSTOM,
+					 &pool_ops);
+	g_assert(driver != NULL);
+	g_assert(nugu_decoder_driver_set_pool_size(driver, -1) < 0);
+
+	pcm = nugu_pcm_new("sink", NULL, prop);
+	g_assert(pcm != NULL);
+
+	dec1 = nugu_decoder_new(driver, pcm);
+	g_assert(dec1 != NULL);
+	g_assert(nugu_decoder_set_skip_size(dec1, 100) == 0);
+	g_assert(nugu_decoder_free(dec1) == 0);
+
+	/* the idle decoder is reused with the new sink */
+	dec2 = nugu_decoder_new(driver, NULL);
+	g_assert(dec2 == dec1);
+	g_assert(nugu_decoder_get_pcm(dec2) == NULL);
+
+	nugu_decoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.created, ==, 1);
+	g_assert_cmpuint(stats.reused, ==, 1);
+	g_assert_cmpuint(stats.destroyed, ==, 0);
+	g_assert_cmpuint(stats.pooled, ==, 0);
+
+	g_assert(nugu_decoder_driver_free(driver) == -1);
+
+	nugu_decoder_free(dec2);
+	nugu_decoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.pooled, ==, 1);
+
+	/* idle decoders are destroyed with the driver */
+	g_assert(nugu_decoder_driver_free(driver) == 0);
+
+	/* the driver built against the older header has no reset */
+	driver = (nugu_decoder_driver_new)("test", NUGU_DECODER_TYPE_CUSTOM,
+					   &pool_ops);
+	g_assert(driver != NULL);
+
+	dec1 = nugu_decoder_new(driver, pcm);
+	g_assert(dec1 != NULL);
+	g_assert(nugu_decoder_free(dec1) == 0);
+
+	nugu_decoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.destroyed, ==, 1);
+	g_assert_cmpuint(stats.pooled, ==, 0);
+	g_assert(nugu_decoder_driver_free(driver) == 0);
+
+	nugu_pcm_free(pcm);
+}
+
 int main(int argc, char *argv[])
 {
 #if !GLIB_CHECK_VERSION(2, 36, 0)
@@ -172,6 +442,12 @@ int main(int argc, char *argv[])
 
 	g_test_add_func("/decoder/driver_default", test_decoder_default);
 	g_test_add_func("/decoder/decode", test_decoder_decode);
+	g_test_add_func("/decoder/play", test_decoder_play);
+	g_test_add_func("/decoder/pool", test_decoder_pool);
+
+	if (g_test_perf())
+		g_test_add_func("/decoder/play_benchmark",
+				test_decoder_play_benchmark);
 
 	return g_test_run();
 }
@@ -50,6 +50,7 @@ static void on_data(NuguDirective *ndir, int seq, void *userdata)
 static void test_nugu_directive_callback(void)
 {
 	NuguDirective *ndir;
+	int64_t msec;
 
 	ndir = nugu_directive_new("TTS", "Speak", "1.0", TEST_UUID_1,
 				  TEST_UUID_2, TEST_UUID_1, "{}", "{}");
@@ -62,12 +63,18 @@ static void test_nugu_directive_callback(void)
 	g_assert(nugu_directive_is_active(ndir) == 1);
 
 	g_assert(flag == 0);
+	g_assert(nugu_directive_get_data_time(ndir) == 0);
 	g_assert(nugu_directive_add_data(ndir, sizeof(dummy), dummy) == 0);
 	g_assert(flag == 1);
 
+	/* the receive time is kept after the data is consumed */
+	msec = nugu_directive_get_data_time(ndir);
+	g_assert(msec > 0);
+
 	g_assert(nugu_directive_remove_data_callback(ndir) == 0);
 	g_assert(nugu_directive_add_data(ndir, sizeof(dummy), dummy) == 0);
 	g_assert(flag == 1);
+	g_assert(nugu_directive_get_data_time(ndir) >= msec);
 
 	nugu_directive_unref(ndir);
 }
@@ -73,6 +73,21 @@ static struct nugu_encoder_driver_ops fail_ops = {
 
 static struct nugu_encoder_driver_ops empty_ops = { .encode = NULL };
 
+static int _reset_count;
+
+static int dummy_reset(NuguEncoderDriver *driver, NuguEncoder *enc)
+{
+	_reset_count++;
+	return 0;
+}
+
+static struct nugu_encoder_driver_ops pool_ops = {
+	.create = dummy_create,
+	.encode = dummy_encode,
+	.destroy = dummy_destroy,
+	.reset = dummy_reset
+};
+
 static void test_encoder_encode(void)
 {
 	NuguEncoderDriver *driver;
@@ -188,6 +203,96 @@ static void test_encoder_default(void)
 	g_assert(nugu_encoder_driver_free(driver) == 0);
 }
 
+static void test_encoder_pool(void)
+{
+	NuguEncoderDriver *driver;
+	NuguEncoder *enc1;
+	NuguEncoder *enc2;
+	NuguEncoder *enc3;
+	NuguAudioProperty prop2 = prop;
+	struct nugu_encoder_pool_stats stats;
+
+	g_assert(nugu_encoder_driver_set_pool_size(NULL, 1) < 0);
+
+	/* driver without reset: always destroyed */
+	driver = nugu_encoder_driver_new("test", NUGU_ENCODER_TYPE_CUSTOM,
+					 &encoder_driver_ops);
+	g_assert(driver != NULL);
+
+	enc1 = nugu_encoder_new(driver, prop);
+	g_assert(enc1 != NULL);
+	g_assert(nugu_encoder_free(enc1) == 0);
+
+	nugu_encoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.created, ==, 1);
+	g_assert_cmpuint(stats.reused, ==, 0);
+	g_assert_cmpuint(stats.destroyed, ==, 1);
+	g_assert_cmpuint(stats.pooled, ==, 0);
+	g_assert(nugu_encoder_driver_free(driver) == 0);
+
+	/* the driver built against the older header has no reset */
+	_reset_count = 0;
+	driver = (nugu_encoder_driver_new)("test", NUGU_ENCODER_TYPE_CUSTOM,
+					   &pool_ops);
+	g_assert(driver != NULL);
+
+	enc1 = nugu_encoder_new(driver, prop);
+	g_assert(enc1 != NULL);
+	g_assert(nugu_encoder_free(enc1) == 0);
+	g_assert_cmpint(_reset_count, ==, 0);
+	g_assert(nugu_encoder_driver_free(driver) == 0);
+
+	_reset_count = 0;
+	driver = nugu_encoder_driver_new("test", NUGU_ENCODER_TYPE_CUSTOM,
+					 &pool_ops);
+	g_assert(driver != NULL);
+	g_assert(nugu_encoder_driver_set_pool_size(driver, 1) == 0);
+
+	enc1 = nugu_encoder_new(driver, prop);
+	enc2 = nugu_encoder_new(driver, prop);
+	g_assert(enc1 != NULL && enc2 != NULL && enc1 != enc2);
+
+	/* only one encoder is kept by the pool size */
+	g_assert(nugu_encoder_free(enc1) == 0);
+	g_assert(nugu_encoder_free(enc2) == 0);
+	g_assert_cmpint(_reset_count, ==, 1);
+
+	nugu_encoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.created, ==, 2);
+	g_assert_cmpuint(stats.destroyed, ==, 1);
+	g_assert_cmpuint(stats.pooled, ==, 1);
+
+	/* different property is not reused */
+	prop2.samplerate = NUGU_AUDIO_SAMPLE_RATE_22K;
+	enc3 = nugu_encoder_new(driver, prop2);
+	g_assert(enc3 != NULL && enc3 != enc1);
+	nugu_encoder_free(enc3);
+
+	enc3 = nugu_encoder_new(driver, prop);
+	g_assert(enc3 == enc1);
+
+	nugu_encoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.created, ==, 3);
+	g_assert_cmpuint(stats.reused, ==, 1);
+	g_assert_cmpuint(stats.pooled, ==, 0);
+
+	/* in use */
+	g_assert(nugu_encoder_driver_free(driver) == -1);
+
+	nugu_encoder_free(enc3);
+	g_assert(nugu_encoder_driver_set_pool_size(driver, 0) == 0);
+
+	nugu_encoder_driver_get_pool_stats(driver, &stats);
+	g_assert_cmpuint(stats.destroyed, ==, 3);
+	g_assert_cmpuint(stats.pooled, ==, 0);
+
+	/* idle encoders are destroyed with the driver */
+	g_assert(nugu_encoder_driver_set_pool_size(driver, 1) == 0);
+	enc1 = nugu_encoder_new(driver, prop);
+	nugu_encoder_free(enc1);
+	g_assert(nugu_encoder_driver_free(driver) == 0);
+}
+
 int main(int argc, char *argv[])
 {
 #if !GLIB_CHECK_VERSION(2, 36, 0)
@@ -203,6 +308,7 @@ int main(int argc, char *argv[])
 
 	g_test_add_func("/encoder/driver_default", test_encoder_default);
 	g_test_add_func("/encoder/encode", test_encoder_encode);
+	g_test_add_func("/encoder/pool", test_encoder_pool);
 
 	return g_test_run();
 }
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_jitter.h"
+
+/* each arrival has 100 msec of audio */
+static int _add_stream(NuguJitter *jitter, const int *times, int count,
+		       unsigned int underruns, int added_latency)
+{
+	int i;
+
+	nugu_jitter_begin(jitter);
+
+	for (i = 0; i < count; i++)
+		nugu_jitter_add_arrival(jitter, 1000 + times[i], 100);
+
+	return nugu_jitter_end(jitter, count * 100, underruns, added_latency);
+}
+
+static void test_jitter_required(void)
+{
+	NuguJitter *jitter;
+	const int steady[] = { 0, 50, 100, 150 };
+	const int slow[] = { 0, 150, 300, 450 };
+	const int burst[] = { 0, 0, 0, 700 };
+
+	jitter = nugu_jitter_new(0.0, 5000);
+	g_assert(jitter != NULL);
+	g_assert(nugu_jitter_get_threshold(jitter) == 0);
+
+	/* no arrivals */
+	nugu_jitter_begin(jitter);
+	g_assert(nugu_jitter_end(jitter, 100, 0, 0) == -1);
+
+	/* faster than the playback */
+	g_assert(_add_stream(jitter, steady, 4, 0, 0) == 0);
+	g_assert(nugu_jitter_get_threshold(jitter) == 0);
+
+	/* start after the 2nd arrival (100 msec buffered) */
+	g_assert(_add_stream(jitter, slow, 4, 0, 0) == 101);
+	g_assert(nugu_jitter_get_threshold(jitter) == 101);
+
+	/* wait for the last arrival (300 msec buffered) */
+	g_assert(_add_stream(jitter, burst, 4, 0, 0) == 301);
+	g_assert(nugu_jitter_get_threshold(jitter) == 301);
+
+	/* the threshold is limited */
+	nugu_jitter_free(jitter);
+	jitter = nugu_jitter_new(0.0, 150);
+	g_assert(_add_stream(jitter, burst, 4, 0, 0) == 301);
+	g_assert(nugu_jitter_get_threshold(jitter) == 150);
+
+	nugu_jitter_free(jitter);
+}
+
+static void test_jitter_target_rate(void)
+{
+	NuguJitter *jitter;
+	struct nugu_jitter_stats stats;
+	const int steady[] = { 0, 50, 100, 150 };
+	const int slow[] = { 0, 150, 300, 450 };
+	int i;
+
+	/* one slow stream among 10 streams */
+	jitter = nugu_jitter_new(0.1, 5000);
+	g_assert(jitter != NULL);
+
+	g_assert(_add_stream(jitter, slow, 4, 3, 0) == 101);
+	for (i = 0; i < 9; i++)
+		_add_stream(jitter, steady, 4, 0, 20);
+
+	g_assert(nugu_jitter_get_threshold(jitter) == 0);
+
+	/* two slow streams exceed the target rate */
+	_add_stream(jitter, slow, 4, 1, 0);
+	g_assert(nugu_jitter_get_threshold(jitter) == 101);
+
+	nugu_jitter_get_stats(jitter, &stats);
+	g_assert(stats.streams == 11);
+	g_assert(stats.underrun_streams == 2);
+	g_assert(stats.underruns == 4);
+	g_assert(stats.added_latency == 180);
+	g_assert(stats.threshold == 101);
+
+	nugu_jitter_free(jitter);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/jitter/required", test_jitter_required);
+	g_test_add_func("/jitter/target_rate", test_jitter_target_rate);
+
+	return g_test_run();
+}
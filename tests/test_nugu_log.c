@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <glib.h>
+
+#include "base/nugu_log.h"
+
+#define TEST_THREADS 4
+
+/* fit in the ring buffer of each thread without the writer */
+#define TEST_LINES 500
+
+#define BENCH_LINES 200000
+
+static int _saved_stderr = -1;
+
+/* redirect the stderr to the file to check the log output */
+static void capture_begin(const char *path)
+{
+	int fd;
+
+	fflush(stderr);
+	_saved_stderr = dup(STDERR_FILENO);
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	g_assert(fd >= 0);
+
+	dup2(fd, STDERR_FILENO);
+	close(fd);
+}
+
+static void capture_end(void)
+{
+	fflush(stderr);
+	dup2(_saved_stderr, STDERR_FILENO);
+	close(_saved_stderr);
+	_saved_stderr = -1;
+}
+
+static void setup(void)
+{
+	nugu_log_set_system(NUGU_LOG_SYSTEM_STDERR);
+	nugu_log_set_level(NUGU_LOG_LEVEL_DEBUG);
+	nugu_log_set_modules(NUGU_LOG_MODULE_ALL);
+	nugu_log_set_prefix_fields(NUGU_LOG_PREFIX_NONE);
+}
+
+static gpointer log_thread(gpointer userdata)
+{
+	int id = GPOINTER_TO_INT(userdata);
+	int i;
+
+	for (i = 0; i < TEST_LINES; i++)
+		nugu_info("thread-%d %d", id, i);
+
+	return NULL;
+}
+
+static void test_log_async_order(void)
+{
+	GThread *threads[TEST_THREADS];
+	int next[TEST_THREADS] = { 0 };
+	char *contents = NULL;
+	gchar **lines;
+	gchar path[] = "/tmp/nugu_log_XXXXXX";
+	int fd;
+	int i;
+
+	setup();
+
+	fd = g_mkstemp(path);
+	g_assert(fd >= 0);
+	close(fd);
+
+	capture_begin(path);
+
+	g_assert(nugu_log_set_async(1) == 0);
+	g_assert(nugu_log_is_async() == 1);
+
+	for (i = 0; i < TEST_THREADS; i++)
+		threads[i] = g_thread_new("log", log_thread,
+					  GINT_TO_POINTER(i));
+
+	for (i = 0; i < TEST_THREADS; i++)
+		g_thread_join(threads[i]);
+
+	/* the queued messages are written before the return */
+	g_assert(nugu_log_set_async(0) == 0);
+	g_assert(nugu_log_is_async() == 0);
+
+	capture_end();
+
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL) == TRUE);
+	unlink(path);
+
+	g_assert_cmpuint(nugu_log_get_dropped_count(), ==, 0);
+
+	/* the messages of each thread keep the order */
+	lines = g_strsplit(contents, "\n", -1);
+	for (i = 0; lines[i] != NULL; i++) {
+		int id;
+		int seq;
+
+		if (lines[i][0] == '\0')
+			continue;
+
+		g_assert(sscanf(lines[i], "thread-%d %d", &id, &seq) == 2);
+		g_assert(id >= 0 && id < TEST_THREADS);
+		g_assert_cmpint(seq, ==, next[id]);
+		next[id]++;
+	}
+
+	for (i = 0; i < TEST_THREADS; i++)
+		g_assert_cmpint(next[i], ==, TEST_LINES);
+
+	g_strfreev(lines);
+	g_free(contents);
+}
+
+static void test_log_async_flush(void)
+{
+	char *contents = NULL;
+	gchar path[] = "/tmp/nugu_log_XXXXXX";
+	int fd;
+
+	setup();
+
+	fd = g_mkstemp(path);
+	g_assert(fd >= 0);
+	close(fd);
+
+	capture_begin(path);
+
+	g_assert(nugu_log_set_async(1) == 0);
+
+	nugu_error("flushed message");
+	nugu_log_flush();
+
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL) == TRUE);
+	g_assert(strstr(contents, "flushed message") != NULL);
+	g_free(contents);
+
+	g_assert(nugu_log_set_async(0) == 0);
+
+	capture_end();
+	unlink(path);
+}
+
+static void test_log_async_names(void)
+{
+	char *contents = NULL;
+	gchar path[] = "/tmp/nugu_log_XXXXXX";
+	char *filename;
+	char *funcname;
+	int fd;
+
+	setup();
+	nugu_log_set_prefix_fields(NUGU_LOG_PREFIX_FILENAME |
+				   NUGU_LOG_PREFIX_FUNCTION);
+
+	fd = g_mkstemp(path);
+	g_assert(fd >= 0);
+	close(fd);
+
+	capture_begin(path);
+
+	g_assert(nugu_log_set_async(1) == 0);
+
+	/* names of the plugin which is unloaded before the writer */
+	filename = g_strdup("plugins/unloaded.c");
+	funcname = g_strdup("unloaded_func");
+	nugu_log_print(NUGU_LOG_MODULE_DEFAULT, NUGU_LOG_LEVEL_INFO, filename,
+		       funcname, 10, "message of the unloaded");
+	memset(filename, 'x', strlen(filename));
+	memset(funcname, 'x', strlen(funcname));
+	g_free(filename);
+	g_free(funcname);
+
+	g_assert(nugu_log_set_async(0) == 0);
+
+	capture_end();
+
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL) == TRUE);
+	unlink(path);
+
+	g_assert(strstr(contents, "unloaded.c") != NULL);
+	g_assert(strstr(contents, "unloaded_func") != NULL);
+	g_assert(strstr(contents, "message of the unloaded") != NULL);
+
+	g_free(contents);
+	nugu_log_set_prefix_fields(NUGU_LOG_PREFIX_NONE);
+}
+
+static void test_log_async_drop(void)
+{
+	char *contents = NULL;
+	gchar **lines;
+	gchar path[] = "/tmp/nugu_log_XXXXXX";
+	char *msg;
+	unsigned int dropped;
+	int written = 0;
+	int fd;
+	int i;
+
+	setup();
+
+	fd = g_mkstemp(path);
+	g_assert(fd >= 0);
+	close(fd);
+
+	/* burst of the long messages over the ring buffer */
+	msg = g_malloc(3001);
+	memset(msg, 'x', 3000);
+	msg[3000] = '\0';
+
+	dropped = nugu_log_get_dropped_count();
+
+	capture_begin(path);
+
+	g_assert(nugu_log_set_async(1) == 0);
+
+	for (i = 0; i < 100; i++)
+		nugu_info("%s", msg);
+
+	g_assert(nugu_log_set_async(0) == 0);
+
+	capture_end();
+
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL) == TRUE);
+	unlink(path);
+
+	lines = g_strsplit(contents, "\n", -1);
+	for (i = 0; lines[i] != NULL; i++) {
+		if (strcmp(lines[i], msg) == 0)
+			written++;
+	}
+
+	/* every message is written or counted as dropped */
+	dropped = nugu_log_get_dropped_count() - dropped;
+	g_assert_cmpint(written + (int)dropped, ==, 100);
+
+	g_strfreev(lines);
+	g_free(contents);
+	g_free(msg);
+}
+
+static void bench_log(const char *name)
+{
+	gint64 begin;
+	gint64 elapsed;
+	gint64 max_latency = 0;
+	int i;
+
+	begin = g_get_monotonic_time();
+
+	for (i = 0; i < BENCH_LINES; i++) {
+		gint64 t = g_get_monotonic_time();
+
+		nugu_dbg("benchmark message %d with the value %s", i, name);
+
+		t = g_get_monotonic_time() - t;
+		if (t > max_latency)
+			max_latency = t;
+	}
+
+	elapsed = g_get_monotonic_time() - begin;
+
+	g_test_message("%s: %.0f calls/s, avg %.2f usec, max %" G_GINT64_FORMAT
+		       " usec",
+		       name, (double)BENCH_LINES * 1000000 / elapsed,
+		       (double)elapsed / BENCH_LINES, max_latency);
+	g_test_minimized_result((double)elapsed / BENCH_LINES,
+				"%s caller latency (usec)", name);
+}
+
+static void test_log_benchmark(void)
+{
+	unsigned int dropped;
+
+	if (!g_test_perf())
+		return;
+
+	nugu_log_set_system(NUGU_LOG_SYSTEM_STDERR);
+	nugu_log_set_level(NUGU_LOG_LEVEL_DEBUG);
+	nugu_log_set_modules(NUGU_LOG_MODULE_ALL);
+	nugu_log_set_prefix_fields(NUGU_LOG_PREFIX_ALL);
+
+	capture_begin("/dev/null");
+
+	bench_log("sync");
+
+	dropped = nugu_log_get_dropped_count();
+	nugu_log_set_async(1);
+	bench_log("async");
+	nugu_log_set_async(0);
+	dropped = nugu_log_get_dropped_count() - dropped;
+
+	capture_end();
+
+	g_test_message("async: %u messages dropped", dropped);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/log/async/order", test_log_async_order);
+	g_test_add_func("/log/async/flush", test_log_async_flush);
+	g_test_add_func("/log/async/names", test_log_async_names);
+	g_test_add_func("/log/async/drop", test_log_async_drop);
+	g_test_add_func("/log/benchmark", test_log_benchmark);
+
+	return g_test_run();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_mainloop.h"
+
+struct test_data {
+	GMutex lock;
+	GCond cond;
+	GThread *thread;
+	int count;
+};
+
+static int on_idle(void *userdata)
+{
+	struct test_data *data = userdata;
+
+	g_mutex_lock(&data->lock);
+	data->thread = g_thread_self();
+	data->count++;
+	g_cond_signal(&data->cond);
+	g_mutex_unlock(&data->lock);
+
+	return 0;
+}
+
+static void on_invoke(void *userdata)
+{
+	struct test_data *data = userdata;
+
+	g_assert(nugu_mainloop_is_owner() == 1);
+
+	data->thread = g_thread_self();
+	data->count++;
+}
+
+static int on_quit(void *userdata)
+{
+	g_main_loop_quit((GMainLoop *)userdata);
+
+	return 0;
+}
+
+static void test_mainloop_default(void)
+{
+	struct test_data data;
+	GMainLoop *loop;
+
+	memset(&data, 0, sizeof(data));
+
+	g_assert(nugu_mainloop_is_dedicated() == 0);
+	g_assert(nugu_mainloop_get_context() == g_main_context_default());
+
+	loop = g_main_loop_new(NULL, FALSE);
+
+	g_assert(nugu_mainloop_idle_add(on_idle, &data) > 0);
+	g_assert(nugu_mainloop_timeout_add(100, on_quit, loop) > 0);
+
+	g_main_loop_run(loop);
+	g_main_loop_unref(loop);
+
+	g_assert(data.count == 1);
+	g_assert(data.thread == g_thread_self());
+
+	/* nobody runs the default context, so it is invoked immediately */
+	nugu_mainloop_invoke(on_invoke, &data);
+	g_assert(data.count == 2);
+}
+
+static void test_mainloop_dedicated(void)
+{
+	struct test_data data;
+	unsigned int id;
+
+	memset(&data, 0, sizeof(data));
+	g_mutex_init(&data.lock);
+	g_cond_init(&data.cond);
+
+	g_assert(nugu_mainloop_start() == 0);
+	g_assert(nugu_mainloop_start() == -1);
+	g_assert(nugu_mainloop_is_dedicated() == 1);
+	g_assert(nugu_mainloop_get_context() != g_main_context_default());
+	g_assert(nugu_mainloop_is_owner() == 0);
+
+	/* the source is dispatched on the SDK thread */
+	g_mutex_lock(&data.lock);
+	g_assert(nugu_mainloop_idle_add(on_idle, &data) > 0);
+	while (data.count == 0)
+		g_cond_wait(&data.cond, &data.lock);
+	g_mutex_unlock(&data.lock);
+
+	g_assert(data.thread != g_thread_self());
+
+	/* invoke waits for the completion on the SDK thread */
+	data.thread = NULL;
+	nugu_mainloop_invoke(on_invoke, &data);
+	g_assert(data.count == 2);
+	g_assert(data.thread != NULL);
+	g_assert(data.thread != g_thread_self());
+
+	/* removed source is never dispatched */
+	id = nugu_mainloop_timeout_add(10, on_idle, &data);
+	g_assert(id > 0);
+	nugu_mainloop_source_remove(id);
+	g_usleep(50 * 1000);
+	g_assert(data.count == 2);
+
+	nugu_mainloop_stop();
+	g_assert(nugu_mainloop_is_dedicated() == 0);
+	g_assert(nugu_mainloop_get_context() == g_main_context_default());
+
+	g_cond_clear(&data.cond);
+	g_mutex_clear(&data.lock);
+}
+
+static void test_mainloop_remove(void)
+{
+	struct test_data data;
+	unsigned int id;
+
+	memset(&data, 0, sizeof(data));
+
+	/* attached to the default context before the dedicated one starts */
+	id = nugu_mainloop_idle_add(on_idle, &data);
+	g_assert(id > 0);
+
+	g_assert(nugu_mainloop_start() == 0);
+
+	/* removed from the context which the source was attached to */
+	nugu_mainloop_source_remove(id);
+
+	nugu_mainloop_stop();
+
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+
+	g_assert(data.count == 0);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/mainloop/default", test_mainloop_default);
+	g_test_add_func("/mainloop/dedicated", test_mainloop_dedicated);
+	g_test_add_func("/mainloop/remove", test_mainloop_remove);
+
+	return g_test_run();
+}
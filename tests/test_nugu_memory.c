@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_buffer.h"
+#include "base/nugu_directive.h"
+#include "base/nugu_equeue.h"
+#include "base/nugu_mainloop.h"
+#include "base/nugu_memory.h"
+#include "base/nugu_ringbuffer.h"
+
+#include "http2/directives_parser.h"
+
+#define TEST_DIALOGS 1000
+#define TEST_WARMUP_DIALOGS 10
+
+#define TEST_JSON "{\"token\":\"abcdefg\",\"text\":\"hello\"}"
+
+#define TEST_BOUNDARY "nugu-test-boundary"
+#define TEST_CONTENT_TYPE \
+	"content-type: multipart/related; boundary=" TEST_BOUNDARY "\r\n"
+
+/* directive response: "msg-<seq>" directive in a multipart body */
+#define TEST_RESPONSE_FORMAT                                                   \
+	"--" TEST_BOUNDARY "\r\n"                                              \
+	"Content-Type: application/json\r\n"                                   \
+	"\r\n"                                                                 \
+	"{\"directives\":[{\"header\":{\"namespace\":\"TTS\","                 \
+	"\"name\":\"Speak\",\"version\":\"1.0\",\"messageId\":\"msg-%d\","     \
+	"\"dialogRequestId\":\"dialog-%d\"},\"payload\":" TEST_JSON "}]}"      \
+	"\r\n\r\n"                                                             \
+	"--" TEST_BOUNDARY "--\r\n"
+
+static NuguDirective *_received;
+
+static uint64_t get_current(enum nugu_memory_tag tag)
+{
+	struct nugu_memory_stat stat;
+
+	g_assert(nugu_memory_get_stat(tag, &stat) == 0);
+
+	return stat.current;
+}
+
+static uint64_t get_peak(enum nugu_memory_tag tag)
+{
+	struct nugu_memory_stat stat;
+
+	g_assert(nugu_memory_get_stat(tag, &stat) == 0);
+
+	return stat.peak;
+}
+
+static int is_enabled(void)
+{
+	struct nugu_memory_stat stat;
+
+	if (nugu_memory_get_stat(NUGU_MEMORY_TAG_BUFFER, &stat) == 0)
+		return 1;
+
+	g_test_skip("memory accounting is disabled");
+
+	return 0;
+}
+
+static void test_memory_alloc(void)
+{
+	uint64_t base;
+	char *ptr;
+
+	if (!is_enabled())
+		return;
+
+	base = get_current(NUGU_MEMORY_TAG_BUFFER);
+	nugu_memory_reset_peak();
+
+	ptr = nugu_memory_alloc(NUGU_MEMORY_TAG_BUFFER, 100);
+	g_assert(ptr != NULL);
+	g_assert(ptr[0] == 0 && ptr[99] == 0);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base + 100);
+
+	ptr = nugu_memory_realloc(NUGU_MEMORY_TAG_BUFFER, ptr, 100, 300);
+	g_assert(ptr != NULL);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base + 300);
+
+	ptr = nugu_memory_realloc(NUGU_MEMORY_TAG_BUFFER, ptr, 300, 50);
+	g_assert(ptr != NULL);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base + 50);
+	g_assert_cmpint(get_peak(NUGU_MEMORY_TAG_BUFFER), ==, base + 300);
+
+	nugu_memory_free(NUGU_MEMORY_TAG_BUFFER, ptr, 50);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base);
+
+	/* memory allocated by the other allocator */
+	nugu_memory_add(NUGU_MEMORY_TAG_JSON, 10);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_JSON), ==, 10);
+	nugu_memory_sub(NUGU_MEMORY_TAG_JSON, 10);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_JSON), ==, 0);
+
+	nugu_memory_reset_peak();
+	g_assert_cmpint(get_peak(NUGU_MEMORY_TAG_BUFFER), ==, base);
+
+	g_assert_cmpstr(nugu_memory_get_tag_name(NUGU_MEMORY_TAG_NETWORK), ==,
+			"network");
+}
+
+static void test_memory_tag(void)
+{
+	NuguBuffer *buf;
+	NuguRingBuffer *ring;
+	char tmp[100] = {
+		0,
+	};
+	uint64_t base;
+	void *data;
+
+	if (!is_enabled())
+		return;
+
+	base = get_current(NUGU_MEMORY_TAG_BUFFER);
+
+	/* accounted memory is moved to the new tag */
+	buf = nugu_buffer_new(100);
+	g_assert(get_current(NUGU_MEMORY_TAG_BUFFER) > base);
+	nugu_buffer_set_memory_tag(buf, NUGU_MEMORY_TAG_NETWORK);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base);
+	g_assert(get_current(NUGU_MEMORY_TAG_NETWORK) > 100);
+
+	/* resized data is accounted to the new tag */
+	g_assert(nugu_buffer_add(buf, tmp, 100) == 100);
+	g_assert(nugu_buffer_add(buf, tmp, 10) == 10);
+	g_assert(get_current(NUGU_MEMORY_TAG_NETWORK) > 200);
+	nugu_buffer_free(buf, 1);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_NETWORK), ==, 0);
+
+	/* ownership of the data is moved out */
+	buf = nugu_buffer_new(0);
+	nugu_buffer_set_memory_tag(buf, NUGU_MEMORY_TAG_JSON);
+	data = nugu_buffer_free(buf, 0);
+	g_assert(data != NULL);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_JSON), ==, 0);
+	free(data);
+
+	ring = nugu_ring_buffer_new(10, 10);
+	nugu_ring_buffer_set_memory_tag(ring, NUGU_MEMORY_TAG_RECORDER);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_BUFFER), ==, base);
+	g_assert(get_current(NUGU_MEMORY_TAG_RECORDER) > 100);
+	nugu_ring_buffer_free(ring);
+	g_assert_cmpint(get_current(NUGU_MEMORY_TAG_RECORDER), ==, 0);
+}
+
+static void on_new_directive(enum nugu_equeue_type type, void *data,
+			     void *userdata)
+{
+	NuguDirective *ndir = data;
+
+	g_assert(_received == NULL);
+
+	nugu_directive_ref(ndir);
+	_received = ndir;
+}
+
+/* directive response received through the multipart and directive parsers */
+static NuguDirective *receive_directive(int seq, NuguBuffer *json)
+{
+	NuguDirective *ndir;
+	DirParser *dp;
+	char *response;
+
+	dp = dir_parser_new(DIR_PARSER_TYPE_EVENT_RESPONSE);
+	g_assert(dp != NULL);
+	g_assert(dir_parser_add_header(dp, TEST_CONTENT_TYPE,
+				       strlen(TEST_CONTENT_TYPE)) == 0);
+	dir_parser_set_json_buffer(dp, json);
+
+	response = g_strdup_printf(TEST_RESPONSE_FORMAT, seq, seq);
+	g_assert(dir_parser_parse(dp, response, strlen(response)) == 0);
+	g_free(response);
+	dir_parser_free(dp);
+
+	while (g_main_context_iteration(nugu_mainloop_get_context(), FALSE))
+		;
+
+	ndir = _received;
+	_received = NULL;
+
+	return ndir;
+}
+
+/* allocations of a dialog: listening, event, directive with attachment */
+static void run_dialog(int seq)
+{
+	NuguRingBuffer *ring;
+	NuguDirective *ndir;
+	NuguBuffer *json;
+	NuguBuffer *body;
+	char item[512];
+	char *msg_id;
+	void *data;
+	int i;
+
+	memset(item, seq, sizeof(item));
+
+	ring = nugu_ring_buffer_new(sizeof(item), 10);
+	nugu_ring_buffer_set_memory_tag(ring, NUGU_MEMORY_TAG_RECORDER);
+	for (i = 0; i < 20; i++)
+		nugu_ring_buffer_push_data(ring, item, sizeof(item));
+
+	body = nugu_buffer_new(0);
+	nugu_buffer_set_memory_tag(body, NUGU_MEMORY_TAG_NETWORK);
+	for (i = 0; i < 10; i++)
+		nugu_buffer_add(body, item, sizeof(item));
+
+	json = nugu_buffer_new(0);
+	nugu_buffer_set_memory_tag(json, NUGU_MEMORY_TAG_JSON);
+
+	ndir = receive_directive(seq, json);
+	g_assert(ndir != NULL);
+	g_assert(nugu_buffer_get_size(json) > strlen(TEST_JSON));
+
+	msg_id = g_strdup_printf("msg-%d", seq);
+	g_assert_cmpstr(nugu_directive_peek_msg_id(ndir), ==, msg_id);
+	g_free(msg_id);
+
+	nugu_directive_set_media_type(ndir, "audio/mpeg");
+	for (i = 0; i < 5; i++)
+		nugu_directive_add_data(ndir, sizeof(item),
+					(unsigned char *)item);
+	nugu_directive_close_data(ndir);
+
+	data = nugu_directive_get_data(ndir, NULL);
+	free(data);
+
+	nugu_directive_unref(ndir);
+
+	nugu_buffer_free(json, 1);
+	nugu_buffer_free(body, 1);
+	nugu_ring_buffer_free(ring);
+}
+
+static void test_memory_dialogs(void)
+{
+	uint64_t current[NUGU_MEMORY_TAG_MAX];
+	int i;
+
+	if (!is_enabled())
+		return;
+
+	g_assert(nugu_equeue_initialize() == 0);
+	g_assert(nugu_equeue_set_handler(
+			 NUGU_EQUEUE_TYPE_NEW_DIRECTIVE, on_new_directive,
+			 (NuguEqueueDestroyCallback)nugu_directive_unref,
+			 NULL) == 0);
+
+	for (i = 0; i < TEST_WARMUP_DIALOGS; i++)
+		run_dialog(i);
+
+	for (i = 0; i < NUGU_MEMORY_TAG_MAX; i++)
+		current[i] = get_current((enum nugu_memory_tag)i);
+
+	nugu_memory_reset_peak();
+
+	for (i = TEST_WARMUP_DIALOGS; i < TEST_DIALOGS; i++)
+		run_dialog(i);
+
+	nugu_memory_dump();
+
+	nugu_equeue_deinitialize();
+
+	/* no tag grows unbounded */
+	for (i = 0; i < NUGU_MEMORY_TAG_MAX; i++) {
+		enum nugu_memory_tag tag = (enum nugu_memory_tag)i;
+
+		g_assert_cmpint(get_current(tag), ==, current[i]);
+	}
+
+	/* usage of each dialog is accounted */
+	g_assert(get_peak(NUGU_MEMORY_TAG_NETWORK) >= 512 * 10);
+	g_assert(get_peak(NUGU_MEMORY_TAG_RECORDER) >= 512 * 10);
+	g_assert(get_peak(NUGU_MEMORY_TAG_ATTACHMENT) >= 512 * 5);
+	g_assert(get_peak(NUGU_MEMORY_TAG_DIRECTIVE) > strlen(TEST_JSON));
+	g_assert(get_peak(NUGU_MEMORY_TAG_JSON) > strlen(TEST_JSON));
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/memory/alloc", test_memory_alloc);
+	g_test_add_func("/memory/tag", test_memory_tag);
+	g_test_add_func("/memory/dialogs", test_memory_dialogs);
+
+	return g_test_run();
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_metrics.h"
+
+#define TEST_THREADS 4
+#define TEST_ADDS_PER_THREAD 10000
+
+static gpointer add_thread(gpointer userdata)
+{
+	NuguMetric *metric = userdata;
+	int i;
+
+	for (i = 0; i < TEST_ADDS_PER_THREAD; i++)
+		nugu_metric_add(metric, 1);
+
+	return NULL;
+}
+
+static void test_metrics_register(void)
+{
+	NuguMetric *counter;
+	NuguMetric *gauge;
+
+	counter = nugu_metrics_register("test_register_counter",
+					NUGU_METRIC_TYPE_COUNTER, "counter");
+	g_assert(counter != NULL);
+
+	/* same name returns the registered metric */
+	g_assert(nugu_metrics_register("test_register_counter",
+				       NUGU_METRIC_TYPE_COUNTER,
+				       NULL) == counter);
+	g_assert(nugu_metrics_find("test_register_counter") == counter);
+	g_assert(nugu_metrics_find("test_unknown") == NULL);
+
+	/* type mismatch */
+	g_assert(nugu_metrics_register("test_register_counter",
+				       NUGU_METRIC_TYPE_GAUGE, NULL) == NULL);
+
+	nugu_metric_add(counter, 3);
+	nugu_metric_add(counter, -1);
+	g_assert_cmpint(nugu_metric_get(counter), ==, 3);
+
+	gauge = nugu_metrics_register("test_register_gauge",
+				      NUGU_METRIC_TYPE_GAUGE, "gauge");
+	g_assert(gauge != NULL);
+
+	nugu_metric_add(gauge, 2);
+	nugu_metric_add(gauge, -5);
+	g_assert_cmpint(nugu_metric_get(gauge), ==, -3);
+	nugu_metric_set(gauge, 7);
+	g_assert_cmpint(nugu_metric_get(gauge), ==, 7);
+
+	/* gauges are kept */
+	nugu_metrics_reset();
+	g_assert_cmpint(nugu_metric_get(counter), ==, 0);
+	g_assert_cmpint(nugu_metric_get(gauge), ==, 7);
+
+	/* NULL is ignored */
+	nugu_metric_add(NULL, 1);
+	nugu_metric_set(NULL, 1);
+	nugu_metric_observe(NULL, 1);
+}
+
+static void test_metrics_register_once(void)
+{
+	static NuguMetric *handle;
+	NuguMetric *counter;
+
+	counter = nugu_metrics_register_once(&handle, "test_once_counter",
+					     NUGU_METRIC_TYPE_COUNTER, NULL);
+	g_assert(counter != NULL);
+	g_assert(handle == counter);
+	g_assert(nugu_metrics_find("test_once_counter") == counter);
+
+	/* the handle is returned without the lookup */
+	g_assert(nugu_metrics_register_once(&handle, "test_once_counter",
+					    NUGU_METRIC_TYPE_COUNTER,
+					    NULL) == counter);
+
+	/* values beyond 32-bit are kept */
+	nugu_metric_add(counter, G_MAXUINT32);
+	nugu_metric_add(counter, G_MAXUINT32);
+	g_assert_cmpint(nugu_metric_get(counter), ==,
+			(gint64)G_MAXUINT32 * 2);
+
+	nugu_metrics_reset();
+	g_assert_cmpint(nugu_metric_get(counter), ==, 0);
+}
+
+static void test_metrics_histogram(void)
+{
+	struct nugu_metric_snapshot snapshots[NUGU_METRICS_MAX];
+	struct nugu_metric_snapshot *snapshot = NULL;
+	NuguMetric *hist;
+	int count;
+	int i;
+
+	hist = nugu_metrics_register("test_histogram",
+				     NUGU_METRIC_TYPE_HISTOGRAM, NULL);
+	g_assert(hist != NULL);
+
+	nugu_metric_observe(hist, 0);
+	nugu_metric_observe(hist, 1);
+	nugu_metric_observe(hist, 2);
+	nugu_metric_observe(hist, 3);
+	nugu_metric_observe(hist, 4);
+	nugu_metric_observe(hist, 1000000000);
+
+	count = nugu_metrics_get_snapshot(snapshots, NUGU_METRICS_MAX);
+	for (i = 0; i < count; i++) {
+		if (g_strcmp0(snapshots[i].name, "test_histogram") == 0)
+			snapshot = &snapshots[i];
+	}
+
+	g_assert(snapshot != NULL);
+	g_assert_cmpint(snapshot->type, ==, NUGU_METRIC_TYPE_HISTOGRAM);
+	g_assert_cmpint(snapshot->count, ==, 6);
+	g_assert_cmpint(snapshot->value, ==, 1000000010);
+
+	/* le=1: 0, 1 / le=2: 2 / le=4: 3, 4 / +Inf: 1000000000 */
+	g_assert_cmpint(snapshot->buckets[0], ==, 2);
+	g_assert_cmpint(snapshot->buckets[1], ==, 1);
+	g_assert_cmpint(snapshot->buckets[2], ==, 2);
+	g_assert_cmpint(snapshot->buckets[NUGU_METRICS_BUCKETS - 1], ==, 1);
+}
+
+static void test_metrics_format(void)
+{
+	NuguMetric *counter;
+	char *text;
+
+	counter = nugu_metrics_register("test_format_total",
+					NUGU_METRIC_TYPE_COUNTER,
+					"Total of the format test");
+	nugu_metric_add(counter, 42);
+
+	text = nugu_metrics_format();
+	g_assert(text != NULL);
+
+	g_assert(strstr(text, "# HELP test_format_total "
+			      "Total of the format test\n") != NULL);
+	g_assert(strstr(text, "# TYPE test_format_total counter\n") != NULL);
+	g_assert(strstr(text, "\ntest_format_total 42\n") != NULL);
+	g_assert(strstr(text, "# TYPE test_histogram histogram\n") != NULL);
+	g_assert(strstr(text, "test_histogram_bucket{le=\"4\"} 5\n") != NULL);
+	g_assert(strstr(text, "test_histogram_bucket{le=\"+Inf\"} 6\n") !=
+		 NULL);
+	g_assert(strstr(text, "test_histogram_count 6\n") != NULL);
+
+	free(text);
+}
+
+static void test_metrics_concurrent(void)
+{
+	GThread *threads[TEST_THREADS];
+	NuguMetric *counter;
+	int i;
+
+	counter = nugu_metrics_register("test_concurrent",
+					NUGU_METRIC_TYPE_COUNTER, NULL);
+
+	for (i = 0; i < TEST_THREADS; i++)
+		threads[i] = g_thread_new("metrics", add_thread, counter);
+
+	for (i = 0; i < TEST_THREADS; i++)
+		g_thread_join(threads[i]);
+
+	g_assert_cmpint(nugu_metric_get(counter), ==,
+			TEST_THREADS * TEST_ADDS_PER_THREAD);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/metrics/register", test_metrics_register);
+	g_test_add_func("/metrics/register_once", test_metrics_register_once);
+	g_test_add_func("/metrics/histogram", test_metrics_histogram);
+	g_test_add_func("/metrics/format", test_metrics_format);
+	g_test_add_func("/metrics/concurrent", test_metrics_concurrent);
+
+	return g_test_run();
+}
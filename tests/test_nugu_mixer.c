@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_mainloop.h"
+#include "base/nugu_mixer.h"
+
+/* 10 msec of 22050 Hz mono */
+#define PERIOD_SAMPLES 220
+
+/* 1 second of the source */
+#define SOURCE_SAMPLES 22050
+
+#define WAIT_TIMEOUT_MSEC 3000
+
+static int _output_started;
+static int _eos_count;
+
+static int output_create(NuguPcmDriver *driver, NuguPcm *pcm,
+			 NuguAudioProperty property)
+{
+	return 0;
+}
+
+static int output_start(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	/* the output is started without holding the mixer lock */
+	g_assert(nugu_mixer_get_ducking(NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND) >
+		 0.0f);
+
+	_output_started++;
+	return 0;
+}
+
+static int output_stop(NuguPcmDriver *driver, NuguPcm *pcm)
+{
+	_output_started--;
+	return 0;
+}
+
+static struct nugu_pcm_driver_ops output_ops = {
+	.create = output_create,
+	.start = output_start,
+	.stop = output_stop
+};
+
+static void on_event(enum nugu_media_event event, void *userdata)
+{
+	if (event == NUGU_MEDIA_EVENT_END_OF_STREAM)
+		_eos_count++;
+}
+
+static NuguAudioProperty make_property(enum nugu_audio_sample_rate rate)
+{
+	NuguAudioProperty prop;
+
+	prop.samplerate = rate;
+	prop.format = NUGU_AUDIO_FORMAT_S16_LE;
+	prop.channel = 1;
+
+	return prop;
+}
+
+static void push_constant(NuguPcm *pcm, int16_t value, int count, int is_last)
+{
+	int16_t *samples = g_new(int16_t, count);
+	int i;
+
+	for (i = 0; i < count; i++)
+		samples[i] = GINT16_TO_LE(value);
+
+	g_assert(nugu_pcm_push_data(pcm, (const char *)samples,
+				    count * sizeof(int16_t), is_last) > 0);
+	g_free(samples);
+}
+
+/* read a period from the output like the device, returns the last sample */
+static int16_t read_period(NuguPcm *output)
+{
+	int16_t samples[PERIOD_SAMPLES];
+	size_t copied = 0;
+	gint64 until = g_get_monotonic_time() + WAIT_TIMEOUT_MSEC * 1000;
+
+	while (copied < sizeof(samples)) {
+		int len = nugu_pcm_get_data(output, (char *)samples + copied,
+					    sizeof(samples) - copied);
+
+		g_assert(len >= 0);
+		copied += len;
+
+		if (copied < sizeof(samples)) {
+			g_assert(g_get_monotonic_time() < until);
+			g_usleep(1000);
+		}
+	}
+
+	return GINT16_FROM_LE(samples[PERIOD_SAMPLES - 1]);
+}
+
+static void test_mixer_mix(void)
+{
+	NuguPcmDriver *output_driver;
+	NuguPcm *output;
+	NuguPcm *tts;
+	NuguPcm *beep;
+	int16_t value = 0;
+	int i;
+
+	output_driver = nugu_pcm_driver_new("test_output", &output_ops);
+	g_assert(nugu_mixer_initialize(
+			 output_driver,
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_22K)) == 0);
+	g_assert(nugu_mixer_get_driver() != NULL);
+
+	output = nugu_mixer_get_output();
+	g_assert(output != NULL);
+
+	tts = nugu_pcm_new("tts", nugu_mixer_get_driver(),
+			   make_property(NUGU_AUDIO_SAMPLE_RATE_22K));
+	g_assert(tts != NULL);
+	nugu_pcm_set_audio_attribute(tts, NUGU_AUDIO_ATTRIBUTE_VOICE_COMMAND);
+
+	/* converted by the resampler */
+	beep = nugu_pcm_new("beep", nugu_mixer_get_driver(),
+			    make_property(NUGU_AUDIO_SAMPLE_RATE_16K));
+	g_assert(beep != NULL);
+	nugu_pcm_set_audio_attribute(beep, NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND);
+
+	/* the output is opened once for the sources */
+	g_assert(nugu_pcm_start(tts) == 0);
+	g_assert(nugu_pcm_start(beep) == 0);
+	g_assert_cmpint(_output_started, ==, 1);
+
+	push_constant(tts, 1000, SOURCE_SAMPLES, 0);
+	push_constant(beep, 4000, SOURCE_SAMPLES, 0);
+
+	/* per-source gain by the volume */
+	g_assert(nugu_pcm_set_volume(beep, 50) == 0);
+
+	for (i = 0; i < 30; i++)
+		value = read_period(output);
+	g_assert_cmpint(value, >=, 2990);
+	g_assert_cmpint(value, <=, 3010);
+
+	/* ducking is ramped to the target */
+	g_assert(nugu_mixer_set_ducking(NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND,
+					0.25f) == 0);
+	g_assert(nugu_mixer_get_ducking(NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND) ==
+		 0.25f);
+
+	for (i = 0; i < 30; i++)
+		value = read_period(output);
+	g_assert_cmpint(value, >=, 1490);
+	g_assert_cmpint(value, <=, 1510);
+
+	g_assert(nugu_mixer_set_ducking(NUGU_AUDIO_ATTRIBUTE_SYSTEM_SOUND,
+					1.0f) == 0);
+
+	/* paused source is not mixed */
+	g_assert(nugu_pcm_pause(beep) == 0);
+
+	for (i = 0; i < 10; i++)
+		value = read_period(output);
+	g_assert_cmpint(value, ==, 1000);
+
+	g_assert(nugu_pcm_stop(tts) == 0);
+	g_assert(nugu_pcm_stop(beep) == 0);
+
+	/* pcm objects still use the mixer */
+	g_assert(nugu_mixer_deinitialize() == -1);
+
+	nugu_pcm_free(tts);
+	nugu_pcm_free(beep);
+
+	g_assert(nugu_mixer_deinitialize() == 0);
+	g_assert(nugu_mixer_get_driver() == NULL);
+	g_assert_cmpint(_output_started, ==, 0);
+
+	nugu_pcm_driver_free(output_driver);
+}
+
+static void test_mixer_eos(void)
+{
+	NuguPcmDriver *output_driver;
+	NuguPcm *output;
+	NuguPcm *pcm;
+	char buf[PERIOD_SAMPLES * sizeof(int16_t)];
+	size_t consumed = 0;
+	gint64 until;
+
+	output_driver = nugu_pcm_driver_new("test_output", &output_ops);
+	g_assert(nugu_mixer_initialize(
+			 output_driver,
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_22K)) == 0);
+	output = nugu_mixer_get_output();
+
+	pcm = nugu_pcm_new("tts", nugu_mixer_get_driver(),
+			   make_property(NUGU_AUDIO_SAMPLE_RATE_22K));
+	nugu_pcm_set_event_callback(pcm, on_event, NULL);
+
+	_eos_count = 0;
+	g_assert(nugu_pcm_start(pcm) == 0);
+	push_constant(pcm, 1000, PERIOD_SAMPLES * 5, 1);
+
+	/* end of stream after the device plays out the source */
+	until = g_get_monotonic_time() + WAIT_TIMEOUT_MSEC * 1000;
+	while (_eos_count == 0) {
+		g_assert(g_get_monotonic_time() < until);
+
+		consumed += nugu_pcm_get_data(output, buf, sizeof(buf));
+		while (g_main_context_iteration(nugu_mainloop_get_context(),
+						FALSE))
+			;
+		g_usleep(1000);
+	}
+
+	g_assert_cmpuint(consumed, >=, sizeof(buf) * 5);
+	g_assert_cmpint(_eos_count, ==, 1);
+
+	g_assert(nugu_pcm_stop(pcm) == 0);
+	nugu_pcm_free(pcm);
+
+	g_assert(nugu_mixer_deinitialize() == 0);
+	nugu_pcm_driver_free(output_driver);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/mixer/mix", test_mixer_mix);
+	g_test_add_func("/mixer/eos", test_mixer_eos);
+
+	return g_test_run();
+}
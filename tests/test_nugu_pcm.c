@@ -243,6 +243,216 @@ static void test_pcm_audio_attribute(void)
 	nugu_pcm_driver_remove(driver);
 }
 
+#define TEST_STREAM_SIZE (1024 * 1024)
+#define TEST_PUSH_SIZE 4096
+
+#define TEST_RESERVE_SIZE 960
+
+static gpointer _producer(gpointer userdata)
+{
+	NuguPcm *pcm = userdata;
+	char buf[TEST_PUSH_SIZE];
+	char *reserved;
+	int total = 0;
+	int i;
+
+	while (total < TEST_STREAM_SIZE) {
+		for (i = 0; i < TEST_PUSH_SIZE; i++)
+			buf[i] = (char)((total + i) & 0xFF);
+
+		g_assert(nugu_pcm_push_data(pcm, buf, TEST_PUSH_SIZE, 0) ==
+			 TEST_PUSH_SIZE);
+		total += TEST_PUSH_SIZE;
+
+		/* write directly to the reserved space */
+		reserved = nugu_pcm_reserve_data(pcm, TEST_RESERVE_SIZE);
+		g_assert(reserved != NULL);
+
+		for (i = 0; i < TEST_RESERVE_SIZE; i++)
+			reserved[i] = (char)((total + i) & 0xFF);
+
+		g_assert(nugu_pcm_commit_data(pcm, TEST_RESERVE_SIZE, 0) == 0);
+		total += TEST_RESERVE_SIZE;
+	}
+
+	nugu_pcm_push_data_done(pcm);
+
+	return NULL;
+}
+
+static void test_pcm_buffer(void)
+{
+	NuguPcmDriver *driver;
+	NuguPcm *pcm;
+	NuguAudioProperty prop;
+	GThread *thread;
+	char *data;
+	char *ptr;
+	char tmp[1000];
+	int total = 0;
+	int ret;
+	int i;
+
+	driver = nugu_pcm_driver_new("dummy", &dummy_driver_ops);
+	g_assert(driver != NULL);
+
+	prop.samplerate = NUGU_AUDIO_SAMPLE_RATE_22K;
+	prop.format = NUGU_AUDIO_FORMAT_S16_LE;
+	prop.channel = 1;
+
+	pcm = nugu_pcm_new("buffer", driver, prop);
+	g_assert(pcm != NULL);
+
+	/* push the data larger than the internal chunk */
+	data = g_malloc(50000);
+	for (i = 0; i < 50000; i++)
+		data[i] = (char)(i & 0xFF);
+
+	g_assert(nugu_pcm_push_data(pcm, data, 50000, 0) == 50000);
+	g_assert(nugu_pcm_get_data_size(pcm) == 50000);
+
+	while (total < 50000) {
+		ret = nugu_pcm_get_data(pcm, tmp, sizeof(tmp));
+		g_assert(ret == sizeof(tmp));
+		g_assert(memcmp(tmp, data + total, ret) == 0);
+		total += ret;
+	}
+	g_assert(nugu_pcm_get_data_size(pcm) == 0);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 0);
+
+	/* no more data before the last data */
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 0);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 1);
+
+	/* no more data after the last data is not an underrun */
+	g_assert(nugu_pcm_push_data_done(pcm) == 0);
+	g_assert(nugu_pcm_receive_is_last_data(pcm) == 1);
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 0);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 1);
+
+	/* clear the remaining data */
+	g_assert(nugu_pcm_push_data(pcm, data, 50000, 0) == 50000);
+	g_assert(nugu_pcm_get_data(pcm, tmp, 10) == 10);
+	nugu_pcm_clear_buffer(pcm);
+	g_assert(nugu_pcm_get_data_size(pcm) == 0);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 0);
+	g_assert(nugu_pcm_receive_is_last_data(pcm) == 0);
+
+	g_assert(nugu_pcm_push_data(pcm, "abc", 3, 1) == 3);
+	g_assert(nugu_pcm_get_data_size(pcm) == 3);
+	memset(tmp, 0, sizeof(tmp));
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 3);
+	g_assert_cmpstr(tmp, ==, "abc");
+
+	/* reserve closes the chunk which doesn't have enough space */
+	nugu_pcm_clear_buffer(pcm);
+	g_assert(nugu_pcm_push_data(pcm, data, 16000, 0) == 16000);
+	g_assert(nugu_pcm_reserve_data(pcm, 20000) == NULL);
+	g_assert(nugu_pcm_commit_data(pcm, 1, 0) < 0);
+
+	ptr = nugu_pcm_reserve_data(pcm, 1000);
+	g_assert(ptr != NULL);
+	memset(ptr, 'x', 1000);
+	g_assert(nugu_pcm_commit_data(pcm, 500, 0) == 0);
+	g_assert(nugu_pcm_get_data_size(pcm) == 16500);
+
+	total = 0;
+	while ((ret = nugu_pcm_get_data(pcm, tmp, sizeof(tmp))) > 0) {
+		for (i = 0; i < ret; i++) {
+			if (total + i < 16000)
+				g_assert(tmp[i] == data[total + i]);
+			else
+				g_assert(tmp[i] == 'x');
+		}
+		total += ret;
+	}
+	g_assert(total == 16500);
+
+	g_free(data);
+
+	/* producer thread and consumer without lock */
+	nugu_pcm_clear_buffer(pcm);
+
+	thread = g_thread_new("producer", _producer, pcm);
+
+	total = 0;
+	while (!nugu_pcm_receive_is_last_data(pcm) ||
+	       nugu_pcm_get_data_size(pcm) > 0) {
+		ret = nugu_pcm_get_data(pcm, tmp, sizeof(tmp));
+		g_assert(ret >= 0);
+
+		for (i = 0; i < ret; i++)
+			g_assert(tmp[i] == (char)((total + i) & 0xFF));
+
+		total += ret;
+	}
+
+	g_thread_join(thread);
+
+	g_assert(total >= TEST_STREAM_SIZE);
+	g_assert(total % (TEST_PUSH_SIZE + TEST_RESERVE_SIZE) == 0);
+	g_assert(nugu_pcm_get_data_size(pcm) == 0);
+	g_assert(nugu_pcm_receive_is_last_data(pcm) == 1);
+
+	nugu_pcm_free(pcm);
+	nugu_pcm_driver_free(driver);
+}
+
+static void test_pcm_start_threshold(void)
+{
+	NuguPcmDriver *driver;
+	NuguAudioProperty prop;
+	NuguPcm *pcm;
+	char tmp[100];
+
+	driver = nugu_pcm_driver_new("dummy", &dummy_driver_ops);
+	g_assert(driver != NULL);
+
+	prop.samplerate = NUGU_AUDIO_SAMPLE_RATE_22K;
+	prop.format = NUGU_AUDIO_FORMAT_S16_LE;
+	prop.channel = 1;
+
+	pcm = nugu_pcm_new("threshold", driver, prop);
+	g_assert(pcm != NULL);
+
+	nugu_pcm_set_start_threshold(pcm, 10);
+	g_assert(nugu_pcm_get_start_threshold(pcm) == 10);
+	g_assert(nugu_pcm_get_start_latency(pcm) == -1);
+
+	/* buffering is not an underrun */
+	g_assert(nugu_pcm_push_data(pcm, "12345", 5, 0) == 5);
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 0);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 0);
+	g_assert(nugu_pcm_get_start_latency(pcm) == -1);
+
+	g_assert(nugu_pcm_push_data(pcm, "67890", 5, 0) == 5);
+	g_assert(nugu_pcm_get_total_size(pcm) == 10);
+	g_assert(nugu_pcm_get_data(pcm, tmp, 3) == 3);
+	g_assert(nugu_pcm_get_start_latency(pcm) >= 0);
+
+	/* started, the threshold is not applied to the same stream */
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 7);
+	g_assert(nugu_pcm_push_data(pcm, "ab", 2, 0) == 2);
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 2);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 2);
+
+	/* applied again to the next stream */
+	nugu_pcm_clear_buffer(pcm);
+	g_assert(nugu_pcm_get_start_latency(pcm) == -1);
+	g_assert(nugu_pcm_get_total_size(pcm) == 0);
+
+	g_assert(nugu_pcm_push_data(pcm, "abc", 3, 0) == 3);
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 0);
+
+	/* the last data starts the playback under the threshold */
+	g_assert(nugu_pcm_push_data_done(pcm) == 0);
+	g_assert(nugu_pcm_get_data(pcm, tmp, sizeof(tmp)) == 3);
+	g_assert(nugu_pcm_get_underrun_count(pcm) == 0);
+
+	nugu_pcm_free(pcm);
+	nugu_pcm_driver_free(driver);
+}
+
 int main(int argc, char *argv[])
 {
 #if !GLIB_CHECK_VERSION(2, 36, 0)
@@ -255,6 +465,8 @@ int main(int argc, char *argv[])
 	g_test_add_func("/pcm/default", test_pcm_default);
 	g_test_add_func("/pcm/driver", test_pcm_multiple);
 	g_test_add_func("/pcm/audio_attribute", test_pcm_audio_attribute);
+	g_test_add_func("/pcm/buffer", test_pcm_buffer);
+	g_test_add_func("/pcm/start_threshold", test_pcm_start_threshold);
 
 	return g_test_run();
 }
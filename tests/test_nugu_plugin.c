@@ -22,6 +22,8 @@
 
 #include "base/nugu_plugin.h"
 
+#define PARALLEL_PLUGINS 3
+
 static struct nugu_plugin_desc test_plugin_desc = {
 	.name = "test",
 	.priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
@@ -86,6 +88,155 @@ static struct nugu_plugin_desc p3_desc = {
 	.init = init_ok
 };
 
+static gint parallel_entered;
+static gint parallel_overlapped;
+
+static int init_count(NuguPlugin *p)
+{
+	gint *count = nugu_plugin_get_data(p);
+
+	if (count)
+		g_atomic_int_inc(count);
+
+	return 0;
+}
+
+static int init_wait_others(NuguPlugin *p)
+{
+	gint64 timeout = g_get_monotonic_time() + G_USEC_PER_SEC;
+
+	g_atomic_int_inc(&parallel_entered);
+
+	/* all init() are running at the same time if initialized in parallel */
+	while (g_atomic_int_get(&parallel_entered) < PARALLEL_PLUGINS) {
+		if (g_get_monotonic_time() > timeout)
+			return 0;
+
+		g_usleep(1000);
+	}
+
+	g_atomic_int_inc(&parallel_overlapped);
+
+	return 0;
+}
+
+#define EXT(p_provides, p_flags)                                               \
+	{                                                                      \
+		.size = sizeof(struct nugu_plugin_desc_ext),                   \
+		.provides = p_provides, .flags = p_flags                       \
+	}
+
+static struct nugu_plugin_desc lazy_desc = {
+	.name = "lazy",
+	.priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	.version = "0.1",
+	.load = load_ok,
+	.unload = NULL,
+	.init = init_count
+};
+
+static struct nugu_plugin_desc_ext lazy_ext = EXT(
+	NUGU_PLUGIN_PROVIDES_PCM | NUGU_PLUGIN_PROVIDES_RECORDER,
+	NUGU_PLUGIN_FLAG_LAZY);
+
+static struct nugu_plugin_desc lazy_fail_desc = {
+	.name = "lazy_fail",
+	.priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	.version = "0.1",
+	.load = load_ok,
+	.unload = NULL,
+	.init = init_fail
+};
+
+static struct nugu_plugin_desc_ext lazy_fail_ext =
+	EXT(NUGU_PLUGIN_PROVIDES_DECODER, NUGU_PLUGIN_FLAG_LAZY);
+
+/* same as the portaudio drivers which need the 'portaudio' plugin */
+static int init_dependent(NuguPlugin *p)
+{
+	if (!nugu_plugin_find("base"))
+		return -1;
+
+	return init_ok(p);
+}
+
+static struct nugu_plugin_desc dependent_descs[] = {
+	{ .name = "base",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_fail },
+	{ .name = "dependent",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT + 1,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_dependent }
+};
+
+static struct nugu_plugin_desc parallel_descs[] = {
+	{ .name = "pcm",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_wait_others },
+	{ .name = "player",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_wait_others },
+	{ .name = "recorder",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_wait_others },
+	/* same driver type with 'pcm', so initialized after 'pcm' */
+	{ .name = "pcm2",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_ok },
+	/* not declared, so initialized first on the caller thread */
+	{ .name = "none",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_ok }
+};
+
+static struct nugu_plugin_desc_ext parallel_exts[] = {
+	EXT(NUGU_PLUGIN_PROVIDES_PCM, 0),
+	EXT(NUGU_PLUGIN_PROVIDES_PLAYER, 0),
+	EXT(NUGU_PLUGIN_PROVIDES_RECORDER, 0),
+	EXT(NUGU_PLUGIN_PROVIDES_PCM, 0),
+	EXT(0, 0)
+};
+
+/* lazy plugins of the different priorities which share the pcm */
+static struct nugu_plugin_desc multi_descs[] = {
+	{ .name = "multi",
+	  .priority = NUGU_PLUGIN_PRIORITY_DEFAULT,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_ok },
+	{ .name = "high",
+	  .priority = NUGU_PLUGIN_PRIORITY_HIGH,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_ok },
+	{ .name = "rec",
+	  .priority = NUGU_PLUGIN_PRIORITY_LOW,
+	  .version = "0.1",
+	  .load = load_ok,
+	  .init = init_ok }
+};
+
+static struct nugu_plugin_desc_ext multi_exts[] = {
+	EXT(NUGU_PLUGIN_PROVIDES_PCM | NUGU_PLUGIN_PROVIDES_DECODER,
+	    NUGU_PLUGIN_FLAG_LAZY),
+	EXT(NUGU_PLUGIN_PROVIDES_PCM, NUGU_PLUGIN_FLAG_LAZY),
+	EXT(NUGU_PLUGIN_PROVIDES_RECORDER, NUGU_PLUGIN_FLAG_LAZY)
+};
+
 static void test_plugin_priority(void)
 {
 	NuguPlugin *p1;
@@ -125,6 +276,138 @@ static void test_plugin_priority(void)
 	nugu_plugin_deinitialize();
 }
 
+static void test_plugin_lazy(void)
+{
+	NuguPlugin *p;
+	NuguPlugin *p_fail;
+	gint count = 0;
+
+	p = nugu_plugin_new_full(&lazy_desc, &lazy_ext);
+	g_assert(p != NULL);
+	g_assert(nugu_plugin_add(p) == 0);
+	g_assert(nugu_plugin_set_data(p, &count) == 0);
+
+	p_fail = nugu_plugin_new_full(&lazy_fail_desc, &lazy_fail_ext);
+	g_assert(p_fail != NULL);
+	g_assert(nugu_plugin_add(p_fail) == 0);
+
+	/* lazy plugins are not initialized */
+	g_assert_cmpint(nugu_plugin_initialize(), ==, 0);
+	g_assert_cmpint(count, ==, 0);
+	g_assert(nugu_plugin_find("lazy") == NULL);
+
+	/* other driver type */
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PLAYER), ==,
+			0);
+	g_assert_cmpint(count, ==, 0);
+
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_RECORDER), ==,
+			1);
+	g_assert_cmpint(count, ==, 1);
+	g_assert(nugu_plugin_find("lazy") == p);
+
+	/* initialized only once */
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_PCM), ==, 0);
+	g_assert_cmpint(count, ==, 1);
+
+	/* failed lazy plugin is removed */
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_DECODER), ==,
+			0);
+	g_assert(nugu_plugin_find("lazy_fail") == NULL);
+
+	nugu_plugin_deinitialize();
+
+#ifdef NUGU_ENV_PLUGIN_INIT
+	/* all plugins are initialized at once */
+	g_setenv(NUGU_ENV_PLUGIN_INIT, "serial", TRUE);
+
+	count = 0;
+	p = nugu_plugin_new_full(&lazy_desc, &lazy_ext);
+	g_assert(p != NULL);
+	g_assert(nugu_plugin_add(p) == 0);
+	g_assert(nugu_plugin_set_data(p, &count) == 0);
+
+	g_assert_cmpint(nugu_plugin_initialize(), ==, 1);
+	g_assert_cmpint(count, ==, 1);
+
+	nugu_plugin_deinitialize();
+
+	g_unsetenv(NUGU_ENV_PLUGIN_INIT);
+#endif
+}
+
+static void test_plugin_parallel(void)
+{
+	char check[30];
+	size_t i;
+
+	check[0] = '\0';
+
+	for (i = 0; i < G_N_ELEMENTS(parallel_descs); i++) {
+		NuguPlugin *p = nugu_plugin_new_full(&parallel_descs[i],
+						     &parallel_exts[i]);
+
+		g_assert(p != NULL);
+		g_assert(nugu_plugin_add(p) == 0);
+		g_assert(nugu_plugin_set_data(p, check) == 0);
+	}
+
+	g_assert_cmpint(nugu_plugin_initialize(), ==,
+			G_N_ELEMENTS(parallel_descs));
+
+	/* only 'none' and 'pcm2' write the name */
+	g_assert_cmpstr(check, ==, "nonepcm2");
+
+	g_assert_cmpint(parallel_overlapped, ==, PARALLEL_PLUGINS);
+
+	nugu_plugin_deinitialize();
+}
+
+static void test_plugin_lazy_multi(void)
+{
+	struct nugu_plugin_desc_ext old_ext;
+	char check[30];
+	size_t i;
+
+	check[0] = '\0';
+
+	for (i = 0; i < G_N_ELEMENTS(multi_descs); i++) {
+		NuguPlugin *p = nugu_plugin_new_full(&multi_descs[i],
+						     &multi_exts[i]);
+
+		g_assert(p != NULL);
+		g_assert(nugu_plugin_add(p) == 0);
+		g_assert(nugu_plugin_set_data(p, check) == 0);
+	}
+
+	g_assert_cmpint(nugu_plugin_initialize(), ==, 0);
+
+	/* the higher priority pcm plugin is initialized before 'multi' */
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_DECODER), ==,
+			2);
+	g_assert_cmpstr(check, ==, "highmulti");
+
+	g_assert_cmpint(nugu_plugin_require(NUGU_PLUGIN_PROVIDES_RECORDER), ==,
+			1);
+	g_assert_cmpstr(check, ==, "highmultirec");
+
+	nugu_plugin_deinitialize();
+
+	/* the fields beyond the size of the older extension are ignored */
+	old_ext = multi_exts[0];
+	old_ext.size = sizeof(unsigned int) * 2;
+
+	check[0] = '\0';
+	g_assert(nugu_plugin_add(nugu_plugin_new_full(&multi_descs[0],
+						      &old_ext)) == 0);
+	g_assert(nugu_plugin_set_data(nugu_plugin_find("multi"), check) == 0);
+
+	g_assert_cmpint(nugu_plugin_initialize(), ==, 1);
+	g_assert_cmpstr(check, ==, "multi");
+
+	nugu_plugin_deinitialize();
+}
+
 static void test_plugin_init_fail(void)
 {
 	NuguPlugin *p;
@@ -147,6 +430,34 @@ static void test_plugin_init_fail(void)
 	nugu_plugin_deinitialize();
 }
 
+static void test_plugin_find_failed(void)
+{
+	size_t i;
+	int serial;
+
+	for (serial = 0; serial < 2; serial++) {
+#ifdef NUGU_ENV_PLUGIN_INIT
+		if (serial)
+			g_setenv(NUGU_ENV_PLUGIN_INIT, "serial", TRUE);
+#endif
+
+		for (i = 0; i < G_N_ELEMENTS(dependent_descs); i++)
+			g_assert(nugu_plugin_add(nugu_plugin_new(
+					 &dependent_descs[i])) == 0);
+
+		/* the failed 'base' is not found by the 'dependent' */
+		g_assert_cmpint(nugu_plugin_initialize(), ==, 0);
+		g_assert(nugu_plugin_find("base") == NULL);
+		g_assert(nugu_plugin_find("dependent") == NULL);
+
+		nugu_plugin_deinitialize();
+
+#ifdef NUGU_ENV_PLUGIN_INIT
+		g_unsetenv(NUGU_ENV_PLUGIN_INIT);
+#endif
+	}
+}
+
 static void test_plugin_load(void)
 {
 	NuguPlugin *plugin;
@@ -257,6 +568,10 @@ int main(int argc, char *argv[])
 	g_test_add_func("/plugin/default", test_plugin_default);
 	g_test_add_func("/plugin/init_fail", test_plugin_init_fail);
 	g_test_add_func("/plugin/priority", test_plugin_priority);
+	g_test_add_func("/plugin/lazy", test_plugin_lazy);
+	g_test_add_func("/plugin/parallel", test_plugin_parallel);
+	g_test_add_func("/plugin/lazy_multi", test_plugin_lazy_multi);
+	g_test_add_func("/plugin/find_failed", test_plugin_find_failed);
 	g_test_add_func("/plugin/load", test_plugin_load);
 
 	return g_test_run();
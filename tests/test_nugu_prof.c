@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_mainloop.h"
+#include "base/nugu_prof.h"
+
+#define DIALOG_1 "00000000000000000000000000000001"
+#define DIALOG_2 "00000000000000000000000000000002"
+
+#define TEST_LATENCY_COUNT 20
+#define TEST_LATENCY_USEC 2000
+
+#define TEST_THREADS 4
+#define TEST_MARKS_PER_THREAD 10000
+
+/* more than the marks waiting for the callback */
+#define TEST_PENDING_MARKS 256
+
+static struct nugu_prof_record records[NUGU_PROF_RING_SIZE];
+
+static void assert_timeline(const char *dialog_id,
+			    const enum nugu_prof_type *expected, int count)
+{
+	int i;
+
+	g_assert_cmpint(nugu_prof_get_timeline(dialog_id, records,
+					       NUGU_PROF_RING_SIZE),
+			==, count);
+
+	for (i = 0; i < count; i++) {
+		g_assert_cmpint(records[i].type, ==, expected[i]);
+		g_assert_cmpstr(records[i].dialog_id, ==, dialog_id);
+
+		if (i > 0)
+			g_assert_cmpint(records[i].timestamp_ns, >=,
+					records[i - 1].timestamp_ns);
+	}
+}
+
+static void test_prof_timeline(void)
+{
+	const enum nugu_prof_type expected[] = {
+		NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED,
+		NUGU_PROF_TYPE_ASR_LISTENING_STARTED,
+		NUGU_PROF_TYPE_ASR_RECOGNIZE,
+		NUGU_PROF_TYPE_ASR_RECOGNIZING_STARTED,
+		NUGU_PROF_TYPE_ASR_END_POINT_DETECTED,
+		NUGU_PROF_TYPE_ASR_RESULT,
+		NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE,
+		NUGU_PROF_TYPE_TTS_STARTED,
+		NUGU_PROF_TYPE_TTS_FIRST_PCM_WRITE
+	};
+
+	nugu_prof_clear();
+
+	/* not related to the dialog */
+	nugu_prof_mark(NUGU_PROF_TYPE_NETWORK_PING_REQUEST);
+
+	nugu_prof_mark(NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RECOGNIZE, DIALOG_1, NULL, NULL);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_RECOGNIZING_STARTED);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_END_POINT_DETECTED);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RESULT, DIALOG_1, NULL, NULL);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE, DIALOG_1, NULL,
+			    NULL);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_STARTED, DIALOG_1, NULL, NULL);
+	nugu_prof_mark(NUGU_PROF_TYPE_TTS_FIRST_PCM_WRITE);
+
+	assert_timeline(DIALOG_1, expected, G_N_ELEMENTS(expected));
+
+	/* unknown dialog */
+	g_assert_cmpint(nugu_prof_get_timeline(DIALOG_2, records,
+					       NUGU_PROF_RING_SIZE),
+			==, 0);
+
+	/* limited by the max */
+	g_assert_cmpint(nugu_prof_get_timeline(DIALOG_1, records, 3), ==, 3);
+	g_assert_cmpint(records[2].type, ==, NUGU_PROF_TYPE_ASR_RECOGNIZE);
+
+	g_assert_cmpint(nugu_prof_get_timeline(NULL, records, 1), ==, -1);
+	g_assert_cmpint(nugu_prof_get_timeline(DIALOG_1, records, 0), ==, -1);
+
+	nugu_prof_clear();
+	g_assert_cmpint(nugu_prof_get_timeline(DIALOG_1, records,
+					       NUGU_PROF_RING_SIZE),
+			==, 0);
+}
+
+static void test_prof_overlap(void)
+{
+	const enum nugu_prof_type expected_1[] = {
+		NUGU_PROF_TYPE_ASR_RECOGNIZE,
+		NUGU_PROF_TYPE_ASR_END_POINT_DETECTED,
+		NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE,
+		NUGU_PROF_TYPE_TTS_STARTED,
+		NUGU_PROF_TYPE_TTS_FIRST_PCM_WRITE
+	};
+	const enum nugu_prof_type expected_2[] = {
+		NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED,
+		NUGU_PROF_TYPE_ASR_LISTENING_STARTED,
+		NUGU_PROF_TYPE_ASR_RECOGNIZE,
+		NUGU_PROF_TYPE_ASR_END_POINT_DETECTED
+	};
+
+	nugu_prof_clear();
+
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RECOGNIZE, DIALOG_1, NULL, NULL);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_END_POINT_DETECTED);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_SPEAK_DIRECTIVE, DIALOG_1, NULL,
+			    NULL);
+
+	/* barge-in while the first dialog is speaking */
+	nugu_prof_mark(NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_STARTED, DIALOG_1, NULL, NULL);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+	nugu_prof_mark(NUGU_PROF_TYPE_TTS_FIRST_PCM_WRITE);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RECOGNIZE, DIALOG_2, NULL, NULL);
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_END_POINT_DETECTED);
+
+	assert_timeline(DIALOG_1, expected_1, G_N_ELEMENTS(expected_1));
+	assert_timeline(DIALOG_2, expected_2, G_N_ELEMENTS(expected_2));
+}
+
+static void test_prof_ring_wrap(void)
+{
+	const enum nugu_prof_type expected[] = {
+		NUGU_PROF_TYPE_ASR_RECOGNIZE, NUGU_PROF_TYPE_ASR_RESULT
+	};
+	int i;
+
+	nugu_prof_clear();
+
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RECOGNIZE, DIALOG_1, NULL, NULL);
+
+	for (i = 0; i < NUGU_PROF_RING_SIZE; i++)
+		nugu_prof_mark(NUGU_PROF_TYPE_NETWORK_PING_REQUEST);
+
+	/* overwritten by the newer records */
+	g_assert_cmpint(nugu_prof_get_timeline(DIALOG_1, records,
+					       NUGU_PROF_RING_SIZE),
+			==, 0);
+
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RECOGNIZE, DIALOG_2, NULL, NULL);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_ASR_RESULT, DIALOG_2, NULL, NULL);
+
+	assert_timeline(DIALOG_2, expected, G_N_ELEMENTS(expected));
+}
+
+static void test_prof_latency(void)
+{
+	struct nugu_prof_latency latency;
+	int i;
+
+	nugu_prof_clear();
+
+	/* no relative type */
+	g_assert_cmpint(nugu_prof_get_latency(
+				NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED,
+				&latency),
+			==, -1);
+
+	g_assert_cmpint(nugu_prof_get_latency(
+				NUGU_PROF_TYPE_ASR_LISTENING_STARTED, &latency),
+			==, 0);
+	g_assert_cmpint(latency.from, ==,
+			NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED);
+	g_assert_cmpint(latency.to, ==, NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+	g_assert_cmpuint(latency.count, ==, 0);
+
+	for (i = 0; i < TEST_LATENCY_COUNT; i++) {
+		nugu_prof_mark(NUGU_PROF_TYPE_WAKEUP_KEYWORD_DETECTED);
+		g_usleep(TEST_LATENCY_USEC);
+		nugu_prof_mark(NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+	}
+
+	/* counted only once for each mark of the relative type */
+	nugu_prof_mark(NUGU_PROF_TYPE_ASR_LISTENING_STARTED);
+
+	g_assert_cmpint(nugu_prof_get_latency(
+				NUGU_PROF_TYPE_ASR_LISTENING_STARTED, &latency),
+			==, 0);
+	g_assert_cmpuint(latency.count, ==, TEST_LATENCY_COUNT);
+	g_assert_cmpint(latency.min, >=, TEST_LATENCY_USEC);
+	g_assert_cmpint(latency.p50, >=, latency.min);
+	g_assert_cmpint(latency.p90, >=, latency.p50);
+	g_assert_cmpint(latency.p99, >=, latency.p90);
+	g_assert_cmpint(latency.max, >=, latency.p99);
+
+	nugu_prof_clear();
+
+	g_assert_cmpint(nugu_prof_get_latency(
+				NUGU_PROF_TYPE_ASR_LISTENING_STARTED, &latency),
+			==, 0);
+	g_assert_cmpuint(latency.count, ==, 0);
+}
+
+static gpointer mark_thread(gpointer userdata)
+{
+	const char *dialog_id = userdata;
+	int i;
+
+	for (i = 0; i < TEST_MARKS_PER_THREAD; i++)
+		nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_STARTED, dialog_id,
+				    NULL, NULL);
+
+	return NULL;
+}
+
+static void test_prof_concurrent(void)
+{
+	char dialog_ids[TEST_THREADS][NUGU_MAX_UUID_STRING_SIZE + 1];
+	GThread *threads[TEST_THREADS];
+	int total = 0;
+	int i;
+	int j;
+
+	nugu_prof_clear();
+
+	for (i = 0; i < TEST_THREADS; i++) {
+		g_snprintf(dialog_ids[i], sizeof(dialog_ids[i]), "%032d", i);
+		threads[i] = g_thread_new("mark", mark_thread, dialog_ids[i]);
+	}
+
+	/* read while the writers are running */
+	for (j = 0; j < 100; j++) {
+		for (i = 0; i < TEST_THREADS; i++) {
+			int count;
+			int k;
+
+			count = nugu_prof_get_timeline(dialog_ids[i], records,
+						       NUGU_PROF_RING_SIZE);
+			g_assert_cmpint(count, >=, 0);
+
+			for (k = 0; k < count; k++)
+				g_assert_cmpstr(records[k].dialog_id, ==,
+						dialog_ids[i]);
+		}
+	}
+
+	for (i = 0; i < TEST_THREADS; i++)
+		g_thread_join(threads[i]);
+
+	/* the ring keeps the latest records of all the threads */
+	for (i = 0; i < TEST_THREADS; i++)
+		total += nugu_prof_get_timeline(dialog_ids[i], records,
+						NUGU_PROF_RING_SIZE);
+
+	g_assert_cmpint(total, ==, NUGU_PROF_RING_SIZE);
+}
+
+struct callback_result {
+	int count;
+	enum nugu_prof_type types[4];
+	char contents[4][16];
+};
+
+static void on_prof(enum nugu_prof_type type, const struct nugu_prof_data *data,
+		    void *userdata)
+{
+	struct callback_result *result = userdata;
+
+	g_assert_cmpint(type, ==, data->type);
+	g_assert_cmpint(result->count, <, 4);
+
+	result->types[result->count] = type;
+	g_strlcpy(result->contents[result->count],
+		  data->contents ? data->contents : "",
+		  sizeof(result->contents[0]));
+	result->count++;
+}
+
+static void test_prof_callback(void)
+{
+	struct callback_result result;
+
+	memset(&result, 0, sizeof(result));
+
+	nugu_prof_clear();
+	nugu_prof_set_callback(on_prof, &result);
+
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_CACHE_MISS, DIALOG_1, NULL,
+			    "first");
+	nugu_prof_mark(NUGU_PROF_TYPE_TTS_STARTED);
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_CACHE_MISS, DIALOG_1, NULL,
+			    "second");
+
+	while (g_main_context_iteration(nugu_mainloop_get_context(), FALSE))
+		;
+
+	/* each mark is delivered in the order of the marking */
+	g_assert_cmpint(result.count, ==, 3);
+	g_assert_cmpint(result.types[0], ==, NUGU_PROF_TYPE_TTS_CACHE_MISS);
+	g_assert_cmpstr(result.contents[0], ==, "first");
+	g_assert_cmpint(result.types[1], ==, NUGU_PROF_TYPE_TTS_STARTED);
+	g_assert_cmpstr(result.contents[1], ==, "");
+	g_assert_cmpint(result.types[2], ==, NUGU_PROF_TYPE_TTS_CACHE_MISS);
+	g_assert_cmpstr(result.contents[2], ==, "second");
+
+	/* the last data does not have the contents of the callback */
+	nugu_prof_mark_data(NUGU_PROF_TYPE_TTS_CACHE_MISS, DIALOG_1, NULL,
+			    "third");
+	nugu_prof_set_callback(NULL, NULL);
+
+	while (g_main_context_iteration(nugu_mainloop_get_context(), FALSE))
+		;
+
+	g_assert_cmpint(result.count, ==, 3);
+
+	nugu_prof_clear();
+}
+
+static void on_prof_count(enum nugu_prof_type type,
+			  const struct nugu_prof_data *data, void *userdata)
+{
+	(*(int *)userdata)++;
+}
+
+static void test_prof_callback_full(void)
+{
+	int count = 0;
+	int i;
+
+	nugu_prof_clear();
+	nugu_prof_set_callback(on_prof_count, &count);
+
+	/* the marks over the pending slots are not delivered */
+	for (i = 0; i < TEST_PENDING_MARKS * 2; i++)
+		nugu_prof_mark(NUGU_PROF_TYPE_TTS_STARTED);
+
+	while (g_main_context_iteration(nugu_mainloop_get_context(), FALSE))
+		;
+
+	g_assert_cmpint(count, >, 0);
+	g_assert_cmpint(count, <, TEST_PENDING_MARKS * 2);
+
+	/* delivered again after the slots are drained */
+	count = 0;
+	for (i = 0; i < 10; i++)
+		nugu_prof_mark(NUGU_PROF_TYPE_TTS_STARTED);
+
+	while (g_main_context_iteration(nugu_mainloop_get_context(), FALSE))
+		;
+
+	g_assert_cmpint(count, ==, 10);
+
+	nugu_prof_set_callback(NULL, NULL);
+	nugu_prof_clear();
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/prof/timeline", test_prof_timeline);
+	g_test_add_func("/prof/overlap", test_prof_overlap);
+	g_test_add_func("/prof/ring_wrap", test_prof_ring_wrap);
+	g_test_add_func("/prof/latency", test_prof_latency);
+	g_test_add_func("/prof/concurrent", test_prof_concurrent);
+	g_test_add_func("/prof/callback", test_prof_callback);
+	g_test_add_func("/prof/callback_full", test_prof_callback_full);
+
+	return g_test_run();
+}
@@ -95,6 +95,37 @@ static struct nugu_recorder_driver_ops timeout_driver_ops = {
 	.stop = timeout_stop
 };
 
+static int _driver_started;
+
+/* the driver is never started twice by the linked recorders */
+static int linked_start(NuguRecorderDriver *driver, NuguRecorder *rec,
+			NuguAudioProperty property)
+{
+	int16_t data[2] = { 0, 0 };
+
+	(void)driver;
+	(void)property;
+
+	g_assert(g_atomic_int_compare_and_exchange(&_driver_started, 0, 1));
+
+	return nugu_recorder_push_frame(rec, (char *)data, sizeof(data));
+}
+
+static int linked_stop(NuguRecorderDriver *driver, NuguRecorder *rec)
+{
+	(void)driver;
+	(void)rec;
+
+	g_assert(g_atomic_int_compare_and_exchange(&_driver_started, 1, 0));
+
+	return 0;
+}
+
+static struct nugu_recorder_driver_ops linked_driver_ops = {
+	.start = linked_start,
+	.stop = linked_stop
+};
+
 static gint _push_data(void *p)
 {
 	int *count = (int *)p;
@@ -223,6 +254,134 @@ static void test_recorder_timeout(void)
 	nugu_recorder_driver_free(rec_drv);
 }
 
+static void test_recorder_source(void)
+{
+	NuguAudioProperty property;
+	NuguRecorderDriver *rec_drv;
+	NuguRecorder *source;
+	NuguRecorder *mono;
+	NuguRecorder *stereo;
+	int16_t data[2] = { 100, -200 };
+	int16_t temp[4];
+	int size;
+	int max;
+
+	SET_DEFAULT_AUDIO_PROPERTY(property);
+
+	rec_drv = nugu_recorder_driver_new(DEFAULT_PLUGIN_NAME,
+					   &timeout_driver_ops);
+	nugu_recorder_driver_register(rec_drv);
+
+	source = nugu_recorder_new("rec_source", rec_drv);
+	g_assert(nugu_recorder_set_property(source, property) == 0);
+	g_assert(nugu_recorder_set_frame_size(source, sizeof(data),
+					      SET_AUDIO_MAX_FRAMES) == 0);
+
+	mono = nugu_recorder_new("rec_mono", NULL);
+	g_assert(nugu_recorder_set_property(mono, property) == 0);
+
+	property.channel = 2;
+	stereo = nugu_recorder_new("rec_stereo", NULL);
+	g_assert(nugu_recorder_set_property(stereo, property) == 0);
+
+	g_assert(nugu_recorder_set_source(mono, mono) == -1);
+	g_assert(nugu_recorder_set_source(mono, source) == 0);
+	g_assert(nugu_recorder_set_source(stereo, source) == 0);
+	g_assert(nugu_recorder_get_source(stereo) == source);
+
+	// starting the linked recorder starts the source
+	g_assert(nugu_recorder_start(mono) == 0);
+	g_assert(nugu_recorder_is_recording(source) == 1);
+	g_assert(nugu_recorder_start(stereo) == 0);
+	g_assert(nugu_recorder_set_source(stereo, NULL) == -1);
+
+	// frame of the same duration
+	g_assert(nugu_recorder_get_frame_size(stereo, &size, &max) == 0);
+	g_assert(size == sizeof(data) * 2 && max == SET_AUDIO_MAX_FRAMES);
+
+	g_assert(nugu_recorder_push_frame(source, (char *)data,
+					  sizeof(data)) == 0);
+
+	g_assert(nugu_recorder_get_frame(mono, (char *)temp, &size) == 0);
+	g_assert(size == sizeof(data));
+	g_assert(temp[0] == 100 && temp[1] == -200);
+
+	g_assert(nugu_recorder_get_frame(stereo, (char *)temp, &size) == 0);
+	g_assert(size == sizeof(data) * 2);
+	g_assert(temp[0] == 100 && temp[1] == 100);
+	g_assert(temp[2] == -200 && temp[3] == -200);
+
+	// the source is stopped by the last linked recorder
+	g_assert(nugu_recorder_stop(mono) == 0);
+	g_assert(nugu_recorder_is_recording(source) == 1);
+	g_assert(nugu_recorder_stop(stereo) == 0);
+	g_assert(nugu_recorder_is_recording(source) == 0);
+	g_assert(nugu_recorder_is_recording(stereo) == 0);
+
+	nugu_recorder_free(stereo);
+	nugu_recorder_free(mono);
+	nugu_recorder_free(source);
+	nugu_recorder_driver_remove(rec_drv);
+	nugu_recorder_driver_free(rec_drv);
+}
+
+static void *_start_stop_linked(void *data)
+{
+	NuguRecorder *rec = data;
+	int i;
+
+	for (i = 0; i < 1000; i++) {
+		g_assert(nugu_recorder_start(rec) == 0);
+		g_assert(nugu_recorder_stop(rec) == 0);
+	}
+
+	return NULL;
+}
+
+static void test_recorder_source_threads(void)
+{
+	NuguAudioProperty property;
+	NuguRecorderDriver *rec_drv;
+	NuguRecorder *source;
+	NuguRecorder *sinks[2];
+	pthread_t tids[2];
+	int i;
+
+	SET_DEFAULT_AUDIO_PROPERTY(property);
+
+	rec_drv = nugu_recorder_driver_new(DEFAULT_PLUGIN_NAME,
+					   &linked_driver_ops);
+	nugu_recorder_driver_register(rec_drv);
+
+	source = nugu_recorder_new("rec_source", rec_drv);
+	g_assert(nugu_recorder_set_property(source, property) == 0);
+	g_assert(nugu_recorder_set_frame_size(source, 4,
+					      SET_AUDIO_MAX_FRAMES) == 0);
+
+	for (i = 0; i < 2; i++) {
+		sinks[i] = nugu_recorder_new("rec_sink", NULL);
+		g_assert(nugu_recorder_set_property(sinks[i], property) == 0);
+		g_assert(nugu_recorder_set_source(sinks[i], source) == 0);
+	}
+
+	// the source is started and stopped once by the linked recorders
+	for (i = 0; i < 2; i++)
+		pthread_create(&tids[i], NULL, _start_stop_linked, sinks[i]);
+
+	for (i = 0; i < 2; i++)
+		pthread_join(tids[i], NULL);
+
+	g_assert(nugu_recorder_is_recording(source) == 0);
+	g_assert(g_atomic_int_get(&_driver_started) == 0);
+
+	for (i = 0; i < 2; i++)
+		nugu_recorder_free(sinks[i]);
+
+	nugu_recorder_free(source);
+	nugu_recorder_driver_remove(rec_drv);
+	nugu_recorder_driver_free(rec_drv);
+}
+
 int main(int argc, char *argv[])
 {
 #if !GLIB_CHECK_VERSION(2, 36, 0)
@@ -234,5 +393,8 @@ int main(int argc, char *argv[])
 
 	g_test_add_func("/recorder/default", test_recorder_default);
 	g_test_add_func("/recorder/timeout", test_recorder_timeout);
+	g_test_add_func("/recorder/source", test_recorder_source);
+	g_test_add_func("/recorder/source_threads",
+			test_recorder_source_threads);
 	return g_test_run();
 }
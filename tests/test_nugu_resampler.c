@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_mainloop.h"
+#include "base/nugu_plugin.h"
+#include "base/nugu_recorder.h"
+#include "base/nugu_resampler.h"
+
+/* 1 second of 16 kHz */
+#define TEST_FRAMES 16000
+
+/* skip the edges of the round trip which are not fully filtered */
+#define TEST_MARGIN 400
+
+#define BENCHMARK_SECONDS 60
+
+/* cos and sin of pi/8: 1 kHz at 16 kHz */
+#define COS_1K 0.92387953251128674
+#define SIN_1K 0.38268343236508977
+
+static const enum nugu_audio_sample_rate test_rates[] = {
+	NUGU_AUDIO_SAMPLE_RATE_8K, NUGU_AUDIO_SAMPLE_RATE_22K,
+	NUGU_AUDIO_SAMPLE_RATE_32K, NUGU_AUDIO_SAMPLE_RATE_44K
+};
+
+static NuguAudioProperty make_property(enum nugu_audio_sample_rate rate,
+				       enum nugu_audio_format format,
+				       int channel)
+{
+	NuguAudioProperty prop;
+
+	prop.samplerate = rate;
+	prop.format = format;
+	prop.channel = channel;
+
+	return prop;
+}
+
+/* sine wave by the rotation, to avoid the libm dependency */
+static void fill_sine(int16_t *samples, int count, double cos_w, double sin_w,
+		      double amplitude)
+{
+	double c = 1.0;
+	double s = 0.0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		double tmp = c * cos_w - s * sin_w;
+
+		samples[i] = (int16_t)(s * amplitude);
+
+		s = s * cos_w + c * sin_w;
+		c = tmp;
+	}
+}
+
+static double energy(const int16_t *samples, int count)
+{
+	double sum = 0;
+	int i;
+
+	for (i = 0; i < count; i++)
+		sum += (double)samples[i] * samples[i];
+
+	return sum;
+}
+
+static int convert(NuguResampler *rs, const int16_t *in, int frames,
+		   int16_t **out)
+{
+	size_t size = frames * sizeof(int16_t);
+	size_t out_size = nugu_resampler_get_output_size(rs, size);
+	int ret;
+
+	*out = g_malloc(out_size);
+	ret = nugu_resampler_process(rs, in, size, *out, out_size);
+	g_assert(ret >= 0);
+
+	return ret / (int)sizeof(int16_t);
+}
+
+static void test_resampler_unsupported(void)
+{
+	g_assert(nugu_resampler_new(
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+				       NUGU_AUDIO_FORMAT_S24_LE, 1),
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+				       NUGU_AUDIO_FORMAT_S16_LE, 1)) == NULL);
+	g_assert(nugu_resampler_new(
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_MAX,
+				       NUGU_AUDIO_FORMAT_S16_LE, 1),
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+				       NUGU_AUDIO_FORMAT_S16_LE, 1)) == NULL);
+	g_assert(nugu_resampler_new(
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+				       NUGU_AUDIO_FORMAT_S16_LE, 3),
+			 make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+				       NUGU_AUDIO_FORMAT_S16_LE, 2)) == NULL);
+}
+
+static void test_resampler_passthrough(void)
+{
+	NuguAudioProperty prop = make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					       NUGU_AUDIO_FORMAT_S16_LE, 1);
+	NuguResampler *rs;
+	int16_t in[5] = { 1, -2, 3, -32768, 32767 };
+	int16_t out[6];
+
+	rs = nugu_resampler_new(prop, prop);
+	g_assert(rs != NULL);
+	g_assert(nugu_resampler_is_passthrough(rs) == 1);
+	g_assert(nugu_resampler_convert_size(rs, sizeof(in)) == sizeof(in));
+
+	g_assert(nugu_resampler_process(rs, in, sizeof(in), out, 4) == -1);
+	g_assert(nugu_resampler_process(rs, in, sizeof(in), out,
+					sizeof(out)) == sizeof(in));
+	g_assert_cmpmem(in, sizeof(in), out, sizeof(in));
+
+	nugu_resampler_free(rs);
+}
+
+static void test_resampler_channel(void)
+{
+	NuguResampler *rs;
+	int16_t mono[3] = { 0x0102, -2, 300 };
+	int16_t stereo[6] = { 100, 200, -100, -300, 7, 8 };
+	int16_t out[8];
+	int i;
+
+	/* mono little endian -> stereo big endian */
+	rs = nugu_resampler_new(make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 1),
+				make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_BE, 2));
+	g_assert(rs != NULL);
+	g_assert(nugu_resampler_is_passthrough(rs) == 0);
+	g_assert(nugu_resampler_convert_size(rs, sizeof(mono)) ==
+		 sizeof(stereo));
+
+	g_assert(nugu_resampler_process(rs, mono, sizeof(mono), out,
+					sizeof(out)) == sizeof(stereo));
+	for (i = 0; i < 3; i++) {
+		int16_t value = GINT16_TO_BE(mono[i]);
+
+		g_assert_cmpint(out[i * 2], ==, value);
+		g_assert_cmpint(out[i * 2 + 1], ==, value);
+	}
+	nugu_resampler_free(rs);
+
+	/* stereo -> mono */
+	rs = nugu_resampler_new(make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 2),
+				make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 1));
+	g_assert(rs != NULL);
+
+	g_assert(nugu_resampler_process(rs, stereo, sizeof(stereo), out,
+					sizeof(out)) == 3 * sizeof(int16_t));
+	g_assert_cmpint(out[0], ==, 150);
+	g_assert_cmpint(out[1], ==, -200);
+	g_assert_cmpint(out[2], ==, 7);
+
+	/* incomplete frame is kept for the next call */
+	g_assert(nugu_resampler_process(rs, stereo, 3, out, sizeof(out)) == 0);
+	g_assert(nugu_resampler_process(rs, (char *)stereo + 3, 1, out,
+					sizeof(out)) == sizeof(int16_t));
+	g_assert_cmpint(out[0], ==, 150);
+	nugu_resampler_free(rs);
+}
+
+static void test_resampler_stream(void)
+{
+	NuguAudioProperty in = make_property(NUGU_AUDIO_SAMPLE_RATE_44K,
+					     NUGU_AUDIO_FORMAT_S16_BE, 2);
+	NuguAudioProperty out = make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 1);
+	NuguResampler *rs;
+	GRand *rand = g_rand_new_with_seed(1234);
+	int16_t *src;
+	int16_t *whole;
+	char *chunked;
+	size_t pos = 0;
+	size_t len = 0;
+	int count;
+	int i;
+
+	src = g_new(int16_t, TEST_FRAMES);
+	for (i = 0; i < TEST_FRAMES; i++)
+		src[i] = (int16_t)g_rand_int_range(rand, -16384, 16384);
+	g_rand_free(rand);
+
+	rs = nugu_resampler_new(in, out);
+	g_assert(rs != NULL);
+	count = convert(rs, src, TEST_FRAMES, &whole);
+	g_assert_cmpint(count, >, 0);
+
+	/* same output with the chunks of odd sizes */
+	nugu_resampler_reset(rs);
+	chunked = g_malloc(count * sizeof(int16_t) + 4096);
+
+	while (pos < TEST_FRAMES * sizeof(int16_t)) {
+		size_t size = MIN(pos % 37 + 1, TEST_FRAMES * sizeof(int16_t) -
+							 pos);
+		size_t out_size = nugu_resampler_get_output_size(rs, size);
+		int ret;
+
+		g_assert(len + out_size <= count * sizeof(int16_t) + 4096);
+		ret = nugu_resampler_process(rs, (char *)src + pos, size,
+					     chunked + len, out_size);
+		g_assert_cmpint(ret, >=, 0);
+
+		pos += size;
+		len += ret;
+	}
+
+	g_assert_cmpuint(len, ==, count * sizeof(int16_t));
+	g_assert_cmpmem(whole, count * sizeof(int16_t), chunked, len);
+
+	g_free(chunked);
+	g_free(whole);
+	g_free(src);
+	nugu_resampler_free(rs);
+}
+
+static void test_resampler_quality(void)
+{
+	NuguAudioProperty base = make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					       NUGU_AUDIO_FORMAT_S16_LE, 1);
+	int16_t *src;
+	size_t i;
+
+	src = g_new(int16_t, TEST_FRAMES);
+	fill_sine(src, TEST_FRAMES, COS_1K, SIN_1K, 16000.0);
+
+	for (i = 0; i < G_N_ELEMENTS(test_rates); i++) {
+		NuguAudioProperty prop = make_property(
+			test_rates[i], NUGU_AUDIO_FORMAT_S16_LE, 1);
+		NuguResampler *forward = nugu_resampler_new(base, prop);
+		NuguResampler *backward = nugu_resampler_new(prop, base);
+		int16_t *mid;
+		int16_t *result;
+		double signal;
+		double noise = 0;
+		int count;
+		int n;
+
+		g_assert(forward != NULL);
+		g_assert(backward != NULL);
+
+		count = convert(forward, src, TEST_FRAMES, &mid);
+		count = convert(backward, mid, count, &result);
+		g_assert_cmpint(count, >, TEST_FRAMES - 2 * TEST_MARGIN);
+
+		/* the output is aligned to the input */
+		for (n = TEST_MARGIN; n < TEST_FRAMES - 2 * TEST_MARGIN; n++) {
+			double diff = result[n] - src[n];
+
+			noise += diff * diff;
+		}
+		signal = energy(src + TEST_MARGIN,
+				TEST_FRAMES - 3 * TEST_MARGIN);
+
+		g_test_message("16000 -> %zd -> 16000: signal/noise %.1f",
+			       nugu_resampler_convert_size(forward, 32000) / 2,
+			       signal / noise);
+
+		/* SNR > 50 dB */
+		g_assert(signal > noise * 100000.0);
+
+		g_free(mid);
+		g_free(result);
+		nugu_resampler_free(forward);
+		nugu_resampler_free(backward);
+	}
+
+	g_free(src);
+}
+
+static void test_resampler_alias(void)
+{
+	NuguResampler *rs;
+	int16_t *src;
+	int16_t *out;
+	double ratio;
+	int count;
+
+	/* 7 kHz at 16 kHz is aliased to 1 kHz at 8 kHz without the filter */
+	src = g_new(int16_t, TEST_FRAMES);
+	fill_sine(src, TEST_FRAMES, -COS_1K, SIN_1K, 16000.0);
+
+	rs = nugu_resampler_new(make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 1),
+				make_property(NUGU_AUDIO_SAMPLE_RATE_8K,
+					      NUGU_AUDIO_FORMAT_S16_LE, 1));
+	g_assert(rs != NULL);
+
+	count = convert(rs, src, TEST_FRAMES, &out);
+	g_assert_cmpint(count, >, TEST_FRAMES / 2 - TEST_MARGIN);
+
+	ratio = energy(out + TEST_MARGIN / 2, count - TEST_MARGIN) /
+		energy(src + TEST_MARGIN, (count - TEST_MARGIN) * 2);
+	g_test_message("alias: %g", ratio);
+
+	/* attenuated more than 50 dB */
+	g_assert(ratio < 0.00001);
+
+	g_free(out);
+	g_free(src);
+	nugu_resampler_free(rs);
+}
+
+static void test_resampler_benchmark(void)
+{
+	NuguAudioProperty base = make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					       NUGU_AUDIO_FORMAT_S16_LE, 1);
+	int16_t *src;
+	void *out;
+	size_t out_size;
+	GTimer *timer;
+	size_t i;
+	int loop;
+
+	src = g_new(int16_t, TEST_FRAMES);
+	fill_sine(src, TEST_FRAMES, COS_1K, SIN_1K, 16000.0);
+
+	timer = g_timer_new();
+
+	for (i = 0; i < G_N_ELEMENTS(test_rates); i++) {
+		NuguResampler *rs = nugu_resampler_new(
+			base, make_property(test_rates[i],
+					    NUGU_AUDIO_FORMAT_S16_LE, 2));
+		double elapsed;
+
+		/* 100 ms chunks like the recorder drivers, with the history */
+		out_size = nugu_resampler_get_output_size(rs, 3200 * 2);
+		out = g_malloc(out_size);
+
+		g_timer_start(timer);
+		for (loop = 0; loop < BENCHMARK_SECONDS * 10; loop++)
+			g_assert(nugu_resampler_process(
+					 rs, src + (loop % 10) * 1600, 3200,
+					 out, out_size) > 0);
+		elapsed = g_timer_elapsed(timer, NULL);
+
+		g_test_message("16000 mono -> %zd stereo: %f sec (x%.0f)",
+			       nugu_resampler_convert_size(rs, 3200) * 10 / 4,
+			       elapsed, BENCHMARK_SECONDS / elapsed);
+
+		g_free(out);
+		nugu_resampler_free(rs);
+	}
+
+	g_timer_destroy(timer);
+	g_free(src);
+}
+
+static NuguRecorderDriver *load_filereader(void)
+{
+	NuguRecorderDriver *driver;
+	NuguPlugin *plugin;
+
+	driver = nugu_recorder_driver_find("filereader");
+	if (driver)
+		return driver;
+
+	plugin = nugu_plugin_new_from_file(PLUGINPATH
+					   "/filereader" NUGU_PLUGIN_FILE_EXTENSION);
+	if (!plugin)
+		return NULL;
+
+	nugu_plugin_add(plugin);
+	nugu_plugin_initialize();
+
+	return nugu_recorder_driver_find("filereader");
+}
+
+/**
+ * Capture the NUGU_RECORDING_FROM_FILE (16 kHz, mono, S16_LE) once by the
+ * filereader and feed all the sample rates.
+ */
+static void test_resampler_filereader(void)
+{
+	NuguAudioProperty prop = make_property(NUGU_AUDIO_SAMPLE_RATE_16K,
+					       NUGU_AUDIO_FORMAT_S16_LE, 1);
+	NuguRecorder *sinks[G_N_ELEMENTS(test_rates)];
+	NuguRecorderDriver *driver;
+	NuguRecorder *source;
+	GTimer *timer;
+	size_t i;
+
+	if (!getenv(NUGU_ENV_RECORDING_FROM_FILE)) {
+		g_test_skip("NUGU_RECORDING_FROM_FILE is not set");
+		return;
+	}
+
+	driver = load_filereader();
+	if (!driver) {
+		g_test_skip("filereader is not available");
+		return;
+	}
+
+	source = nugu_recorder_new("source", driver);
+	nugu_recorder_set_property(source, prop);
+
+	for (i = 0; i < G_N_ELEMENTS(test_rates); i++) {
+		char name[16];
+
+		snprintf(name, sizeof(name), "sink%zd", i);
+		sinks[i] = nugu_recorder_new(name, NULL);
+		nugu_recorder_set_property(
+			sinks[i], make_property(test_rates[i],
+						NUGU_AUDIO_FORMAT_S16_LE, 1));
+		g_assert(nugu_recorder_set_source(sinks[i], source) == 0);
+		g_assert(nugu_recorder_start(sinks[i]) == 0);
+	}
+
+	timer = g_timer_new();
+
+	/* the filereader pushes the whole file in the idle callback */
+	while (nugu_recorder_get_frame_count(source) == 0 &&
+	       g_timer_elapsed(timer, NULL) < 5)
+		g_main_context_iteration(nugu_mainloop_get_context(), FALSE);
+
+	g_test_message("capture and conversion: %f sec",
+		       g_timer_elapsed(timer, NULL));
+	g_timer_destroy(timer);
+
+	g_assert_cmpint(nugu_recorder_get_frame_count(source), >, 0);
+
+	for (i = 0; i < G_N_ELEMENTS(test_rates); i++) {
+		int size = 0;
+		int max = 0;
+
+		nugu_recorder_get_frame_size(sinks[i], &size, &max);
+		g_test_message("sink%zd: %d frames of %d bytes", i,
+			       nugu_recorder_get_frame_count(sinks[i]), size);
+		g_assert_cmpint(nugu_recorder_get_frame_count(sinks[i]), >, 0);
+
+		g_assert(nugu_recorder_stop(sinks[i]) == 0);
+		nugu_recorder_free(sinks[i]);
+	}
+
+	g_assert(nugu_recorder_is_recording(source) == 0);
+	nugu_recorder_free(source);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/resampler/unsupported", test_resampler_unsupported);
+	g_test_add_func("/resampler/passthrough", test_resampler_passthrough);
+	g_test_add_func("/resampler/channel", test_resampler_channel);
+	g_test_add_func("/resampler/stream", test_resampler_stream);
+	g_test_add_func("/resampler/quality", test_resampler_quality);
+	g_test_add_func("/resampler/alias", test_resampler_alias);
+
+	if (g_test_perf()) {
+		g_test_add_func("/resampler/benchmark",
+				test_resampler_benchmark);
+		g_test_add_func("/resampler/filereader",
+				test_resampler_filereader);
+	}
+
+	return g_test_run();
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_sample.h"
+
+/* odd length to cover the scalar tail of each SIMD loop */
+#define TEST_SAMPLES 1003
+#define BENCHMARK_SAMPLES 4800
+#define BENCHMARK_LOOP 20000
+
+static const enum nugu_sample_isa test_isa[] = { NUGU_SAMPLE_ISA_SSE2,
+						 NUGU_SAMPLE_ISA_AVX2,
+						 NUGU_SAMPLE_ISA_NEON };
+
+struct sample_result {
+	int16_t swap[TEST_SAMPLES];
+	float fsamples[TEST_SAMPLES];
+	int16_t s16[TEST_SAMPLES];
+	int16_t mono[TEST_SAMPLES / 2];
+	int16_t gain[TEST_SAMPLES];
+	int16_t attenuate[TEST_SAMPLES];
+};
+
+static int16_t src_s16[TEST_SAMPLES];
+static float src_float[TEST_SAMPLES];
+
+static void fill_source(void)
+{
+	GRand *rand = g_rand_new_with_seed(1234);
+	int i;
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		src_s16[i] = (int16_t)g_rand_int_range(rand, -32768, 32768);
+		src_float[i] = (float)g_rand_double_range(rand, -1.5, 1.5);
+	}
+
+	/* boundary values */
+	src_s16[0] = -32768;
+	src_s16[1] = 32767;
+	src_s16[2] = 0;
+	src_float[0] = 1.0f;
+	src_float[1] = -1.0f;
+	src_float[2] = 0.5f / 32768.0f;
+	src_float[3] = 1.5f / 32768.0f;
+	src_float[4] = 40000.0f;
+	src_float[5] = -40000.0f;
+
+	g_rand_free(rand);
+}
+
+static void run_kernels(struct sample_result *result)
+{
+	nugu_sample_s16_swap(src_s16, result->swap, TEST_SAMPLES);
+	nugu_sample_s16_to_float(src_s16, result->fsamples, TEST_SAMPLES);
+	nugu_sample_float_to_s16(src_float, result->s16, TEST_SAMPLES);
+	nugu_sample_s16_downmix_stereo(src_s16, result->mono, TEST_SAMPLES / 2);
+	nugu_sample_s16_gain(src_s16, result->gain, TEST_SAMPLES, 2.0f);
+	nugu_sample_s16_gain(src_s16, result->attenuate, TEST_SAMPLES, 0.3f);
+}
+
+static void test_sample_scalar(void)
+{
+	int16_t s16[8] = { 0x0102, -2, 0, 0, 0, 0, 0, 0 };
+	int16_t out[8];
+	unsigned char le[4];
+	float f[2];
+	float fin[4] = { 0.5f, -1.0f, 2.0f, 1.5f / 32768.0f };
+
+	g_assert(nugu_sample_set_isa(NUGU_SAMPLE_ISA_SCALAR) == 0);
+	g_assert(nugu_sample_get_isa() == NUGU_SAMPLE_ISA_SCALAR);
+	g_assert_cmpstr(nugu_sample_isa_name(NUGU_SAMPLE_ISA_SCALAR), ==,
+			"scalar");
+
+	/* little-endian byte stream */
+	nugu_sample_s16_to_le(s16, le, 2);
+	g_assert(le[0] == 0x02 && le[1] == 0x01);
+	g_assert(le[2] == 0xFE && le[3] == 0xFF);
+
+	nugu_sample_s16_from_le(le, out, 2);
+	g_assert(out[0] == 0x0102 && out[1] == -2);
+
+	/* in-place byte swap */
+	nugu_sample_s16_swap(s16, s16, 1);
+	g_assert(s16[0] == 0x0201);
+
+	nugu_sample_s16_to_float(out, f, 2);
+	g_assert(f[0] == 0x0102 / 32768.0f);
+	g_assert(f[1] == -2 / 32768.0f);
+
+	/* saturation and round to nearest even */
+	nugu_sample_float_to_s16(fin, out, 4);
+	g_assert(out[0] == 16384);
+	g_assert(out[1] == -32768);
+	g_assert(out[2] == 32767);
+	g_assert(out[3] == 2);
+
+	/* in-place down-mix */
+	s16[0] = 100;
+	s16[1] = 201;
+	s16[2] = -32768;
+	s16[3] = -32768;
+	s16[4] = 32767;
+	s16[5] = -1;
+	nugu_sample_s16_downmix_stereo(s16, s16, 3);
+	g_assert(s16[0] == 150);
+	g_assert(s16[1] == -32768);
+	g_assert(s16[2] == 16383);
+
+	s16[0] = 20000;
+	s16[1] = -20000;
+	s16[2] = 3;
+	nugu_sample_s16_gain(s16, out, 3, 2.0f);
+	g_assert(out[0] == 32767);
+	g_assert(out[1] == -32768);
+	g_assert(out[2] == 6);
+
+	g_assert(nugu_sample_float_dot(fin, fin, 0) == 0.0f);
+	g_assert(nugu_sample_float_dot(fin, fin, 2) == 1.25f);
+
+	g_assert(nugu_sample_set_isa(NUGU_SAMPLE_ISA_AUTO) == 0);
+	g_assert(nugu_sample_get_isa() != NUGU_SAMPLE_ISA_AUTO);
+}
+
+static void test_sample_simd(void)
+{
+	struct sample_result *expected = g_new0(struct sample_result, 1);
+	struct sample_result *result = g_new0(struct sample_result, 1);
+	float expected_dot;
+	float dot;
+	size_t i;
+
+	fill_source();
+
+	g_assert(nugu_sample_set_isa(NUGU_SAMPLE_ISA_SCALAR) == 0);
+	run_kernels(expected);
+	expected_dot = nugu_sample_float_dot(src_float + 6, src_float + 6,
+					     TEST_SAMPLES - 6);
+
+	for (i = 0; i < G_N_ELEMENTS(test_isa); i++) {
+		if (nugu_sample_set_isa(test_isa[i]) != 0) {
+			g_test_message("%s: not supported",
+				       nugu_sample_isa_name(test_isa[i]));
+			continue;
+		}
+
+		g_test_message("%s: compare with scalar",
+			       nugu_sample_isa_name(test_isa[i]));
+
+		memset(result, 0, sizeof(struct sample_result));
+		run_kernels(result);
+
+		g_assert(memcmp(expected, result,
+				sizeof(struct sample_result)) == 0);
+
+		/* only the summation order is different */
+		dot = nugu_sample_float_dot(src_float + 6, src_float + 6,
+					    TEST_SAMPLES - 6);
+		g_assert(dot > expected_dot * 0.9999f &&
+			 dot < expected_dot * 1.0001f);
+	}
+
+	nugu_sample_set_isa(NUGU_SAMPLE_ISA_AUTO);
+
+	g_free(expected);
+	g_free(result);
+}
+
+static void benchmark_isa(enum nugu_sample_isa isa, int16_t *s16, float *f,
+			  int16_t *mono)
+{
+	GTimer *timer;
+	int loop;
+
+	if (nugu_sample_set_isa(isa) != 0)
+		return;
+
+	timer = g_timer_new();
+
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		nugu_sample_s16_to_float(s16, f, BENCHMARK_SAMPLES);
+	g_test_message("%s: s16 -> float: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		nugu_sample_float_to_s16(f, s16, BENCHMARK_SAMPLES);
+	g_test_message("%s: float -> s16: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		nugu_sample_s16_swap(s16, s16, BENCHMARK_SAMPLES);
+	g_test_message("%s: byte swap: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		nugu_sample_s16_downmix_stereo(s16, mono,
+					       BENCHMARK_SAMPLES / 2);
+	g_test_message("%s: down-mix: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		nugu_sample_s16_gain(s16, s16, BENCHMARK_SAMPLES, 0.9f);
+	g_test_message("%s: gain: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_start(timer);
+	for (loop = 0; loop < BENCHMARK_LOOP; loop++)
+		f[loop % BENCHMARK_SAMPLES] +=
+			nugu_sample_float_dot(f, f, BENCHMARK_SAMPLES) * 1e-9f;
+	g_test_message("%s: dot product: %f sec", nugu_sample_isa_name(isa),
+		       g_timer_elapsed(timer, NULL));
+
+	g_timer_destroy(timer);
+}
+
+static void test_sample_benchmark(void)
+{
+	int16_t *s16 = g_new0(int16_t, BENCHMARK_SAMPLES);
+	float *f = g_new0(float, BENCHMARK_SAMPLES);
+	int16_t *mono = g_new0(int16_t, BENCHMARK_SAMPLES / 2);
+	int i;
+
+	for (i = 0; i < BENCHMARK_SAMPLES; i++)
+		s16[i] = (int16_t)(i * 7);
+
+	benchmark_isa(NUGU_SAMPLE_ISA_SCALAR, s16, f, mono);
+	for (i = 0; i < (int)G_N_ELEMENTS(test_isa); i++)
+		benchmark_isa(test_isa[i], s16, f, mono);
+
+	nugu_sample_set_isa(NUGU_SAMPLE_ISA_AUTO);
+
+	g_free(mono);
+	g_free(f);
+	g_free(s16);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/sample/scalar", test_sample_scalar);
+	g_test_add_func("/sample/simd", test_sample_simd);
+
+	if (g_test_perf())
+		g_test_add_func("/sample/benchmark", test_sample_benchmark);
+
+	return g_test_run();
+}
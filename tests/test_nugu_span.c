@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "base/nugu_span.h"
+
+#define TEST_THREADS 3
+#define TEST_SPANS_PER_THREAD 100
+
+/* larger than the buffer of a thread */
+#define TEST_OVERFLOW_SPANS 5000
+
+/* more than the threads which can be recorded at the same time */
+#define TEST_RECYCLE_THREADS 100
+
+static char *make_path(void)
+{
+	return g_build_filename(g_get_tmp_dir(), "test_nugu_span.json", NULL);
+}
+
+static int count_string(const char *haystack, const char *needle)
+{
+	const char *pos = haystack;
+	int count = 0;
+
+	while ((pos = strstr(pos, needle)) != NULL) {
+		count++;
+		pos += strlen(needle);
+	}
+
+	return count;
+}
+
+static char *dump_contents(int *count)
+{
+	char *path = make_path();
+	char *contents = NULL;
+
+	*count = nugu_span_dump(path);
+	g_assert_cmpint(*count, >=, 0);
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL) == TRUE);
+
+	unlink(path);
+	g_free(path);
+
+	return contents;
+}
+
+static gpointer span_thread(gpointer userdata)
+{
+	int i;
+
+	for (i = 0; i < TEST_SPANS_PER_THREAD; i++) {
+		nugu_span_begin("outer");
+		nugu_span_begin("inner");
+		nugu_span_end("inner");
+		nugu_span_end("outer");
+	}
+
+	return NULL;
+}
+
+static void test_span_disabled(void)
+{
+	char *contents;
+	int count;
+
+	nugu_span_disable();
+	nugu_span_clear();
+
+	nugu_span_begin("disabled");
+	nugu_span_end("disabled");
+
+	contents = dump_contents(&count);
+	g_assert(strstr(contents, "\"disabled\"") == NULL);
+	g_free(contents);
+}
+
+static void test_span_threads(void)
+{
+	GThread *threads[TEST_THREADS];
+	char *contents;
+	int count;
+	int i;
+
+	nugu_span_enable();
+	nugu_span_clear();
+	g_assert_cmpint(nugu_span_is_enabled(), ==, 1);
+
+	for (i = 0; i < TEST_THREADS; i++)
+		threads[i] = g_thread_new("span", span_thread, NULL);
+
+	for (i = 0; i < TEST_THREADS; i++)
+		g_thread_join(threads[i]);
+
+	contents = dump_contents(&count);
+
+	/* spans of the finished threads are kept */
+	g_assert_cmpint(count_string(contents, "\"outer\",\"ph\":\"B\""), ==,
+			TEST_THREADS * TEST_SPANS_PER_THREAD);
+	g_assert_cmpint(count_string(contents, "\"inner\",\"ph\":\"E\""), ==,
+			TEST_THREADS * TEST_SPANS_PER_THREAD);
+	g_assert_cmpint(count_string(contents, "\"thread_name\""), >=,
+			TEST_THREADS);
+	g_assert(g_str_has_prefix(contents, "{\"displayTimeUnit\""));
+	g_assert(g_str_has_suffix(contents, "]}\n"));
+
+	g_free(contents);
+	nugu_span_disable();
+}
+
+static void test_span_overflow(void)
+{
+	char *contents;
+	int count;
+	int i;
+
+	nugu_span_enable();
+	nugu_span_clear();
+
+	/* the begin is overwritten */
+	nugu_span_begin("lost");
+	for (i = 0; i < TEST_OVERFLOW_SPANS; i++) {
+		nugu_span_begin("filler");
+		nugu_span_end("filler");
+	}
+	nugu_span_end("lost");
+
+	contents = dump_contents(&count);
+
+	/* the end without the begin is not dumped */
+	g_assert(strstr(contents, "\"lost\"") == NULL);
+	g_assert_cmpint(count_string(contents, "\"ph\":\"B\""), ==,
+			count_string(contents, "\"ph\":\"E\""));
+
+	g_free(contents);
+
+	/* the spans before the clear are discarded */
+	nugu_span_clear();
+	nugu_span_begin("after_clear");
+	nugu_span_end("after_clear");
+
+	contents = dump_contents(&count);
+	g_assert(strstr(contents, "\"filler\"") == NULL);
+	g_assert_cmpint(count_string(contents, "\"after_clear\""), ==, 2);
+	g_free(contents);
+
+	nugu_span_disable();
+}
+
+static gpointer recycle_thread(gpointer userdata)
+{
+	nugu_span_begin(userdata);
+	nugu_span_end(userdata);
+
+	return NULL;
+}
+
+static void test_span_recycle(void)
+{
+	char *contents;
+	int count;
+	int i;
+
+	nugu_span_enable();
+	nugu_span_clear();
+
+	/* the slots of the finished threads are reused */
+	for (i = 0; i < TEST_RECYCLE_THREADS; i++)
+		g_thread_join(g_thread_new("span", recycle_thread, "recycled"));
+
+	g_thread_join(g_thread_new("span", recycle_thread, "last"));
+
+	contents = dump_contents(&count);
+	g_assert_cmpint(count_string(contents, "\"last\""), ==, 2);
+	g_assert_cmpint(count_string(contents, "\"recycled\",\"ph\":\"B\""), >,
+			0);
+	g_free(contents);
+
+	/* the buffers of the finished threads are released by the clear */
+	nugu_span_clear();
+
+	contents = dump_contents(&count);
+	g_assert(strstr(contents, "\"recycled\"") == NULL);
+	g_assert(strstr(contents, "\"last\"") == NULL);
+	g_free(contents);
+
+	nugu_span_disable();
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/span/disabled", test_span_disabled);
+	g_test_add_func("/span/threads", test_span_threads);
+	g_test_add_func("/span/overflow", test_span_overflow);
+	g_test_add_func("/span/recycle", test_span_recycle);
+
+	return g_test_run();
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "base/nugu_trace.h"
+
+#define TEST_BLOCK_SIZE (16 * 1024)
+
+static char *make_path(void)
+{
+	gchar *path = g_strdup("/tmp/nugu_trace_XXXXXX");
+	int fd;
+
+	fd = g_mkstemp(path);
+	g_assert(fd >= 0);
+	close(fd);
+
+	return path;
+}
+
+/* decode the trace file into the string */
+static char *decode(const char *path, int *count)
+{
+	char *contents = NULL;
+	gsize length = 0;
+	gchar *out_path;
+	FILE *fp;
+
+	out_path = make_path();
+
+	fp = fopen(out_path, "w");
+	g_assert(fp != NULL);
+	*count = nugu_trace_decode(path, fp);
+	fclose(fp);
+
+	g_assert(g_file_get_contents(out_path, &contents, &length, NULL) ==
+		 TRUE);
+	unlink(out_path);
+	g_free(out_path);
+
+	return contents;
+}
+
+static void test_trace_decode(void)
+{
+	const char *body = "{\"directives\":[]}garbage";
+	gchar *path;
+	char *text;
+	int count;
+
+	g_assert(nugu_trace_get_format(0) == NULL);
+	g_assert(nugu_trace_get_format(NUGU_TRACE_ID_MAX) == NULL);
+	g_assert(nugu_trace_get_format(NUGU_TRACE_ID_EVENT) != NULL);
+
+	path = make_path();
+
+	g_assert(nugu_trace_open(path, 64 * 1024) == 0);
+	g_assert(nugu_trace_is_enabled() == 1);
+
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_EVENT, "multipart ",
+				  (void *)0x1234, 6, "{\"a\":1}") == 0);
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_EVENT_ATTACHMENT,
+				  "https://host/v1/event-attachment") == 0);
+
+	/* slice of the body without the null terminator */
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_DIRECTIVES, "(test)", 17,
+				  body) == 0);
+
+	nugu_trace_close();
+	g_assert(nugu_trace_is_enabled() == 0);
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_POLICY, 2, "{}") == -1);
+
+	text = decode(path, &count);
+	g_assert_cmpint(count, ==, 3);
+
+	g_assert(strstr(text, "--> Event multipart (0x1234)\n{\"a\":1\n") !=
+		 NULL);
+	g_assert(strstr(text, "--> EventAttachment\n"
+			      "https://host/v1/event-attachment\n") != NULL);
+	g_assert(strstr(text, "<-- Directives(test)\n{\"directives\":[]}\n") !=
+		 NULL);
+	g_assert(strstr(text, "garbage") == NULL);
+
+	g_free(text);
+	unlink(path);
+	g_free(path);
+}
+
+static void test_trace_circular(void)
+{
+	char msg[100];
+	gchar *path;
+	char *text;
+	char *pos;
+	int count;
+	int first = -1;
+	int last = -1;
+	int i;
+
+	path = make_path();
+
+	/* 3 blocks */
+	g_assert(nugu_trace_open(path, 64 + TEST_BLOCK_SIZE * 3) == 0);
+
+	for (i = 0; i < 2000; i++) {
+		snprintf(msg, sizeof(msg), "message-%04d", i);
+		g_assert(nugu_trace_write(NUGU_TRACE_ID_EVENT_ATTACHMENT,
+					  msg) == 0);
+	}
+
+	nugu_trace_close();
+
+	text = decode(path, &count);
+	g_assert_cmpint(count, >, 0);
+	g_assert_cmpint(count, <, 2000);
+
+	/* the newest messages are kept in order */
+	pos = text;
+	while ((pos = strstr(pos, "message-")) != NULL) {
+		int seq = atoi(pos + 8);
+
+		if (first < 0)
+			first = seq;
+		else
+			g_assert_cmpint(seq, ==, last + 1);
+
+		last = seq;
+		pos += 8;
+	}
+
+	g_assert_cmpint(last, ==, 1999);
+	g_assert_cmpint(last - first + 1, ==, count);
+
+	g_free(text);
+	unlink(path);
+	g_free(path);
+}
+
+static void test_trace_truncate(void)
+{
+	gchar *path;
+	char *body;
+	char *text;
+	int count;
+
+	path = make_path();
+	g_assert(nugu_trace_open(path, 64 + TEST_BLOCK_SIZE * 2) == 0);
+
+	/* larger than a block */
+	body = g_malloc(TEST_BLOCK_SIZE * 2);
+	memset(body, 'x', TEST_BLOCK_SIZE * 2);
+
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_POLICY, TEST_BLOCK_SIZE * 2,
+				  body) == 0);
+	g_assert(nugu_trace_write(NUGU_TRACE_ID_POLICY, 2, "{}") == 0);
+
+	nugu_trace_close();
+
+	text = decode(path, &count);
+	g_assert_cmpint(count, ==, 2);
+	g_assert(strstr(text, "xxx<...too long...>\n") != NULL);
+	g_assert(strstr(text, "<-- Policy\n{}\n") != NULL);
+
+	g_free(text);
+	g_free(body);
+	unlink(path);
+	g_free(path);
+}
+
+static void test_trace_invalid(void)
+{
+	gchar *path;
+	FILE *fp;
+
+	path = make_path();
+
+	fp = fopen(path, "w");
+	g_assert(fp != NULL);
+	fputs("not a trace file", fp);
+	fclose(fp);
+
+	g_assert(nugu_trace_decode(path, stdout) == -1);
+	g_assert(nugu_trace_open(path, 1024) == -1);
+
+	unlink(path);
+	g_free(path);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/trace/decode", test_trace_decode);
+	g_test_add_func("/trace/circular", test_trace_circular);
+	g_test_add_func("/trace/truncate", test_trace_truncate);
+	g_test_add_func("/trace/invalid", test_trace_invalid);
+
+	return g_test_run();
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023 SK Telecom Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "base/nugu_watchdog.h"
+
+#define TEST_THRESHOLD_MSEC 10
+#define MAX_TEST_STATS 8
+
+static gboolean on_busy_idle(gpointer userdata)
+{
+	int64_t begin = nugu_watchdog_begin();
+
+	/* block the main loop over the threshold */
+	g_usleep(TEST_THRESHOLD_MSEC * 2 * 1000);
+
+	nugu_watchdog_end("busy", begin, (const void *)on_busy_idle, userdata);
+
+	return FALSE;
+}
+
+static gboolean on_quick_idle(gpointer userdata)
+{
+	int64_t begin = nugu_watchdog_begin();
+
+	nugu_watchdog_end("quick", begin, (const void *)on_quick_idle, userdata);
+
+	return FALSE;
+}
+
+static gboolean on_quit(gpointer userdata)
+{
+	g_main_loop_quit((GMainLoop *)userdata);
+
+	return FALSE;
+}
+
+static void test_watchdog_disabled(void)
+{
+	struct nugu_watchdog_stat stats[MAX_TEST_STATS];
+
+	nugu_watchdog_reset();
+	g_assert(nugu_watchdog_is_enabled() == 0);
+
+	/* no measurement when disabled */
+	g_assert(nugu_watchdog_begin() == 0);
+	nugu_watchdog_end("disabled", 0, NULL, NULL);
+
+	g_assert(nugu_watchdog_get_stats(stats, MAX_TEST_STATS) == 0);
+	g_assert(nugu_watchdog_get_stats(NULL, MAX_TEST_STATS) == -1);
+	g_assert(nugu_watchdog_get_stats(stats, 0) == -1);
+}
+
+static void test_watchdog_stats(void)
+{
+	struct nugu_watchdog_stat stats[MAX_TEST_STATS];
+	unsigned int buckets[NUGU_WATCHDOG_LAG_BUCKETS];
+	unsigned int total = 0;
+	GMainLoop *loop;
+	int count;
+	int i;
+
+	nugu_watchdog_reset();
+	nugu_watchdog_enable(TEST_THRESHOLD_MSEC);
+	g_assert(nugu_watchdog_is_enabled() == 1);
+
+	loop = g_main_loop_new(NULL, FALSE);
+
+	g_idle_add(on_quick_idle, NULL);
+	g_idle_add(on_busy_idle, NULL);
+	g_idle_add(on_quick_idle, NULL);
+	g_timeout_add(350, on_quit, loop);
+
+	g_main_loop_run(loop);
+	g_main_loop_unref(loop);
+
+	count = nugu_watchdog_get_stats(stats, MAX_TEST_STATS);
+	g_assert(count == 2);
+
+	/* sorted by the maximum running time */
+	g_assert_cmpstr(stats[0].tag, ==, "busy");
+	g_assert(stats[0].count == 1);
+	g_assert(stats[0].stalls == 1);
+	g_assert(stats[0].max >= TEST_THRESHOLD_MSEC * 1000);
+
+	g_assert_cmpstr(stats[1].tag, ==, "quick");
+	g_assert(stats[1].count == 2);
+	g_assert(stats[1].stalls == 0);
+
+	/* the lag check runs every 100 msec */
+	nugu_watchdog_get_lag_histogram(buckets);
+	for (i = 0; i < NUGU_WATCHDOG_LAG_BUCKETS; i++)
+		total += buckets[i];
+	g_assert(total > 0);
+
+	nugu_watchdog_disable();
+	g_assert(nugu_watchdog_is_enabled() == 0);
+
+	nugu_watchdog_reset();
+	g_assert(nugu_watchdog_get_stats(stats, MAX_TEST_STATS) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+#if !GLIB_CHECK_VERSION(2, 36, 0)
+	g_type_init();
+#endif
+
+	g_test_init(&argc, &argv, NULL);
+	g_log_set_always_fatal((GLogLevelFlags)G_LOG_FATAL_MASK);
+
+	g_test_add_func("/watchdog/disabled", test_watchdog_disabled);
+	g_test_add_func("/watchdog/stats", test_watchdog_stats);
+
+	return g_test_run();
+}